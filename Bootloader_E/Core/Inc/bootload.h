@@ -4,10 +4,12 @@
  *  Created on: Nov 23, 2025
  *      Author: fs
  *
- * Custom USB Bootloader for STM32H733VGT6 (Encrypted - v3.0)
+ * Custom USB Bootloader for STM32H733VGT6 (Encrypted - v3.5)
  * Bootloader: 0x08000000-0x0801FFFF (128KB, full sector 0)
+ * Public key info: 0x0801FFE0 (v3.1, read by the application)
  * Version info: 0x0801FFF0 (last 16 bytes of bootloader sector)
- * Application: 0x08020000-0x080FFFFF (896KB, sectors 1-7)
+ * Application: 0x08020000-0x080DFFFF (768KB, sectors 1-6)
+ * Validity log: 0x080E0000-0x080FFFFF (v3.4, sector 7, validity.h)
  */
 
 #ifndef INC_BOOTLOAD_H_
@@ -55,6 +57,13 @@ return_code_t SetBootloaderFlag(void);
  */
 uint8_t IsBootloaderModeRequested(void);
 
+/**
+ * @brief Check if the application asked for its staged firmware to be installed
+ * Called by bootloader at startup, after IsBootloaderModeRequested()
+ * @return 1 if install requested, 0 otherwise
+ */
+uint8_t IsStagedInstallRequested(void);
+
 /**
  * @brief Jump from bootloader to application
  * Called by bootloader when no firmware update is needed
@@ -84,28 +93,78 @@ HAL_StatusTypeDef FlashLock(void);
 HAL_StatusTypeDef EraseApplicationFlash(void);
 
 /**
- * @brief Write data to flash
+ * @brief Erase the next sector of the incoming image ahead of its data
+ * Called from the main loop after each packet (v3.2 progressive erase)
+ */
+void EraseAhead(void);
+
+/**
+ * @brief Write data to flash, reading each flash word back
  * @param address Flash address (must be 32-byte aligned)
- * @param data Pointer to data buffer
+ * @param data Pointer to data buffer (4-byte aligned)
  * @param length Data length (must be multiple of 32)
  * @return HAL status
  */
 HAL_StatusTypeDef WriteFlash(uint32_t address, uint8_t *data, uint32_t length);
 
 /**
- * @brief Verify flash contents
- * @param address Flash address to verify
- * @param data Pointer to expected data
- * @param length Data length in bytes
+ * @brief Verify flash contents, 32-byte flash words
+ * @param address Flash address to verify (32-byte aligned)
+ * @param data Pointer to expected data (4-byte aligned)
+ * @param length Data length in bytes (multiple of 32)
  * @return 1 if match, 0 if mismatch
  */
 uint8_t VerifyFlash(uint32_t address, uint8_t *data, uint32_t length);
 
 /**
- * @brief Calculate CRC32 of application flash
+ * @brief CRC32 of the image programmed by the current update, padded to
+ * flash words; accumulated while programming, no pass over the flash
  * @return CRC32 value
  */
-uint32_t CalculateApplicationCRC(void);
+uint32_t GetApplicationCRC(void);
+
+// ============================================================================
+// Staged Firmware Install (v3.1)
+// ============================================================================
+
+/**
+ * @brief Install the .sfu image the application staged in the W25Q
+ * Verifies its signature, then decrypts and programs it at internal flash
+ * speed, first flash word last: an interrupted install leaves the
+ * application invalid and the staging record in place, so it runs again
+ * at the next start. The record is cleared once done, or if the image
+ * is not authentic.
+ * @return HAL_OK if the new application is programmed and verified
+ */
+HAL_StatusTypeDef InstallStagedFirmware(void);
+
+// ============================================================================
+// Rollback (v3.5)
+// ============================================================================
+
+/* Before an install erases a confirmed application, it is copied to the
+ * W25Q rollback slot (Staging/rollback.h) and the new image is recorded on
+ * trial. It must call rollback_confirm() within ROLLBACK_TRIAL_BOOTS boots,
+ * otherwise the copy is installed back. */
+typedef enum {
+    TRIAL_RUN,          // Start the application
+    TRIAL_CONFIRMED,    // Confirmed and recorded: reset
+    TRIAL_EXPIRED       // Never confirmed: RestoreBackup()
+} TrialResult_t;
+
+/**
+ * @brief Count a boot of the image on trial, or record its confirmation
+ * @return What main() does next
+ */
+TrialResult_t CheckTrialBoot(void);
+
+/**
+ * @brief Install the backup once CheckTrialBoot() has asked for it, at
+ * internal flash speed, first flash word last; resumed at the next start
+ * if interrupted. A backup whose hash does not match is dropped.
+ * @return HAL_OK if the previous application is back
+ */
+HAL_StatusTypeDef RestoreBackup(void);
 
 // ============================================================================
 // USB CDC Firmware Update Protocol
@@ -132,9 +191,41 @@ typedef struct {
 #define PACKET_TYPE_ENC_DATA   0x11  // Contains encrypted data chunk
 #define PACKET_TYPE_ENC_END    0x12  // Triggers signature verification
 
-// Bootloader version (v3.0 = 0x0300 - Encrypted bootloader)
+// Streaming encrypted update (v3.2)
+// STREAM_START is a FirmwarePacket_t like ENC_START, with the requested chunk
+// size in 'address'; the response carries the granted size in 256-byte units
+// in byte 5. The host then sends FirmwareChunk_t frames of exactly
+// 16 + granted size bytes, at most STREAM_WINDOW unacknowledged, each
+// answered with the number of chunks accepted (bytes 5-6, little-endian;
+// a chunk is programmed while the next one is decrypted, the last at once).
+// After the last chunk the link is back to FirmwarePacket_t and ENC_END
+// finishes as usual.
+#define PACKET_TYPE_STREAM_START  0x13  // SFU header + chunk size negotiation
+#define PACKET_TYPE_STREAM_DATA   0x14  // FirmwareChunk_t
+
+#define STREAM_CHUNK_MIN       256
+#define STREAM_CHUNK_MAX       8192  // Multiple of 256, two frames in RAM
+#define STREAM_WINDOW          2     // Chunks in flight: one processed, one received
+
+// Streaming chunk frame (same header layout as FirmwarePacket_t)
+typedef struct {
+    uint32_t packet_type;  // PACKET_TYPE_STREAM_DATA
+    uint32_t offset;       // Offset of this chunk in the encrypted image
+    uint32_t length;       // Ciphertext bytes, the granted size except in the last chunk
+    uint32_t crc32;        // CRC32 of the ciphertext
+    uint8_t data[STREAM_CHUNK_MAX];
+} FirmwareChunk_t;
+
+#define STREAM_FRAME_HEADER_SIZE  16
+
+// Bootloader version (v3.0 = 0x0300 - Encrypted bootloader,
+// v3.1 = 0x0301 - installs firmware staged in the W25Q, exports public key,
+// v3.2 = 0x0302 - streaming encrypted update,
+// v3.3 = 0x0303 - installs staged delta images,
+// v3.4 = 0x0304 - application validity log,
+// v3.5 = 0x0305 - rollback slot in the W25Q, trial boots)
 #define BOOTLOADER_VERSION_MAJOR  3
-#define BOOTLOADER_VERSION_MINOR  0
+#define BOOTLOADER_VERSION_MINOR  5
 #define BOOTLOADER_VERSION        ((BOOTLOADER_VERSION_MAJOR << 8) | BOOTLOADER_VERSION_MINOR)
 
 // Status response structure (sent in response to STATUS packet)
@@ -148,7 +239,8 @@ typedef struct {
     uint16_t reserved;       // Padding
     uint32_t bytes_received; // Total bytes received so far
     uint32_t next_address;   // Expected next write address
-    uint32_t flags;          // Bit 0: flash erased, Bit 1: transfer in progress
+    uint32_t flags;          // Bit 0: flash erased, Bit 1: transfer in progress,
+                             // Bit 2: encrypted, Bit 3: streaming
     uint8_t footer;          // 0x55
     uint8_t padding[3];      // Pad to 24 bytes
 } BootloaderStatus_t;
@@ -169,6 +261,26 @@ typedef enum {
  */
 int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet);
 
+/**
+ * @brief Process a streamed chunk (v3.2): hash, decrypt and program it
+ * Flash stays unlocked from STREAM_START to ENC_END (or reset)
+ * @param chunk Pointer to received chunk frame
+ * @return 0=Success, -1=Error
+ */
+int32_t ProcessFirmwareChunk(FirmwareChunk_t *chunk);
+
+/**
+ * @brief Chunk size granted by the last STREAM_START
+ * @return Chunk size in bytes, 0 outside a streaming session
+ */
+uint32_t GetStreamChunkSize(void);
+
+/**
+ * @brief Number of chunks accepted in the current streaming session
+ * @return Chunk count
+ */
+uint32_t GetStreamChunksStored(void);
+
 /**
  * @brief Get current firmware update progress (0-100)
  * @return Progress percentage
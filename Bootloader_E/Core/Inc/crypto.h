@@ -7,6 +7,7 @@
 #define INC_CRYPTO_H_
 
 #include "main.h"
+#include "sfu.h"
 #include <stdint.h>
 
 /* Return codes */
@@ -23,19 +24,15 @@
 #define ECDSA_SIG_SIZE      64
 #define ECDSA_PUBKEY_SIZE   64
 
-/* .sfu file header magic */
-#define SFU_MAGIC           0x5546534C  /* "LSFU" in little-endian */
+/* DMA pipeline: largest block, same as the largest stream chunk */
+#define CRYPTO_PIPELINE_BLOCK_MAX  8192
+#define CRYPTO_DMA_TIMEOUT_MS      100
 
-/* Secure Firmware Update header structure */
-typedef struct __attribute__((packed)) {
-    uint32_t magic;
-    uint32_t version;
-    uint32_t firmware_size;
-    uint32_t original_size;
-    uint8_t  iv[AES_IV_SIZE];
-    uint8_t  signature[ECDSA_SIG_SIZE];
-    uint32_t header_crc;
-} SFU_Header_t;
+/* .sfu file header (SFU_Header_t, SFU_MAGIC): see Staging/sfu.h */
+
+/* Public key info at fixed address 0x0801FFE0 (v3.1+), read by the
+ * application to check staged firmware against the same key */
+#define CRYPTO_KEY_INFO_MAGIC  0x4B504C42  /* "BLPK" */
 
 int32_t Crypto_Init(void);
 void Crypto_Reset(void);  /* Reset crypto state after interrupted transfer */
@@ -45,11 +42,32 @@ int32_t Crypto_ECDSA_Verify(const uint8_t *data, uint32_t data_length, const uin
 int32_t Crypto_ValidateSFUHeader(const SFU_Header_t *header);
 int32_t Crypto_DecryptFirmwareBlock(const uint8_t *encrypted_block, uint8_t *decrypted_block, uint32_t length, uint8_t *iv);
 
+/* Rollback backup (v3.5): AES-256-CBC encryption with the device key, iv
+ * updated for the next block like Crypto_DecryptFirmwareBlock(), and a
+ * random IV from the RNG */
+int32_t Crypto_EncryptBlock(const uint8_t *block, uint8_t *encrypted_block, uint32_t length, uint8_t *iv);
+int32_t Crypto_Random(uint8_t *data, uint32_t length);
+
+/* Validity record tag (v3.4): SipHash-2-4 of a short record, keyed with
+ * a key derived from the device AES key, folded to 32 bits. Software only,
+ * no peripheral: usable at reset, before HAL initialisation. */
+uint32_t Crypto_RecordTag(const uint8_t *data, uint32_t length);
+
 /* Incremental SHA-256 for large data (signature verification) */
 int32_t Crypto_SHA256_Start(void);
 int32_t Crypto_SHA256_Update(const uint8_t *data, uint32_t length);
 int32_t Crypto_SHA256_Finish(uint8_t *hash);
 
+/* DMA pipeline (v3.2): block N is decrypted by CRYP and hashed by HASH,
+ * both fed by DMA, while the CPU programs block N-1 through the callback.
+ * The callback gets the decrypted block and its length; the buffer has
+ * 32 bytes of room past the block for flash word padding.
+ * Blocks follow Crypto_SHA256_Start(); set last on the final one, which is
+ * programmed before returning. */
+typedef HAL_StatusTypeDef (*Crypto_ProgramFn)(uint8_t *data, uint32_t length);
+int32_t Crypto_PipelineBlock(const uint8_t *encrypted, uint32_t length, uint8_t *iv,
+                             uint8_t last, Crypto_ProgramFn program);
+
 /* ECDSA verification with pre-computed hash */
 int32_t Crypto_ECDSA_VerifyHash(const uint8_t *hash, const uint8_t *signature);
 
@@ -0,0 +1,37 @@
+/*
+ * decompress.h
+ * Streaming LZ4 decompression of compressed .sfu images (SFU_MAGIC_LZ4)
+ */
+
+#ifndef INC_DECOMPRESS_H_
+#define INC_DECOMPRESS_H_
+
+#include "main.h"
+#include "sfu.h"
+#include <stdint.h>
+
+/* Return codes */
+#define DECOMPRESS_OK       0
+#define DECOMPRESS_ERROR   -1
+
+/* Output is handed over in slices of this size, each starting on a flash
+ * word; the last one is shorter. The window holds the last SFU_LZ4_WINDOW
+ * bytes plus the slice being filled. */
+#define DECOMPRESS_FLUSH    4096
+#define DECOMPRESS_RING     (SFU_LZ4_WINDOW + DECOMPRESS_FLUSH)
+
+/* The callback gets a slice of the output and its length; the buffer has
+ * room past a short last slice for flash word padding (same contract as
+ * Crypto_ProgramFn). */
+typedef HAL_StatusTypeDef (*Decompress_OutputFn)(uint8_t *data, uint32_t length);
+
+/* Decompress an LZ4 block stream of output_size bytes, fed in pieces of any
+ * size. Offsets beyond SFU_LZ4_WINDOW or the output so far, output past
+ * output_size, input after the end and callback errors all fail. */
+void Decompress_Start(uint32_t output_size, Decompress_OutputFn output);
+int32_t Decompress_Feed(const uint8_t *data, uint32_t length);
+
+/* DECOMPRESS_OK once the stream ended on a sequence, with every byte output */
+int32_t Decompress_Finish(void);
+
+#endif /* INC_DECOMPRESS_H_ */
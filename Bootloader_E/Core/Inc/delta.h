@@ -0,0 +1,33 @@
+/*
+ * delta.h
+ * Patch records of delta .sfu images (SFU_MAGIC_DELTA), see Staging/sfu.h
+ */
+
+#ifndef INC_DELTA_H_
+#define INC_DELTA_H_
+
+#include "main.h"
+#include "sfu.h"
+#include <stdint.h>
+
+/* Return codes */
+#define DELTA_OK            0
+#define DELTA_ERROR        -1
+
+/* Output is handed over in blocks of this size (one W25Q sector), the last
+ * one shorter */
+#define DELTA_OUTPUT_BLOCK  4096
+
+typedef HAL_StatusTypeDef (*Delta_OutputFn)(const uint8_t *data, uint32_t length);
+
+/* Apply a patch to base (read in place) to make target_size bytes. The patch
+ * is fed in pieces of any size; records reaching outside the base or past
+ * target_size, and callback errors, fail. */
+void Delta_Start(const uint8_t *base, uint32_t base_size, uint32_t target_size,
+                 Delta_OutputFn output);
+int32_t Delta_Feed(const uint8_t *patch, uint32_t length);
+
+/* DELTA_OK once the patch ended on a record with target_size bytes output */
+int32_t Delta_Finish(void);
+
+#endif /* INC_DELTA_H_ */
@@ -0,0 +1,21 @@
+#ifndef __DMA_H__
+#define __DMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* DMA1 streams of the crypto pipeline (crypto.c) */
+#define CRYP_IN_DMA_STREAM    DMA1_Stream0
+#define CRYP_OUT_DMA_STREAM   DMA1_Stream1
+#define HASH_IN_DMA_STREAM    DMA1_Stream2
+
+void MX_DMA_Init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DMA_H__ */
@@ -0,0 +1,16 @@
+/*
+ * iwdg.h
+ * Watchdog refresh for the shared W25Q64 driver
+ *
+ * The bootloader does not start the IWDG, it only keeps refreshing the one
+ * the application may have started (IWDG_REFRESH() in main.h).
+ */
+
+#ifndef __IWDG_H__
+#define __IWDG_H__
+
+#include "main.h"
+
+#define watchdog_refresh()  IWDG_REFRESH()
+
+#endif /* __IWDG_H__ */
@@ -0,0 +1,82 @@
+/*
+ * validity.h
+ * Application validity log: a record written by the bootloader when an
+ * install starts and when it completes, checked at power-on before any
+ * initialisation so that a good application is entered at once
+ */
+
+#ifndef INC_VALIDITY_H_
+#define INC_VALIDITY_H_
+
+#include "main.h"
+#include <stdint.h>
+
+/* Last flash sector, taken from the application (sectors 1-6, 768KB).
+ * Records are appended one flash word at a time. When too few slots are
+ * left, the sector is erased and the log starts again from the first slot,
+ * its counter going on: between the erase and the next record the log is
+ * empty, and the stack pointer check applies. */
+#define VALIDITY_LOG_ADDRESS    0x080E0000UL
+#define VALIDITY_LOG_SECTOR     7
+#define VALIDITY_LOG_SIZE       0x20000 // 4096 records
+#define VALIDITY_RECORD_SIZE    32
+#define VALIDITY_SLOTS          (VALIDITY_LOG_SIZE / VALIDITY_RECORD_SIZE)
+#define VALIDITY_MAGIC          0x5256534C  // "LSVR" in little-endian
+
+/* Slots searched back from the end for an authentic record, past records
+ * damaged by a power cut (ECC error) or forged */
+#define VALIDITY_LOOKBACK       4
+
+/* image_size value that is not an image */
+#define VALIDITY_STARTED        0x00000000  // Install started, not finished
+
+/* flags */
+#define VALIDITY_FLAG_TRIAL     0x00000001  // Not confirmed yet (rollback.h)
+
+typedef struct {
+    uint32_t magic;         // VALIDITY_MAGIC
+    uint32_t counter;       // Previous record's + 1, across log erases
+    uint32_t image_size;    // Bytes programmed (whole flash words)
+    uint32_t image_crc;     // CRC32 of image_size bytes of application flash
+    uint32_t app_stack;     // First two words of the image
+    uint32_t app_reset;
+    uint32_t flags;         // VALIDITY_FLAG_*
+    uint32_t tag;           // Crypto_RecordTag() of the words above
+} ValidityRecord_t;
+
+typedef enum {
+    VALIDITY_OK,            // Application is the image the last install wrote
+    VALIDITY_TRIAL,         // Same, installed on trial: boots are counted
+    VALIDITY_NONE,          // No record (log erased): stack pointer check only
+    VALIDITY_INCOMPLETE,    // Last install did not finish, or no authentic record
+    VALIDITY_MISMATCH       // Counters, first words or a damaged slot: check the CRC
+} ValidityState_t;
+
+/* Newest authentic record against the application's first words. Reads
+ * flash only, through a path that survives ECC errors: works before MPU,
+ * HAL and clock initialisation, tens of microseconds. */
+ValidityState_t Validity_Check(void);
+
+/* Decide from a Validity_Check() state, with the CRC check of
+ * VALIDITY_MISMATCH (whole image read; CRC unit needed). A good image is
+ * recorded again so that the next power-on takes the fast path. */
+uint8_t Validity_ApplicationValid(ValidityState_t state);
+
+/* Before application flash is erased: the application is not valid until
+ * Validity_InstallDone(). image_crc is the CRC32 of the image padded to
+ * flash words, accumulated by the caller as each word was programmed and
+ * read back (GetApplicationCRC()): the image is not read again here.
+ * trial: a backup of the previous image is kept, the new one must confirm
+ * itself. Validity_InstallStarted() erases the log first if it has no room
+ * for the install's records (about 1 s). Leave the flash lock as they find it. */
+HAL_StatusTypeDef Validity_InstallStarted(void);
+HAL_StatusTypeDef Validity_InstallDone(uint32_t image_size, uint32_t image_crc,
+                                       uint8_t trial);
+
+/* End the trial of the installed image: recorded again without the flag */
+HAL_StatusTypeDef Validity_Confirm(void);
+
+/* Size and CRC32 of the installed image (VALIDITY_OK or VALIDITY_TRIAL) */
+HAL_StatusTypeDef Validity_InstalledImage(uint32_t *image_size, uint32_t *image_crc);
+
+#endif /* INC_VALIDITY_H_ */
@@ -1,12 +1,20 @@
 /**
  * STM32H733VGT6 Custom USB Bootloader Implementation
  * Bootloader at 0x08000000 (Sector 0, 128KB)
- * Application at 0x08020000 (Sectors 1-7, 896KB)
+ * Application at 0x08020000 (Sectors 1-6, 768KB)
+ * Validity log at 0x080E0000 (Sector 7, validity.h)
  */
 
 #include "stm32h7xx_hal.h"
 #include "bootload.h"
+#include "checksum.h"
 #include "crypto.h"
+#include "decompress.h"
+#include "delta.h"
+#include "octospi.h"
+#include "rollback.h"
+#include "staging.h"
+#include "validity.h"
 #include "usbd_cdc_if.h"
 #include <string.h>
 
@@ -32,19 +40,21 @@ const struct {
 // RTC Backup Register for bootloader flag (survives reset)
 #define RTC_BACKUP_BOOTLOADER_FLAG  0  // Use register 0
 #define BOOTLOADER_MAGIC_VALUE      0xDEADBEEF
+// STAGING_INSTALL_MAGIC (staging.h) in the same register: install staged image
 
 // Memory layout - STM32H733VGT6 has 128KB sectors!
 #define BOOTLOADER_START_ADDRESS    0x08000000
 #define APPLICATION_START_ADDRESS   0x08020000  // Sector 1 (128KB offset)
-#define FLASH_END_ADDRESS           0x080FFFFF
+#define FLASH_END_ADDRESS           0x080DFFFF  // End of the application: sector 7 holds the validity log
 
 // Flash sector definitions for STM32H733VGT6 (1MB flash, 128KB sectors)
 // Sector 0: 0x08000000 - 0x0801FFFF (Bootloader)
 // Sector 1: 0x08020000 - 0x0803FFFF (App start)
-// Sector 2-7: App continues
+// Sector 2-6: App continues
+// Sector 7: 0x080E0000 - 0x080FFFFF (Validity log)
 #define BL_FLASH_SECTOR_SIZE        0x20000  // 128KB sectors
-#define BL_FLASH_TOTAL_SIZE         0x100000  // 1MB
 #define APP_FIRST_SECTOR            1         // Application starts at sector 1
+#define APP_SECTORS                 6         // Sectors 1-6
 
 /**
  * @brief Request bootloader entry from application
@@ -123,6 +133,24 @@ uint8_t IsBootloaderModeRequested(void)
     return 0;
 }
 
+/**
+ * @brief Check if the application requested a staged firmware install
+ * Called right after IsBootloaderModeRequested(), which enabled backup
+ * domain access - MUST work without HAL initialized!
+ * @return 1 if install requested, 0 otherwise
+ */
+uint8_t IsStagedInstallRequested(void)
+{
+    if (RTC->BKP0R == STAGING_INSTALL_MAGIC) {
+        // Clear the flag: an interrupted install resumes because the
+        // application is left invalid, not because of this flag
+        RTC->BKP0R = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
 // Function pointer type for application entry
 typedef void (*pFunction)(void);
 
@@ -185,7 +213,7 @@ void JumpToApplication(void)
 
     // Get the application's Reset Handler address and jump
     // NOTE: Do NOT set MSP - app's Reset_Handler sets it as first instruction
-    JumpToApp = (pFunction)app_reset_vector;
+    JumpToApp = (pFunction)(uintptr_t)app_reset_vector;
     JumpToApp();
 
     // Never reached
@@ -198,6 +226,30 @@ void JumpToApplication(void)
 
 // Track which sectors have been erased (for progressive erase)
 static uint32_t last_erased_sector = 0;
+// Last sector the incoming image covers: nothing past it is erased
+static uint32_t erase_end_sector = 0;
+
+// Rollback slot (v3.5, below): called before an install erases the application
+static void PrepareRollback(void);
+
+/**
+ * @brief Flash sector holding an address
+ * @param address Flash address
+ * @return Absolute sector number
+ */
+static uint32_t SectorOf(uint32_t address)
+{
+    return (address - BOOTLOADER_START_ADDRESS) / BL_FLASH_SECTOR_SIZE;
+}
+
+/**
+ * @brief Check the flash lock
+ * @return 1 if locked, 0 if unlocked
+ */
+static uint8_t FlashLocked(void)
+{
+    return (FLASH->CR1 & FLASH_CR_LOCK) != 0;
+}
 
 /**
  * @brief Unlock flash for programming
@@ -206,7 +258,7 @@ static uint32_t last_erased_sector = 0;
 HAL_StatusTypeDef FlashUnlock(void)
 {
     // Check if flash is already unlocked (STM32H7 uses FLASH_CR1 for bank 1)
-    if ((FLASH->CR1 & FLASH_CR_LOCK) == 0) {
+    if (!FlashLocked()) {
         // Already unlocked
         return HAL_OK;
     }
@@ -247,221 +299,1090 @@ static HAL_StatusTypeDef EraseSingleSector(uint32_t sector_num)
 
     HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase_init, &sector_error);
 
-    if (status != HAL_OK || sector_error != 0xFFFFFFFF) {
+    if (status != HAL_OK || sector_error != 0xFFFFFFFF) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Erase sectors as needed for the given address
+ * Sectors are erased in order and only once per session: a RESUME keeps
+ * last_erased_sector, so sectors already written are never erased again.
+ * Normally EraseAhead() got there first and nothing is erased here.
+ * Leaves the flash lock as it found it.
+ * @param address Flash address that needs to be written
+ * @return HAL status, HAL_ERROR past the end of the image
+ */
+static HAL_StatusTypeDef EnsureSectorErased(uint32_t address)
+{
+    // Calculate which sector this address belongs to
+    uint32_t sector_num = SectorOf(address);
+
+    if (sector_num < APP_FIRST_SECTOR || sector_num > erase_end_sector) {
+        return HAL_ERROR;
+    }
+    if (sector_num <= last_erased_sector) {
+        return HAL_OK;
+    }
+
+    uint8_t was_locked = FlashLocked();
+    if (was_locked && FlashUnlock() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status = HAL_OK;
+    while (last_erased_sector < sector_num) {
+        // Refresh watchdog before each sector erase (takes ~seconds)
+        IWDG_REFRESH();
+        status = EraseSingleSector(last_erased_sector + 1);
+        if (status != HAL_OK) {
+            break;
+        }
+        last_erased_sector++;
+    }
+
+    if (was_locked) {
+        FlashLock();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Start a progressive erase for an image of the given size
+ * Erases the first application sector now (so the first data can be
+ * written), the following ones in EraseAhead(), never those past the image
+ * @param image_size Bytes the image will occupy in application flash
+ * @return HAL status
+ */
+static HAL_StatusTypeDef BeginProgressiveErase(uint32_t image_size)
+{
+    if (image_size == 0
+            || image_size > FLASH_END_ADDRESS + 1 - APPLICATION_START_ADDRESS) {
+        return HAL_ERROR;
+    }
+
+    // v3.5: keep the application being replaced in the W25Q
+    PrepareRollback();
+
+    // v3.4: the application is not valid again until the install completes
+    if (Validity_InstallStarted() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    last_erased_sector = 0;
+    erase_end_sector = SectorOf(APPLICATION_START_ADDRESS + image_size - 1);
+
+    return EnsureSectorErased(APPLICATION_START_ADDRESS);
+}
+
+/**
+ * @brief Erase application flash sectors (1-6)
+ * Whole-application erase; updates use BeginProgressiveErase() instead
+ *
+ * STM32H733VGT6 Memory Map (128KB sectors):
+ *   Sector 0: 0x08000000 - 0x0801FFFF = Bootloader
+ *   Sector 1-6: 0x08020000 - 0x080DFFFF = Application (768KB)
+ *   Sector 7: 0x080E0000 - 0x080FFFFF = Validity log
+ *
+ * @return HAL status
+ */
+HAL_StatusTypeDef EraseApplicationFlash(void)
+{
+    FLASH_EraseInitTypeDef erase;
+    uint32_t error;
+    const uint32_t SECTORS_TO_ERASE = APP_SECTORS;
+
+    PrepareRollback();
+    if (Validity_InstallStarted() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    HAL_FLASH_Unlock();
+
+    for (uint32_t i = 0; i < SECTORS_TO_ERASE; i++) {
+        // Refresh watchdog before each sector erase (takes ~seconds)
+        IWDG_REFRESH();
+
+        erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+        erase.Banks = FLASH_BANK_1;
+        erase.Sector = APP_FIRST_SECTOR + i;
+        erase.NbSectors = 1;
+        erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+        if (HAL_FLASHEx_Erase(&erase, &error) != HAL_OK) {
+            HAL_FLASH_Lock();
+            return HAL_ERROR;
+        }
+    }
+
+    HAL_FLASH_Lock();
+
+    // Mark all sectors as erased so WriteFlash doesn't try to erase again
+    last_erased_sector = APP_FIRST_SECTOR + SECTORS_TO_ERASE - 1;
+    erase_end_sector = last_erased_sector;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Write data to flash, reading each flash word back
+ * @param address Flash address to write to (must be aligned to 256-bit / 32 bytes)
+ * @param data Pointer to data buffer (4-byte aligned)
+ * @param length Data length in bytes (must be multiple of 32)
+ * @return HAL status, HAL_ERROR if a word reads back different
+ */
+HAL_StatusTypeDef WriteFlash(uint32_t address, uint8_t *data, uint32_t length)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+
+    // CRITICAL SAFETY CHECK: Prevent any writes to bootloader area
+    if (address < APPLICATION_START_ADDRESS) {
+        return HAL_ERROR;
+    }
+
+    // Also check that the write won't overflow into invalid area
+    if (address + length > FLASH_END_ADDRESS + 1) {
+        return HAL_ERROR;
+    }
+
+    // STM32H7 flash is programmed in 256-bit (32 byte) words
+    // Address must be 32-byte aligned
+    if ((address % 32) != 0) {
+        return HAL_ERROR;
+    }
+
+    // Length must be multiple of 32 bytes
+    if ((length % 32) != 0) {
+        return HAL_ERROR;
+    }
+
+    // Program flash in 256-bit chunks
+    for (uint32_t i = 0; i < length; i += 32) {
+        IWDG_REFRESH();  // Refresh watchdog during flash writes
+        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD,
+                                   address + i,
+                                   (uint32_t)(uintptr_t)(data + i));
+        if (status != HAL_OK) {
+            return status;
+        }
+        // Read back while the word is at hand, no second pass later
+        if (!VerifyFlash(address + i, data + i, 32)) {
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Verify flash contents, one 256-bit flash word at a time
+ * @param address Flash address to verify (32-byte aligned)
+ * @param data Pointer to expected data (4-byte aligned)
+ * @param length Data length in bytes (multiple of 32)
+ * @return 1 if match, 0 if mismatch
+ */
+uint8_t VerifyFlash(uint32_t address, uint8_t *data, uint32_t length)
+{
+    const uint32_t *flash_ptr = (const uint32_t *)(uintptr_t)address;
+    const uint32_t *expected = (const uint32_t *)data;
+
+    for (uint32_t i = 0; i < length / 4; i += 8) {
+        uint32_t diff = (flash_ptr[i] ^ expected[i]) | (flash_ptr[i + 1] ^ expected[i + 1]) |
+                        (flash_ptr[i + 2] ^ expected[i + 2]) | (flash_ptr[i + 3] ^ expected[i + 3]) |
+                        (flash_ptr[i + 4] ^ expected[i + 4]) | (flash_ptr[i + 5] ^ expected[i + 5]) |
+                        (flash_ptr[i + 6] ^ expected[i + 6]) | (flash_ptr[i + 7] ^ expected[i + 7]);
+        if (diff != 0) {
+            return 0;  // Mismatch
+        }
+    }
+
+    return 1;  // Match
+}
+
+// CRC32 of the image this update programmed, in image order, padded to
+// flash words with 0xFF: extended as each write is verified
+static uint32_t image_crc = CRC32_INIT;
+
+/**
+ * @brief Program the next image bytes and extend the image CRC
+ * WriteFlash() has read every word back, so the CRC runs over the data
+ * buffer rather than the flash
+ * @param address Flash address, where the previous image write ended
+ * @param data Image data, padded to flash words
+ * @param length Data length in bytes (multiple of 32)
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ProgramImageWords(uint32_t address, uint8_t *data, uint32_t length)
+{
+    if (WriteFlash(address, data, length) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    image_crc = crc32_ieee(image_crc, data, length);
+    return HAL_OK;
+}
+
+/**
+ * @brief Get the CRC32 of the image programmed by the current update
+ * Complete when the last write returns: application flash is not read again
+ * @return CRC32 value
+ */
+uint32_t GetApplicationCRC(void)
+{
+    return image_crc;
+}
+
+// ============================================================================
+// Staged Firmware Install (v3.1)
+// ============================================================================
+
+// One W25Q sector per step: multiple of the AES block and the flash word
+#define STAGED_CHUNK_SIZE           4096
+#define FLASH_WORD_SIZE             32
+
+__attribute__((aligned(32)))
+static uint8_t staged_enc_buffer[STAGED_CHUNK_SIZE];
+__attribute__((aligned(32)))
+static uint8_t staged_dec_buffer[STAGED_CHUNK_SIZE];
+__attribute__((aligned(32)))
+static uint8_t staged_first_word[FLASH_WORD_SIZE];
+static uint32_t staged_written = 0;         // Image bytes programmed
+static uint8_t external_flash_ready = 0;
+
+/**
+ * @brief Set up OCTOSPI2 and the W25Q for indirect access, once
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ExternalFlashInit(void)
+{
+    if (!external_flash_ready) {
+        // W25Q64_OCTO_SPI_Init() starts with a DeInit: the handle must be set up
+        MX_OCTOSPI2_Init();
+        if (W25Q64_OCTO_SPI_Init(&hospi2) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        external_flash_ready = 1;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Feed the decrypted payload of a compressed image (SFU_MAGIC_LZ4)
+ * to the decompressor, after Decompress_Start()
+ * PKCS7 padding is removed from the last block, which must end the stream.
+ * @param data Decrypted data, whole AES blocks
+ * @param length Number of bytes
+ * @param last 1 if the payload ends with this data
+ * @return HAL status
+ */
+static HAL_StatusTypeDef FeedCompressed(const uint8_t *data, uint32_t length, uint8_t last)
+{
+    if (last) {
+        uint8_t pad = data[length - 1];
+        if (pad == 0 || pad > AES_BLOCK_SIZE || pad > length) {
+            return HAL_ERROR;
+        }
+        length -= pad;
+    }
+
+    if (Decompress_Feed(data, length) != DECOMPRESS_OK) {
+        return HAL_ERROR;
+    }
+    if (last && Decompress_Finish() != DECOMPRESS_OK) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Check that a flash sector is blank
+ * @param sector_num Absolute sector number
+ * @return 1 if all bytes are 0xFF
+ */
+static uint8_t SectorBlank(uint32_t sector_num)
+{
+    const uint32_t *word = (const uint32_t *)(uintptr_t)(BOOTLOADER_START_ADDRESS +
+                                                         sector_num * BL_FLASH_SECTOR_SIZE);
+
+    for (uint32_t i = 0; i < BL_FLASH_SECTOR_SIZE / 4; i++) {
+        if (word[i] != 0xFFFFFFFF) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Hash a range of the W25Q
+ * @param address W25Q address
+ * @param length Number of bytes, a multiple of 4
+ * @param hash SHA-256 of the range, 4-byte aligned
+ * @return HAL status
+ */
+static HAL_StatusTypeDef HashStaged(uint32_t address, uint32_t length, uint8_t *hash)
+{
+    uint32_t size;
+
+    Crypto_Reset();
+    if (Crypto_SHA256_Start() != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t offset = 0; offset < length; offset += size) {
+        IWDG_REFRESH();
+        size = length - offset;
+        if (size > STAGED_CHUNK_SIZE) {
+            size = STAGED_CHUNK_SIZE;
+        }
+        if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer, address + offset, size) != HAL_OK ||
+            Crypto_SHA256_Update(staged_enc_buffer, size) != CRYPTO_OK) {
+            Crypto_Reset();
+            return HAL_ERROR;
+        }
+    }
+
+    if (Crypto_SHA256_Finish(hash) != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Hash the staged ciphertext and check its signature
+ * The W25Q is outside the chip: the application's check is not trusted
+ * @param header Staged .sfu header
+ * @return HAL status
+ */
+static HAL_StatusTypeDef VerifyStagedFirmware(const SFU_Header_t *header)
+{
+    __attribute__((aligned(4)))
+    static uint8_t staged_hash[SHA256_DIGEST_SIZE];
+
+    if (HashStaged(STAGING_PAYLOAD_OFFSET, header->firmware_size, staged_hash) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    IWDG_REFRESH();
+    if (Crypto_ECDSA_VerifyHash(staged_hash, header->signature) != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Program and verify the next image bytes of a staged install
+ * The first flash word is kept for the end of the install.
+ * @param data Image data, with room for flash word padding
+ * @param length Number of bytes
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ProgramStagedData(uint8_t *data, uint32_t length)
+{
+    uint32_t padded_size = (length + FLASH_WORD_SIZE - 1) / FLASH_WORD_SIZE * FLASH_WORD_SIZE;
+    memset(data + length, 0xFF, padded_size - length);
+
+    uint32_t skip = 0;
+    if (staged_written == 0) {
+        memcpy(staged_first_word, data, FLASH_WORD_SIZE);
+        skip = FLASH_WORD_SIZE;
+    }
+
+    if (WriteFlash(APPLICATION_START_ADDRESS + staged_written + skip,
+                   data + skip, padded_size - skip) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    // The first word is in the CRC already, read back when it is committed
+    image_crc = crc32_ieee(image_crc, data, padded_size);
+    staged_written += length;
+    return HAL_OK;
+}
+
+/**
+ * @brief Erase the application flash for a staged install
+ * Sectors the image needs are erased, later ones only if not blank.
+ * @param image_size Bytes of the new image
+ * @return HAL status
+ */
+static HAL_StatusTypeDef EraseForStagedImage(uint32_t image_size)
+{
+    uint32_t sectors = (image_size + BL_FLASH_SECTOR_SIZE - 1) / BL_FLASH_SECTOR_SIZE;
+
+    if (Validity_InstallStarted() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t i = 0; i < APP_SECTORS; i++) {
+        IWDG_REFRESH();
+        if ((i < sectors || !SectorBlank(APP_FIRST_SECTOR + i)) &&
+            EraseSingleSector(APP_FIRST_SECTOR + i) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    staged_written = 0;
+    image_crc = CRC32_INIT;
+    return HAL_OK;
+}
+
+// Next install is recorded on trial: PrepareRollback() kept a backup
+static uint8_t install_trial = 0;
+
+/**
+ * @brief Program the first flash word kept by ProgramStagedData()
+ * Application becomes valid with its first word and the validity record
+ * @return HAL status
+ */
+static HAL_StatusTypeDef CommitStagedImage(void)
+{
+    if (WriteFlash(APPLICATION_START_ADDRESS, staged_first_word, FLASH_WORD_SIZE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return Validity_InstallDone(staged_written, image_crc, install_trial);
+}
+
+/**
+ * @brief Decrypt the staged image into application flash
+ * A compressed image is decompressed on the way.
+ * The first flash word (stack pointer, reset vector) is programmed last.
+ * @param header Staged .sfu header, already verified
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ProgramStagedFirmware(const SFU_Header_t *header)
+{
+    __attribute__((aligned(4)))
+    static uint8_t iv[AES_IV_SIZE];
+    uint8_t compressed = (header->magic == SFU_MAGIC_LZ4);
+    uint32_t size;
+
+    PrepareRollback();
+    if (EraseForStagedImage(header->original_size) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    memcpy(iv, header->iv, AES_IV_SIZE);
+    if (compressed) {
+        Decompress_Start(header->original_size, ProgramStagedData);
+    }
+
+    for (uint32_t offset = 0; offset < header->firmware_size; offset += size) {
+        IWDG_REFRESH();
+        size = header->firmware_size - offset;
+        if (size > STAGED_CHUNK_SIZE) {
+            size = STAGED_CHUNK_SIZE;
+        }
+
+        if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer,
+                             STAGING_PAYLOAD_OFFSET + offset, size) != HAL_OK ||
+            Crypto_DecryptFirmwareBlock(staged_enc_buffer, staged_dec_buffer,
+                                        size, iv) != CRYPTO_OK) {
+            return HAL_ERROR;
+        }
+
+        if (compressed) {
+            if (FeedCompressed(staged_dec_buffer, size,
+                               offset + size == header->firmware_size) != HAL_OK) {
+                return HAL_ERROR;
+            }
+            continue;
+        }
+
+        // Trim PKCS7 padding
+        uint32_t data_size = header->original_size - offset;
+        if (data_size > size) {
+            data_size = size;
+        }
+        if (ProgramStagedData(staged_dec_buffer, data_size) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    return CommitStagedImage();
+}
+
+// ============================================================================
+// Delta Install (v3.3)
+// ============================================================================
+
+// Delta output is written to the W25Q one sector at a time
+#if DELTA_OUTPUT_BLOCK != W25Q_SECTOR_SIZE
+#error "DELTA_OUTPUT_BLOCK must be one W25Q sector"
+#endif
+
+__attribute__((aligned(4)))
+static SFU_DeltaHeader_t delta_header;
+__attribute__((aligned(4)))
+static uint8_t delta_hash[SHA256_DIGEST_SIZE];
+static uint32_t scratch_address = 0;        // Next W25Q sector of the rebuilt image
+
+/**
+ * @brief Round an image size up to whole flash words
+ */
+static uint32_t FlashWordPadded(uint32_t size)
+{
+    return (size + FLASH_WORD_SIZE - 1) / FLASH_WORD_SIZE * FLASH_WORD_SIZE;
+}
+
+/**
+ * @brief Delta output callback: write a block of the rebuilt image to the scratch area
+ * @param data Image data
+ * @param length Number of bytes, one W25Q sector at most
+ * @return HAL status
+ */
+static HAL_StatusTypeDef WriteScratch(const uint8_t *data, uint32_t length)
+{
+    IWDG_REFRESH();
+    if (W25Q64_OSPI_EraseBlockStart(&hospi2, scratch_address, W25Q_SECTOR_SIZE) != HAL_OK ||
+        W25Q64_OSPI_AutoPollingMemReady(&hospi2) != HAL_OK ||
+        W25Q64_OSPI_Write(&hospi2, (uint8_t *)data, scratch_address, length) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    scratch_address += W25Q_SECTOR_SIZE;
+    return HAL_OK;
+}
+
+/**
+ * @brief Decompressor output callback: patch records to the delta decoder
+ * @param data Patch data
+ * @param length Number of bytes
+ * @return HAL status
+ */
+static HAL_StatusTypeDef PatchOutput(uint8_t *data, uint32_t length)
+{
+    return (Delta_Feed(data, length) == DELTA_OK) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Decrypt and check the delta header at the start of the staged payload
+ * @param header Staged .sfu header, already verified
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ReadDeltaHeader(const SFU_Header_t *header)
+{
+    __attribute__((aligned(4)))
+    static uint8_t iv[AES_IV_SIZE];
+
+    memcpy(iv, header->iv, AES_IV_SIZE);
+    if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer, STAGING_PAYLOAD_OFFSET,
+                         sizeof(SFU_DeltaHeader_t)) != HAL_OK ||
+        Crypto_DecryptFirmwareBlock(staged_enc_buffer, (uint8_t *)&delta_header,
+                                    sizeof(SFU_DeltaHeader_t), iv) != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+
+    if (delta_header.magic != SFU_DELTA_MAGIC ||
+        delta_header.base_size == 0 ||
+        delta_header.base_size % FLASH_WORD_SIZE != 0 ||
+        delta_header.base_size > SFU_MAX_ORIGINAL_SIZE ||
+        delta_header.patch_size == 0) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Check that the installed application is the base of the delta
+ * @return HAL status, HAL_ERROR if it is another image
+ */
+static HAL_StatusTypeDef CheckDeltaBase(void)
+{
+    Crypto_Reset();
+    if (Crypto_SHA256_Start() != CRYPTO_OK ||
+        Crypto_SHA256_Update((const uint8_t *)APPLICATION_START_ADDRESS,
+                             delta_header.base_size) != CRYPTO_OK ||
+        Crypto_SHA256_Finish(delta_hash) != CRYPTO_OK) {
+        Crypto_Reset();
+        return HAL_ERROR;
+    }
+
+    return (memcmp(delta_hash, delta_header.base_sha256, SHA256_DIGEST_SIZE) == 0) ?
+           HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Check the rebuilt image in the scratch area against the signed hash
+ * @param header Staged .sfu header
+ * @return HAL status, HAL_ERROR if the scratch does not hold the target
+ */
+static HAL_StatusTypeDef CheckScratch(const SFU_Header_t *header)
+{
+    if (HashStaged(STAGING_SCRATCH_OFFSET(header->firmware_size),
+                   FlashWordPadded(header->original_size), delta_hash) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return (memcmp(delta_hash, delta_header.target_sha256, SHA256_DIGEST_SIZE) == 0) ?
+           HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Rebuild the target image in the scratch area
+ * The patch is decrypted, decompressed and applied to the application
+ * flash, read in place; the application is not modified.
+ * @param header Staged .sfu header, delta header read
+ * @return HAL status
+ */
+static HAL_StatusTypeDef RebuildDeltaImage(const SFU_Header_t *header)
+{
+    __attribute__((aligned(4)))
+    static uint8_t iv[AES_IV_SIZE];
+    uint32_t size;
+
+    scratch_address = STAGING_SCRATCH_OFFSET(header->firmware_size);
+    Delta_Start((const uint8_t *)APPLICATION_START_ADDRESS, delta_header.base_size,
+                header->original_size, WriteScratch);
+    Decompress_Start(delta_header.patch_size, PatchOutput);
+
+    memcpy(iv, header->iv, AES_IV_SIZE);
+    for (uint32_t offset = 0; offset < header->firmware_size; offset += size) {
+        IWDG_REFRESH();
+        size = header->firmware_size - offset;
+        if (size > STAGED_CHUNK_SIZE) {
+            size = STAGED_CHUNK_SIZE;
+        }
+
+        if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer,
+                             STAGING_PAYLOAD_OFFSET + offset, size) != HAL_OK ||
+            Crypto_DecryptFirmwareBlock(staged_enc_buffer, staged_dec_buffer,
+                                        size, iv) != CRYPTO_OK) {
+            return HAL_ERROR;
+        }
+
+        // The delta header is not part of the compressed patch
+        uint32_t skip = (offset == 0) ? sizeof(SFU_DeltaHeader_t) : 0;
+        if (FeedCompressed(staged_dec_buffer + skip, size - skip,
+                           offset + size == header->firmware_size) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    return (Delta_Finish() == DELTA_OK) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Program the rebuilt image from the scratch area into application flash
+ * The W25Q is read twice: the programmed flash is hashed again before the
+ * first flash word makes the application valid.
+ * @param header Staged .sfu header
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ProgramFromScratch(const SFU_Header_t *header)
+{
+    uint32_t scratch = STAGING_SCRATCH_OFFSET(header->firmware_size);
+    uint32_t padded_size = FlashWordPadded(header->original_size);
+    uint32_t size;
+
+    PrepareRollback();
+    if (EraseForStagedImage(header->original_size) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t offset = 0; offset < header->original_size; offset += size) {
+        IWDG_REFRESH();
+        size = header->original_size - offset;
+        if (size > STAGED_CHUNK_SIZE) {
+            size = STAGED_CHUNK_SIZE;
+        }
+        if (W25Q64_OSPI_Read(&hospi2, staged_dec_buffer, scratch + offset, size) != HAL_OK ||
+            ProgramStagedData(staged_dec_buffer, size) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    IWDG_REFRESH();
+    Crypto_Reset();
+    if (Crypto_SHA256_Start() != CRYPTO_OK ||
+        Crypto_SHA256_Update(staged_first_word, FLASH_WORD_SIZE) != CRYPTO_OK ||
+        (padded_size > FLASH_WORD_SIZE &&
+         Crypto_SHA256_Update((const uint8_t *)(APPLICATION_START_ADDRESS + FLASH_WORD_SIZE),
+                              padded_size - FLASH_WORD_SIZE) != CRYPTO_OK) ||
+        Crypto_SHA256_Finish(delta_hash) != CRYPTO_OK) {
+        Crypto_Reset();
+        return HAL_ERROR;
+    }
+    if (memcmp(delta_hash, delta_header.target_sha256, SHA256_DIGEST_SIZE) != 0) {
+        return HAL_ERROR;
+    }
+
+    return CommitStagedImage();
+}
+
+/**
+ * @brief Rebuild a staged delta image and install it
+ * Until the application is erased, errors return HAL_ERROR with the
+ * application untouched; *committing tells the caller whether it was.
+ * An image already rebuilt (interrupted install) is installed again
+ * without the base.
+ * @param header Staged .sfu header, already verified
+ * @param committing Set to 1 once the application flash is modified
+ * @return HAL status
+ */
+static HAL_StatusTypeDef InstallDelta(const SFU_Header_t *header, uint8_t *committing)
+{
+    HAL_StatusTypeDef status;
+
+    *committing = 0;
+    if (ReadDeltaHeader(header) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    IWDG_REFRESH();
+    if (Crypto_ECDSA_VerifyHash(delta_header.target_sha256,
+                                delta_header.target_signature) != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+
+    if (CheckScratch(header) != HAL_OK) {
+        if (CheckDeltaBase() != HAL_OK ||
+            RebuildDeltaImage(header) != HAL_OK ||
+            CheckScratch(header) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    *committing = 1;
+    __DSB();
+    status = FlashUnlock();
+    if (status == HAL_OK) {
+        status = ProgramFromScratch(header);
+    }
+    FlashLock();
+    __DSB();
+    __ISB();
+
+    return status;
+}
+
+/**
+ * @brief Install the firmware staged in the W25Q by the application
+ * Called from main() after Crypto_Init(), before USB init
+ * @return HAL status
+ */
+HAL_StatusTypeDef InstallStagedFirmware(void)
+{
+    static staging_record_t record;
+    HAL_StatusTypeDef status;
+
+    if (ExternalFlashInit() != HAL_OK ||
+        staging_read_record(&hospi2, &record) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (VerifyStagedFirmware(&record.header) != HAL_OK) {
+        // Not authentic or unreadable: never try this image again
+        staging_clear(&hospi2);
+        return HAL_ERROR;
+    }
+
+    if (record.header.magic == SFU_MAGIC_DELTA) {
+        uint8_t committing;
+
+        if (InstallDelta(&record.header, &committing) != HAL_OK) {
+            if (!committing) {
+                // Application untouched: wrong base or bad patch
+                staging_clear(&hospi2);
+            }
+            // Otherwise the record is kept: installed again from the scratch area
+            return HAL_ERROR;
+        }
+
+        staging_clear(&hospi2);
+        return HAL_OK;
+    }
+
+    __DSB();
+    status = FlashUnlock();
+    if (status == HAL_OK) {
+        status = ProgramStagedFirmware(&record.header);
+    }
+    FlashLock();
+    __DSB();
+    __ISB();
+
+    if (status != HAL_OK) {
+        // Record kept: the install starts again at the next reset
         return HAL_ERROR;
     }
 
+    staging_clear(&hospi2);
     return HAL_OK;
 }
 
+// ============================================================================
+// Rollback (v3.5)
+// ============================================================================
+
 /**
- * @brief Erase sectors as needed for the given address
- * Only erases ONE sector at a time to avoid USB timeout
- * @param address Flash address that needs to be written
+ * @brief Program a backup chunk (staged_enc_buffer) into the rollback slot
+ * and read it back
+ * @param address W25Q address
+ * @param length Number of bytes, one chunk at most
  * @return HAL status
- * @note Reserved for encrypted firmware updates (progressive erase)
  */
-__attribute__((unused))
-static HAL_StatusTypeDef EnsureSectorErased(uint32_t address)
+static HAL_StatusTypeDef WriteBackupChunk(uint32_t address, uint32_t length)
 {
-    // Calculate which sector this address belongs to
-    uint32_t sector_num = (address - BOOTLOADER_START_ADDRESS) / BL_FLASH_SECTOR_SIZE;
-
-    // Check if we need to erase this sector
-    if (sector_num > last_erased_sector) {
-        // Erase only the next sector (ONE at a time to keep USB alive)
-        uint32_t next_sector = last_erased_sector + 1;
-        HAL_StatusTypeDef status = EraseSingleSector(next_sector);
-        if (status != HAL_OK) {
-            return HAL_ERROR;
-        }
-        last_erased_sector = next_sector;
+    if (W25Q64_OSPI_Write(&hospi2, staged_enc_buffer, address, length) != HAL_OK ||
+        W25Q64_OSPI_Read(&hospi2, staged_dec_buffer, address, length) != HAL_OK ||
+        memcmp(staged_dec_buffer, staged_enc_buffer, length) != 0) {
+        return HAL_ERROR;
     }
 
     return HAL_OK;
 }
 
 /**
- * @brief Erase application flash sectors (1-7)
- * Called from main() BEFORE USB init, so USB is not affected
- *
- * STM32H733VGT6 Memory Map (128KB sectors):
- *   Sector 0: 0x08000000 - 0x0801FFFF = Bootloader
- *   Sector 1-7: 0x08020000 - 0x080FFFFF = Application (896KB)
- *
- * @return HAL status
+ * @brief Copy the installed application into the rollback slot
+ * Encrypted with the device key and a random IV, its SHA-256 after it in
+ * the same CBC chain. The record is erased first and written once every
+ * chunk has been read back: an interrupted backup leaves none.
+ * @param image_size Bytes of the installed image, from its validity record
+ * @param image_crc CRC32 of the installed image, from its validity record
+ * @return HAL status, HAL_ERROR if the flash is not the recorded image
  */
-HAL_StatusTypeDef EraseApplicationFlash(void)
+static HAL_StatusTypeDef BackupApplication(uint32_t image_size, uint32_t image_crc)
 {
-    FLASH_EraseInitTypeDef erase;
-    uint32_t error;
-    const uint32_t SECTORS_TO_ERASE = 7;  // Sectors 1-7
-
-    HAL_FLASH_Unlock();
+    static rollback_record_t record;
+    __attribute__((aligned(4)))
+    static uint8_t iv[AES_IV_SIZE];
+    __attribute__((aligned(4)))
+    static uint8_t digest[ROLLBACK_DIGEST_SIZE];
+    uint32_t crc = CRC32_INIT;
+    uint32_t size;
+
+    if (image_size > ROLLBACK_IMAGE_MAX ||
+        rollback_clear(&hospi2) != HAL_OK ||
+        W25Q64_OSPI_EraseRange(&hospi2, ROLLBACK_IMAGE_OFFSET,
+                               ROLLBACK_IMAGE_OFFSET + image_size + ROLLBACK_DIGEST_SIZE) != HAL_OK ||
+        Crypto_Random(record.iv, AES_IV_SIZE) != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
 
-    for (uint32_t i = 0; i < SECTORS_TO_ERASE; i++) {
-        // Refresh watchdog before each sector erase (takes ~seconds)
-        IWDG_REFRESH();
+    memcpy(iv, record.iv, AES_IV_SIZE);
+    Crypto_Reset();
+    if (Crypto_SHA256_Start() != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
 
-        erase.TypeErase = FLASH_TYPEERASE_SECTORS;
-        erase.Banks = FLASH_BANK_1;
-        erase.Sector = APP_FIRST_SECTOR + i;
-        erase.NbSectors = 1;
-        erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    for (uint32_t offset = 0; offset < image_size; offset += size) {
+        const uint8_t *image = (const uint8_t *)(uintptr_t)(APPLICATION_START_ADDRESS + offset);
 
-        if (HAL_FLASHEx_Erase(&erase, &error) != HAL_OK) {
-            HAL_FLASH_Lock();
+        IWDG_REFRESH();
+        size = image_size - offset;
+        if (size > STAGED_CHUNK_SIZE) {
+            size = STAGED_CHUNK_SIZE;
+        }
+        crc = crc32_ieee(crc, image, size);
+        if (Crypto_SHA256_Update(image, size) != CRYPTO_OK ||
+            Crypto_EncryptBlock(image, staged_enc_buffer, size, iv) != CRYPTO_OK ||
+            WriteBackupChunk(ROLLBACK_IMAGE_OFFSET + offset, size) != HAL_OK) {
+            Crypto_Reset();
             return HAL_ERROR;
         }
     }
 
-    HAL_FLASH_Lock();
-
-    // Mark all sectors as erased so WriteFlash doesn't try to erase again
-    last_erased_sector = APP_FIRST_SECTOR + SECTORS_TO_ERASE;
+    if (Crypto_SHA256_Finish(digest) != CRYPTO_OK || crc != image_crc ||
+        Crypto_EncryptBlock(digest, staged_enc_buffer, ROLLBACK_DIGEST_SIZE, iv) != CRYPTO_OK ||
+        WriteBackupChunk(ROLLBACK_IMAGE_OFFSET + image_size, ROLLBACK_DIGEST_SIZE) != HAL_OK) {
+        return HAL_ERROR;
+    }
 
-    return HAL_OK;
+    record.image_size = image_size;
+    record.image_crc = image_crc;
+    return rollback_write_record(&hospi2, &record);
 }
 
 /**
- * @brief Write data to flash
- * @param address Flash address to write to (must be aligned to 256-bit / 32 bytes)
- * @param data Pointer to data buffer
- * @param length Data length in bytes (must be multiple of 32)
- * @return HAL status
+ * @brief Before an install erases the application: keep it in the rollback
+ * slot and put the new image on trial
+ * Only a confirmed image (VALIDITY_OK) is copied, and only if the slot does
+ * not hold it already: over an image on trial the backup stays the last
+ * confirmed one. Without the W25Q or a backup the install is recorded
+ * without trial, as before v3.5.
  */
-HAL_StatusTypeDef WriteFlash(uint32_t address, uint8_t *data, uint32_t length)
+static void PrepareRollback(void)
 {
-    HAL_StatusTypeDef status = HAL_OK;
+    static rollback_record_t record;
+    uint32_t image_size, image_crc;
+    uint8_t kept;
 
-    // CRITICAL SAFETY CHECK: Prevent any writes to bootloader area
-    if (address < APPLICATION_START_ADDRESS) {
-        return HAL_ERROR;
+    install_trial = 0;
+    if (ExternalFlashInit() != HAL_OK) {
+        return;
     }
 
-    // Also check that the write won't overflow into invalid area
-    if (address + length > FLASH_END_ADDRESS) {
-        return HAL_ERROR;
+    kept = (rollback_read_record(&hospi2, &record) == HAL_OK);
+    if (Validity_Check() == VALIDITY_OK &&
+        Validity_InstalledImage(&image_size, &image_crc) == HAL_OK &&
+        (!kept || record.image_size != image_size || record.image_crc != image_crc)) {
+        kept = (BackupApplication(image_size, image_crc) == HAL_OK);
     }
 
-    // STM32H7 flash is programmed in 256-bit (32 byte) words
-    // Address must be 32-byte aligned
-    if ((address % 32) != 0) {
-        return HAL_ERROR;
+    // Marks of an earlier trial or restore do not apply to the new image
+    install_trial = kept && rollback_new_trial(&hospi2) == HAL_OK;
+}
+
+/**
+ * @brief Count a boot of the image on trial (VALIDITY_TRIAL)
+ * Called from main() after Crypto_Init(), in place of the early jump
+ * @return TRIAL_RUN: start the application (boot counted, or W25Q not
+ *         readable); TRIAL_CONFIRMED: recorded as confirmed, reset for the
+ *         early jump; TRIAL_EXPIRED: no boot left, RestoreBackup() next
+ */
+TrialResult_t CheckTrialBoot(void)
+{
+    static rollback_record_t record;
+    bool marks[ROLLBACK_MARKS];
+
+    if (ExternalFlashInit() != HAL_OK ||
+        rollback_read_marks(&hospi2, marks) != HAL_OK) {
+        return TRIAL_RUN;
     }
 
-    // Length must be multiple of 32 bytes
-    if ((length % 32) != 0) {
-        return HAL_ERROR;
+    // Confirmed, or nothing to go back to: the image stays
+    if (marks[ROLLBACK_MARK_CONFIRMED] ||
+        rollback_read_record(&hospi2, &record) != HAL_OK) {
+        return Validity_Confirm() == HAL_OK ? TRIAL_CONFIRMED : TRIAL_RUN;
     }
 
-    // Program flash in 256-bit chunks
-    for (uint32_t i = 0; i < length; i += 32) {
-        IWDG_REFRESH();  // Refresh watchdog during flash writes
-        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD,
-                                   address + i,
-                                   (uint32_t)(data + i));
-        if (status != HAL_OK) {
-            return status;
+    // Restore asked for and not started yet (reset before the erase)
+    if (marks[ROLLBACK_MARK_RESTORE]) {
+        return TRIAL_EXPIRED;
+    }
+
+    for (uint32_t i = 0; i < ROLLBACK_TRIAL_BOOTS; i++) {
+        if (!marks[ROLLBACK_MARK_BOOT + i]) {
+            rollback_set_mark(&hospi2, ROLLBACK_MARK_BOOT + i);
+            return TRIAL_RUN;
         }
     }
 
-    return HAL_OK;
+    // Every trial boot started and none confirmed
+    if (rollback_set_mark(&hospi2, ROLLBACK_MARK_RESTORE) != HAL_OK) {
+        return TRIAL_RUN;
+    }
+    return TRIAL_EXPIRED;
 }
 
 /**
- * @brief Verify flash contents
- * @param address Flash address to verify
- * @param data Pointer to expected data
- * @param length Data length in bytes
- * @return 1 if match, 0 if mismatch
+ * @brief Decrypt the backup into application flash
+ * Programmed like a staged image, first flash word last. The hash after
+ * the image and the recorded CRC must both match before it is committed.
+ * @param record Rollback record
+ * @return HAL status
  */
-uint8_t VerifyFlash(uint32_t address, uint8_t *data, uint32_t length)
+static HAL_StatusTypeDef ProgramBackup(const rollback_record_t *record)
 {
-    uint8_t *flash_ptr = (uint8_t *)address;
+    __attribute__((aligned(4)))
+    static uint8_t iv[AES_IV_SIZE];
+    __attribute__((aligned(4)))
+    static uint8_t digest[ROLLBACK_DIGEST_SIZE];
+    __attribute__((aligned(4)))
+    static uint8_t kept_digest[ROLLBACK_DIGEST_SIZE];
+    uint32_t total = record->image_size + ROLLBACK_DIGEST_SIZE;
+    uint32_t size;
+
+    install_trial = 0;
+    if (EraseForStagedImage(record->image_size) != HAL_OK) {
+        return HAL_ERROR;
+    }
 
-    for (uint32_t i = 0; i < length; i++) {
-        if (flash_ptr[i] != data[i]) {
-            return 0;  // Mismatch
+    memcpy(iv, record->iv, AES_IV_SIZE);
+    Crypto_Reset();
+    if (Crypto_SHA256_Start() != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t offset = 0; offset < total; offset += size) {
+        IWDG_REFRESH();
+        size = total - offset;
+        if (size > STAGED_CHUNK_SIZE) {
+            size = STAGED_CHUNK_SIZE;
+        }
+
+        if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer,
+                             ROLLBACK_IMAGE_OFFSET + offset, size) != HAL_OK ||
+            Crypto_DecryptFirmwareBlock(staged_enc_buffer, staged_dec_buffer,
+                                        size, iv) != CRYPTO_OK) {
+            Crypto_Reset();
+            return HAL_ERROR;
+        }
+
+        // The hash ends the last chunk (both are whole flash words)
+        uint32_t data_size = size;
+        if (offset + size > record->image_size) {
+            data_size = record->image_size - offset;
+            memcpy(kept_digest, staged_dec_buffer + data_size, ROLLBACK_DIGEST_SIZE);
+        }
+        if (data_size > 0 &&
+            (Crypto_SHA256_Update(staged_dec_buffer, data_size) != CRYPTO_OK ||
+             ProgramStagedData(staged_dec_buffer, data_size) != HAL_OK)) {
+            Crypto_Reset();
+            return HAL_ERROR;
         }
     }
 
-    return 1;  // Match
+    if (Crypto_SHA256_Finish(digest) != CRYPTO_OK) {
+        return HAL_ERROR;
+    }
+    if (memcmp(digest, kept_digest, ROLLBACK_DIGEST_SIZE) != 0 ||
+        image_crc != record->image_crc) {
+        // Altered or damaged in the W25Q: never tried again
+        rollback_clear(&hospi2);
+        return HAL_ERROR;
+    }
+
+    return CommitStagedImage();
 }
 
 /**
- * @brief Get application CRC32 for verification
- * @return CRC32 value
+ * @brief Install the backup kept in the rollback slot
+ * Only once CheckTrialBoot() has set the restore mark. Called from main()
+ * when the application is not valid: an interrupted restore runs again
+ * from the start at the next power-on.
+ * @return HAL status, HAL_ERROR with the application invalid if the backup
+ *         was refused
  */
-uint32_t CalculateApplicationCRC(void)
+HAL_StatusTypeDef RestoreBackup(void)
 {
-    // Enable CRC peripheral clock
-    __HAL_RCC_CRC_CLK_ENABLE();
+    static rollback_record_t record;
+    bool marks[ROLLBACK_MARKS];
+    HAL_StatusTypeDef status;
+
+    if (ExternalFlashInit() != HAL_OK ||
+        rollback_read_marks(&hospi2, marks) != HAL_OK ||
+        !marks[ROLLBACK_MARK_RESTORE] ||
+        rollback_read_record(&hospi2, &record) != HAL_OK ||
+        record.image_size > FLASH_END_ADDRESS + 1 - APPLICATION_START_ADDRESS) {
+        return HAL_ERROR;
+    }
 
-    // Calculate CRC of application flash
-    uint32_t *flash_ptr = (uint32_t *)APPLICATION_START_ADDRESS;
-    uint32_t flash_size = FLASH_END_ADDRESS - APPLICATION_START_ADDRESS + 1;
-    uint32_t word_count = flash_size / 4;
+    __DSB();
+    status = FlashUnlock();
+    if (status == HAL_OK) {
+        status = ProgramBackup(&record);
+    }
+    FlashLock();
+    __DSB();
+    __ISB();
 
-    // Use HAL CRC calculation
-    return HAL_CRC_Calculate(&hcrc, flash_ptr, word_count);
+    return status;
 }
 
 // ============================================================================
 // USB CDC Firmware Update Protocol
 // ============================================================================
 
-// Software CRC32 table (matches Python binascii.crc32)
-static const uint32_t crc32_table[256] = {
-    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
-    0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
-    0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
-    0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
-    0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
-    0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
-    0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
-    0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
-    0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
-    0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
-    0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
-    0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
-    0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
-    0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
-    0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
-    0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
-    0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
-    0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
-    0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
-    0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
-    0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
-    0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
-};
-
-/**
- * @brief Software CRC32 calculation (matches Python binascii.crc32)
- * Uses standard zlib/PNG CRC32 algorithm:
- * - Initial value: 0xFFFFFFFF
- * - Final XOR: 0xFFFFFFFF
- */
-static uint32_t software_crc32(const uint8_t *data, uint32_t length)
-{
-    uint32_t crc = 0xFFFFFFFF;  // Start with all 1s
-    for (uint32_t i = 0; i < length; i++) {
-        crc = crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
-    }
-    return crc ^ 0xFFFFFFFF;  // Final XOR
-}
-
 // Types are defined in bootload.h
 // No need to redefine them here
 
@@ -481,6 +1402,8 @@ static uint8_t packet_buffer[288];  // 256 bytes + padding to 32-byte boundary
 static uint8_t encrypted_mode = 0;           // 1 if processing encrypted .sfu
 static SFU_Header_t sfu_header;              // Stored SFU header
 static uint32_t enc_received_bytes = 0;      // Encrypted bytes received
+static uint8_t compressed_mode = 0;          // 1 if the payload is LZ4 (v3.2)
+static uint32_t enc_decrypted_bytes = 0;     // Decrypted bytes decompressed
 
 // CRITICAL: These buffers MUST be 4-byte aligned for HAL_CRYP hardware
 __attribute__((aligned(4)))
@@ -490,6 +1413,142 @@ static uint8_t decrypted_buffer[256];        // Buffer for decrypted data
 __attribute__((aligned(4)))
 static uint8_t aligned_enc_buffer[256];      // Aligned copy of encrypted input
 
+// ============================================================================
+// Streaming Update State (v3.2)
+// ============================================================================
+static uint32_t stream_chunk_size = 0;       // Granted chunk size, 0 = not streaming
+static uint32_t stream_chunks = 0;           // Chunks accepted this session
+
+#if STREAM_CHUNK_MAX > CRYPTO_PIPELINE_BLOCK_MAX
+#error "Stream chunks must fit the crypto pipeline buffers"
+#endif
+
+/**
+ * @brief Program the next bytes of the image, flash unlocked
+ * Used for decrypted data (stream chunks) and decompressed output
+ * @param data Image data, with room for flash word padding
+ * @param length Number of bytes, the PKCS7 padding of the last block trimmed
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ProgramImageData(uint8_t *data, uint32_t length)
+{
+    // Trim PKCS7 padding on the last chunk, pad to a flash word with 0xFF
+    uint32_t data_to_write = length;
+    uint32_t remaining = sfu_header.original_size - fw_received_bytes;
+    if (data_to_write > remaining) {
+        data_to_write = remaining;
+    }
+    uint32_t padded_length = ((data_to_write + 31) / 32) * 32;
+    memset(data + data_to_write, 0xFF, padded_length - data_to_write);
+
+    // Stream chunks and decompressor slices are multiples of 256 except the
+    // last: every write starts on a flash word
+    uint32_t flash_address = APPLICATION_START_ADDRESS + fw_received_bytes;
+    __DSB();
+    if (EnsureSectorErased(flash_address + padded_length - 1) != HAL_OK
+            || ProgramImageWords(flash_address, data, padded_length) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    __DSB();
+    __ISB();
+
+    fw_received_bytes += data_to_write;
+    return HAL_OK;
+}
+
+/**
+ * @brief Decompress decrypted data of a compressed image into flash
+ * @param data Decrypted data, whole AES blocks
+ * @param length Number of bytes
+ * @return HAL status
+ */
+static HAL_StatusTypeDef DecompressImageData(const uint8_t *data, uint32_t length)
+{
+    enc_decrypted_bytes += length;
+    return FeedCompressed(data, length, enc_decrypted_bytes == sfu_header.firmware_size);
+}
+
+/**
+ * @brief Validate an SFU header and start an encrypted update (ENC_START and
+ * STREAM_START): reset crypto, erase the image's first sector (after the
+ * rollback backup, which uses CRYP and HASH), start the hash
+ * @param packet Packet carrying the SFU header in its data field
+ * @return 0=Success, -1=Error
+ */
+static int32_t StartEncryptedUpdate(FirmwarePacket_t *packet)
+{
+    HAL_StatusTypeDef status;
+
+    // Clear any leftover packet data from interrupted USB transfer
+    CDC_ClearPacketState();
+    IWDG_REFRESH();
+
+    // Reset crypto state first (handles interrupted transfers)
+    Crypto_Reset();
+    encrypted_mode = 0;
+    compressed_mode = 0;
+    stream_chunk_size = 0;
+    stream_chunks = 0;
+
+    // Verify we have enough data for header
+    if (packet->length < sizeof(SFU_Header_t)) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    // Copy and validate SFU header
+    memcpy(&sfu_header, packet->data, sizeof(SFU_Header_t));
+
+    // Check magic: plain or LZ4-compressed payload
+    if (sfu_header.magic != SFU_MAGIC && sfu_header.magic != SFU_MAGIC_LZ4) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    // Validate sizes
+    if (sfu_header.firmware_size == 0 || sfu_header.firmware_size > APP_SECTORS * BL_FLASH_SECTOR_SIZE) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+    if (sfu_header.original_size == 0 || sfu_header.original_size > APP_SECTORS * BL_FLASH_SECTOR_SIZE) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    // Initialize encrypted mode
+    encrypted_mode = 1;
+    enc_received_bytes = 0;
+    compressed_mode = (sfu_header.magic == SFU_MAGIC_LZ4);
+    enc_decrypted_bytes = 0;
+    if (compressed_mode) {
+        Decompress_Start(sfu_header.original_size, ProgramImageData);
+    }
+    fw_total_bytes = sfu_header.original_size;
+    fw_received_bytes = 0;
+    image_crc = CRC32_INIT;
+    fw_update_state = FW_RECEIVING;
+
+    // Copy IV for CBC decryption
+    memcpy(current_iv, sfu_header.iv, AES_IV_SIZE);
+
+    // Erase only the sectors the image covers, progressively
+    status = BeginProgressiveErase(sfu_header.original_size);
+    if (status != HAL_OK) {
+        encrypted_mode = 0;
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    // Start incremental hash for signature verification
+    if (Crypto_SHA256_Start() != CRYPTO_OK) {
+        encrypted_mode = 0;
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    return 0;
+}
+
 /**
  * @brief Process received firmware packet from USB CDC
  * @param packet Pointer to received packet
@@ -508,10 +1567,12 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
             fw_update_state = FW_RECEIVING;
             fw_total_bytes = packet->length;  // Total firmware size
             fw_received_bytes = 0;
+            image_crc = CRC32_INIT;
 
             // v2: Always erase flash on START (enables safe restart)
             // This is critical for handling USB disconnects - ensures clean slate
-            status = EraseApplicationFlash();
+            // v3.2: first sector now, the rest of the image progressively
+            status = BeginProgressiveErase(fw_total_bytes);
             if (status != HAL_OK) {
                 fw_update_state = FW_ERROR;
                 return -1;
@@ -559,7 +1620,7 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
             }
 
             // Verify packet CRC
-            uint32_t calc_crc = software_crc32(packet->data, packet->length);
+            uint32_t calc_crc = crc32_ieee(CRC32_INIT, packet->data, packet->length);
             if (calc_crc != packet->crc32) {
                 fw_update_state = FW_ERROR;
                 return -1;
@@ -592,10 +1653,13 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
                 return -1;
             }
 
-            // Flash is erased before USB init, no need for progressive erase here
+            // Sectors are erased ahead of the data, this only catches up
+            status = EnsureSectorErased(flash_address + padded_length - 1);
 
             // Write to flash
-            status = WriteFlash(flash_address, packet_buffer, padded_length);
+            if (status == HAL_OK) {
+                status = ProgramImageWords(flash_address, packet_buffer, padded_length);
+            }
 
             // Lock flash immediately
             FlashLock();
@@ -629,6 +1693,12 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
                 return -1;
             }
 
+            // Record the image so the next power-on jumps straight to it
+            if (Validity_InstallDone(fw_received_bytes, image_crc, install_trial) != HAL_OK) {
+                fw_update_state = FW_ERROR;
+                return -1;
+            }
+
             // Set completion state (main loop will beep and reset device)
             fw_update_state = FW_COMPLETE;
 
@@ -640,64 +1710,36 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
 
         case PACKET_TYPE_ENC_START:
             // Encrypted firmware update - packet contains SFU header
-            {
-                // Clear any leftover packet data from interrupted USB transfer
-                CDC_ClearPacketState();
-                IWDG_REFRESH();
-
-                // Reset crypto state first (handles interrupted transfers)
-                Crypto_Reset();
-                encrypted_mode = 0;
-
-                // Verify we have enough data for header
-                if (packet->length < sizeof(SFU_Header_t)) {
-                    fw_update_state = FW_ERROR;
-                    return -1;
-                }
+            return StartEncryptedUpdate(packet);
 
-                // Copy and validate SFU header
-                memcpy(&sfu_header, packet->data, sizeof(SFU_Header_t));
+        case PACKET_TYPE_STREAM_START:
+            // v3.2: as ENC_START, then chunk frames instead of packets
+            {
+                // Chunk size requested in the address field, multiple of 256
+                uint32_t chunk_size = packet->address & ~(STREAM_CHUNK_MIN - 1);
 
-                // Check magic
-                if (sfu_header.magic != SFU_MAGIC) {
-                    fw_update_state = FW_ERROR;
+                if (StartEncryptedUpdate(packet) != 0) {
                     return -1;
                 }
 
-                // Validate sizes
-                if (sfu_header.firmware_size == 0 || sfu_header.firmware_size > (896 * 1024)) {
-                    fw_update_state = FW_ERROR;
-                    return -1;
+                if (chunk_size < STREAM_CHUNK_MIN) {
+                    chunk_size = STREAM_CHUNK_MIN;
                 }
-                if (sfu_header.original_size == 0 || sfu_header.original_size > (896 * 1024)) {
-                    fw_update_state = FW_ERROR;
-                    return -1;
+                if (chunk_size > STREAM_CHUNK_MAX) {
+                    chunk_size = STREAM_CHUNK_MAX;
                 }
 
-                // Initialize encrypted mode
-                encrypted_mode = 1;
-                enc_received_bytes = 0;
-                fw_total_bytes = sfu_header.original_size;
-                fw_received_bytes = 0;
-                fw_update_state = FW_RECEIVING;
-
-                // Copy IV for CBC decryption
-                memcpy(current_iv, sfu_header.iv, AES_IV_SIZE);
-
-                // Start incremental hash for signature verification
-                if (Crypto_SHA256_Start() != CRYPTO_OK) {
+                // Flash stays unlocked for the whole session: locked again by
+                // ENC_END or ResetFirmwareUpdate()
+                if (FlashUnlock() != HAL_OK) {
                     encrypted_mode = 0;
                     fw_update_state = FW_ERROR;
                     return -1;
                 }
 
-                // Erase application flash
-                status = EraseApplicationFlash();
-                if (status != HAL_OK) {
-                    encrypted_mode = 0;
-                    fw_update_state = FW_ERROR;
-                    return -1;
-                }
+                stream_chunk_size = chunk_size;
+                // Switch the receiver before the response lets the host stream
+                CDC_SetStreamMode(STREAM_FRAME_HEADER_SIZE + chunk_size);
 
                 return 0;
             }
@@ -723,7 +1765,7 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
                 }
 
                 // CRC check (over encrypted data)
-                uint32_t enc_crc = software_crc32(packet->data, packet->length);
+                uint32_t enc_crc = crc32_ieee(CRC32_INIT, packet->data, packet->length);
                 if (enc_crc != packet->crc32) {
                     fw_update_state = FW_ERROR;
                     return -1;
@@ -747,6 +1789,22 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
 
                 enc_received_bytes += packet->length;
 
+                // Compressed: the decompressor programs whole slices
+                if (compressed_mode) {
+                    __DSB();
+                    status = FlashUnlock();
+                    if (status == HAL_OK) {
+                        status = DecompressImageData(decrypted_buffer, packet->length);
+                    }
+                    FlashLock();
+
+                    if (status != HAL_OK) {
+                        fw_update_state = FW_ERROR;
+                        return -1;
+                    }
+                    return 0;
+                }
+
                 // Calculate actual data to write (handle final packet padding)
                 uint32_t data_to_write = packet->length;
                 uint32_t remaining = sfu_header.original_size - fw_received_bytes;
@@ -778,7 +1836,10 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
                     return -1;
                 }
 
-                status = WriteFlash(flash_address, packet_buffer, padded_length);
+                status = EnsureSectorErased(flash_address + padded_length - 1);
+                if (status == HAL_OK) {
+                    status = ProgramImageWords(flash_address, packet_buffer, padded_length);
+                }
                 FlashLock();
 
                 if (status != HAL_OK) {
@@ -829,6 +1890,16 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
 
                 // Signature valid - firmware is authentic
                 encrypted_mode = 0;
+                compressed_mode = 0;
+                stream_chunk_size = 0;
+                FlashLock();
+
+                // Only an authentic image gets a validity record: after a
+                // failed signature the application stays refused
+                if (Validity_InstallDone(fw_received_bytes, image_crc, install_trial) != HAL_OK) {
+                    fw_update_state = FW_ERROR;
+                    return -1;
+                }
                 fw_update_state = FW_COMPLETE;
 
                 return 0;
@@ -839,6 +1910,115 @@ int32_t ProcessFirmwarePacket(FirmwarePacket_t *packet)
     }
 }
 
+/**
+ * @brief Program a decrypted stream chunk (Crypto_PipelineBlock() callback)
+ * Runs while CRYP and HASH work on the following chunk; a compressed
+ * chunk is decompressed here too
+ * @param data Decrypted chunk, with room for flash word padding
+ * @param length Decrypted bytes
+ * @return HAL status
+ */
+static HAL_StatusTypeDef ProgramStreamChunk(uint8_t *data, uint32_t length)
+{
+    if (compressed_mode) {
+        return DecompressImageData(data, length);
+    }
+    return ProgramImageData(data, length);
+}
+
+/**
+ * @brief Process a streamed chunk (v3.2)
+ * The next chunk is received into the other frame buffer meanwhile, and the
+ * chunk is decrypted and hashed by DMA while the previous one is programmed;
+ * the last chunk is programmed before returning.
+ * @param chunk Pointer to received chunk frame
+ * @return 0=Success, -1=Error
+ */
+int32_t ProcessFirmwareChunk(FirmwareChunk_t *chunk)
+{
+    IWDG_REFRESH();
+
+    if (fw_update_state != FW_RECEIVING || !encrypted_mode || stream_chunk_size == 0) {
+        return -1;
+    }
+
+    // In order, full size except the last one, whole AES blocks
+    uint32_t remaining_enc = sfu_header.firmware_size - enc_received_bytes;
+    if (chunk->packet_type != PACKET_TYPE_STREAM_DATA
+            || chunk->offset != enc_received_bytes
+            || chunk->length == 0
+            || chunk->length > stream_chunk_size
+            || (chunk->length % AES_BLOCK_SIZE) != 0
+            || chunk->length > remaining_enc
+            || (chunk->length < stream_chunk_size && chunk->length != remaining_enc)) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    // CRC check (over encrypted data)
+    if (crc32_ieee(CRC32_INIT, chunk->data, chunk->length) != chunk->crc32) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    // Frame buffers are aligned: CRYP and HASH DMA read the chunk in place
+    uint8_t last = (chunk->length == remaining_enc);
+    if (Crypto_PipelineBlock(chunk->data, chunk->length, current_iv, last,
+                             ProgramStreamChunk) != CRYPTO_OK) {
+        fw_update_state = FW_ERROR;
+        return -1;
+    }
+
+    enc_received_bytes += chunk->length;
+    stream_chunks++;
+
+    // Last chunk: back to packets for ENC_END, before the response goes out
+    if (enc_received_bytes == sfu_header.firmware_size) {
+        CDC_SetStreamMode(0);
+    }
+
+    return 0;
+}
+
+uint32_t GetStreamChunkSize(void)
+{
+    return stream_chunk_size;
+}
+
+uint32_t GetStreamChunksStored(void)
+{
+    return stream_chunks;
+}
+
+/**
+ * @brief Erase the next sector of the incoming image once data has been
+ * written to the last erased one
+ * Called from the main loop after the packet's response is sent, so the
+ * host is already sending data for the current sector while this runs.
+ * Execution stalls during the erase (single flash bank), the USB FIFOs and
+ * the host hold the data meanwhile.
+ */
+void EraseAhead(void)
+{
+    if (fw_update_state != FW_RECEIVING || last_erased_sector == 0
+            || last_erased_sector >= erase_end_sector) {
+        return;
+    }
+
+    // Wait for the first data in the last erased sector: the first packet
+    // after START is not held up by a second erase
+    if (fw_received_bytes == 0
+            || SectorOf(APPLICATION_START_ADDRESS + fw_received_bytes - 1) < last_erased_sector) {
+        return;
+    }
+
+    uint32_t next_sector_address = BOOTLOADER_START_ADDRESS
+                                   + (last_erased_sector + 1) * BL_FLASH_SECTOR_SIZE;
+    if (EnsureSectorErased(next_sector_address) != HAL_OK) {
+        fw_update_state = FW_ERROR;
+    }
+}
+
 /**
  * @brief Get current firmware update progress (0-100)
  * @return Progress percentage
@@ -869,10 +2049,16 @@ void ResetFirmwareUpdate(void)
     fw_update_state = FW_IDLE;
     fw_total_bytes = 0;
     fw_received_bytes = 0;
+    image_crc = CRC32_INIT;
     last_erased_sector = 0;
+    erase_end_sector = 0;
     // Reset encrypted mode state
     encrypted_mode = 0;
     enc_received_bytes = 0;
+    // Reset streaming state, the receiver goes back to packets
+    stream_chunk_size = 0;
+    stream_chunks = 0;
+    CDC_SetStreamMode(0);
     memset(&sfu_header, 0, sizeof(sfu_header));
     memset(current_iv, 0, sizeof(current_iv));
     FlashLock();
@@ -920,6 +2106,7 @@ void GetBootloaderStatus(BootloaderStatus_t *status)
     if (last_erased_sector > 0) status->flags |= 0x01;  // Bit 0: flash erased
     if (fw_update_state == FW_RECEIVING) status->flags |= 0x02;  // Bit 1: transfer in progress
     if (encrypted_mode) status->flags |= 0x04;  // Bit 2: encrypted mode (v3.0)
+    if (stream_chunk_size) status->flags |= 0x08;  // Bit 3: streaming (v3.2)
     status->footer = 0x55;
     status->padding[0] = 0;
     status->padding[1] = 0;
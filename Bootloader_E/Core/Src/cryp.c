@@ -1,6 +1,9 @@
 #include "cryp.h"
+#include "dma.h"
 
 CRYP_HandleTypeDef hcryp;
+DMA_HandleTypeDef hdma_cryp_in;
+DMA_HandleTypeDef hdma_cryp_out;
 
 /* Dummy key/IV for initial CRYP setup (will be replaced on actual decrypt) */
 static const uint32_t dummy_key[8] = {0};
@@ -25,6 +28,46 @@ void HAL_CRYP_MspInit(CRYP_HandleTypeDef* crypHandle)
   if(crypHandle->Instance==CRYP)
   {
     __HAL_RCC_CRYP_CLK_ENABLE();
+
+    /* MspInit runs on every decrypt (state forced to RESET): set the
+     * streams up once. Word transfers, the FIFOs take 32-bit words. */
+    if (hdma_cryp_in.State == HAL_DMA_STATE_RESET)
+    {
+      hdma_cryp_in.Instance = CRYP_IN_DMA_STREAM;
+      hdma_cryp_in.Init.Request = DMA_REQUEST_CRYP_IN;
+      hdma_cryp_in.Init.Direction = DMA_MEMORY_TO_PERIPH;
+      hdma_cryp_in.Init.PeriphInc = DMA_PINC_DISABLE;
+      hdma_cryp_in.Init.MemInc = DMA_MINC_ENABLE;
+      hdma_cryp_in.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+      hdma_cryp_in.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+      hdma_cryp_in.Init.Mode = DMA_NORMAL;
+      hdma_cryp_in.Init.Priority = DMA_PRIORITY_HIGH;
+      hdma_cryp_in.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+      if (HAL_DMA_Init(&hdma_cryp_in) != HAL_OK)
+      {
+        Error_Handler();
+      }
+    }
+    __HAL_LINKDMA(crypHandle, hdmain, hdma_cryp_in);
+
+    if (hdma_cryp_out.State == HAL_DMA_STATE_RESET)
+    {
+      hdma_cryp_out.Instance = CRYP_OUT_DMA_STREAM;
+      hdma_cryp_out.Init.Request = DMA_REQUEST_CRYP_OUT;
+      hdma_cryp_out.Init.Direction = DMA_PERIPH_TO_MEMORY;
+      hdma_cryp_out.Init.PeriphInc = DMA_PINC_DISABLE;
+      hdma_cryp_out.Init.MemInc = DMA_MINC_ENABLE;
+      hdma_cryp_out.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+      hdma_cryp_out.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+      hdma_cryp_out.Init.Mode = DMA_NORMAL;
+      hdma_cryp_out.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+      hdma_cryp_out.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+      if (HAL_DMA_Init(&hdma_cryp_out) != HAL_OK)
+      {
+        Error_Handler();
+      }
+    }
+    __HAL_LINKDMA(crypHandle, hdmaout, hdma_cryp_out);
   }
 }
 
@@ -34,5 +77,9 @@ void HAL_CRYP_MspDeInit(CRYP_HandleTypeDef* crypHandle)
   {
     /* Keep CRYP clock enabled - we need it for subsequent operations */
     /* __HAL_RCC_CRYP_CLK_DISABLE(); */
+
+    /* Stop a transfer cut short (pipeline timeout), set up again on MspInit */
+    HAL_DMA_DeInit(crypHandle->hdmain);
+    HAL_DMA_DeInit(crypHandle->hdmaout);
   }
 }
@@ -6,12 +6,46 @@
 #include "uECC.h"
 #include <string.h>
 
+/* Comb table of ECDSA_PUBLIC_KEY, generated by Tools/ecdsa_comb_table.py
+ * (gitignored like crypto_keys.h). Without it, verification uses uECC_verify(). */
+#if __has_include("ecdsa_table.h")
+#include "ecdsa_table.h"
+#define CRYPTO_ECDSA_TABLE 1
+#else
+#define CRYPTO_ECDSA_TABLE 0
+#endif
+
 // CRITICAL: Must be 4-byte aligned for HAL_CRYP hardware operations
 __attribute__((aligned(4)))
 static uint8_t crypto_temp_buffer[AES_BLOCK_SIZE];
 static uint8_t hash_started = 0;
+static uint8_t hash_dma = 0;        // Hash fed by DMA: finish with HAL_HASHEx_SHA256_Finish
 static uint8_t key_converted = 0;
 
+/* DMA pipeline buffers: DMA1 cannot reach the DTCM, these live in AXI SRAM
+ * like all .bss. 32 spare bytes for the caller's flash word padding. */
+__attribute__((aligned(32)))
+static uint8_t pipeline_buffer[2][CRYPTO_PIPELINE_BLOCK_MAX + 32];
+static uint8_t pipeline_next = 0;       // Buffer the next block is decrypted into
+static uint32_t pipeline_pending = 0;   // Bytes of the other buffer not programmed yet
+
+/* Public key export: the application verifies staged firmware with it.
+ * Only a pointer to the key, the AES key stays private to the bootloader. */
+__attribute__((section(".bootloader_key_info"), used))
+const struct {
+    uint32_t magic;               // CRYPTO_KEY_INFO_MAGIC
+    uint16_t key_version;         // CRYPTO_KEY_VERSION
+    uint16_t reserved;
+    const uint8_t *public_key;    // ECDSA P-256 x || y, in this sector
+    uint32_t reserved2;
+} bootloader_key_info = {
+    .magic = CRYPTO_KEY_INFO_MAGIC,
+    .key_version = CRYPTO_KEY_VERSION,
+    .reserved = 0,
+    .public_key = ECDSA_PUBLIC_KEY,
+    .reserved2 = 0
+};
+
 /* Key and IV buffers as 32-bit words (CRYP requires big-endian word format) */
 __attribute__((aligned(4)))
 static uint32_t key_words[8];   // 32 bytes = 8 words
@@ -51,6 +85,10 @@ int32_t Crypto_Init(void) {
 void Crypto_Reset(void) {
     /* Reset incremental hash state flag */
     hash_started = 0;
+    hash_dma = 0;
+    /* A decrypted block not programmed yet belongs to the interrupted transfer */
+    pipeline_pending = 0;
+    pipeline_next = 0;
     /* Reset key converted flag so it re-converts on next decrypt */
     key_converted = 0;
 
@@ -62,10 +100,8 @@ void Crypto_Reset(void) {
     /* Note: Don't DeInit CRYP here - leave it initialized */
 }
 
-int32_t Crypto_AES256_Decrypt(const uint8_t *encrypted, uint8_t *decrypted,
-                              uint32_t length, const uint8_t *iv) {
-    if ((length % AES_BLOCK_SIZE) != 0) return CRYPTO_ERROR;
-
+/* Load key and IV into CRYP for AES-256-CBC (the call sets the direction) */
+static int32_t CrypSetup(const uint8_t *iv) {
     /* Convert key from byte array to big-endian 32-bit words (only once) */
     if (!key_converted) {
         for (int i = 0; i < 8; i++) {
@@ -92,6 +128,15 @@ int32_t Crypto_AES256_Decrypt(const uint8_t *encrypted, uint8_t *decrypted,
 
     if (HAL_CRYP_Init(&hcryp) != HAL_OK) return CRYPTO_ERROR;
 
+    return CRYPTO_OK;
+}
+
+int32_t Crypto_AES256_Decrypt(const uint8_t *encrypted, uint8_t *decrypted,
+                              uint32_t length, const uint8_t *iv) {
+    if ((length % AES_BLOCK_SIZE) != 0) return CRYPTO_ERROR;
+
+    if (CrypSetup(iv) != CRYPTO_OK) return CRYPTO_ERROR;
+
     /* Perform AES-256-CBC decryption
      * Size is in 32-bit words, so divide length by 4 */
     if (HAL_CRYP_Decrypt(&hcryp, (uint32_t*)encrypted, length / 4,
@@ -114,15 +159,11 @@ int32_t Crypto_ECDSA_Verify(const uint8_t *data, uint32_t data_length,
                             const uint8_t *signature) {
     uint8_t hash[SHA256_DIGEST_SIZE];
     if (Crypto_SHA256(data, data_length, hash) != CRYPTO_OK) return CRYPTO_ERROR;
-    const struct uECC_Curve_t *curve = uECC_secp256r1();
-    if (uECC_verify(ECDSA_PUBLIC_KEY, hash, sizeof(hash), signature, curve)) {
-        return CRYPTO_OK;
-    }
-    return CRYPTO_INVALID_SIG;
+    return Crypto_ECDSA_VerifyHash(hash, signature);
 }
 
 int32_t Crypto_ValidateSFUHeader(const SFU_Header_t *header) {
-    if (header->magic != SFU_MAGIC) return CRYPTO_ERROR;
+    if (header->magic != SFU_MAGIC && header->magic != SFU_MAGIC_LZ4) return CRYPTO_ERROR;
     if (header->firmware_size == 0 || header->firmware_size > (1024 * 1024)) return CRYPTO_ERROR;
     uint32_t header_data_size = offsetof(SFU_Header_t, signature);
     return Crypto_ECDSA_Verify((const uint8_t*)header, header_data_size, header->signature);
@@ -142,6 +183,118 @@ int32_t Crypto_DecryptFirmwareBlock(const uint8_t *encrypted_block,
     return result;
 }
 
+int32_t Crypto_EncryptBlock(const uint8_t *block, uint8_t *encrypted_block,
+                            uint32_t length, uint8_t *iv) {
+    if ((length % AES_BLOCK_SIZE) != 0 || length == 0) return CRYPTO_ERROR;
+
+    if (CrypSetup(iv) != CRYPTO_OK) return CRYPTO_ERROR;
+
+    if (HAL_CRYP_Encrypt(&hcryp, (uint32_t*)block, length / 4,
+                         (uint32_t*)encrypted_block, HAL_MAX_DELAY) != HAL_OK) {
+        return CRYPTO_ERROR;
+    }
+
+    /* Next IV: the last ciphertext block */
+    memcpy(iv, &encrypted_block[length - AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+    return CRYPTO_OK;
+}
+
+int32_t Crypto_Random(uint8_t *data, uint32_t length) {
+    return uECC_RNG_Callback(data, length) ? CRYPTO_OK : CRYPTO_ERROR;
+}
+
+/* Stop both peripherals and their DMA (the MSP DeInit aborts the streams) */
+static void PipelineAbort(void) {
+    HAL_CRYP_DeInit(&hcryp);
+    hcryp.State = HAL_CRYP_STATE_RESET;
+    HAL_HASH_DeInit(&hhash);
+    hhash.State = HAL_HASH_STATE_RESET;
+    hash_started = 0;
+    hash_dma = 0;
+}
+
+/* Start decrypting and hashing a block by DMA; both read the ciphertext */
+static int32_t PipelineStart(const uint8_t *encrypted, uint8_t *decrypted,
+                             uint32_t length, const uint8_t *iv, uint8_t last) {
+    if (CrypSetup(iv) != CRYPTO_OK) return CRYPTO_ERROR;
+
+    /* MDMAT keeps the digest open for the next block, the last one closes it */
+    if (last) {
+        __HAL_HASH_RESET_MDMAT();
+    } else {
+        __HAL_HASH_SET_MDMAT();
+    }
+    hash_dma = 1;
+    if (HAL_HASHEx_SHA256_Start_DMA(&hhash, (uint8_t*)encrypted, length) != HAL_OK) {
+        return CRYPTO_ERROR;
+    }
+
+    if (HAL_CRYP_Decrypt_DMA(&hcryp, (uint32_t*)encrypted, length / 4,
+                             (uint32_t*)decrypted) != HAL_OK) {
+        return CRYPTO_ERROR;
+    }
+
+    return CRYPTO_OK;
+}
+
+/* Wait until both DMA transfers are done: the ciphertext may be reused after */
+static int32_t PipelineWait(void) {
+    uint32_t start = HAL_GetTick();
+
+    while (HAL_CRYP_GetState(&hcryp) == HAL_CRYP_STATE_BUSY ||
+           HAL_HASH_GetState(&hhash) == HAL_HASH_STATE_BUSY) {
+        if (HAL_GetTick() - start > CRYPTO_DMA_TIMEOUT_MS) return CRYPTO_ERROR;
+    }
+
+    if (HAL_CRYP_GetState(&hcryp) != HAL_CRYP_STATE_READY ||
+        HAL_HASH_GetState(&hhash) != HAL_HASH_STATE_READY) {
+        return CRYPTO_ERROR;
+    }
+
+    return CRYPTO_OK;
+}
+
+int32_t Crypto_PipelineBlock(const uint8_t *encrypted, uint32_t length, uint8_t *iv,
+                             uint8_t last, Crypto_ProgramFn program) {
+    uint8_t *decrypted = pipeline_buffer[pipeline_next];
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (!hash_started || length == 0 || length > CRYPTO_PIPELINE_BLOCK_MAX ||
+        (length % AES_BLOCK_SIZE) != 0) {
+        return CRYPTO_ERROR;
+    }
+
+    /* Next IV: the last ciphertext block, saved before the DMA starts */
+    memcpy(crypto_temp_buffer, &encrypted[length - AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+
+    if (PipelineStart(encrypted, decrypted, length, iv, last) != CRYPTO_OK) {
+        PipelineAbort();
+        return CRYPTO_ERROR;
+    }
+
+    /* Program the previous block while the peripherals work on this one */
+    if (pipeline_pending != 0) {
+        status = program(pipeline_buffer[pipeline_next ^ 1], pipeline_pending);
+        pipeline_pending = 0;
+    }
+
+    if (PipelineWait() != CRYPTO_OK) {
+        PipelineAbort();
+        return CRYPTO_ERROR;
+    }
+    if (status != HAL_OK) return CRYPTO_ERROR;
+
+    memcpy(iv, crypto_temp_buffer, AES_BLOCK_SIZE);
+    pipeline_next ^= 1;
+
+    if (last) {
+        return program(decrypted, length) == HAL_OK ? CRYPTO_OK : CRYPTO_ERROR;
+    }
+    pipeline_pending = length;
+
+    return CRYPTO_OK;
+}
+
 /* Incremental SHA-256 hashing for signature verification */
 int32_t Crypto_SHA256_Start(void) {
     /* Reset HAL state so it will accept reinitialization */
@@ -157,7 +310,7 @@ int32_t Crypto_SHA256_Start(void) {
 }
 
 int32_t Crypto_SHA256_Update(const uint8_t *data, uint32_t length) {
-    if (!hash_started) return CRYPTO_ERROR;
+    if (!hash_started || hash_dma) return CRYPTO_ERROR;
     if (length == 0) return CRYPTO_OK;
     if (HAL_HASHEx_SHA256_Accmlt(&hhash, (uint8_t*)data, length) != HAL_OK) {
         return CRYPTO_ERROR;
@@ -178,7 +331,14 @@ int32_t Crypto_SHA256_Finish(uint8_t *hash) {
     // Use a dummy buffer to avoid HAL_ERROR from NULL pointer check
     static uint8_t dummy_buffer[4] __attribute__((aligned(4))) = {0};
 
-    HAL_StatusTypeDef hal_result = HAL_HASHEx_SHA256_Accmlt_End(&hhash, dummy_buffer, 0, hash, HAL_MAX_DELAY);
+    HAL_StatusTypeDef hal_result;
+    if (hash_dma) {
+        // The last DMA block (MDMAT reset) started the digest calculation
+        hash_dma = 0;
+        hal_result = HAL_HASHEx_SHA256_Finish(&hhash, hash, CRYPTO_DMA_TIMEOUT_MS);
+    } else {
+        hal_result = HAL_HASHEx_SHA256_Accmlt_End(&hhash, dummy_buffer, 0, hash, HAL_MAX_DELAY);
+    }
     if (hal_result != HAL_OK) {
         // Return negative HAL status + 100 for distinction
         return -(100 + (int32_t)hal_result);  // -101=ERROR, -102=BUSY, -103=TIMEOUT
@@ -192,9 +352,88 @@ uint8_t Crypto_IsHashStarted(void) {
 }
 
 int32_t Crypto_ECDSA_VerifyHash(const uint8_t *hash, const uint8_t *signature) {
+#if CRYPTO_ECDSA_TABLE
+    /* A table left over from another key would reject every image */
+    if (memcmp(ECDSA_TABLE_KEY, ECDSA_PUBLIC_KEY, ECDSA_PUBKEY_SIZE) == 0) {
+        return ecdsa_comb_verify(ECDSA_Q_TABLE, hash, signature) ? CRYPTO_OK : CRYPTO_INVALID_SIG;
+    }
+#endif
     const struct uECC_Curve_t *curve = uECC_secp256r1();
     if (uECC_verify(ECDSA_PUBLIC_KEY, hash, SHA256_DIGEST_SIZE, signature, curve)) {
         return CRYPTO_OK;
     }
     return CRYPTO_INVALID_SIG;
 }
+
+/* SipHash-2-4 (Aumasson, Bernstein): a MAC made for short inputs, a few
+ * hundred cycles for a 28-byte record where HMAC-SHA-256 in software
+ * would take tens of thousands */
+#define ROTL64(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+static inline uint64_t bytes_to_le64(const uint8_t *bytes) {
+    uint64_t x = 0;
+    for (int i = 7; i >= 0; i--) {
+        x = (x << 8) | bytes[i];
+    }
+    return x;
+}
+
+static inline void SipRound(uint64_t v[4]) {
+    v[0] += v[1]; v[1] = ROTL64(v[1], 13); v[1] ^= v[0]; v[0] = ROTL64(v[0], 32);
+    v[2] += v[3]; v[3] = ROTL64(v[3], 16); v[3] ^= v[2];
+    v[0] += v[3]; v[3] = ROTL64(v[3], 21); v[3] ^= v[0];
+    v[2] += v[1]; v[1] = ROTL64(v[1], 17); v[1] ^= v[2]; v[2] = ROTL64(v[2], 32);
+}
+
+static uint64_t SipHash24(const uint64_t key[2], const uint8_t *data, uint32_t length) {
+    uint64_t v[4] = {
+        key[0] ^ 0x736f6d6570736575ULL, key[1] ^ 0x646f72616e646f6dULL,
+        key[0] ^ 0x6c7967656e657261ULL, key[1] ^ 0x7465646279746573ULL
+    };
+    uint64_t last = (uint64_t)length << 56;
+    uint32_t i;
+
+    for (i = 0; i + 8 <= length; i += 8) {
+        uint64_t m = bytes_to_le64(data + i);
+        v[3] ^= m;
+        SipRound(v);
+        SipRound(v);
+        v[0] ^= m;
+    }
+    for (uint32_t j = 0; i + j < length; j++) {
+        last |= (uint64_t)data[i + j] << (8 * j);
+    }
+    v[3] ^= last;
+    SipRound(v);
+    SipRound(v);
+    v[0] ^= last;
+
+    v[2] ^= 0xFF;
+    for (int r = 0; r < 4; r++) {
+        SipRound(v);
+    }
+    return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+uint32_t Crypto_RecordTag(const uint8_t *data, uint32_t length) {
+    static uint64_t tag_key[2];
+    static uint8_t tag_key_ready = 0;
+
+    /* Not the AES key itself: SipHash keyed with its first half, over its
+     * second half and a label, once per boot */
+    if (!tag_key_ready) {
+        uint64_t half[2] = { bytes_to_le64(AES_KEY), bytes_to_le64(AES_KEY + 8) };
+        uint8_t label[AES_KEY_SIZE / 2 + 4];
+
+        memcpy(label, AES_KEY + AES_KEY_SIZE / 2, AES_KEY_SIZE / 2);
+        for (uint32_t i = 0; i < 2; i++) {
+            memcpy(label + AES_KEY_SIZE / 2, i ? "LSV1" : "LSV0", 4);
+            tag_key[i] = SipHash24(half, label, sizeof(label));
+        }
+        memset(label, 0, sizeof(label));
+        tag_key_ready = 1;
+    }
+
+    uint64_t tag = SipHash24(tag_key, data, length);
+    return (uint32_t)tag ^ (uint32_t)(tag >> 32);
+}
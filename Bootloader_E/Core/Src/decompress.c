@@ -0,0 +1,189 @@
+#include "decompress.h"
+#include <string.h>
+
+/* LZ4 block format: sequences of a token (literal length << 4 | match
+ * length - 4), more literal length bytes while 255, the literals, a 16-bit
+ * little-endian offset, more match length bytes while 255. The last
+ * sequence has literals only. Each state consumes one input byte, except
+ * LITERALS which copies what is available. */
+typedef enum {
+    DEC_TOKEN,
+    DEC_LIT_LEN,
+    DEC_LITERALS,
+    DEC_OFFSET_LO,
+    DEC_OFFSET_HI,
+    DEC_MATCH_LEN,
+    DEC_DONE,
+    DEC_FAILED
+} DecompressState_t;
+
+/* Output window, flushed from here: slices start on flash words */
+__attribute__((aligned(32)))
+static uint8_t ring[DECOMPRESS_RING];
+
+static DecompressState_t state = DEC_FAILED;
+static Decompress_OutputFn output_fn;
+static uint32_t output_size;
+static uint32_t produced;       // Bytes output so far
+static uint32_t ring_pos;       // produced % DECOMPRESS_RING
+static uint32_t token;
+static uint32_t run_length;     // Literal or match bytes still to come
+static uint32_t offset;
+
+/* Hand over the slice being filled: full, or the last one */
+static int32_t Flush(void) {
+    uint32_t slice_length = ring_pos % DECOMPRESS_FLUSH;
+    if (slice_length == 0) slice_length = DECOMPRESS_FLUSH;
+    uint32_t start = (ring_pos == 0 ? DECOMPRESS_RING : ring_pos) - slice_length;
+
+    return output_fn(&ring[start], slice_length) == HAL_OK ? DECOMPRESS_OK : DECOMPRESS_ERROR;
+}
+
+/* Bytes that can be written at ring_pos before the slice is full */
+static uint32_t SliceRoom(void) {
+    return DECOMPRESS_FLUSH - ring_pos % DECOMPRESS_FLUSH;
+}
+
+/* Account for n bytes written at ring_pos, flushing a full slice */
+static int32_t Advance(uint32_t n) {
+    produced += n;
+    ring_pos += n;
+    if (ring_pos % DECOMPRESS_FLUSH == 0) {
+        if (ring_pos == DECOMPRESS_RING) ring_pos = 0;
+        return Flush();
+    }
+    return DECOMPRESS_OK;
+}
+
+/* Copy a match: the window keeps SFU_LZ4_WINDOW bytes behind the slice
+ * being filled, so the source is never overwritten before it is read */
+static int32_t CopyMatch(void) {
+    while (run_length > 0) {
+        uint32_t n = SliceRoom();
+        if (n > run_length) n = run_length;
+        uint32_t src = ring_pos >= offset ? ring_pos - offset : ring_pos + DECOMPRESS_RING - offset;
+
+        if (offset >= n && src + n <= DECOMPRESS_RING) {
+            memcpy(&ring[ring_pos], &ring[src], n);
+        } else {
+            /* Overlapping (repeats the last offset bytes) or wrapping */
+            for (uint32_t i = 0; i < n; i++) {
+                ring[ring_pos + i] = ring[src];
+                if (++src == DECOMPRESS_RING) src = 0;
+            }
+        }
+        run_length -= n;
+        if (Advance(n) != DECOMPRESS_OK) return DECOMPRESS_ERROR;
+    }
+    return DECOMPRESS_OK;
+}
+
+/* Match of the sequence, then the next token */
+static int32_t CopyMatchChecked(void) {
+    if (run_length > output_size - produced) return DECOMPRESS_ERROR;
+    state = DEC_TOKEN;
+    return CopyMatch();
+}
+
+/* After the literals: end of the stream, or the match of the sequence */
+static int32_t LiteralsDone(void) {
+    if (produced < output_size) {
+        state = DEC_OFFSET_LO;
+        return DECOMPRESS_OK;
+    }
+    state = DEC_DONE;
+    return ring_pos % DECOMPRESS_FLUSH != 0 ? Flush() : DECOMPRESS_OK;
+}
+
+void Decompress_Start(uint32_t size, Decompress_OutputFn output) {
+    output_fn = output;
+    output_size = size;
+    produced = 0;
+    ring_pos = 0;
+    state = DEC_TOKEN;
+}
+
+static int32_t Step(const uint8_t **data, uint32_t *avail) {
+    uint8_t byte;
+
+    if (state == DEC_LITERALS) {
+        uint32_t n = SliceRoom();
+        if (n > run_length) n = run_length;
+        if (n > *avail) n = *avail;
+        memcpy(&ring[ring_pos], *data, n);
+        *data += n;
+        *avail -= n;
+        run_length -= n;
+        if (Advance(n) != DECOMPRESS_OK) return DECOMPRESS_ERROR;
+        return run_length == 0 ? LiteralsDone() : DECOMPRESS_OK;
+    }
+
+    byte = *(*data)++;
+    (*avail)--;
+
+    switch (state) {
+        case DEC_TOKEN:
+            token = byte;
+            run_length = token >> 4;
+            if (run_length == 15) {
+                state = DEC_LIT_LEN;
+                return DECOMPRESS_OK;
+            }
+            break;
+
+        case DEC_LIT_LEN:
+            run_length += byte;
+            if (byte == 255) {
+                return run_length > output_size - produced ? DECOMPRESS_ERROR : DECOMPRESS_OK;
+            }
+            break;
+
+        case DEC_OFFSET_LO:
+            offset = byte;
+            state = DEC_OFFSET_HI;
+            return DECOMPRESS_OK;
+
+        case DEC_OFFSET_HI:
+            offset |= (uint32_t)byte << 8;
+            if (offset == 0 || offset > produced || offset > SFU_LZ4_WINDOW) {
+                return DECOMPRESS_ERROR;
+            }
+            run_length = (token & 0x0F) + 4;
+            if ((token & 0x0F) == 15) {
+                state = DEC_MATCH_LEN;
+                return DECOMPRESS_OK;
+            }
+            return CopyMatchChecked();
+
+        case DEC_MATCH_LEN:
+            run_length += byte;
+            if (byte == 255) {
+                return run_length > output_size - produced ? DECOMPRESS_ERROR : DECOMPRESS_OK;
+            }
+            return CopyMatchChecked();
+
+        default:
+            /* Input after the end, or after an error */
+            return DECOMPRESS_ERROR;
+    }
+
+    /* Token or literal length complete */
+    if (run_length > output_size - produced) return DECOMPRESS_ERROR;
+    if (run_length == 0) return LiteralsDone();
+    state = DEC_LITERALS;
+    return DECOMPRESS_OK;
+}
+
+int32_t Decompress_Feed(const uint8_t *data, uint32_t length) {
+    while (length > 0) {
+        if (Step(&data, &length) != DECOMPRESS_OK) {
+            state = DEC_FAILED;
+            return DECOMPRESS_ERROR;
+        }
+    }
+    return DECOMPRESS_OK;
+}
+
+int32_t Decompress_Finish(void) {
+    return state == DEC_DONE ? DECOMPRESS_OK : DECOMPRESS_ERROR;
+}
@@ -0,0 +1,156 @@
+#include "delta.h"
+#include <string.h>
+
+/* Each record: control (add_len, insert_len, seek), then add_len bytes
+ * added to the base, then insert_len new bytes */
+typedef enum {
+    DELTA_CONTROL,
+    DELTA_ADD,
+    DELTA_INSERT,
+    DELTA_FAILED
+} DeltaState_t;
+
+static uint8_t output_block[DELTA_OUTPUT_BLOCK];
+
+static DeltaState_t state = DELTA_FAILED;
+static Delta_OutputFn output_fn;
+static const uint8_t *base;
+static uint32_t base_size;
+static uint32_t base_pos;
+static uint32_t target_size;
+static uint32_t produced;           // Bytes output so far
+static uint32_t block_fill;         // Bytes in output_block
+static uint8_t control[SFU_DELTA_RECORD_SIZE];
+static uint32_t control_fill;
+static uint32_t add_len;            // Bytes of the record still to come
+static uint32_t insert_len;
+static int32_t seek;
+
+static uint32_t ReadLE32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Bytes that can be added to output_block before it is full */
+static uint32_t BlockRoom(void) {
+    return DELTA_OUTPUT_BLOCK - block_fill;
+}
+
+static int32_t Emitted(uint32_t n) {
+    block_fill += n;
+    produced += n;
+    if (block_fill == DELTA_OUTPUT_BLOCK) {
+        block_fill = 0;
+        if (output_fn(output_block, DELTA_OUTPUT_BLOCK) != HAL_OK) return DELTA_ERROR;
+    }
+    return DELTA_OK;
+}
+
+/* Record control complete: check it against the base and the target */
+static int32_t StartRecord(void) {
+    add_len = ReadLE32(&control[0]);
+    insert_len = ReadLE32(&control[4]);
+    seek = (int32_t)ReadLE32(&control[8]);
+    control_fill = 0;
+
+    if (add_len > target_size - produced ||
+        insert_len > target_size - produced - add_len ||
+        add_len > base_size - base_pos) {
+        return DELTA_ERROR;
+    }
+
+    state = add_len ? DELTA_ADD : DELTA_INSERT;
+    return DELTA_OK;
+}
+
+/* Insert bytes done: move the base position, then the next record */
+static int32_t EndRecord(void) {
+    int64_t pos = (int64_t)base_pos + seek;
+
+    if (pos < 0 || pos > base_size) return DELTA_ERROR;
+    base_pos = (uint32_t)pos;
+    state = DELTA_CONTROL;
+    return DELTA_OK;
+}
+
+void Delta_Start(const uint8_t *base_image, uint32_t base_length, uint32_t size,
+                 Delta_OutputFn output) {
+    base = base_image;
+    base_size = base_length;
+    target_size = size;
+    output_fn = output;
+    base_pos = 0;
+    produced = 0;
+    block_fill = 0;
+    control_fill = 0;
+    state = DELTA_CONTROL;
+}
+
+static int32_t Step(const uint8_t **patch, uint32_t *avail) {
+    uint32_t n;
+
+    switch (state) {
+        case DELTA_CONTROL:
+            n = SFU_DELTA_RECORD_SIZE - control_fill;
+            if (n > *avail) n = *avail;
+            memcpy(&control[control_fill], *patch, n);
+            control_fill += n;
+            *patch += n;
+            *avail -= n;
+            if (control_fill < SFU_DELTA_RECORD_SIZE) return DELTA_OK;
+            if (StartRecord() != DELTA_OK) return DELTA_ERROR;
+            if (state == DELTA_INSERT && insert_len == 0) return EndRecord();
+            return DELTA_OK;
+
+        case DELTA_ADD:
+            n = BlockRoom();
+            if (n > add_len) n = add_len;
+            if (n > *avail) n = *avail;
+            for (uint32_t i = 0; i < n; i++) {
+                output_block[block_fill + i] = base[base_pos + i] + (*patch)[i];
+            }
+            base_pos += n;
+            add_len -= n;
+            *patch += n;
+            *avail -= n;
+            if (Emitted(n) != DELTA_OK) return DELTA_ERROR;
+            if (add_len > 0) return DELTA_OK;
+            state = DELTA_INSERT;
+            return insert_len == 0 ? EndRecord() : DELTA_OK;
+
+        case DELTA_INSERT:
+            n = BlockRoom();
+            if (n > insert_len) n = insert_len;
+            if (n > *avail) n = *avail;
+            memcpy(&output_block[block_fill], *patch, n);
+            insert_len -= n;
+            *patch += n;
+            *avail -= n;
+            if (Emitted(n) != DELTA_OK) return DELTA_ERROR;
+            return insert_len == 0 ? EndRecord() : DELTA_OK;
+
+        default:
+            return DELTA_ERROR;
+    }
+}
+
+int32_t Delta_Feed(const uint8_t *patch, uint32_t length) {
+    while (length > 0) {
+        if (Step(&patch, &length) != DELTA_OK) {
+            state = DELTA_FAILED;
+            return DELTA_ERROR;
+        }
+    }
+    return DELTA_OK;
+}
+
+int32_t Delta_Finish(void) {
+    if (state != DELTA_CONTROL || control_fill != 0 || produced != target_size) {
+        return DELTA_ERROR;
+    }
+    state = DELTA_FAILED;
+    if (block_fill > 0 && output_fn(output_block, block_fill) != HAL_OK) {
+        return DELTA_ERROR;
+    }
+    return DELTA_OK;
+}
@@ -1,6 +1,8 @@
 #include "hash.h"
+#include "dma.h"
 
 HASH_HandleTypeDef hhash;
+DMA_HandleTypeDef hdma_hash_in;
 
 void MX_HASH_Init(void)
 {
@@ -13,12 +15,27 @@ void MX_HASH_Init(void)
 
 void HAL_HASH_MspInit(HASH_HandleTypeDef* hashHandle)
 {
-  (void)hashHandle;
   __HAL_RCC_HASH_CLK_ENABLE();
+
+  hdma_hash_in.Instance = HASH_IN_DMA_STREAM;
+  hdma_hash_in.Init.Request = DMA_REQUEST_HASH_IN;
+  hdma_hash_in.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_hash_in.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_hash_in.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_hash_in.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  hdma_hash_in.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+  hdma_hash_in.Init.Mode = DMA_NORMAL;
+  hdma_hash_in.Init.Priority = DMA_PRIORITY_HIGH;
+  hdma_hash_in.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+  if (HAL_DMA_Init(&hdma_hash_in) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  __HAL_LINKDMA(hashHandle, hdmain, hdma_hash_in);
 }
 
 void HAL_HASH_MspDeInit(HASH_HandleTypeDef* hashHandle)
 {
-  (void)hashHandle;
+  HAL_DMA_DeInit(hashHandle->hdmain);
   __HAL_RCC_HASH_CLK_DISABLE();
 }
@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "crc.h"
+#include "dma.h"
 #include "cryp.h"
 #include "hash.h"
 #include "rng.h"
@@ -31,6 +32,7 @@
 #include "bootload.h"
 #include "usbd_cdc_if.h"
 #include "crypto.h"
+#include "validity.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -75,20 +77,37 @@ int main(void)
 {
   /* USER CODE BEGIN 1 */
   uint8_t bootloader_requested = 0;
+  uint8_t install_requested = 0;
   uint8_t application_valid = 0;
   uint32_t bootloader_timeout = BOOTLOADER_TIMEOUT_MS;
 
+  // Cycle counter from reset: the application reads it at main() to report
+  // its boot time (DWT->CYCCNT, 64 MHz HSI until it sets up its clocks)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
   // *** EARLIEST POSSIBLE CHECK: Jump to app BEFORE any peripheral/MPU init ***
   // This ensures the app starts in a clean state (no MPU, no HAL, no peripherals)
   // NOTE: IsBootloaderModeRequested() clears the flag, so save the result!
   {
       bootloader_requested = IsBootloaderModeRequested();  // Save result for later use
+      install_requested = IsStagedInstallRequested();      // Same register, same rule
+      // v3.4: the validity record of the last install (sector 7), flash
+      // reads only, ECC errors survived, tag checked in software. Without
+      // records (never updated by v3.4+, or log just erased) the stack
+      // pointer check stays; anything else is decided after init, with the CRC unit
+      // (v3.5: an image on trial too, its boots are counted in the W25Q)
+      ValidityState_t validity = Validity_Check();
       uint32_t early_app_stack = *((uint32_t *)APPLICATION_ADDRESS);
-      uint8_t early_app_valid = ((early_app_stack & 0xFFF00000) == 0x20000000 ||
-                                  (early_app_stack & 0xFFF00000) == 0x24000000);
+      uint8_t early_app_valid = (validity == VALIDITY_OK) ||
+                                (validity == VALIDITY_NONE &&
+                                 ((early_app_stack & 0xFFF00000) == 0x20000000 ||
+                                  (early_app_stack & 0xFFF00000) == 0x24000000));
 
       // If no bootloader requested and valid app exists, jump immediately
-      if (!bootloader_requested && early_app_valid) {
+      if (!bootloader_requested && !install_requested && early_app_valid) {
           JumpToApplication();
           // Never returns
       }
@@ -117,6 +136,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_CRC_Init();
   MX_RTC_Init();
   MX_CRYP_Init();
@@ -126,14 +146,64 @@ int main(void)
   /* Initialize crypto module */
   Crypto_Init();
 
-  // Check if valid application exists (stack pointer in RAM region)
-  uint32_t app_stack = *((uint32_t *)APPLICATION_ADDRESS);
-  application_valid = ((app_stack & 0xFFF00000) == 0x20000000 ||
-                       (app_stack & 0xFFF00000) == 0x24000000) ? 1 : 0;
+  // Check if valid application exists (validity record, CRC if the record
+  // disagrees, stack pointer in RAM region without records)
+  application_valid = Validity_ApplicationValid(Validity_Check());
+
+  // Image found good by its CRC and recorded again: restart into it from a
+  // clean state (if the record could not be written: after the timeout)
+  if (application_valid && !bootloader_requested && !install_requested &&
+      Validity_Check() == VALIDITY_OK) {
+      NVIC_SystemReset();
+  }
 
-  // v2.1: Only erase at entry if app is ALREADY invalid
-  // If bootloader_requested && app valid, wait for START packet to erase
-  // This allows user to cancel (power cycle) without losing firmware
+  // v3.5: an image installed over a backup runs on trial until it confirms
+  // itself; once its boots are used up, the backup is restored below
+  if (application_valid && !bootloader_requested && !install_requested &&
+      Validity_Check() == VALIDITY_TRIAL) {
+      switch (CheckTrialBoot()) {
+          case TRIAL_RUN:
+              // Boot counted: start it from here, as after the timeout
+              JumpToApplication();
+              break;
+          case TRIAL_CONFIRMED:
+              NVIC_SystemReset();
+              break;
+          default:
+              application_valid = 0;
+              break;
+      }
+  }
+
+  // v3.1: Install firmware staged in the W25Q by the application, on request
+  // or to finish an install interrupted before the app's first word was written
+  // v3.5: otherwise an invalid application is replaced by the backup, if a
+  // restore was asked for (trial expired, or restore interrupted)
+  if (install_requested || !application_valid) {
+      if (InstallStagedFirmware() == HAL_OK ||
+          (!application_valid && RestoreBackup() == HAL_OK)) {
+          // SUCCESS: 2 long beeps = about to reset
+          for (int i = 0; i < 2; i++) {
+              IWDG_REFRESH();
+              HAL_GPIO_WritePin(GPIOA, GPIO_PIN_2, GPIO_PIN_SET);
+              HAL_Delay(500);
+              IWDG_REFRESH();
+              HAL_GPIO_WritePin(GPIOA, GPIO_PIN_2, GPIO_PIN_RESET);
+              HAL_Delay(300);
+          }
+          NVIC_SystemReset();
+      }
+      // Nothing installed: if the app is untouched, restart into it from a
+      // clean state, otherwise wait for a USB update below
+      application_valid = Validity_ApplicationValid(Validity_Check());
+      if (install_requested && application_valid) {
+          NVIC_SystemReset();
+      }
+  }
+
+  // v3.2: Nothing is erased at entry: START erases the image's sectors
+  // progressively, so USB comes up at once and the user can still cancel
+  // (power cycle) without losing firmware
   if (bootloader_requested || !application_valid) {
       // 3 short beeps = entering bootloader mode
       for (int i = 0; i < 3; i++) {
@@ -143,19 +213,12 @@ int main(void)
           HAL_Delay(100);
       }
 
-      // Only erase if app is ALREADY invalid (nothing to lose)
-      // If app is valid, erase happens on START packet in ProcessFirmwarePacket()
-      if (!application_valid) {
-          EraseApplicationFlash();
-      }
-
       // 1 long beep = ready for firmware transfer
       HAL_GPIO_WritePin(GPIOA, GPIO_PIN_2, GPIO_PIN_SET);
       HAL_Delay(500);
       HAL_GPIO_WritePin(GPIOA, GPIO_PIN_2, GPIO_PIN_RESET);
   }
 
-  // Initialize USB after flash erase is complete
   MX_USB_DEVICE_Init();
   /* USER CODE BEGIN 2 */
 
@@ -175,6 +238,9 @@ int main(void)
     // Process any received packets (do flash operations here, not in interrupt)
     CDC_ProcessPacket();
 
+    // Erase the next sector while the host sends data for the current one
+    EraseAhead();
+
     // Check firmware update state
     FirmwareUpdateState_t fw_state = GetFirmwareUpdateState();
 
@@ -224,7 +290,8 @@ int main(void)
         HAL_Delay(10);
         bootloader_timeout -= 10;
     } else {
-        // Timeout expired
+        // Timeout expired: an update may have been started since power-on
+        application_valid = Validity_ApplicationValid(Validity_Check());
         if (application_valid) {
             // Jump to application
             JumpToApplication();
@@ -0,0 +1,276 @@
+#include "validity.h"
+#include "bootload.h"
+#include "checksum.h"
+#include "crypto.h"
+#include <stddef.h>
+#include <string.h>
+
+#define APPLICATION_ADDRESS 0x08020000  // Sector 1 (128KB offset)
+#define APPLICATION_SIZE    (768 * 1024) // Sectors 1-6
+
+static const volatile uint32_t *const log_words = (const volatile uint32_t *)VALIDITY_LOG_ADDRESS;
+
+__attribute__((aligned(32)))
+static ValidityRecord_t new_record;
+
+static uint32_t RecordTag(const ValidityRecord_t *record) {
+    return Crypto_RecordTag((const uint8_t *)record, offsetof(ValidityRecord_t, tag));
+}
+
+/* Copy a slot. A power cut while a flash word is programmed can leave it
+ * with an ECC error the hardware cannot correct: reading it is a bus
+ * error, and at reset nothing handles it. Precise bus faults are ignored
+ * while FAULTMASK and CCR.BFHFNMIGN are set; the flash reports the error
+ * in DBECCERR instead. Returns 0 for a damaged slot. */
+static uint8_t ReadSlot(uint32_t index, ValidityRecord_t *record) {
+    const volatile uint32_t *src = log_words + index * (VALIDITY_RECORD_SIZE / 4);
+    uint32_t *dst = (uint32_t *)record;
+    uint32_t ccr = SCB->CCR;
+
+    FLASH->CCR1 = FLASH_CCR_CLR_SNECCERR | FLASH_CCR_CLR_DBECCERR;
+    __set_FAULTMASK(1);
+    SCB->CCR = ccr | SCB_CCR_BFHFNMIGN_Msk;
+    __DSB();
+    __ISB();
+
+    for (uint32_t i = 0; i < VALIDITY_RECORD_SIZE / 4; i++) {
+        dst[i] = src[i];
+    }
+
+    __DSB();
+    SCB->CCR = ccr;
+    __ISB();
+    __set_FAULTMASK(0);
+
+    if (FLASH->SR1 & FLASH_SR_DBECCERR) {
+        FLASH->CCR1 = FLASH_CCR_CLR_SNECCERR | FLASH_CCR_CLR_DBECCERR;
+        SCB->CFSR = SCB_CFSR_BUSFAULTSR_Msk;
+        return 0;
+    }
+    return 1;
+}
+
+static uint8_t SlotErased(uint32_t index) {
+    ValidityRecord_t record;
+    const uint32_t *word = (const uint32_t *)&record;
+
+    if (!ReadSlot(index, &record)) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < VALIDITY_RECORD_SIZE / 4; i++) {
+        if (word[i] != 0xFFFFFFFF) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Slots in use, damaged ones included. They fill from the start, so a
+ * binary search finds the end in log2(VALIDITY_SLOTS) reads. */
+static uint32_t SlotsUsed(void) {
+    uint32_t lo = 0, hi = VALIDITY_SLOTS;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (!SlotErased(mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* A record written by this bootloader: readable, magic and tag right */
+static uint8_t ReadRecord(uint32_t index, ValidityRecord_t *record) {
+    return ReadSlot(index, record) && record->magic == VALIDITY_MAGIC &&
+           record->tag == RecordTag(record);
+}
+
+/* Newest authentic record among the last VALIDITY_LOOKBACK of n slots.
+ * Returns its slot, -1 if there is none. */
+static int32_t NewestRecord(uint32_t n, ValidityRecord_t *record) {
+    for (uint32_t i = n; i > 0 && n - i < VALIDITY_LOOKBACK; i--) {
+        if (ReadRecord(i - 1, record)) {
+            return (int32_t)(i - 1);
+        }
+    }
+    return -1;
+}
+
+static uint8_t StackPointerValid(uint32_t app_stack) {
+    return (app_stack & 0xFFF00000) == 0x20000000 ||
+           (app_stack & 0xFFF00000) == 0x24000000;
+}
+
+ValidityState_t Validity_Check(void) {
+    ValidityRecord_t record, previous;
+    uint32_t n = SlotsUsed();
+    const uint32_t *app = (const uint32_t *)APPLICATION_ADDRESS;
+
+    if (n == 0) return VALIDITY_NONE;
+
+    int32_t newest = NewestRecord(n, &record);
+    if (newest < 0 || record.image_size == VALIDITY_STARTED) {
+        return VALIDITY_INCOMPLETE;
+    }
+
+    /* Each counter follows the previous record's: a record copied to the
+     * end shows up here, and so does a damaged or forged slot after the
+     * newest record. The first slot after an erase has no previous record. */
+    if (newest != (int32_t)(n - 1) ||
+        (newest > 0 && (NewestRecord((uint32_t)newest, &previous) < 0 ||
+                        previous.counter != record.counter - 1)) ||
+        app[0] != record.app_stack || app[1] != record.app_reset ||
+        !StackPointerValid(app[0])) {
+        return VALIDITY_MISMATCH;
+    }
+
+    return (record.flags & VALIDITY_FLAG_TRIAL) ? VALIDITY_TRIAL : VALIDITY_OK;
+}
+
+static HAL_StatusTypeDef EraseLog(void) {
+    FLASH_EraseInitTypeDef erase;
+    uint32_t error = 0;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Banks = FLASH_BANK_1;
+    erase.Sector = VALIDITY_LOG_SECTOR;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    IWDG_REFRESH();
+    if (HAL_FLASHEx_Erase(&erase, &error) != HAL_OK || error != 0xFFFFFFFF) {
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+/* Program the next slot, erasing the log first when fewer than room
+ * slots are left (room: records the caller still has to write, more than
+ * VALIDITY_SLOTS to erase in any case) */
+static HAL_StatusTypeDef Append(uint32_t image_size, uint32_t image_crc, uint32_t flags,
+                                uint32_t room) {
+    ValidityRecord_t last;
+    uint32_t n = SlotsUsed();
+    const uint32_t *app = (const uint32_t *)APPLICATION_ADDRESS;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    memset(&new_record, 0, sizeof(new_record));
+    new_record.magic = VALIDITY_MAGIC;
+    new_record.counter = NewestRecord(n, &last) < 0 ? 1 : last.counter + 1;
+    new_record.image_size = image_size;
+    new_record.image_crc = image_crc;
+    new_record.app_stack = app[0];
+    new_record.app_reset = app[1];
+    new_record.flags = flags;
+    new_record.tag = RecordTag(&new_record);
+
+    uint8_t was_locked = (FLASH->CR1 & FLASH_CR_LOCK) != 0;
+    if (was_locked && FlashUnlock() != HAL_OK) {
+        return HAL_ERROR;
+    }
+    if (VALIDITY_SLOTS - n < room) {
+        status = EraseLog();
+        n = 0;
+    }
+    if (status == HAL_OK) {
+        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD,
+                                   VALIDITY_LOG_ADDRESS + n * VALIDITY_RECORD_SIZE,
+                                   (uint32_t)(uintptr_t)&new_record);
+    }
+    if (was_locked) {
+        FlashLock();
+    }
+    __DSB();
+
+    if (status != HAL_OK || !ReadSlot(n, &last) ||
+        memcmp(&last, &new_record, VALIDITY_RECORD_SIZE) != 0) {
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Validity_InstallStarted(void) {
+    ValidityRecord_t record;
+    uint32_t n = SlotsUsed();
+    int32_t newest = n > 0 ? NewestRecord(n, &record) : -1;
+
+    /* Already marked (install retried) */
+    if (n > 0 && newest == (int32_t)(n - 1) && record.image_size == VALIDITY_STARTED) {
+        return HAL_OK;
+    }
+
+    /* Room for this record, the completion and a trial's confirmation:
+     * the log is erased here, while the application is still whole. So is
+     * a log with no authentic record left, as a power cut during its erase
+     * leaves it: the next slots may be damaged too. */
+    return Append(VALIDITY_STARTED, 0, 0,
+                  (n > 0 && newest < 0) ? VALIDITY_SLOTS + 1 : 3);
+}
+
+HAL_StatusTypeDef Validity_InstallDone(uint32_t image_size, uint32_t image_crc,
+                                       uint8_t trial) {
+    uint32_t size = (image_size + 31) / 32 * 32;
+
+    if (size == 0 || size > APPLICATION_SIZE) {
+        return HAL_ERROR;
+    }
+
+    return Append(size, image_crc, trial ? VALIDITY_FLAG_TRIAL : 0, 1);
+}
+
+HAL_StatusTypeDef Validity_Confirm(void) {
+    ValidityRecord_t record;
+
+    if (Validity_Check() != VALIDITY_TRIAL) {
+        return HAL_ERROR;
+    }
+
+    NewestRecord(SlotsUsed(), &record);
+    return Append(record.image_size, record.image_crc, 0, 1);
+}
+
+HAL_StatusTypeDef Validity_InstalledImage(uint32_t *image_size, uint32_t *image_crc) {
+    ValidityRecord_t record;
+    ValidityState_t state = Validity_Check();
+
+    if (state != VALIDITY_OK && state != VALIDITY_TRIAL) {
+        return HAL_ERROR;
+    }
+
+    NewestRecord(SlotsUsed(), &record);
+    *image_size = record.image_size;
+    *image_crc = record.image_crc;
+    return HAL_OK;
+}
+
+uint8_t Validity_ApplicationValid(ValidityState_t state) {
+    const uint32_t *app = (const uint32_t *)APPLICATION_ADDRESS;
+
+    switch (state) {
+        case VALIDITY_OK:
+        case VALIDITY_TRIAL:
+            return 1;
+
+        case VALIDITY_NONE:
+            return StackPointerValid(app[0]);
+
+        case VALIDITY_MISMATCH: {
+            ValidityRecord_t record;
+
+            if (NewestRecord(SlotsUsed(), &record) < 0 ||
+                record.image_size > APPLICATION_SIZE || !StackPointerValid(app[0]) ||
+                crc32_ieee(CRC32_INIT, (const uint8_t *)APPLICATION_ADDRESS,
+                           record.image_size) != record.image_crc) {
+                return 0;
+            }
+            /* Same image: record it again, counters in order */
+            Append(record.image_size, record.image_crc, record.flags, 1);
+            return 1;
+        }
+
+        default:
+            return 0;
+    }
+}
@@ -20,6 +20,11 @@ static uint8_t UserTxBufferFS[64];
 __attribute__((aligned(4)))
 static uint8_t PacketAssemblyBuffer[sizeof(FirmwarePacket_t)];
 static uint32_t rx_buffer_index = 0;
+static volatile uint32_t rx_last_tick = 0;  // HAL tick of the last received bytes
+
+// A partial packet idle this long is a leftover (e.g. the rest of a chunk
+// frame sent before the host saw an error): drop it to resynchronise
+#define PACKET_IDLE_TIMEOUT_MS  500
 
 // Processing buffer (copy of packet for main loop processing)
 // CRITICAL: Must be 4-byte aligned for HAL_HASH operations on packet->data
@@ -29,6 +34,19 @@ static uint8_t PacketProcessingBuffer[sizeof(FirmwarePacket_t)];
 // Packet ready flag (processed in main loop, not in interrupt)
 static volatile uint8_t packet_ready = 0;
 
+// v3.2 streaming: chunk frames alternate between two buffers, the interrupt
+// fills one while the main loop decrypts and programs the other
+__attribute__((aligned(4)))
+static uint8_t StreamBuffer[2][sizeof(FirmwareChunk_t)];
+static volatile uint32_t stream_frame_size = 0;   // 0 = FirmwarePacket_t mode
+static volatile uint8_t stream_ready[2] = {0, 0};
+static volatile uint8_t stream_overrun = 0;       // Host exceeded STREAM_WINDOW
+static uint8_t stream_fill = 0;                   // Buffer being received (interrupt)
+static uint8_t stream_next = 0;                   // Buffer to process (main loop)
+
+// Response buffers stay valid while the IN transfer runs
+static uint8_t StreamResponse[8];
+
 /**
  * @brief Clear USB packet assembly state
  * Call this at start of ENC_START to ensure clean state after reconnect
@@ -39,6 +57,24 @@ void CDC_ClearPacketState(void)
     packet_ready = 0;
 }
 
+/**
+ * @brief Switch the receiver between packets and streamed chunk frames
+ * Called from the main loop before the response that lets the host switch
+ * @param frame_size Chunk frame size in bytes (header + chunk), 0 for packets
+ */
+void CDC_SetStreamMode(uint32_t frame_size)
+{
+    __disable_irq();
+    rx_buffer_index = 0;
+    stream_ready[0] = 0;
+    stream_ready[1] = 0;
+    stream_overrun = 0;
+    stream_fill = 0;
+    stream_next = 0;
+    stream_frame_size = frame_size;
+    __enable_irq();
+}
+
 // Function prototypes (already declared in usbd_cdc_if.h)
 static int8_t CDC_Init_FS(void);
 static int8_t CDC_DeInit_FS(void);
@@ -52,7 +88,8 @@ USBD_CDC_ItfTypeDef USBD_Interface_fops_HS =
     CDC_Init_FS,
     CDC_DeInit_FS,
     CDC_Control_FS,
-    CDC_Receive_FS
+    CDC_Receive_FS,
+    NULL            // TransmitCplt: not used
 };
 
 /**
@@ -69,6 +106,10 @@ static int8_t CDC_Init_FS(void)
     // get mixed with new packets, causing corruption
     rx_buffer_index = 0;
     packet_ready = 0;
+    // A new connection always starts with packets (STATUS, STREAM_START)
+    stream_frame_size = 0;
+    stream_ready[0] = 0;
+    stream_ready[1] = 0;
 
     return USBD_OK;
 }
@@ -83,6 +124,9 @@ static int8_t CDC_DeInit_FS(void)
     // This ensures clean state when USB reconnects
     rx_buffer_index = 0;
     packet_ready = 0;
+    stream_frame_size = 0;
+    stream_ready[0] = 0;
+    stream_ready[1] = 0;
     return USBD_OK;
 }
 
@@ -91,6 +135,8 @@ static int8_t CDC_DeInit_FS(void)
  */
 static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 {
+    (void)length;
+
     switch(cmd)
     {
     case CDC_SEND_ENCAPSULATED_COMMAND:
@@ -147,6 +193,32 @@ static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 
     // Now process the received data
     uint32_t bytes_received = *Len;
+    rx_last_tick = HAL_GetTick();
+
+    // v3.2 streaming: frames may straddle USB packets, copy in runs
+    if (stream_frame_size != 0) {
+        uint32_t i = 0;
+        while (i < bytes_received) {
+            if (stream_ready[stream_fill]) {
+                // Both buffers full: the host ignored the window
+                stream_overrun = 1;
+                break;
+            }
+            uint32_t n = stream_frame_size - rx_buffer_index;
+            if (n > bytes_received - i) {
+                n = bytes_received - i;
+            }
+            memcpy(&StreamBuffer[stream_fill][rx_buffer_index], &Buf[i], n);
+            rx_buffer_index += n;
+            i += n;
+            if (rx_buffer_index == stream_frame_size) {
+                stream_ready[stream_fill] = 1;
+                stream_fill ^= 1;
+                rx_buffer_index = 0;
+            }
+        }
+        return USBD_OK;
+    }
 
     // DEFENSIVE: If starting fresh packet and first byte looks like ENC_START (0x11),
     // ensure we have clean state (handles edge cases where DeInit wasn't called)
@@ -182,6 +254,55 @@ static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
  */
 void CDC_ProcessPacket(void)
 {
+    // Resynchronise packet framing after a stalled partial packet
+    if (stream_frame_size == 0 && !packet_ready && rx_buffer_index != 0
+            && HAL_GetTick() - rx_last_tick > PACKET_IDLE_TIMEOUT_MS) {
+        __disable_irq();
+        if (HAL_GetTick() - rx_last_tick > PACKET_IDLE_TIMEOUT_MS) {
+            rx_buffer_index = 0;
+        }
+        __enable_irq();
+    }
+
+    // v3.2 streaming: one chunk per call, the other buffer keeps receiving
+    if (stream_frame_size != 0 && (stream_ready[stream_next] || stream_overrun)) {
+        int32_t result = -1;
+
+        if (!stream_overrun) {
+            result = ProcessFirmwareChunk((FirmwareChunk_t *)StreamBuffer[stream_next]);
+        }
+
+        uint32_t chunks = GetStreamChunksStored();
+        StreamResponse[0] = 0xAA;
+        StreamResponse[1] = PACKET_TYPE_STREAM_DATA;
+        StreamResponse[2] = (result == 0) ? 0x01 : 0x00;
+        StreamResponse[3] = GetFirmwareUpdateProgress();
+        StreamResponse[4] = (uint8_t)(GetFirmwareUpdateState());
+        StreamResponse[5] = (uint8_t)(chunks & 0xFF);
+        StreamResponse[6] = (uint8_t)(chunks >> 8);
+        StreamResponse[7] = 0x55;
+
+        if (stream_overrun) {
+            // Data lost: drop the session, the host starts over
+            ResetFirmwareUpdate();
+        } else if (result != 0) {
+            // Error: main loop resets the update, which also ends streaming
+            CDC_SetStreamMode(0);
+        } else if (stream_frame_size != 0) {
+            // Free the buffer only now: the host sends the chunk after next
+            // once this one is acknowledged
+            stream_ready[stream_next] = 0;
+            stream_next ^= 1;
+        }
+
+        // The previous response is long gone (one per chunk), wait briefly if not
+        uint32_t start = HAL_GetTick();
+        while (CDC_Transmit_HS(StreamResponse, sizeof(StreamResponse)) == USBD_BUSY
+               && HAL_GetTick() - start < 10) {
+        }
+        return;
+    }
+
     if (packet_ready) {
         // Process firmware packet from the processing buffer
         FirmwarePacket_t *packet = (FirmwarePacket_t *)PacketProcessingBuffer;
@@ -206,7 +327,9 @@ void CDC_ProcessPacket(void)
         response[2] = (result == 0) ? 0x01 : 0x00;  // Success/Fail
         response[3] = GetFirmwareUpdateProgress();  // Progress %
         response[4] = (uint8_t)(GetFirmwareUpdateState());
-        response[5] = 0x00;
+        // v3.2: STREAM_START returns the granted chunk size (256-byte units)
+        response[5] = (pkt_type == PACKET_TYPE_STREAM_START)
+                      ? (uint8_t)(GetStreamChunkSize() / STREAM_CHUNK_MIN) : 0x00;
         response[6] = 0x00;
         response[7] = 0x55;  // Response footer
 
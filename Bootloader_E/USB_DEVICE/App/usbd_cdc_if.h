@@ -109,6 +109,7 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_HS;
 uint8_t CDC_Transmit_HS(uint8_t* Buf, uint16_t Len);
 void CDC_ProcessPacket(void);
 void CDC_ClearPacketState(void);  // Clear packet assembly state after reconnect
+void CDC_SetStreamMode(uint32_t frame_size);  // v3.2: chunk frames of frame_size bytes, 0 = packets
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
 
@@ -0,0 +1,210 @@
+#include <checksum.h>
+#include <string.h>
+
+#ifdef CRC_SOFTWARE
+
+#include <stdbool.h>
+
+// Slicing by 8: table k gives the CRC of a byte followed by k zero bytes
+static uint32_t crc32_table[8][256];
+static uint16_t crc16_table[8][256];
+static bool tables_ready = false;
+
+static void make_tables(void)
+{
+	for (uint16_t n = 0; n < 256; n++)
+	{
+		uint32_t c = n;
+		uint16_t h = n << 8;
+
+		for (uint8_t k = 0; k < 8; k++)
+		{
+			c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+			h = (h & 0x8000) ? (h << 1) ^ 0x1021 : h << 1;
+		}
+		crc32_table[0][n] = c;
+		crc16_table[0][n] = h;
+	}
+
+	for (uint16_t n = 0; n < 256; n++)
+		for (uint8_t k = 1; k < 8; k++)
+		{
+			uint32_t c = crc32_table[k - 1][n];
+			uint16_t h = crc16_table[k - 1][n];
+
+			crc32_table[k][n] = (c >> 8) ^ crc32_table[0][c & 0xFF];
+			crc16_table[k][n] = (h << 8) ^ crc16_table[0][h >> 8];
+		}
+
+	tables_ready = true;
+}
+
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+	if (!tables_ready)
+		make_tables();
+
+	for (; length >= 8; data += 8, length -= 8)
+		crc = crc16_table[7][(crc >> 8) ^ data[0]]
+				^ crc16_table[6][(crc & 0xFF) ^ data[1]]
+				^ crc16_table[5][data[2]] ^ crc16_table[4][data[3]]
+				^ crc16_table[3][data[4]] ^ crc16_table[2][data[5]]
+				^ crc16_table[1][data[6]] ^ crc16_table[0][data[7]];
+
+	while (length--)
+		crc = (crc << 8) ^ crc16_table[0][(crc >> 8) ^ *data++];
+
+	return crc;
+}
+
+uint32_t crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	uint32_t c = ~crc;
+
+	if (!tables_ready)
+		make_tables();
+
+	for (; length >= 8; data += 8, length -= 8)
+	{
+		uint32_t lo = c
+				^ (data[0] | data[1] << 8 | data[2] << 16
+						| (uint32_t) data[3] << 24);
+
+		c = crc32_table[7][lo & 0xFF] ^ crc32_table[6][(lo >> 8) & 0xFF]
+				^ crc32_table[5][(lo >> 16) & 0xFF] ^ crc32_table[4][lo >> 24]
+				^ crc32_table[3][data[4]] ^ crc32_table[2][data[5]]
+				^ crc32_table[1][data[6]] ^ crc32_table[0][data[7]];
+	}
+
+	while (length--)
+		c = crc32_table[0][(c ^ *data++) & 0xFF] ^ (c >> 8);
+
+	return ~c;
+}
+
+#else
+
+#include <main.h>
+
+#define CRC_MDMA_CHANNEL	MDMA_Channel15
+#define CRC_MDMA_BLOCK		0xFFFC	// Largest word multiple in one MDMA block
+
+static MDMA_HandleTypeDef hmdma_crc;
+static uint8_t mdma_ready = 0;
+
+// Memory to CRC->DR, one word at a time, started by software
+static HAL_StatusTypeDef crc_mdma_init(void)
+{
+	__HAL_RCC_MDMA_CLK_ENABLE();
+
+	hmdma_crc.Instance = CRC_MDMA_CHANNEL;
+	hmdma_crc.Init.Request = MDMA_REQUEST_SW;
+	hmdma_crc.Init.TransferTriggerMode = MDMA_BLOCK_TRANSFER;
+	hmdma_crc.Init.Priority = MDMA_PRIORITY_LOW;
+	hmdma_crc.Init.Endianness = MDMA_LITTLE_ENDIANNESS_PRESERVE;
+	hmdma_crc.Init.SourceInc = MDMA_SRC_INC_WORD;
+	hmdma_crc.Init.DestinationInc = MDMA_DEST_INC_DISABLE;
+	hmdma_crc.Init.SourceDataSize = MDMA_SRC_DATASIZE_WORD;
+	hmdma_crc.Init.DestDataSize = MDMA_DEST_DATASIZE_WORD;
+	hmdma_crc.Init.DataAlignment = MDMA_DATAALIGN_PACKENABLE;
+	hmdma_crc.Init.BufferTransferLength = 128;
+	hmdma_crc.Init.SourceBurst = MDMA_SOURCE_BURST_SINGLE;
+	hmdma_crc.Init.DestBurst = MDMA_DEST_BURST_SINGLE;
+	hmdma_crc.Init.SourceBlockAddressOffset = 0;
+	hmdma_crc.Init.DestBlockAddressOffset = 0;
+
+	if (HAL_MDMA_Init(&hmdma_crc) != HAL_OK)
+		return HAL_ERROR;
+
+	mdma_ready = 1;
+	return HAL_OK;
+}
+
+// Feed n_words aligned words to CRC->DR by MDMA, false if the CPU must do it
+static uint8_t crc_feed_dma(const uint8_t *data, uint32_t n_words)
+{
+	if (!mdma_ready && crc_mdma_init() != HAL_OK)
+		return 0;
+
+	// MDMA reads memory, not the D-cache
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+		SCB_CleanDCache_by_Addr((uint32_t*) ((uint32_t) data & ~31UL),
+				n_words * 4 + ((uint32_t) data & 31));
+
+	for (uint32_t size = n_words * 4; size > 0;)
+	{
+		uint32_t block = size < CRC_MDMA_BLOCK ? size : CRC_MDMA_BLOCK;
+
+		if (HAL_MDMA_Start(&hmdma_crc, (uint32_t) data, (uint32_t) &CRC->DR,
+				block, 1) != HAL_OK
+				|| HAL_MDMA_PollForTransfer(&hmdma_crc, HAL_MDMA_FULL_TRANSFER,
+						100) != HAL_OK)
+		{
+			HAL_MDMA_Abort(&hmdma_crc);
+			return 0;
+		}
+		data += block;
+		size -= block;
+	}
+
+	return 1;
+}
+
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+	uint32_t word;
+
+	__HAL_RCC_CRC_CLK_ENABLE();
+	CRC->POL = 0x1021;
+	CRC->INIT = crc;
+	CRC->CR = CRC_CR_POLYSIZE_0 | CRC_CR_RESET;	// 16 bit, no reflection
+
+	// MSB first: words go in byte swapped
+	for (; length >= 4; data += 4, length -= 4)
+	{
+		memcpy(&word, data, 4);
+		CRC->DR = __REV(word);
+	}
+	while (length--)
+		*(__IO uint8_t*) &CRC->DR = *data++;
+
+	return (uint16_t) CRC->DR;
+}
+
+uint32_t crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	uint32_t word, state;
+
+	__HAL_RCC_CRC_CLK_ENABLE();
+	CRC->POL = 0x04C11DB7;
+	CRC->INIT = __RBIT(~crc);
+	// Reflected in and out, bytes up to the first aligned word
+	CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
+	for (; length > 0 && ((uint32_t) data & 3); length--)
+		*(__IO uint8_t*) &CRC->DR = *data++;
+
+	// Words: reversing all 32 bits reflects each byte and puts the first
+	// byte in memory first. If MDMA fails the CPU starts the words again.
+	state = __RBIT(CRC->DR);
+	CRC->CR = CRC_CR_REV_IN | CRC_CR_REV_OUT;
+	if (length < CRC_DMA_THRESHOLD || !crc_feed_dma(data, length / 4))
+	{
+		CRC->INIT = state;
+		CRC->CR = CRC_CR_REV_IN | CRC_CR_REV_OUT | CRC_CR_RESET;
+		for (uint32_t i = 0; i < length / 4; i++)
+		{
+			memcpy(&word, data + 4 * i, 4);
+			CRC->DR = word;
+		}
+	}
+	data += length & ~3UL;
+	length &= 3;
+
+	CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT;
+	while (length--)
+		*(__IO uint8_t*) &CRC->DR = *data++;
+
+	return ~CRC->DR;
+}
+
+#endif
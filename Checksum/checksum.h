@@ -0,0 +1,28 @@
+/*
+ * CRC16-CCITT and CRC32 shared by the image upload of the firmware
+ * (image_utility.c), the asset directory checks (assets.c) and the firmware
+ * update of Bootloader_E (bootload.c)
+ *
+ * On target both run on the STM32H7 CRC unit, CRC32 fed by MDMA from
+ * CRC_DMA_THRESHOLD bytes on. Host builds define CRC_SOFTWARE and get a
+ * slicing-by-8 table implementation with bit-exact results.
+ *
+ * Both functions continue from a previous result, so a buffer can be
+ * checked in pieces: start with CRC16_CCITT_INIT / CRC32_INIT.
+ * The CRC unit is not shared with interrupts: call from the main loop only.
+ */
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+#include <stdint.h>
+
+#define CRC16_CCITT_INIT	0xFFFF	// CRC-16/CCITT-FALSE, Calculate_CRC() of the loader protocol
+#define CRC32_INIT			0		// zlib / binascii.crc32() convention
+
+#define CRC_DMA_THRESHOLD	4096	// Smaller buffers are fed by the CPU
+
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, uint32_t length);
+uint32_t crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length);
+
+#endif /* CHECKSUM_H_ */
@@ -0,0 +1,30 @@
+/*
+ * SHA-256 in software (FIPS 180-4)
+ *
+ * Used by the application to check the signature of a staged firmware
+ * image (fw_staging.c): the HASH unit is only set up in Bootloader_E.
+ * Incremental like crc32_ieee(): start, update with the data in pieces of
+ * any size, finish. No hardware, so it also builds on the host.
+ */
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include <stdint.h>
+
+#define SHA256_SIZE			32		// Digest bytes
+#define SHA256_BLOCK_SIZE	64
+
+typedef struct
+{
+	uint32_t state[8];
+	uint64_t length;					// Bytes hashed so far
+	uint8_t block[SHA256_BLOCK_SIZE];	// Partial block
+	uint32_t fill;						// Bytes in block
+} sha256_t;
+
+void sha256_start(sha256_t *ctx);
+void sha256_update(sha256_t *ctx, const uint8_t *data, uint32_t length);
+void sha256_finish(sha256_t *ctx, uint8_t digest[SHA256_SIZE]);
+
+#endif /* SHA256_H_ */
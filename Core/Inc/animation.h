@@ -0,0 +1,50 @@
+/**
+ * @file animation.h
+ * @brief Frame-diff animations stored as assets (boot logo)
+ *
+ * An LSAN animation keeps the first frame and, for every following frame,
+ * only the rectangles that changed (all fields little-endian):
+ *
+ *   header  (16 bytes)
+ *   0       4     magic "LSAN"
+ *   4       2     width
+ *   6       2     height
+ *   8       2     number of frames
+ *   10      2     frame period in ms
+ *   12      2     background colour (RGB565), frame 0 is a diff against it
+ *   14      2     reserved
+ *
+ *   frame   2 bytes: number of rectangles, then for each rectangle
+ *   0       2     x in the frame
+ *   2       2     y in the frame
+ *   4       2     width
+ *   6       2     height
+ *   8       4     size of the image that follows
+ *   12      ...   image: raw RGB565 if the size is 2 * width * height,
+ *                 LSIC (see image_codec.h) if it is smaller
+ *
+ * The player is polled: animation_poll() draws the next frame once it is
+ * due on the HAL tick, so the caller can do other work between frames.
+ * Tools/LeShuffler_Image_Loader.py builds the boot logo animation from
+ * the logo frames.
+ */
+
+#ifndef INC_ANIMATION_H_
+#define INC_ANIMATION_H_
+
+#include <assets.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <utilities.h>
+
+#define ANIMATION_MAGIC				"LSAN"
+#define ANIMATION_HEADER_SIZE		16
+#define ANIMATION_RECT_HEADER_SIZE	12
+#define LOGO_FRAME_PERIOD			4		// ms, about one full logo frame drawn (lcd_emulator)
+#define LOGO_START_DELAY			500		// ms, blank screen before the logo
+
+return_code_t animation_start(asset_id_t, uint16_t, uint16_t, uint32_t);
+bool animation_poll(void);
+void animation_finish(void);
+
+#endif /* INC_ANIMATION_H_ */
@@ -0,0 +1,140 @@
+/**
+ * @file assets.h
+ * @brief Asset directory of the images stored in the external flash
+ *
+ * The first sector of the image region holds a versioned directory that
+ * describes every asset (all fields little-endian):
+ *
+ *   header  (16 bytes)
+ *   0       4     magic ASSET_DIR_MAGIC ("LSAD")
+ *   4       2     version (ASSET_DIR_VERSION)
+ *   6       2     number of entries
+ *   8       4     CRC32 of the entries
+ *   12      4     reserved (0xFFFFFFFF)
+ *
+ *   entry   (20 bytes, one per asset)
+ *   0       2     asset id (asset_id_t)
+ *   2       1     format (asset_format_t)
+ *   3       1     reserved
+ *   4       2     width
+ *   6       2     height
+ *   8       4     offset from the start of the image region
+ *   12      4     stored size in bytes
+ *   16      4     CRC32 of the stored bytes
+ *
+ * CRC32 is the usual reflected 0xEDB88320 polynomial (zlib/binascii).
+ * Assets start on sector boundaries so each one can be erased and
+ * rewritten on its own. asset_init() parses the directory once at boot
+ * into a RAM index; images uploaded before the directory existed are
+ * indexed from their historical fixed layout instead. Entries whose size
+ * or image header disagree with their format and dimensions are ignored
+ * (RGB565: 2 * width * height bytes; LSIC and LSAN: header dimensions).
+ */
+
+#ifndef INC_ASSETS_H_
+#define INC_ASSETS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <utilities.h>
+
+// IMAGES SIZES
+#define LOGO_N_FRAMES 				36
+#define LOGO_W 						340UL
+#define LOGO_H 						102UL
+#define LOGO_SIZE 					(LOGO_W * LOGO_H * 2)
+#define SMALL_LOGO_W 				140UL
+#define SMALL_LOGO_H  				24UL
+#define SMALL_LOGO_SIZE 			(SMALL_LOGO_W * SMALL_LOGO_H * 2)
+#define ICON_W 						40UL
+#define ICON_H 						ICON_W
+#define ICON_SIZE 					(ICON_W * ICON_H * 2)
+#define SILH_W 						200UL  	// Frame is 400
+#define SILH_H 						115UL	// Frame is 117
+#define SILH_SIZE 					(SILH_W * SILH_H * 2)
+#define RESTART_W 					100UL
+#define RESTART_H 					RESTART_W
+#define RESTART_SIZE 				(RESTART_W * RESTART_H * 2)
+
+// IMAGE REGION IN FLASH MEMORY, THESE ARE FLASH - NOT EERAM ADDRESSES
+#define FLASH_FACTORY_OFFSET 		0UL
+#define IMAGE_START_ADDRESS     	(OCTOSPI2_BASE + FLASH_FACTORY_OFFSET)
+
+// ASSET DIRECTORY
+#define ASSET_DIR_MAGIC				0x4441534CUL	// "LSAD"
+#define ASSET_DIR_VERSION			1
+#define ASSET_DIR_SIZE				W25Q_SECTOR_SIZE
+#define ASSET_DIR_HEADER_SIZE		16
+#define ASSET_DIR_ENTRY_SIZE		20
+#define ASSET_DIR_MAX_ENTRIES		((ASSET_DIR_SIZE - ASSET_DIR_HEADER_SIZE) / ASSET_DIR_ENTRY_SIZE)
+#define ASSET_ALIGN					W25Q_SECTOR_SIZE
+
+// asset_id_t, in the order of the historical upload (C_headers sorted by name)
+typedef enum
+{
+	ASSET_LOGO_ANIM = 0, // LOGO_N_FRAMES consecutive frames
+	ASSET_SMALL_LOGO = ASSET_LOGO_ANIM + LOGO_N_FRAMES,
+	ASSET_VOID,
+	ASSET_BACK,
+	ASSET_CARD,
+	ASSET_CHECK,
+	ASSET_CROSS,
+	ASSET_EDIT,
+	ASSET_FLAME,
+	ASSET_PLAYER,
+	ASSET_RED_CARD,
+	ASSET_RED_CROSS,
+	ASSET_SAVE,
+	ASSET_SILH,
+	ASSET_CSO_ENTRY,
+	ASSET_CSO_EXIT,
+	ASSET_CHECK_TRAY,
+	ASSET_CONTENT,
+	ASSET_PICK_UP_CARDS,
+	ASSET_SH_EMPTY,
+	ASSET_SH_FULL,
+	ASSET_TRAY_EMPTY,
+	ASSET_RESTART,
+	N_LEGACY_ASSETS,
+	// Assets that only exist with an asset directory
+	ASSET_LOGO_DELTA = N_LEGACY_ASSETS, // LSAN animation of the logo frames
+	N_ASSETS,
+	ASSET_NONE = 0xFFFF
+} asset_id_t;
+
+// LOGO: LAST FRAME OF ANIMATION
+#define ASSET_LOGO					(ASSET_LOGO_ANIM + LOGO_N_FRAMES - 1)
+
+// asset_format_t
+typedef enum
+{
+	ASSET_FORMAT_RGB565 = 0, ASSET_FORMAT_LSIC = 1, ASSET_FORMAT_LSAN = 2
+} asset_format_t;
+
+// asset_source_t
+typedef enum
+{
+	ASSET_SOURCE_LEGACY, ASSET_SOURCE_DIRECTORY
+} asset_source_t;
+
+// asset_t, RAM index entry
+typedef struct
+{
+	const uint8_t *address;
+	uint32_t size;
+	uint32_t crc;
+	uint16_t width;
+	uint16_t height;
+	asset_format_t format;
+	bool present;
+} asset_t;
+
+return_code_t asset_init(void);
+asset_source_t asset_source(void);
+const asset_t* asset_get(asset_id_t);
+const uint8_t* asset_address(asset_id_t);
+uint32_t asset_region_size(void);
+return_code_t asset_verify(asset_id_t);
+void draw_asset(asset_id_t, uint16_t, uint16_t);
+
+#endif /* INC_ASSETS_H_ */
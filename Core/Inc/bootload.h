@@ -14,6 +14,10 @@
 #define BOOTLOADER_VERSION_ADDR   0x0801FFF0
 #define BOOTLOADER_VERSION_MAGIC  0x424C5652  // "BLVR"
 
+// Bootloader public key location in flash (v3.1+)
+#define BOOTLOADER_KEY_ADDR       0x0801FFE0
+#define BOOTLOADER_KEY_MAGIC      0x4B504C42  // "BLPK"
+
 /**
  * @brief Request entry into bootloader mode
  * Sets flag and resets device
@@ -28,4 +32,12 @@ return_code_t EarlyBootloaderCheck(void);
  */
 uint16_t GetBootloaderVersion(void);
 
+/**
+ * @brief Get the ECDSA P-256 public key the bootloader checks updates with
+ * Reads the key info stored at fixed address by bootloader v3.1+, so staged
+ * firmware is verified against the same key without a copy in the app
+ * @return 64-byte key (x || y) in bootloader flash, or NULL if not exported
+ */
+const uint8_t* GetBootloaderPublicKey(void);
+
 #endif /* INC_BOOTLOAD_H_ */
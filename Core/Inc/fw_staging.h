@@ -0,0 +1,55 @@
+/**
+ * @file fw_staging.h
+ * @brief Background reception of an encrypted firmware update (.sfu)
+ *
+ * The host (Tools/LeShuffler_Updater.py --stage) sends the .sfu to the
+ * running application, which stores it in the W25Q staging area (see
+ * staging.h) between UI events, checks its size, read-back CRC and ECDSA
+ * signature, and only then, on request, resets into Bootloader_E to
+ * install it. The shuffler stays usable during the transfer and the
+ * application flash is only touched once a complete, signed image is
+ * waiting in the external flash.
+ *
+ * Messages are USB_PACKET_SIZE bytes, like the image utility:
+ *   STAGE_BEGIN    [0x21][.sfu header, 100 bytes]...[CRC16 hi][CRC lo]
+ *   STAGE_DATA     [0x22][seq hi][seq lo][size hi][size lo][ciphertext]...[CRC16]
+ *   STAGE_END      [0x23]
+ *   STAGE_INSTALL  [0x24]
+ * with the CRC16 (CCITT) over the bytes after the command. DATA is answered
+ * as in the image utility ([K|N][next expected seq], go-back-N window), the
+ * others with [A][0][0] or [E][error][0] (fw_staging_error_t).
+ *
+ * Needs Bootloader_E 3.1 or later, which installs staged images and
+ * exports its public key (GetBootloaderPublicKey()).
+ */
+
+#ifndef INC_FW_STAGING_H_
+#define INC_FW_STAGING_H_
+
+#define STAGE_BEGIN				0x21
+#define STAGE_DATA				0x22
+#define STAGE_END				0x23
+#define STAGE_INSTALL			0x24
+
+typedef enum
+{
+	STAGING_ERROR_NONE,
+	STAGING_ERROR_HEADER,		// Bad CRC, magic or sizes
+	STAGING_ERROR_BOOTLOADER,	// Bootloader cannot install staged images
+	STAGING_ERROR_FLASH,		// W25Q erase, program or read failed
+	STAGING_ERROR_SIZE,			// END before all the ciphertext arrived
+	STAGING_ERROR_READBACK,		// Stored data differs from what was received
+	STAGING_ERROR_SIGNATURE,	// Not signed with the bootloader key
+	STAGING_ERROR_NOT_STAGED	// INSTALL without a verified image
+} fw_staging_error_t;
+
+/**
+ * @brief Handle at most one pending staging message. Called from the UI
+ *        wait loops only, never while the motors run; other messages are
+ *        dropped. Returns with the flash back in memory-mapped mode, or
+ *        does not return after STAGE_INSTALL.
+ * @retval None
+ */
+void fw_staging_poll(void);
+
+#endif /* INC_FW_STAGING_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file image_codec.h
+ * @brief Compressed RGB565 image format for the external flash
+ *
+ * Images in the W25Q64 are either raw RGB565 (big-endian, as produced by
+ * the image converter) or compressed with the LSIC codec below. The caller
+ * says which: the asset directory records the format of every asset, and
+ * animations tell by the stored size (see animation.h). The magic is only
+ * checked, never used to guess, since raw pixels can spell "LSIC".
+ * Compressed images start with a 12-byte header:
+ *
+ *   offset  size  content
+ *   0       4     magic "LSIC"
+ *   4       4     number of pixels (little-endian)
+ *   8       4     size of the op stream after the header (little-endian)
+ *
+ * The op stream is QOI-like, with one previous pixel and a 64-entry table
+ * of recently seen literals (slot = IMAGE_CODEC_HASH(pixel)):
+ *
+ *   00nnnnnn              run of n+1 previous pixels (1..64)
+ *   01nnnnnn p0 .. pn     n+1 literal pixels, 2 bytes each, big-endian
+ *   10iiiiii              pixel from table slot i
+ *   11nnnnnn mmmmmmmm     run of (n << 8 | m) + 65 previous pixels
+ *
+ * Literals update the table and the previous pixel, table hits update the
+ * previous pixel. The previous pixel and the table start at 0x0000.
+ * Tools/LeShuffler_Image_Loader.py implements the encoder.
+ */
+
+#ifndef INC_IMAGE_CODEC_H_
+#define INC_IMAGE_CODEC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <utilities.h>
+
+#define IMAGE_CODEC_MAGIC			"LSIC"
+#define IMAGE_CODEC_HEADER_SIZE		12
+#define IMAGE_CODEC_HASH(p)			((((p) >> 11) * 3 + (((p) >> 5) & 0x3F) * 5 + ((p) & 0x1F) * 7) & 0x3F)
+
+/**
+ * @brief Check the LSIC header of a compressed image
+ * @param address Start of the image
+ * @param size Stored size, header included
+ * @param n_pixels Number of pixels expected
+ * @return true if the magic, the pixel count and the op stream size match
+ */
+bool image_header_valid(const uint8_t *address, uint32_t size,
+		uint32_t n_pixels);
+
+/**
+ * @brief Draw an image from flash, raw or compressed
+ *
+ * Compressed images are decoded on the fly and streamed to the LCD window:
+ * runs are sent as fills, so only the op stream is read over OSPI.
+ * A compressed image without the LSIC magic or whose pixel count does not
+ * match w * h is not drawn.
+ * @param compressed true for LSIC, false for raw RGB565
+ */
+void draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+		const uint8_t *address, bool compressed);
+
+/**
+ * @brief Decode an image from flash into a RAM framebuffer (host byte order)
+ * @param address Start of the image
+ * @param buffer Destination, n_pixels entries
+ * @param n_pixels Number of pixels expected
+ * @param compressed true for LSIC, false for raw RGB565
+ * @return LS_OK, or LS_ERROR if the stream is malformed or the size differs
+ */
+return_code_t decode_image(const uint8_t *address, uint16_t *buffer,
+		uint32_t n_pixels, bool compressed);
+
+#endif /* INC_IMAGE_CODEC_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @file image_prefetch.h
+ * @brief Background copy of image data from the OCTOSPI window to RAM
+ *
+ * Large raw images are drawn through two RAM line buffers: MDMA fills one
+ * from the memory-mapped flash while the CPU writes the other to the LCD,
+ * so the OSPI read time hides behind the bus writes instead of stalling
+ * the CPU on every cache line fill (see draw_image()).
+ *
+ * One transfer at a time, main loop only. Define IMAGE_NO_PREFETCH to draw
+ * every image straight from the window.
+ */
+
+#ifndef INC_IMAGE_PREFETCH_H_
+#define INC_IMAGE_PREFETCH_H_
+
+#include <stdint.h>
+#include <utilities.h>
+
+#define PREFETCH_LINE_SIZE		1920	// Bytes per buffer: 2 full-width rows, 60 cache lines
+#define PREFETCH_MIN_SIZE		(2 * PREFETCH_LINE_SIZE)	// Smaller images are read directly
+
+/**
+ * @brief Start copying flash to a line buffer
+ * @param buffer Destination, 32-byte aligned, PREFETCH_LINE_SIZE bytes
+ * @param address Source in the flash window, word aligned
+ * @param size Bytes to copy, at most PREFETCH_LINE_SIZE
+ * @return LS_OK, or LS_ERROR if nothing was started (read the flash directly)
+ */
+return_code_t prefetch_start(uint8_t *buffer, const uint8_t *address,
+		uint32_t size);
+
+/**
+ * @brief Wait for the transfer started by prefetch_start()
+ * @return LS_OK once the buffer holds the data, LS_ERROR if the copy failed
+ */
+return_code_t prefetch_wait(void);
+
+#endif /* INC_IMAGE_PREFETCH_H_ */
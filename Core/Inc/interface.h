@@ -12,6 +12,7 @@
 extern "C" {
 #endif
 
+#include <assets.h>
 #include <fonts.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -45,6 +46,8 @@ extern "C" {
 #define LCD_TOP_DOT_X				(LCD_X_TEXT/2 + 2)
 #define LCD_TOP_DOT_Y               (LCD_TOP_ROW + LCD_ROW_HEIGHT/2 + 2)
 #define LCD_N_ROWS 					((BSP_LCD_GetYSize()-LCD_TOP_SPACE-LCD_BOTTOM_SPACE)/LCD_ROW_HEIGHT)
+#define LCD_MAX_N_ROWS				10		// Upper bound of LCD_N_ROWS for static tables
+#define LCD_X_ROW_BOX				(LCD_TOP_DOT_X + 8) // Row text box starts right of dots and checks
 #define LCD_BUFFER_LENGTH			35
 #define LCD_RIGHT_MARGIN    		15
 #define BUTTON_ICON_X       		(BSP_LCD_GetXSize()-ICON_W-LCD_RIGHT_MARGIN)
@@ -61,65 +64,6 @@ extern "C" {
 #define V_ADJUST					50
 #define BUTTON_X_SPACE				20
 
-// IMAGES SIZES
-#define LOGO_N_FRAMES 				36
-#define LOGO_W 						340UL
-#define LOGO_H 						102UL
-#define LOGO_SIZE 					(LOGO_W * LOGO_H * 2)
-#define SMALL_LOGO_W 				140UL
-#define SMALL_LOGO_H  				24UL
-#define SMALL_LOGO_SIZE 			(SMALL_LOGO_W * SMALL_LOGO_H * 2)
-#define ICON_W 						40UL
-#define ICON_H 						ICON_W
-#define ICON_SIZE 					(ICON_W * ICON_H * 2)
-#define SILH_W 						200UL  	// Frame is 400
-#define SILH_H 						115UL	// Frame is 117
-#define SILH_SIZE 					(SILH_W * SILH_H * 2)
-#define RESTART_W 					100UL
-#define RESTART_H 					RESTART_W
-#define RESTART_SIZE 				(RESTART_W * RESTART_H * 2)
-
-// IMAGES ADDRESSES IN FLASH MEMORY, THESE ARE FLASH - NOT EERAM ADDRESSES
-#define FLASH_FACTORY_OFFSET 	0UL
-#define IMAGE_START_ADDRESS     (OCTOSPI2_BASE + FLASH_FACTORY_OFFSET)
-
-/* FINAL VERSION */
-#define LOGO_ANIM_ADDRESS 	    IMAGE_START_ADDRESS
-#define SMALL_LOGO_ADDRESS 	    (LOGO_ANIM_ADDRESS + LOGO_N_FRAMES*LOGO_SIZE)	// AFTER ALL THE ANIMATION FRAMES
-#define VOID_ADDRESS            (SMALL_LOGO_ADDRESS + SMALL_LOGO_SIZE)
-#define BACK_ADDRESS            (VOID_ADDRESS + ICON_SIZE)
-#define CARD_ADDRESS		    (BACK_ADDRESS + ICON_SIZE)
-#define CHECK_ADDRESS		    (CARD_ADDRESS + ICON_SIZE)
-#define CROSS_ADDRESS		    (CHECK_ADDRESS + ICON_SIZE)
-#define EDIT_ADDRESS			(CROSS_ADDRESS + ICON_SIZE)
-#define FLAME_ADDRESS		    (EDIT_ADDRESS + ICON_SIZE)
-#define PLAYER_ADDRESS		    (FLAME_ADDRESS + ICON_SIZE)
-#define RED_CARD_ADDRESS        (PLAYER_ADDRESS + ICON_SIZE)
-#define RED_CROSS_ADDRESS       (RED_CARD_ADDRESS + ICON_SIZE)
-#define SAVE_ADDRESS       		(RED_CROSS_ADDRESS + ICON_SIZE)
-#define SILH_ADDRESS		    (SAVE_ADDRESS + ICON_SIZE)
-#define CSO_ENTRY_ADDRESS     	(SILH_ADDRESS + SILH_SIZE)
-#define CSO_EXIT_ADDRESS     	(CSO_ENTRY_ADDRESS + SILH_SIZE)
-#define CHECK_TRAY_ADDRESS     	(CSO_EXIT_ADDRESS + SILH_SIZE)
-#define CONTENT_ADDRESS     	(CHECK_TRAY_ADDRESS + SILH_SIZE)
-#define PICK_UP_CARDS_ADDRESS   (CONTENT_ADDRESS + SILH_SIZE)
-#define SH_EMPTY_ADDRESS    	(PICK_UP_CARDS_ADDRESS + SILH_SIZE)
-#define SH_FULL_ADDRESS			(SH_EMPTY_ADDRESS + SILH_SIZE)
-#define TRAY_EMPTY_ADDRESS     	(SH_FULL_ADDRESS + SILH_SIZE)
-#define RESTART_ADDRESS     	(TRAY_EMPTY_ADDRESS + SILH_SIZE)
-#define FLASH_CURRENT_OFFSET    (RESTART_ADDRESS + RESTART_SIZE)
-
-/*
- * FLASH_CURRENT_OFFSET is the expected value of the first free address in the flash memory
- * this should coincide with the value stored in EERAM_FLASH_OFFSET by image_utility()
- *
- * FLASH_CURRENT_OFFSET = 0x7028D890
- * Taken: 0x28D890/0x2000000 (2.676.880/33.554.432 or 32 MBytes)
- * */
-
-// LOGO: TAKE LAST FRAME OF ANIMATION
-#define LOGO_ADDRESS		(LOGO_ANIM_ADDRESS + (LOGO_N_FRAMES-1)*LOGO_SIZE)
-
 // context_t
 typedef enum
 {
@@ -165,7 +109,7 @@ typedef enum
 typedef struct
 {
 	icon_code_t code;
-	uint8_t *address;
+	asset_id_t asset;
 } icon_t;
 
 // icon_set_t
@@ -209,6 +153,7 @@ typedef struct
 
 //
 return_code_t set_dynamic_menu(menu_t*);
+void start_animated_logo(void);
 void prompt_animated_logo(void);
 return_code_t interface_init(void);
 void atomic_prompt(return_code_t, char*, uint8_t, prompt_mode_t,
@@ -255,7 +200,7 @@ void prompt_double_deck(void);
 void hide_n_cards_in(void);
 void hide_double_deck(void);
 return_code_t set_param_sub_menu(item_code_t, item_code_t);
-uint8_t* icon_address(icon_code_t);
+asset_id_t icon_asset(icon_code_t);
 void prompt_uid(void);
 void prompt_firmware_version(void);
 return_code_t prompt_tally(void);
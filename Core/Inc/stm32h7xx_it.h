@@ -64,6 +64,7 @@ void EXTI15_10_IRQHandler(void);
 void TIM8_BRK_TIM12_IRQHandler(void);
 void OTG_HS_IRQHandler(void);
 void TIM15_IRQHandler(void);
+void OCTOSPI2_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
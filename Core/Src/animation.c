@@ -0,0 +1,173 @@
+/**
+ * @file animation.c
+ * @brief Polled player for LSAN frame-diff animations (see animation.h)
+ */
+
+#include <animation.h>
+#include <image_codec.h>
+#include <iwdg.h>
+#include <stm32_adafruit_lcd.h>
+#include <string.h>
+
+// animation_t, state of the single player
+typedef struct
+{
+	const uint8_t *next;		// Next frame record (LSAN)
+	const uint8_t *end;
+	asset_id_t frames;			// First full frame asset (legacy), else ASSET_NONE
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+	uint16_t frame;
+	uint16_t n_frames;
+	uint16_t period;
+	uint32_t due;
+	bool running;
+} animation_t;
+
+static animation_t anim;
+
+static uint16_t read_le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// Draw the changed rectangles of one LSAN frame, LS_ERROR if the record is malformed
+static return_code_t draw_frame_rects(void)
+{
+	const uint8_t *p = anim.next;
+	uint16_t n_rects;
+
+	if (p + 2 > anim.end)
+		return LS_ERROR;
+	n_rects = read_le16(p);
+	p += 2;
+
+	for (uint16_t i = 0; i < n_rects; i++)
+	{
+		if (p + ANIMATION_RECT_HEADER_SIZE > anim.end)
+			return LS_ERROR;
+
+		uint16_t x = read_le16(p);
+		uint16_t y = read_le16(p + 2);
+		uint16_t w = read_le16(p + 4);
+		uint16_t h = read_le16(p + 6);
+		uint32_t size = read_le32(p + 8);
+		uint32_t n_pixels = (uint32_t) w * h;
+		p += ANIMATION_RECT_HEADER_SIZE;
+
+		// Raw if exactly 2 bytes per pixel, LSIC (always smaller) otherwise
+		bool compressed = size < 2 * n_pixels;
+
+		if (size > (uint32_t) (anim.end - p) || x + w > anim.width
+				|| y + h > anim.height || w == 0 || h == 0
+				|| size > 2 * n_pixels
+				|| (compressed && !image_header_valid(p, size, n_pixels)))
+			return LS_ERROR;
+
+		draw_image(anim.x + x, anim.y + y, w, h, p, compressed);
+		p += size;
+	}
+
+	anim.next = p;
+
+	return LS_OK;
+}
+
+/**
+ * @brief Start playing an animation asset at (x, y)
+ *
+ * Without an LSAN asset (legacy image layout) the boot logo frames
+ * ASSET_LOGO_ANIM.. are played as full frames instead.
+ * @param id LSAN asset
+ * @param x, y Top left corner on screen
+ * @param delay Time before the first frame, ms
+ * @retval LS_OK, LS_ERROR if nothing can be played
+ */
+return_code_t animation_start(asset_id_t id, uint16_t x, uint16_t y,
+		uint32_t delay)
+{
+	const asset_t *asset = asset_get(id);
+
+	memset(&anim, 0, sizeof(anim));
+	anim.x = x;
+	anim.y = y;
+	anim.frames = ASSET_NONE;
+	anim.due = HAL_GetTick() + delay;
+
+	if (asset != NULL && asset->format == ASSET_FORMAT_LSAN
+			&& asset->size >= ANIMATION_HEADER_SIZE
+			&& memcmp(asset->address, ANIMATION_MAGIC, 4) == 0)
+	{
+		const uint8_t *h = asset->address;
+
+		anim.width = read_le16(h + 4);
+		anim.height = read_le16(h + 6);
+		anim.n_frames = read_le16(h + 8);
+		anim.period = read_le16(h + 10);
+		anim.next = h + ANIMATION_HEADER_SIZE;
+		anim.end = h + asset->size;
+
+		// Frame 0 is a diff against the background colour
+		uint16_t text_color = BSP_LCD_GetTextColor();
+		BSP_LCD_SetTextColor(read_le16(h + 12));
+		BSP_LCD_FillRect(x, y, anim.width, anim.height);
+		BSP_LCD_SetTextColor(text_color);
+	}
+	else if (id == ASSET_LOGO_DELTA && asset_get(ASSET_LOGO_ANIM) != NULL)
+	{
+		anim.frames = ASSET_LOGO_ANIM;
+		anim.width = LOGO_W;
+		anim.height = LOGO_H;
+		anim.n_frames = LOGO_N_FRAMES;
+		anim.period = LOGO_FRAME_PERIOD;
+	}
+	else
+		return LS_ERROR;
+
+	anim.running = anim.n_frames > 0;
+
+	return LS_OK;
+}
+
+/**
+ * @brief Draw the next frame if it is due
+ * @retval true while frames remain
+ */
+bool animation_poll(void)
+{
+	if (!anim.running)
+		return false;
+
+	if ((int32_t) (HAL_GetTick() - anim.due) < 0)
+		return true;
+
+	if (anim.frames != ASSET_NONE)
+		draw_asset(anim.frames + anim.frame, anim.x, anim.y);
+	else if (draw_frame_rects() != LS_OK)
+	{
+		// Corrupted record: stop rather than draw garbage
+		anim.running = false;
+		return false;
+	}
+
+	// Pace on the schedule, not on the end of the previous frame
+	anim.due += anim.period;
+	if (++anim.frame >= anim.n_frames)
+		anim.running = false;
+
+	return anim.running;
+}
+
+// Play the remaining frames
+void animation_finish(void)
+{
+	while (animation_poll())
+		watchdog_refresh();
+}
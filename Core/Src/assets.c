@@ -0,0 +1,249 @@
+/**
+ * @file assets.c
+ * @brief RAM index of the images in the external flash (see assets.h)
+ */
+
+#include <animation.h>
+#include <assets.h>
+#include <checksum.h>
+#include <image_codec.h>
+#include <rollback.h>
+#include <stm32_adafruit_lcd.h>
+#include <string.h>
+
+static asset_t asset_index[N_ASSETS];
+static asset_source_t source = ASSET_SOURCE_LEGACY;
+static uint32_t region_size;
+
+static uint16_t read_le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// Dimensions of the slot an asset is drawn in, those of the layout used
+// before the directory existed
+static void slot_dimensions(asset_id_t id, uint16_t *width, uint16_t *height)
+{
+	if (id < ASSET_SMALL_LOGO || id == ASSET_LOGO_DELTA)
+	{
+		*width = LOGO_W;
+		*height = LOGO_H;
+	}
+	else if (id == ASSET_SMALL_LOGO)
+	{
+		*width = SMALL_LOGO_W;
+		*height = SMALL_LOGO_H;
+	}
+	else if (id < ASSET_SILH)
+	{
+		*width = ICON_W;
+		*height = ICON_H;
+	}
+	else if (id < ASSET_RESTART)
+	{
+		*width = SILH_W;
+		*height = SILH_H;
+	}
+	else
+	{
+		*width = RESTART_W;
+		*height = RESTART_H;
+	}
+}
+
+/*
+ * Images used to be uploaded back to back in asset_id_t order, at addresses
+ * fixed at compile time; EERAM_FLASH_OFFSET then holds region_size
+ */
+static void load_legacy(void)
+{
+	uint32_t offset = 0;
+
+	for (asset_id_t id = 0; id < N_LEGACY_ASSETS; id++)
+	{
+		asset_t *asset = &asset_index[id];
+
+		slot_dimensions(id, &asset->width, &asset->height);
+		asset->address = (const uint8_t*) IMAGE_START_ADDRESS + offset;
+		asset->size = 2UL * asset->width * asset->height;
+		asset->crc = 0;
+		// LSIC uploads always write the directory
+		asset->format = ASSET_FORMAT_RGB565;
+		asset->present = true;
+		offset += asset->size;
+	}
+
+	region_size = offset;
+	source = ASSET_SOURCE_LEGACY;
+}
+
+// Dimensions within the asset's slot, stored size and header consistent
+// with its format and dimensions
+static bool entry_is_consistent(asset_id_t id, const asset_t *asset)
+{
+	const uint8_t *p = asset->address;
+	uint32_t n_pixels = (uint32_t) asset->width * asset->height;
+	uint16_t slot_width, slot_height;
+
+	slot_dimensions(id, &slot_width, &slot_height);
+	if (n_pixels == 0 || asset->width > slot_width
+			|| asset->height > slot_height)
+		return false;
+
+	switch (asset->format)
+	{
+		case ASSET_FORMAT_RGB565:
+			return asset->size == 2 * n_pixels;
+
+		case ASSET_FORMAT_LSIC:
+			return image_header_valid(p, asset->size, n_pixels)
+					&& read_le32(p + 8) == asset->size - IMAGE_CODEC_HEADER_SIZE;
+
+		case ASSET_FORMAT_LSAN:
+			return asset->size >= ANIMATION_HEADER_SIZE
+					&& memcmp(p, ANIMATION_MAGIC, 4) == 0
+					&& read_le16(p + 4) == asset->width
+					&& read_le16(p + 6) == asset->height;
+
+		default:
+			return false;
+	}
+}
+
+static return_code_t load_directory(void)
+{
+	const uint8_t *dir = (const uint8_t*) IMAGE_START_ADDRESS;
+	const uint8_t *entry = dir + ASSET_DIR_HEADER_SIZE;
+	uint16_t n_entries = read_le16(dir + 6);
+
+	if (read_le32(dir) != ASSET_DIR_MAGIC
+			|| read_le16(dir + 4) != ASSET_DIR_VERSION
+			|| n_entries > ASSET_DIR_MAX_ENTRIES)
+		return LS_ERROR;
+
+	if (crc32_ieee(CRC32_INIT, entry, n_entries * ASSET_DIR_ENTRY_SIZE)
+			!= read_le32(dir + 8))
+		return LS_ERROR;
+
+	region_size = ASSET_DIR_SIZE;
+	for (uint16_t i = 0; i < n_entries; i++, entry += ASSET_DIR_ENTRY_SIZE)
+	{
+		uint16_t id = read_le16(entry);
+		uint32_t offset = read_le32(entry + 8);
+		uint32_t size = read_le32(entry + 12);
+
+		// Ignore assets unknown to this firmware and entries out of the
+		// image region (the rollback slot and staging area follow it)
+		if (id >= N_ASSETS || offset < ASSET_DIR_SIZE
+				|| offset + size > ROLLBACK_OFFSET - FLASH_FACTORY_OFFSET
+				|| offset + size < offset)
+			continue;
+
+		asset_t candidate =
+		{ 0 };
+		candidate.address = (const uint8_t*) IMAGE_START_ADDRESS + offset;
+		candidate.size = size;
+		candidate.crc = read_le32(entry + 16);
+		candidate.format = (asset_format_t) entry[2];
+		candidate.width = read_le16(entry + 4);
+		candidate.height = read_le16(entry + 6);
+		candidate.present = true;
+
+		// Drawing trusts width and height: drop entries that contradict them
+		// or would draw outside the slot
+		if (!entry_is_consistent(id, &candidate))
+			continue;
+
+		asset_index[id] = candidate;
+
+		if (offset + size > region_size)
+			region_size = offset + size;
+	}
+
+	source = ASSET_SOURCE_DIRECTORY;
+
+	return LS_OK;
+}
+
+/**
+ * @brief Build the RAM index, flash must be memory mapped
+ * @retval LS_OK if the directory was found, LS_ERROR if the legacy layout is used
+ */
+return_code_t asset_init(void)
+{
+	memset(asset_index, 0, sizeof(asset_index));
+
+	if (load_directory() == LS_OK)
+		return LS_OK;
+
+	memset(asset_index, 0, sizeof(asset_index));
+	load_legacy();
+
+	return LS_ERROR;
+}
+
+asset_source_t asset_source(void)
+{
+	return source;
+}
+
+// NULL if the asset is not in flash
+const asset_t* asset_get(asset_id_t id)
+{
+	if (id >= N_ASSETS || !asset_index[id].present)
+		return NULL;
+
+	return &asset_index[id];
+}
+
+const uint8_t* asset_address(asset_id_t id)
+{
+	const asset_t *asset = asset_get(id);
+
+	return asset ? asset->address : NULL;
+}
+
+// Bytes used in the image region, directory included
+uint32_t asset_region_size(void)
+{
+	return region_size;
+}
+
+/**
+ * @brief Check the stored bytes of an asset against its directory CRC
+ * @retval LS_OK, INVALID_CHOICE if no CRC is known (legacy layout),
+ *         LS_ERROR if missing or corrupted
+ */
+return_code_t asset_verify(asset_id_t id)
+{
+	const asset_t *asset = asset_get(id);
+
+	if (asset == NULL)
+		return LS_ERROR;
+
+	if (source != ASSET_SOURCE_DIRECTORY)
+		return INVALID_CHOICE;
+
+	return crc32_ieee(CRC32_INIT, asset->address, asset->size) == asset->crc ?
+			LS_OK : LS_ERROR;
+}
+
+// Draw an image asset at its stored size, missing assets, animations and
+// images that do not fit on the screen at (x, y) are skipped
+void draw_asset(asset_id_t id, uint16_t x, uint16_t y)
+{
+	const asset_t *asset = asset_get(id);
+
+	if (asset == NULL || asset->format == ASSET_FORMAT_LSAN
+			|| (uint32_t) x + asset->width > BSP_LCD_GetXSize()
+			|| (uint32_t) y + asset->height > BSP_LCD_GetYSize())
+		return;
+
+	draw_image(x, y, asset->width, asset->height, asset->address,
+			asset->format == ASSET_FORMAT_LSIC);
+}
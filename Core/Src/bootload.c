@@ -294,3 +294,27 @@ uint16_t GetBootloaderVersion(void)
     }
     return *(volatile uint16_t*)BOOTLOADER_VERSION_ADDR;
 }
+
+/**
+ * @brief Get the bootloader public key from flash
+ * Key info struct layout at 0x0801FFE0:
+ * uint32_t magic "BLPK" (offset 0)
+ * uint16_t key version (offset 4)
+ * uint16_t reserved (offset 6)
+ * const uint8_t *public_key (offset 8), inside the bootloader sector
+ * @return 64-byte public key, or NULL if not found/old bootloader
+ */
+const uint8_t* GetBootloaderPublicKey(void)
+{
+    uint32_t magic = *(volatile uint32_t*)BOOTLOADER_KEY_ADDR;
+    uint32_t key = *(volatile uint32_t*)(BOOTLOADER_KEY_ADDR + 8);
+
+    if (magic != BOOTLOADER_KEY_MAGIC) {
+        return NULL;
+    }
+    // Key must lie in the bootloader sector, before the key info
+    if (key < 0x08000000 || key + 64 > BOOTLOADER_KEY_ADDR) {
+        return NULL;
+    }
+    return (const uint8_t*)key;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file fw_staging.c
+ * @brief Background reception of an encrypted firmware update (see fw_staging.h)
+ */
+
+#include <utilities.h>
+#include <bootload.h>
+#include <checksum.h>
+#include <fw_staging.h>
+#include <iwdg.h>
+#include <octospi.h>
+#include <sha256.h>
+#include <staging.h>
+#include <string.h>
+#include <uECC.h>
+#include <usbd_cdc_if.h>
+#include <W25Q64.h>
+
+#define ACK						0x41	//A
+#define ERROR					0x45	//E
+#define WINDOWACK				0x4B	//K
+#define NAK						0x4E	//N
+
+#define DATA_HEADER_SIZE		5
+#define DATA_PAYLOAD_SIZE		(USB_PACKET_SIZE - DATA_HEADER_SIZE - 2)
+#define REPLY_SIZE				3
+#define READBACK_SIZE			2048
+
+typedef enum
+{
+	STAGING_IDLE,
+	STAGING_RECEIVING,		// After BEGIN, payload being written
+	STAGING_VERIFIED		// Record written, ready to install
+} staging_state_t;
+
+static staging_state_t state = STAGING_IDLE;
+static staging_record_t record;
+static uint32_t received;			// Ciphertext bytes stored
+static uint32_t erased_end;			// First payload byte not erased yet
+static uint32_t received_crc;		// CRC32 of the ciphertext as received
+static uint16_t expected_seq;
+static bool nak_sent;
+static uint8_t readback[READBACK_SIZE];
+// Alternate reply buffers, one may still be in flight on the IN endpoint
+static uint8_t reply[2][REPLY_SIZE];
+static uint8_t reply_index = 0;
+
+static void send_reply(uint8_t type, uint8_t b1, uint8_t b2)
+{
+	uint32_t start = HAL_GetTick();
+
+	reply[reply_index][0] = type;
+	reply[reply_index][1] = b1;
+	reply[reply_index][2] = b2;
+	// The host waits for every reply: retry briefly if the endpoint is busy
+	while (CDC_Transmit_HS(reply[reply_index], REPLY_SIZE) == USBD_BUSY
+			&& HAL_GetTick() - start < 100)
+		;
+	reply_index ^= 1;
+}
+
+static void reply_seq(uint8_t type)
+{
+	send_reply(type, expected_seq >> 8, expected_seq & 0xFF);
+}
+
+static void reply_status(fw_staging_error_t error)
+{
+	if (error == STAGING_ERROR_NONE)
+		send_reply(ACK, 0, 0);
+	else
+		send_reply(ERROR, error, 0);
+}
+
+// The UI reads images through the memory-mapped window: switch to indirect
+// mode for a staging step and back once the flash is idle again
+static void flash_indirect(void)
+{
+	HAL_OSPI_Abort(&hospi2);
+}
+
+// [address, address + size) is what the step erased or programmed: the
+// window is cached, the lines of that range are dropped
+static void flash_mapped(uint32_t address, uint32_t size)
+{
+	W25Q64_OSPI_AutoPollingMemReady(&hospi2);
+	W25Q64_OSPI_EnableMemoryMappedMode(&hospi2);
+	W25Q64_OSPI_InvalidateMapped(&hospi2, address, size);
+}
+
+static bool crc_valid(const uint8_t *message, uint32_t size)
+{
+	return crc16_ccitt(CRC16_CCITT_INIT, message + 1, size)
+			== ((message[USB_PACKET_SIZE - 2] << 8)
+					| message[USB_PACKET_SIZE - 1]);
+}
+
+static fw_staging_error_t stage_begin(const uint8_t *message)
+{
+	HAL_StatusTypeDef status;
+
+	state = STAGING_IDLE;
+	if (!crc_valid(message, sizeof(SFU_Header_t)))
+		return STAGING_ERROR_HEADER;
+	memcpy(&record.header, message + 1, sizeof(SFU_Header_t));
+	if (!staging_header_valid(&record.header))
+		return STAGING_ERROR_HEADER;
+	if (GetBootloaderPublicKey() == NULL)
+		return STAGING_ERROR_BOOTLOADER;
+
+	// Forget any image staged before: the payload is about to change
+	flash_indirect();
+	status = staging_clear(&hospi2);
+	flash_mapped(STAGING_OFFSET, W25Q_SECTOR_SIZE);
+	if (status != HAL_OK)
+		return STAGING_ERROR_FLASH;
+
+	received = 0;
+	received_crc = CRC32_INIT;
+	erased_end = STAGING_PAYLOAD_OFFSET;
+	expected_seq = 0;
+	nak_sent = false;
+	state = STAGING_RECEIVING;
+
+	return STAGING_ERROR_NONE;
+}
+
+// Erase the sectors [address, end) needs just before they are written, one
+// 4 KB sector at a time so the UI is never held for a whole block
+static HAL_StatusTypeDef store(const uint8_t *data, uint32_t address,
+		uint32_t size)
+{
+	while (erased_end < address + size)
+	{
+		if (W25Q64_OSPI_EraseBlockStart(&hospi2, erased_end, W25Q_SECTOR_SIZE)
+				!= HAL_OK)
+			return HAL_ERROR;
+		erased_end += W25Q_SECTOR_SIZE;
+		watchdog_refresh();
+	}
+
+	if (W25Q64_OSPI_WriteStart(&hospi2, (uint8_t*) data, address, size)
+			!= HAL_OK)
+		return HAL_ERROR;
+
+	return W25Q64_OSPI_WaitWrite(&hospi2);
+}
+
+static void stage_data(const uint8_t *message)
+{
+	uint16_t seq = (message[1] << 8) | message[2];
+	uint16_t size = (message[3] << 8) | message[4];
+	uint32_t address = STAGING_PAYLOAD_OFFSET + received;
+	HAL_StatusTypeDef status;
+
+	if (state != STAGING_RECEIVING)
+	{
+		reply_seq(NAK);
+		return;
+	}
+
+	// Already stored (host resent after a lost reply): acknowledge again
+	if (seq != expected_seq && (uint16_t) (expected_seq - seq) <= 0x8000)
+	{
+		reply_seq(WINDOWACK);
+		return;
+	}
+
+	if (seq != expected_seq || size > DATA_PAYLOAD_SIZE
+			|| size > record.header.firmware_size - received
+			|| !crc_valid(message, DATA_HEADER_SIZE - 1 + size))
+	{
+		// Packets already in flight behind this one are dropped silently
+		if (!nak_sent)
+		{
+			nak_sent = true;
+			reply_seq(NAK);
+		}
+		return;
+	}
+
+	// Sectors up to erased_end are erased just before they are written
+	flash_indirect();
+	status = store(message + DATA_HEADER_SIZE, address, size);
+	flash_mapped(address,
+			(erased_end > address + size ? erased_end : address + size)
+					- address);
+	if (status != HAL_OK)
+	{
+		if (!nak_sent)
+		{
+			nak_sent = true;
+			reply_seq(NAK);
+		}
+		return;
+	}
+
+	received_crc = crc32_ieee(received_crc, message + DATA_HEADER_SIZE, size);
+	received += size;
+	expected_seq++;
+	nak_sent = false;
+	reply_seq(WINDOWACK);
+}
+
+// Hash what the flash really holds, so the signature covers the stored
+// image and not only the USB data
+static fw_staging_error_t verify_stored(void)
+{
+	static uint8_t hash[SHA256_SIZE];
+	static sha256_t sha;
+	const uint8_t *public_key = GetBootloaderPublicKey();
+	uint32_t crc = CRC32_INIT;
+
+	if (public_key == NULL)
+		return STAGING_ERROR_BOOTLOADER;
+
+	sha256_start(&sha);
+	for (uint32_t offset = 0; offset < received; offset += READBACK_SIZE)
+	{
+		uint32_t size =
+				received - offset < READBACK_SIZE ?
+						received - offset : READBACK_SIZE;
+
+		if (W25Q64_OSPI_Read(&hospi2, readback, STAGING_PAYLOAD_OFFSET + offset,
+				size) != HAL_OK)
+			return STAGING_ERROR_FLASH;
+		crc = crc32_ieee(crc, readback, size);
+		sha256_update(&sha, readback, size);
+		watchdog_refresh();
+	}
+	sha256_finish(&sha, hash);
+
+	if (crc != received_crc)
+		return STAGING_ERROR_READBACK;
+	if (!uECC_verify(public_key, hash, SHA256_SIZE, record.header.signature,
+			uECC_secp256r1()))
+		return STAGING_ERROR_SIGNATURE;
+
+	record.payload_crc = crc;
+	if (staging_write_record(&hospi2, &record) != HAL_OK)
+		return STAGING_ERROR_FLASH;
+
+	return STAGING_ERROR_NONE;
+}
+
+static fw_staging_error_t stage_end(void)
+{
+	fw_staging_error_t error;
+
+	if (state != STAGING_RECEIVING
+			|| received != record.header.firmware_size)
+		return STAGING_ERROR_SIZE;
+
+	flash_indirect();
+	error = verify_stored();
+	flash_mapped(STAGING_OFFSET, sizeof(staging_record_t));
+
+	state = error == STAGING_ERROR_NONE ? STAGING_VERIFIED : STAGING_IDLE;
+	return error;
+}
+
+static fw_staging_error_t stage_install(void)
+{
+	staging_record_t stored;
+	HAL_StatusTypeDef status;
+
+	// The record in flash decides, not the state: it also covers an image
+	// verified before the last reset
+	flash_indirect();
+	status = staging_read_record(&hospi2, &stored);
+	flash_mapped(0, 0);		// Nothing written
+	if (status != HAL_OK)
+		return STAGING_ERROR_NOT_STAGED;
+	if (GetBootloaderPublicKey() == NULL)
+		return STAGING_ERROR_BOOTLOADER;
+
+	return STAGING_ERROR_NONE;
+}
+
+// Bootloader_E checks BKP0R first thing and installs the staged image
+static void request_install(void)
+{
+	RCC->APB4ENR |= RCC_APB4ENR_RTCAPBEN;
+	__DSB();
+	PWR->CR1 |= PWR_CR1_DBP;
+	while ((PWR->CR1 & PWR_CR1_DBP) == 0)
+	{
+	}
+	RTC->BKP0R = STAGING_INSTALL_MAGIC;
+	NVIC_SystemReset();
+}
+
+void fw_staging_poll(void)
+{
+	uint8_t *message;
+	uint32_t length;
+	fw_staging_error_t error;
+
+	if ((message = CDC_Message_HS(&length)) == NULL)
+		return;
+
+	// Every command is one full packet, anything else is not ours
+	if (length != USB_PACKET_SIZE)
+	{
+		CDC_Release_Message_HS();
+		return;
+	}
+
+	switch (message[0])
+	{
+		case STAGE_BEGIN:
+			reply_status(stage_begin(message));
+			break;
+
+		case STAGE_DATA:
+			stage_data(message);
+			break;
+
+		case STAGE_END:
+			reply_status(stage_end());
+			break;
+
+		case STAGE_INSTALL:
+			error = stage_install();
+			reply_status(error);
+			if (error == STAGING_ERROR_NONE)
+			{
+				// Let the reply leave before the USB goes down
+				HAL_Delay(100);
+				request_install();
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	CDC_Release_Message_HS();
+}
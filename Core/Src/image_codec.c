@@ -0,0 +1,242 @@
+/**
+ * @file image_codec.c
+ * @brief Streaming decoder for LSIC-compressed RGB565 images (see image_codec.h)
+ */
+
+#include <ili9488.h>
+#include <image_codec.h>
+#include <image_prefetch.h>
+#include <stm32_adafruit_lcd.h>
+#include <string.h>
+
+#define CHUNK_PIXELS		256		// Pixels staged before a burst to the sink
+#define MIN_FILL_RUN		8		// Shorter runs are staged with the literals
+
+// Output of the decoder: runs are filled, staged pixels are written in bursts
+typedef struct
+{
+	void (*fill)(uint16_t pixel, uint32_t count);
+	void (*write)(uint16_t *pixels, uint32_t count);
+} image_sink_t;
+
+static uint16_t *frame_ptr;
+
+static void lcd_fill(uint16_t pixel, uint32_t count)
+{
+	LCD_IO_WriteDataFill16(pixel, count);
+}
+
+static void lcd_write(uint16_t *pixels, uint32_t count)
+{
+	LCD_IO_WriteMultipleData16(pixels, count);
+}
+
+static void frame_fill(uint16_t pixel, uint32_t count)
+{
+	while (count--)
+		*frame_ptr++ = pixel;
+}
+
+static void frame_write(uint16_t *pixels, uint32_t count)
+{
+	memcpy(frame_ptr, pixels, count * sizeof(uint16_t));
+	frame_ptr += count;
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+bool image_header_valid(const uint8_t *address, uint32_t size,
+		uint32_t n_pixels)
+{
+	return size >= IMAGE_CODEC_HEADER_SIZE
+			&& memcmp(address, IMAGE_CODEC_MAGIC, 4) == 0
+			&& read_le32(address + 4) == n_pixels
+			&& read_le32(address + 8) <= size - IMAGE_CODEC_HEADER_SIZE;
+}
+
+// Decode the op stream of a compressed image into a sink
+static return_code_t decode_stream(const uint8_t *address, uint32_t n_pixels,
+		const image_sink_t *sink)
+{
+	static uint16_t chunk[CHUNK_PIXELS];
+	uint16_t index[64] =
+	{ 0 };
+	const uint8_t *p = address + IMAGE_CODEC_HEADER_SIZE;
+	const uint8_t *end = p + read_le32(address + 8);
+	uint32_t n_chunk = 0;
+	uint32_t done = 0;
+	uint16_t prev = 0;
+	return_code_t status = LS_OK;
+
+#define STAGE(px)	{ chunk[n_chunk++] = (px); \
+					  if (n_chunk == CHUNK_PIXELS) { sink->write(chunk, n_chunk); n_chunk = 0; } }
+
+	if (read_le32(address + 4) != n_pixels)
+		return LS_ERROR;
+
+	while (p < end && done < n_pixels)
+	{
+		uint8_t op = *p++;
+		uint32_t run;
+
+		switch (op & 0xC0)
+		{
+			case 0x00:
+				// Short run
+				run = (op & 0x3F) + 1;
+				break;
+
+			case 0xC0:
+				// Long run
+				if (p >= end)
+				{
+					status = LS_ERROR;
+					goto _EXIT;
+				}
+				run = (((op & 0x3F) << 8) | *p++) + 65;
+				break;
+
+			case 0x40:
+				// Literals
+				run = (op & 0x3F) + 1;
+				if (p + 2 * run > end || done + run > n_pixels)
+				{
+					status = LS_ERROR;
+					goto _EXIT;
+				}
+				done += run;
+				while (run--)
+				{
+					prev = (p[0] << 8) | p[1];
+					p += 2;
+					index[IMAGE_CODEC_HASH(prev)] = prev;
+					STAGE(prev);
+				}
+				continue;
+
+			default:
+				// Table hit
+				prev = index[op & 0x3F];
+				done++;
+				STAGE(prev);
+				continue;
+		}
+
+		if (done + run > n_pixels)
+		{
+			status = LS_ERROR;
+			goto _EXIT;
+		}
+		done += run;
+
+		if (run >= MIN_FILL_RUN)
+		{
+			if (n_chunk)
+			{
+				sink->write(chunk, n_chunk);
+				n_chunk = 0;
+			}
+			sink->fill(prev, run);
+		}
+		else
+			while (run--)
+				STAGE(prev);
+	}
+
+	if (done != n_pixels)
+		status = LS_ERROR;
+
+	_EXIT:
+
+	if (n_chunk)
+		sink->write(chunk, n_chunk);
+
+#undef STAGE
+
+	return status;
+}
+
+// Raw image through the line buffers: MDMA reads the next one from flash
+// while the current one goes to the LCD. Small images, unaligned ones and
+// MDMA failures read the rest straight from the flash window.
+static void draw_raw(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+		const uint8_t *address)
+{
+	static ALIGN_32BYTES(uint8_t line[2][PREFETCH_LINE_SIZE]);
+	uint32_t size = 2 * (uint32_t) w * h;
+	uint32_t chunk, next;
+	uint8_t current = 0;
+
+#ifndef IMAGE_NO_PREFETCH
+	if (size < PREFETCH_MIN_SIZE
+			|| prefetch_start(line[0], address, PREFETCH_LINE_SIZE) != LS_OK)
+#endif
+	{
+		ili9488_DrawRGBImage8bit(x, y, w, h, (uint8_t*) address);
+		return;
+	}
+
+	ili9488_StartRGBImage(x, y, w, h);
+	for (uint32_t done = 0; done < size; done += chunk, current ^= 1)
+	{
+		chunk = size - done < PREFETCH_LINE_SIZE ?
+				size - done : PREFETCH_LINE_SIZE;
+		next = size - done - chunk;
+		if (next > PREFETCH_LINE_SIZE)
+			next = PREFETCH_LINE_SIZE;
+
+		if (prefetch_wait() != LS_OK
+				|| (next
+						&& prefetch_start(line[current ^ 1],
+								address + done + chunk, next) != LS_OK))
+		{
+			LCD_IO_WriteMultipleData8((uint8_t*) address + done, size - done);
+			return;
+		}
+		LCD_IO_WriteMultipleData8(line[current], chunk);
+	}
+}
+
+void draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+		const uint8_t *address, bool compressed)
+{
+	static const image_sink_t lcd_sink =
+	{ lcd_fill, lcd_write };
+
+	if (!compressed)
+	{
+		draw_raw(x, y, w, h, address);
+		return;
+	}
+
+	// Do not open the window for a bad header or an image of the wrong size
+	if (memcmp(address, IMAGE_CODEC_MAGIC, 4) != 0
+			|| read_le32(address + 4) != (uint32_t) w * h)
+		return;
+
+	ili9488_StartRGBImage(x, y, w, h);
+	decode_stream(address, (uint32_t) w * h, &lcd_sink);
+}
+
+return_code_t decode_image(const uint8_t *address, uint16_t *buffer,
+		uint32_t n_pixels, bool compressed)
+{
+	static const image_sink_t frame_sink =
+	{ frame_fill, frame_write };
+
+	if (!compressed)
+	{
+		for (uint32_t i = 0; i < n_pixels; i++)
+			buffer[i] = (address[2 * i] << 8) | address[2 * i + 1];
+		return LS_OK;
+	}
+
+	if (memcmp(address, IMAGE_CODEC_MAGIC, 4) != 0)
+		return LS_ERROR;
+
+	frame_ptr = buffer;
+	return decode_stream(address, n_pixels, &frame_sink);
+}
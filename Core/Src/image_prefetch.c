@@ -0,0 +1,95 @@
+/**
+ * @file image_prefetch.c
+ * @brief MDMA copy of image data from the OCTOSPI window (see image_prefetch.h)
+ */
+
+#include <image_prefetch.h>
+#include <main.h>
+
+#define PREFETCH_MDMA_CHANNEL	MDMA_Channel14	// Channel15 feeds the CRC unit
+#define PREFETCH_TIMEOUT		10				// ms, a buffer takes about 100 us
+
+static MDMA_HandleTypeDef hmdma_prefetch;
+static uint8_t mdma_ready = 0;
+static uint32_t source_burst;
+static uint8_t *pending_buffer;
+static uint32_t pending_size;
+
+// Memory to memory in words, started by software. Bursts of 8 words are
+// used from 32-byte aligned sources only, so none crosses a 1 KB boundary.
+static HAL_StatusTypeDef prefetch_mdma_init(uint32_t burst)
+{
+	__HAL_RCC_MDMA_CLK_ENABLE();
+
+	hmdma_prefetch.Instance = PREFETCH_MDMA_CHANNEL;
+	hmdma_prefetch.Init.Request = MDMA_REQUEST_SW;
+	hmdma_prefetch.Init.TransferTriggerMode = MDMA_BLOCK_TRANSFER;
+	hmdma_prefetch.Init.Priority = MDMA_PRIORITY_HIGH;
+	hmdma_prefetch.Init.Endianness = MDMA_LITTLE_ENDIANNESS_PRESERVE;
+	hmdma_prefetch.Init.SourceInc = MDMA_SRC_INC_WORD;
+	hmdma_prefetch.Init.DestinationInc = MDMA_DEST_INC_WORD;
+	hmdma_prefetch.Init.SourceDataSize = MDMA_SRC_DATASIZE_WORD;
+	hmdma_prefetch.Init.DestDataSize = MDMA_DEST_DATASIZE_WORD;
+	hmdma_prefetch.Init.DataAlignment = MDMA_DATAALIGN_PACKENABLE;
+	hmdma_prefetch.Init.BufferTransferLength = 128;
+	hmdma_prefetch.Init.SourceBurst = burst;
+	hmdma_prefetch.Init.DestBurst = MDMA_DEST_BURST_8BEATS;
+	hmdma_prefetch.Init.SourceBlockAddressOffset = 0;
+	hmdma_prefetch.Init.DestBlockAddressOffset = 0;
+
+	if (HAL_MDMA_Init(&hmdma_prefetch) != HAL_OK)
+	{
+		mdma_ready = 0;
+		return HAL_ERROR;
+	}
+
+	source_burst = burst;
+	mdma_ready = 1;
+	return HAL_OK;
+}
+
+return_code_t prefetch_start(uint8_t *buffer, const uint8_t *address,
+		uint32_t size)
+{
+	uint32_t burst =
+			((uint32_t) address & 31) ?
+					MDMA_SOURCE_BURST_SINGLE : MDMA_SOURCE_BURST_8BEATS;
+
+	if (((uint32_t) address & 3) || size == 0 || size > PREFETCH_LINE_SIZE)
+		return LS_ERROR;
+	if ((!mdma_ready || burst != source_burst)
+			&& prefetch_mdma_init(burst) != HAL_OK)
+		return LS_ERROR;
+
+	// Whole words: an image ending on a half word brings 2 bytes too many
+	size = (size + 3) & ~3UL;
+	if (HAL_MDMA_Start(&hmdma_prefetch, (uint32_t) address, (uint32_t) buffer,
+			size, 1) != HAL_OK)
+		return LS_ERROR;
+
+	pending_buffer = buffer;
+	pending_size = size;
+	return LS_OK;
+}
+
+return_code_t prefetch_wait(void)
+{
+	if (pending_buffer == NULL)
+		return LS_ERROR;
+
+	if (HAL_MDMA_PollForTransfer(&hmdma_prefetch, HAL_MDMA_FULL_TRANSFER,
+	PREFETCH_TIMEOUT) != HAL_OK)
+	{
+		HAL_MDMA_Abort(&hmdma_prefetch);
+		pending_buffer = NULL;
+		return LS_ERROR;
+	}
+
+	// MDMA wrote memory behind the D-cache: drop what the CPU last read
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+		SCB_InvalidateDCache_by_Addr((uint32_t*) pending_buffer,
+				(pending_size + 31) & ~31UL);
+	pending_buffer = NULL;
+
+	return LS_OK;
+}
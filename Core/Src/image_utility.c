@@ -1,9 +1,12 @@
+#include <assets.h>
 #include <buttons.h>
+#include <checksum.h>
 #include <definitions.h>
 #include <interface.h>
 #include <iwdg.h>
 #include <octospi.h>
 #include <PSRAM.h>
+#include <rollback.h>
 #include <stdio.h>
 #include <stm32_adafruit_lcd.h>
 #include <stm32h733xx.h>
@@ -24,24 +27,41 @@
 #define END                     0x02
 #define ENDFILE                 0x04
 #define ERASEDSECTOR            0x05
+#define SETOFFSET               0x06
+#define DATA                    0x07    // Windowed data packet
 #define ACK                     0x41    //A
 #define ERASEFLASH              0x43    //C
 #define NAK                     0x4E    //N
 #define ERROR                   0x45    //E
+#define WINDOWACK               0x4B    //K
 #define SENDLASTACKNOWLEDGEMENT 0x53    //S
 
+// DATA packet: [DATA][seq hi][seq lo][size hi][size lo][payload][CRC hi][CRC lo]
+// with the CRC16 over seq, size and payload in the last two bytes. Packets are
+// stored in sequence order only; each one is answered with [WINDOWACK][next
+// expected seq], an out-of-order or corrupt one with a single [NAK][next
+// expected seq] after which the host resends from there (go-back-N)
+#define DATA_HEADER_SIZE        5
+#define DATA_PAYLOAD_SIZE       (USB_PACKET_SIZE - DATA_HEADER_SIZE - 2)
+#define REPLY_SIZE              3
+
+// SETOFFSET: [SETOFFSET][offset, 4 bytes][file size, 4 bytes] big endian, a
+// size of 0 if unknown. Nothing is erased up front: every sector is erased
+// once per session just before its first write, with the largest 4/32/64 KB
+// blocks that stay inside the file, so an update only costs the sectors of
+// the assets actually sent
+#define N_SECTORS               (W25Q_FLASH_SIZE / W25Q_SECTOR_SIZE)
+
 extern char display_buf[];
-extern volatile uint8_t usbBufferCounts;
-extern volatile uint8_t packetReceived;
 uint32_t initial_offset = 0;
 uint32_t current_offset = 0;
+uint32_t end_offset = 0;		// First free byte after everything written
 uint16_t payload_size = 0;
 uint16_t calculated_CRC = 0;
 uint8_t acknowledgement;
 uint8_t payload[2048] =
 { 0 };
 uint8_t crc[2];
-uint8_t usbBuffer[2048];
 uint8_t read_buf[10] =
 { 0 };
 uint8_t hospi_reset;
@@ -57,6 +77,15 @@ union
 
 } address_buffer;
 
+static uint16_t expected_seq = 0;	// Next DATA packet to store
+static bool nak_sent = false;		// Gap already reported, drop until resent
+// Alternate reply buffers, one may still be in flight on the IN endpoint
+static uint8_t reply[2][REPLY_SIZE];
+static uint8_t reply_index = 0;
+static bool reply_pending = false;
+static uint8_t erased[N_SECTORS / 8];	// Sectors erased this session
+static uint32_t erase_end = 0;		// End of the file being received, 0 if unknown
+
 /**
  * @brief Data to send over USB IN endpoint are sent over CDC interface
  *         through this function.
@@ -70,42 +99,128 @@ static uint32_t Send_Byte(uint8_t c)
 }
 
 /**
- * @brief Calculate CRC16 for the data
- * @param  data: Buffer of data
- * @param  length: number of bytes
- * @retval Value of CRC16
+ * @brief  Send or retry the pending windowed reply (cumulative, only the
+ *         latest one matters if the IN endpoint was busy)
+ * @retval None
  */
-static uint16_t Calculate_CRC(uint8_t *data, uint16_t length)
+static void send_reply(void)
 {
-	uint16_t CRC16 = 0xFFFF;
-	uint16_t Poly = 0x1021;
-	for (uint16_t i = 0; i < length; i++)
+	if (CDC_Transmit_HS(reply[reply_index], REPLY_SIZE) == USBD_OK)
 	{
-		CRC16 ^= (data[i] << 8);   //XOR byte into the CRC register
-		for (uint8_t j = 0; j < 8; j++)
-		{  // Process each bit
-			if (CRC16 & 0x8000)
-			{				  // Check if the MSB is set
-				CRC16 = (CRC16 << 1) ^ Poly;  // Shift left and XOR Polynomial
-			}
-			else
-			{
-				CRC16 = CRC16 << 1;  //Just shift left
-			}
+		reply_index ^= 1;
+		reply_pending = false;
+	}
+	else
+		reply_pending = true;
+}
+
+static void reply_seq(uint8_t type)
+{
+	reply[reply_index][0] = type;
+	reply[reply_index][1] = expected_seq >> 8;
+	reply[reply_index][2] = expected_seq & 0xFF;
+	send_reply();
+}
+
+static bool sector_erased(uint32_t address)
+{
+	uint32_t sector = address / W25Q_SECTOR_SIZE;
+
+	return erased[sector / 8] & (1 << (sector % 8));
+}
+
+static void mark_erased(uint32_t address, uint32_t size)
+{
+	for (uint32_t sector = address / W25Q_SECTOR_SIZE;
+			sector < (address + size) / W25Q_SECTOR_SIZE; sector++)
+		erased[sector / 8] |= 1 << (sector % 8);
+}
+
+/**
+ * @brief  Start erasing the largest block at address that ends before end
+ *         and holds no sector already erased this session. Returns while
+ *         the flash is busy: the next command waits for it.
+ * @param  address: sector aligned, not erased yet
+ * @param  end: first byte not to erase
+ * @retval HAL_OK if the erase was started
+ */
+static HAL_StatusTypeDef erase_block_start(uint32_t address, uint32_t end)
+{
+	uint32_t size = W25Q64_EraseBlockSize(address, end);
+
+	// Shrink to 32 KB then 4 KB if part of the block is already erased
+	for (uint32_t i = 0; i < size; i += W25Q_SECTOR_SIZE)
+		if (sector_erased(address + i))
+		{
+			size = size == W25Q_BLOCK64_SIZE ? W25Q_BLOCK32_SIZE : W25Q_SECTOR_SIZE;
+			i = 0;
 		}
+
+	if (W25Q64_OSPI_EraseBlockStart(&hospi2, address, size) != HAL_OK)
+		return HAL_ERROR;
+	mark_erased(address, size);
+
+	return HAL_OK;
+}
+
+/**
+ * @brief  Make [address, address + size) writable: erase the sectors not
+ *         erased yet this session and wait for the flash to be ready.
+ *         Before anything outside it is touched, the asset directory is
+ *         erased so an interrupted upload leaves no valid directory.
+ * @param  address: first byte to write
+ * @param  size: number of bytes
+ * @retval HAL_OK if the flash can be programmed
+ */
+static HAL_StatusTypeDef prepare_write(uint32_t address, uint32_t size)
+{
+	uint32_t end = address + size;
+	uint32_t limit = erase_end > end ? erase_end : end;
+
+	// Images stop where the rollback slot starts (staging area after it)
+	if (end > ROLLBACK_OFFSET)
+		return HAL_ERROR;
+
+	if (address >= FLASH_FACTORY_OFFSET + ASSET_DIR_SIZE
+			&& !sector_erased(FLASH_FACTORY_OFFSET)
+			&& erase_block_start(FLASH_FACTORY_OFFSET,
+			FLASH_FACTORY_OFFSET + ASSET_DIR_SIZE) != HAL_OK)
+		return HAL_ERROR;
+
+	for (address -= address % W25Q_SECTOR_SIZE; address < end; address +=
+	W25Q_SECTOR_SIZE)
+	{
+		if (sector_erased(address))
+			continue;
+		if (erase_block_start(address, limit) != HAL_OK)
+			return HAL_ERROR;
+		watchdog_refresh();
 	}
-	return CRC16; //Final CRC
+
+	return W25Q64_OSPI_AutoPollingMemReady(&hospi2);
 }
 
 /**
- * @brief Erase the QSPI Chip(W25Q128)
+ * @brief  Start erasing what the next DATA packet needs while the USB
+ *         receiver brings it in (file size known only)
  * @param  None
- * @retval Result of the operation: HAL_OK if all operations are OK else HAL_ERROR or HAL_BUSY
+ * @retval None
  */
-static void erase_chip(void)
+static void erase_ahead(void)
 {
-	W25Q64_OSPI_Erase_Chip(&hospi2);
-	HAL_Delay(1000);
+	uint32_t end = current_offset + DATA_PAYLOAD_SIZE;
+
+	if (end > erase_end)
+		end = erase_end;
+
+	for (uint32_t address = current_offset - current_offset % W25Q_SECTOR_SIZE;
+			address < end; address += W25Q_SECTOR_SIZE)
+		if (!sector_erased(address))
+		{
+			// One block at a time, the next packet waits for it if needed
+			erase_block_start(address, erase_end);
+			return;
+		}
 }
 
 /**
@@ -122,7 +237,7 @@ return_code_t read_offset(void)
 	E_PTR_SIZE)) != LS_OK)
 		return ret_val;
 	else
-		current_offset = initial_offset = address_storage.address;
+		current_offset = initial_offset = end_offset = address_storage.address;
 
 	return ret_val;
 }
@@ -131,7 +246,7 @@ static return_code_t write_offset(void)
 	return_code_t ret_val;
 	address_storage_t address_storage;
 
-	address_storage.address = current_offset;
+	address_storage.address = end_offset;
 	ret_val = write_eeram(EERAM_FLASH_OFFSET, address_storage.bytes,
 	E_PTR_SIZE);
 
@@ -144,48 +259,100 @@ static void display_offset(void)
 	int row = 18;
 	BSP_LCD_Clear(LCD_COLOR_BLACK);
 	BSP_LCD_DisplayStringAtLine(row--, (uint8_t*) " LeShuffler Image Utility");
-	snprintf(display_buf, 99, " In flash: %8lu bytes", current_offset);
+	snprintf(display_buf, 99, " In flash: %8lu bytes", end_offset);
 	BSP_LCD_DisplayStringAtLine(row--, (uint8_t*) display_buf);
 	snprintf(display_buf, 99, " Current offset: %#08lx", current_offset);
 	BSP_LCD_DisplayStringAtLine(row--, (uint8_t*) display_buf);
 	snprintf(display_buf, 99, " Transferred: %5.1f%%",
-			(float) current_offset * 100
-					/ (FLASH_CURRENT_OFFSET - OCTOSPI2_BASE));
+			(float) end_offset * 100 / asset_region_size());
 	BSP_LCD_DisplayStringAtLine(row--, (uint8_t*) display_buf);
 }
 
+/**
+ * @brief  Store a windowed DATA packet if it is the next in sequence.
+ *         The USB receiver fills the other ring slots while this one is
+ *         programmed, so the host keeps a window of packets in flight.
+ *         The last page is still programming on return: the next flash
+ *         access waits for it.
+ * @param  packet: USB_PACKET_SIZE bytes
+ * @retval None
+ */
+static void receive_data(uint8_t *packet)
+{
+	uint16_t seq = (packet[1] << 8) | packet[2];
+	uint16_t size = (packet[3] << 8) | packet[4];
+	uint16_t received_CRC = (packet[USB_PACKET_SIZE - 2] << 8)
+			| packet[USB_PACKET_SIZE - 1];
+
+	// Already stored (host resent after a lost reply): acknowledge again
+	if (seq != expected_seq && (uint16_t) (expected_seq - seq) <= 0x8000)
+	{
+		reply_seq(WINDOWACK);
+		return;
+	}
+
+	if (seq != expected_seq || size > DATA_PAYLOAD_SIZE
+			|| crc16_ccitt(CRC16_CCITT_INIT, packet + 1,
+					DATA_HEADER_SIZE - 1 + size) != received_CRC
+			|| prepare_write(current_offset, size) != HAL_OK
+			|| W25Q64_OSPI_WriteStart(&hospi2, packet + DATA_HEADER_SIZE,
+					current_offset, size) != HAL_OK)
+	{
+		// Packets already in flight behind this one are dropped silently
+		if (!nak_sent)
+		{
+			nak_sent = true;
+			reply_seq(NAK);
+		}
+		return;
+	}
+
+	current_offset += size;
+	if (current_offset > end_offset)
+		end_offset = current_offset;
+	expected_seq++;
+	nak_sent = false;
+	reply_seq(WINDOWACK);
+	erase_ahead();
+}
+
 /**
  * @brief Receive the data to write and store in QSPI Chip(W25Q128)
  *        update the value of the current offset in EERAM (at EERAM_FLASH_OFFSET)
- * @param  None
+ * @param  packet: USB_PACKET_SIZE bytes received
  * @retval None
  */
 
-static void receive_store(void)
+static void receive_store(uint8_t *packet)
 {
-	switch (usbBuffer[0])
+	switch (packet[0])
 	{
+		case DATA:
+			receive_data(packet);
+			break;
+
 		case START:
 			//Getting Payload Size
-			payload_size = (usbBuffer[1] << 8) | usbBuffer[2];
+			payload_size = (packet[1] << 8) | packet[2];
 
 			//Getting Payload
-			memcpy(payload, usbBuffer + 3, payload_size);
+			memcpy(payload, packet + 3, payload_size);
 
 			//Calculating CRC16
-			calculated_CRC = Calculate_CRC(payload, payload_size);
+			calculated_CRC = crc16_ccitt(CRC16_CCITT_INIT, payload, payload_size);
 
 			//Getting CRC16
-			uint16_t received_CRC = ((usbBuffer[2046] << 8) | usbBuffer[2047]);
+			uint16_t received_CRC = ((packet[2046] << 8) | packet[2047]);
 
 			//Check
-			if (calculated_CRC == received_CRC)
+			if (calculated_CRC == received_CRC
+					&& prepare_write(current_offset, payload_size) == HAL_OK)
 			{
 				W25Q64_OSPI_Write(&hospi2, payload, current_offset,
 						payload_size);
 				current_offset += payload_size;
-				memset(usbBuffer, 0, sizeof(usbBuffer));
-				packetReceived = 0;
+				if (current_offset > end_offset)
+					end_offset = current_offset;
 				acknowledgement = ACK;
 				HAL_Delay(10);
 				Send_Byte(acknowledgement);
@@ -202,10 +369,10 @@ static void receive_store(void)
 			//Error case to handle error that occurs during file transmission
 			// Note current (non-valid) offset
 			uint32_t tempOffset = current_offset;
-			// Reset valid offset to stored value
-			read_offset();
+			// Reset offset to the start of the file
+			current_offset = initial_offset;
 			//Clean the invalid portion that has been written
-			if (W25Q64_OSPI_EraseSector(&hospi2, current_offset, tempOffset)
+			if (W25Q64_OSPI_EraseRange(&hospi2, current_offset, tempOffset)
 					!= HAL_OK)
 			{
 				HAL_GPIO_WritePin(GPIOA, GPIO_PIN_2, SET);
@@ -224,7 +391,8 @@ static void receive_store(void)
 
 		case ENDFILE:
 			// Creating the Address Buffer that is to be send to excel
-			uint8_t address_buffer[8];
+			// (static: the IN transfer completes after this returns)
+			static uint8_t address_buffer[8];
 			address_buffer[0] = initial_offset >> 24 & 0xFF;
 			address_buffer[1] = initial_offset >> 16 & 0xFF;
 			address_buffer[2] = initial_offset >> 8 & 0xFF;
@@ -234,12 +402,14 @@ static void receive_store(void)
 			address_buffer[6] = current_offset >> 8 & 0xFF;
 			address_buffer[7] = current_offset & 0xFF;
 
+			// Chip is reset before the next file: let any erase finish
+			W25Q64_OSPI_AutoPollingMemReady(&hospi2);
+
 			// Display current offset on screen
 			display_offset();
 			// Update current offset in EERAM
 			write_offset();
 			//Send the Address to excel file
-			HAL_Delay(100);
 			CDC_Transmit_HS(address_buffer, sizeof(address_buffer));
 
 			//Reset initial_offset as current_offset
@@ -250,6 +420,25 @@ static void receive_store(void)
 
 			break;
 
+		case SETOFFSET:
+			// Next file goes to the given offset (asset directory layout)
+			current_offset = initial_offset = (packet[1] << 24)
+					| (packet[2] << 16) | (packet[3] << 8) | packet[4];
+			erase_end = (packet[5] << 24) | (packet[6] << 16) | (packet[7] << 8)
+					| packet[8];
+			if (erase_end != 0)
+				erase_end += initial_offset;
+			if (erase_end > ROLLBACK_OFFSET)
+				erase_end = ROLLBACK_OFFSET;
+			// DATA sequence numbers restart with each file
+			expected_seq = 0;
+			nak_sent = false;
+			acknowledgement = ACK;
+			Send_Byte(acknowledgement);
+			// First block erases while the host sends the first packets
+			erase_ahead();
+			break;
+
 		case SENDLASTACKNOWLEDGEMENT:
 			//Sends last signal
 			HAL_Delay(100);
@@ -257,9 +446,13 @@ static void receive_store(void)
 			break;
 
 		case ERASEFLASH:
-			//Erase Flash
-			erase_chip();
-			read_offset();
+			//Erase Flash: everything written up to now, not the whole chip
+			W25Q64_OSPI_EraseRange(&hospi2, FLASH_FACTORY_OFFSET,
+					end_offset > asset_region_size() ?
+							end_offset : asset_region_size());
+			current_offset = initial_offset = end_offset = FLASH_FACTORY_OFFSET;
+			memset(erased, 0, sizeof(erased));
+			write_offset();
 			// Display Offset on screen
 			display_offset();
 			beep(MEDIUM_BEEP);
@@ -280,48 +473,39 @@ void image_utility(void)
 	if ((status = read_offset()) != LS_OK)
 		LS_error_handler(status);
 
-	// If images already loaded erase them (with warning if they seem OK)
-	if (current_offset != 0)
+	// Images already loaded are replaced as they are received (with warning
+	// if they seem OK); end_offset keeps the extent of what is in flash
+	if (end_offset != 0
+			&& (asset_source() == ASSET_SOURCE_DIRECTORY
+					|| current_offset == asset_region_size()))
 	{
-		if (current_offset == FLASH_CURRENT_OFFSET - OCTOSPI2_BASE)
-		{
-			return_code_t user_input = prompt_interface(MESSAGE, CUSTOM_MESSAGE,
-					"This will erase all images\nAre you sure?", icon_set_check,
-					ICON_CROSS, BUTTON_PRESS);
+		return_code_t user_input = prompt_interface(MESSAGE, CUSTOM_MESSAGE,
+				"This will replace images\nAre you sure?", icon_set_check,
+				ICON_CROSS, BUTTON_PRESS);
 
-			// If ESC abort
-			if (user_input == LS_ESC)
-			{
-				reset_btns();
-				return;
-			}
+		// If ESC abort
+		if (user_input == LS_ESC)
+		{
+			reset_btns();
+			return;
 		}
-		// Else proceed
-		prompt_message("\nErasing image memory");
-
-		// Init flash memory to enable erase
-		W25Q64_OCTO_SPI_Init(&hospi2);
-		HAL_Delay(10);
-
-		// Erase all sectors with images
-		// DEBUGGING
-		W25Q64_OSPI_EraseSector(&hospi2, FLASH_FACTORY_OFFSET, current_offset);
-		//	W25Q64_OSPI_Erase_Chip(&hospi2);
-		// Update offset
-		current_offset = initial_offset = FLASH_FACTORY_OFFSET;
-		if ((status = write_offset()) != LS_OK)
-			LS_error_handler(status);
 	}
+	current_offset = initial_offset = FLASH_FACTORY_OFFSET;
+	memset(erased, 0, sizeof(erased));
 
-	// Enter receiving loop
+	// Enter receiving loop, only left by a reset: the flash is never mapped
+	// again here, so no cached line of the images can be read stale
 	clear_message(TEXT_ERROR);
 	prompt_message("\nReady to receive images");
 	beep(MEDIUM_BEEP);
 	while (1)
 	{
+		uint8_t *packet;
+		uint32_t length;
+
 		watchdog_refresh();
 
-		if (packetReceived)
+		if ((packet = CDC_Message_HS(&length)) != NULL)
 		{
 			if (!hospi_reset)
 			{
@@ -329,11 +513,14 @@ void image_utility(void)
 				W25Q64_OCTO_SPI_Init(&hospi2);
 				hospi_reset = 1;
 			}
-			receive_store();
-			usbBufferCounts = 0;
-			packetReceived = 0;
-
+			// Every command is one full packet, anything else is not ours
+			if (length == USB_PACKET_SIZE)
+				receive_store(packet);
+			CDC_Release_Message_HS();
 		}
+
+		if (reply_pending)
+			send_reply();
 	}
 
 	return;
@@ -5,11 +5,13 @@
  *      Author: Francois S
  */
 
+#include <animation.h>
 #include <basic_operations.h>
 #include <bootload.h>
 #include "iwdg.h"
 #include <buttons.h>
 #include <fonts.h>
+#include <fw_staging.h>
 #include <games.h>
 #include <i2c.h>
 #include <ili9488.h>
@@ -28,6 +30,17 @@ extern uint8_t n_cards_in;
 
 uint8_t LCD_row;
 uint8_t LCD_scroll;
+
+// Menu rows as last drawn by prompt_menu(), so that scrolling only redraws what changed
+typedef struct
+{
+	const char *label;
+	uint16_t right;		// End of the painted text box
+	bool check;
+} menu_row_t;
+static menu_row_t menu_rows[LCD_MAX_N_ROWS];
+static int16_t menu_rows_code = -1; // Menu shown in menu_rows, -1 if invalidated
+static uint32_t menu_rows_clears;	// BSP_LCD_GetClearCount() when menu_rows was drawn
 int16_t display_row; // To be removed eventually (games_old and test)
 char display_buf[N_DISP_MAX + 1];
 
@@ -36,27 +49,27 @@ char custom_game_names[N_CUSTOM_GAMES][GAME_NAME_MAX_CHAR + 1];
 
 // ICONS
 const icon_t icon_void =
-{ .code = ICON_VOID, .address = (uint8_t*) VOID_ADDRESS };
+{ .code = ICON_VOID, .asset = ASSET_VOID };
 const icon_t icon_back =
-{ .code = ICON_BACK, .address = (uint8_t*) BACK_ADDRESS };
+{ .code = ICON_BACK, .asset = ASSET_BACK };
 const icon_t icon_card =
-{ .code = ICON_CARD, .address = (uint8_t*) CARD_ADDRESS };
+{ .code = ICON_CARD, .asset = ASSET_CARD };
 const icon_t icon_check =
-{ .code = ICON_CHECK, .address = (uint8_t*) CHECK_ADDRESS };
+{ .code = ICON_CHECK, .asset = ASSET_CHECK };
 const icon_t icon_cross =
-{ .code = ICON_CROSS, .address = (uint8_t*) CROSS_ADDRESS };
+{ .code = ICON_CROSS, .asset = ASSET_CROSS };
 const icon_t icon_edit =
-{ .code = ICON_EDIT, .address = (uint8_t*) EDIT_ADDRESS };
+{ .code = ICON_EDIT, .asset = ASSET_EDIT };
 const icon_t icon_flame =
-{ .code = ICON_FLAME, .address = (uint8_t*) FLAME_ADDRESS };
+{ .code = ICON_FLAME, .asset = ASSET_FLAME };
 const icon_t icon_player =
-{ .code = ICON_PLAYER, .address = (uint8_t*) PLAYER_ADDRESS };
+{ .code = ICON_PLAYER, .asset = ASSET_PLAYER };
 const icon_t icon_red_card =
-{ .code = ICON_RED_CARD, .address = (uint8_t*) RED_CARD_ADDRESS };
+{ .code = ICON_RED_CARD, .asset = ASSET_RED_CARD };
 const icon_t icon_red_cross =
-{ .code = ICON_RED_CROSS, .address = (uint8_t*) RED_CROSS_ADDRESS };
+{ .code = ICON_RED_CROSS, .asset = ASSET_RED_CROSS };
 const icon_t icon_save =
-{ .code = ICON_SAVE, .address = (uint8_t*) SAVE_ADDRESS };
+{ .code = ICON_SAVE, .asset = ASSET_SAVE };
 
 icon_t icon_list[] =
 { icon_void, icon_back, icon_card, icon_check, icon_cross, icon_edit,
@@ -427,17 +440,13 @@ return_code_t set_dynamic_menu(menu_t *p_dynamic_menu)
 			break;
 
 		default:
-			ret_val = INVALID_CHOICE;
+			return INVALID_CHOICE;
 	}
 
 	uint8_t r_data[e_size];
 
-	if (ret_val == LS_ERROR)
-		goto _EXIT;
-
 	// Get selected items in permanent memory
-	if ((ret_val = EERAM_ReadSRAMData(&hi2c3, address, r_data, e_size))
-			!= LS_OK)
+	if ((ret_val = read_eeram(address, r_data, e_size)) != LS_OK)
 		goto _EXIT;
 
 	// Calculate number of active items in dynamic menu
@@ -491,8 +500,9 @@ return_code_t interface_init(void)
 	{
 		if ((ret_val = read_custom_game_name(text, custom_game_code)) != LS_OK)
 			break;
+		text[GAME_NAME_MAX_CHAR] = '\0';
 		strncpy(custom_game_names[custom_game_code - CUSTOM_1], text,
-		GAME_NAME_MAX_CHAR);
+		GAME_NAME_MAX_CHAR + 1);
 	}
 
 	// Initialise Favorites and Dealers Choice menu
@@ -520,10 +530,8 @@ void prompt_hole_cards(uint16_t player, uint16_t n_players, uint16_t card,
 		// Clear message zone
 		clear_message(TEXT_ERROR);
 		// Draw icons
-		ili9488_DrawRGBImage8bit(x_pos, y_pos - y_icon, ICON_W, ICON_H,
-				icon_player.address);
-		ili9488_DrawRGBImage8bit(x_pos + x_space_2, y_pos - y_icon, ICON_W,
-		ICON_H, icon_card.address);
+		draw_asset(icon_player.asset, x_pos, y_pos - y_icon);
+		draw_asset(icon_card.asset, x_pos + x_space_2, y_pos - y_icon);
 		display_escape_icon(ICON_CROSS);
 	}
 	// If the player number is changing, clear player space
@@ -591,8 +599,7 @@ void prompt_com_cards(uint16_t card, uint16_t n_cards)
 	// Clear message zone
 	clear_message(TEXT_ERROR);
 	// Draw icon
-	ili9488_DrawRGBImage8bit(x_pos + x_space_2, y_pos - y_icon, ICON_W, ICON_H,
-			icon_card.address);
+	draw_asset(icon_card.asset, x_pos + x_space_2, y_pos - y_icon);
 
 	// As the card number is changing, clear card space
 	BSP_LCD_SetTextColor(LCD_COLOR_BCKGND);
@@ -638,6 +645,9 @@ void atomic_prompt(return_code_t message_code, char *text, uint8_t prompt_row,
 	bool end_reached = false;
 	char c;
 
+	// Menu rows are no longer on screen
+	menu_rows_code = -1;
+
 	void prompt_char(void)
 	{
 		// Replace illegal characters and space by blank (we don't overwrite)
@@ -722,8 +732,8 @@ void atomic_prompt(return_code_t message_code, char *text, uint8_t prompt_row,
 			line_end = index_2 - 1;
 			line_end_x = x;
 		}
-		// Reaching end of row
-		else if (x >= x_max)
+		// Reaching end of row (x >= x_max)
+		else
 		{
 			// Normal case
 			if (space_found)
@@ -778,8 +788,7 @@ void prompt_message(char *text)
 	return;
 }
 
-return_code_t graphic_address(uint8_t *eeram_addresses[2],
-		return_code_t error_code)
+return_code_t graphic_assets(asset_id_t assets[2], return_code_t error_code)
 {
 	if (error_type(error_code) != GRAPHIC_ERROR)
 		return INVALID_CHOICE;
@@ -787,63 +796,63 @@ return_code_t graphic_address(uint8_t *eeram_addresses[2],
 	switch (error_code)
 	{
 		case CARD_STUCK_IN_TRAY:
-			eeram_addresses[0] = (uint8_t*) CHECK_TRAY_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_CHECK_TRAY;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case CARD_STUCK_ON_ENTRY:
-			eeram_addresses[0] = (uint8_t*) CSO_ENTRY_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_CSO_ENTRY;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case CARD_STUCK_ON_EXIT:
-			eeram_addresses[0] = (uint8_t*) CSO_EXIT_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_CSO_EXIT;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case SFCIT:
-			eeram_addresses[0] = (uint8_t*) SH_FULL_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) CHECK_TRAY_ADDRESS;
+			assets[0] = ASSET_SH_FULL;
+			assets[1] = ASSET_CHECK_TRAY;
 			break;
 
 		case SENCIT:
-			eeram_addresses[0] = (uint8_t*) SH_EMPTY_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) TRAY_EMPTY_ADDRESS;
+			assets[0] = ASSET_SH_EMPTY;
+			assets[1] = ASSET_TRAY_EMPTY;
 			break;
 
 		case NOT_ENOUGH_CARDS_IN_SHUFFLER:
-			eeram_addresses[0] = (uint8_t*) CONTENT_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) TRAY_EMPTY_ADDRESS;
+			assets[0] = ASSET_CONTENT;
+			assets[1] = ASSET_TRAY_EMPTY;
 			break;
 
 		case TRAY_IS_EMPTY:
-			eeram_addresses[0] = (uint8_t*) TRAY_EMPTY_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_TRAY_EMPTY;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case CHECK_TRAY:
-			eeram_addresses[0] = (uint8_t*) CHECK_TRAY_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_CHECK_TRAY;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case WRONG_INSERTION:
-			eeram_addresses[0] = (uint8_t*) CHECK_TRAY_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_CHECK_TRAY;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case PICK_UP_CARDS:
-			eeram_addresses[0] = (uint8_t*) PICK_UP_CARDS_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_PICK_UP_CARDS;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case CUSTOM_PICK_UP:
-			eeram_addresses[0] = (uint8_t*) PICK_UP_CARDS_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_PICK_UP_CARDS;
+			assets[1] = ASSET_SILH;
 			break;
 
 		case CUSTOM_EMPTY:
-			eeram_addresses[0] = (uint8_t*) CONTENT_ADDRESS;
-			eeram_addresses[1] = (uint8_t*) SILH_ADDRESS;
+			assets[0] = ASSET_CONTENT;
+			assets[1] = ASSET_SILH;
 			break;
 
 		default:
@@ -857,6 +866,10 @@ return_code_t graphic_address(uint8_t *eeram_addresses[2],
 void clear_picture(void)
 {
 	uint16_t silh_x = (BSP_LCD_GetXSize() - SILH_W) / 2;
+
+	// Menu rows are no longer on screen
+	menu_rows_code = -1;
+
 	BSP_LCD_SetTextColor(LCD_COLOR_BCKGND);
 //	BSP_LCD_SetTextColor(LCD_COLOR_GREEN);  // SCREEN DEBUGGING
 	BSP_LCD_FillRect(silh_x, (uint16_t) SILH_Y, (uint16_t) SILH_W,
@@ -872,7 +885,7 @@ void clear_picture(void)
  */
 return_code_t prompt_dynamic_buttons(return_code_t message_code,
 		icon_set_t icon_set, icon_code_t esc_icon_code,
-		uint8_t *eeram_addresses[2], uint16_t silh_x, prompt_mode_t prompt_mode)
+		asset_id_t graphic_ids[2], uint16_t silh_x, prompt_mode_t prompt_mode)
 {
 	return_code_t ret_val = LS_OK;
 	int8_t idx;
@@ -904,6 +917,8 @@ return_code_t prompt_dynamic_buttons(return_code_t message_code,
 	while (1)
 	{
 		watchdog_refresh();
+		// Firmware staged over USB while waiting for the user
+		fw_staging_poll();
 		// Blink image if graphic error
 		if (error_type_val == GRAPHIC_ERROR
 				&& HAL_GetTick() > start_time_2 + blink_lag)
@@ -912,9 +927,7 @@ return_code_t prompt_dynamic_buttons(return_code_t message_code,
 			// Toggle
 			toggle_blink = !toggle_blink;
 			// Draw picture
-			ili9488_DrawRGBImage8bit(silh_x, (uint16_t) SILH_Y,
-					(uint16_t) SILH_W, (uint16_t) SILH_H,
-					eeram_addresses[toggle_blink]);
+			draw_asset(graphic_ids[toggle_blink], silh_x, (uint16_t) SILH_Y);
 			// Reset blink timer
 			start_time_2 = HAL_GetTick();
 		}
@@ -928,7 +941,7 @@ return_code_t prompt_dynamic_buttons(return_code_t message_code,
 				idx = min(idx + increment, icon_set.n_items - 1);
 				change = true;
 			}
-			else if (increment < 0 && index > 0)
+			else if (increment < 0 && idx > 0)
 			{
 				idx = max(idx + increment, 0);
 				change = true;
@@ -1040,7 +1053,7 @@ return_code_t prompt_interface(alert_mode_t alert_mode,
 			(alert_mode == MESSAGE) ? LCD_COLOR_TEXT : LCD_COLOR_RED_SHFLR;
 	uint16_t silh_x = (BSP_LCD_GetXSize() - SILH_W) / 2;
 	bool do_beep = (alert_mode == ALERT);
-	uint8_t *eeram_addresses[2];
+	asset_id_t graphic_ids[2];
 	error_type_t error_type_val = error_type(message_code);
 
 	if (error_type_val == GRAPHIC_ERROR)
@@ -1052,11 +1065,10 @@ return_code_t prompt_interface(alert_mode_t alert_mode,
 		clear_message(TEXT_ERROR);
 
 		// Graphic prompt
-		if (graphic_address(eeram_addresses, message_code) != LS_OK)
+		if (graphic_assets(graphic_ids, message_code) != LS_OK)
 			return INVALID_CHOICE;
 
-		ili9488_DrawRGBImage8bit(silh_x, (uint16_t) SILH_Y, (uint16_t) SILH_W,
-				(uint16_t) SILH_H, eeram_addresses[0]);
+		draw_asset(graphic_ids[0], silh_x, (uint16_t) SILH_Y);
 	}
 	else if (error_type_val == FATAL_ERROR)
 	{
@@ -1069,9 +1081,7 @@ return_code_t prompt_interface(alert_mode_t alert_mode,
 		uint16_t restart_x = (BSP_LCD_GetXSize() - RESTART_W) / 2;
 
 		// Graphic prompt
-		ili9488_DrawRGBImage8bit(restart_x, (uint16_t) SILH_Y,
-				(uint16_t) RESTART_W, (uint16_t) RESTART_H,
-				(uint8_t*) RESTART_ADDRESS);
+		draw_asset(ASSET_RESTART, restart_x, (uint16_t) SILH_Y);
 	}
 	else
 	{
@@ -1087,7 +1097,7 @@ return_code_t prompt_interface(alert_mode_t alert_mode,
 
 	// prompt dynamic buttons manages the interface and the icons except NO_HOLD and pick ups
 	user_input = prompt_dynamic_buttons(message_code, icon_set, esc_icon_code,
-			eeram_addresses, silh_x, prompt_mode);
+			graphic_ids, silh_x, prompt_mode);
 
 	return user_input;
 }
@@ -1114,6 +1124,9 @@ void clear_message(error_type_t error_type_val)
 					BSP_LCD_GetYSize() - (LCD_Y_TITLE + LCD_TITLE_HEIGHT + LCD_BOTTOM_SPACE
 							+ LCD_ROW_HEIGHT - 4) - 2 * V_ADJUST;
 
+	// Menu rows are no longer on screen
+	menu_rows_code = -1;
+
 	// Clear message
 	BSP_LCD_SetTextColor(LCD_COLOR_BCKGND);
 //  DEBUGGING SCREEN
@@ -1138,13 +1151,16 @@ void clear_icons(void)
 
 void prompt_basic_item(char *text, uint8_t row)
 {
+	// Menu rows are no longer on screen
+	menu_rows_code = -1;
+
 	BSP_LCD_SetFont(&LCD_FIXED_FONT);
 	uint16_t Xpos = LCD_X_TEXT;
 	uint16_t Ypos = LCD_FIXED_TOP_ROW - LCD_ROW_HEIGHT * row;
 	uint32_t textSize = 0;
 	uint32_t rowSize;
 	char *ptr = text;
-	char nextChar;
+	char line[MAX_ITEM_CHAR];
 
 	/* Get the text size */
 	while (*ptr++)
@@ -1152,55 +1168,48 @@ void prompt_basic_item(char *text, uint8_t row)
 
 	/* Number of characters available on row */
 	rowSize = (BSP_LCD_GetXSize() - Xpos) / LCD_FIXED_FONT.Width;
+	if (rowSize > MAX_ITEM_CHAR)
+		rowSize = MAX_ITEM_CHAR;
 
-	/* Send the string character by character on LCD
-	 * completing the row with spaces
-	 * */
+	/* Complete the row with spaces and send it in one go */
 	for (uint8_t i = 0; i < rowSize; i++)
-	{
-		if (i < textSize)
-			nextChar = *(text++);
-		else
-			nextChar = ' ';
-		/* Display next character on LCD */
-		BSP_LCD_DisplayChar(Xpos, Ypos, nextChar);
-		/* Increment the column position by one character width */
-		Xpos += LCD_FIXED_FONT.Width;
-	}
+		line[i] = (i < textSize) ? text[i] : ' ';
+	BSP_LCD_DisplayChars(Xpos, Ypos, (uint8_t*) line, rowSize);
 
 	return;
 }
 
-// Clear row and prompt text
-void prompt_menu_item(char *text, uint8_t row)
+// Draw a menu label in a box of its row, returns the end of the text
+static uint16_t draw_menu_label(const char *text, uint8_t row, uint16_t box_x,
+		uint16_t box_right)
 {
-	TFTSTCustomFontData font;
-	uint16_t colour = LCD_COLOR_TEXT;
-	uint16_t x = LCD_X_TEXT;
 	uint16_t y = LCD_TOP_ROW + LCD_ROW_HEIGHT * row;
-	char c;
-
-	// Clear line
-	BSP_LCD_SetTextColor(LCD_COLOR_BCKGND);
-	BSP_LCD_FillRect(0, LCD_TOP_ROW + LCD_ROW_HEIGHT * row + 5,
-	BUTTON_ICON_X, LCD_ROW_HEIGHT);
+	uint16_t right;
+	char line[MAX_ITEM_CHAR + 1];
+
+	// Truncate to MAX_ITEM_CHAR (illegal characters are replaced by the renderer)
+	strncpy(line, text, MAX_ITEM_CHAR);
+	line[MAX_ITEM_CHAR] = 0;
+
+	right = min(tftstTextLineRight(&LCD_REGULAR_FONT, &LCD_BOLD_FONT,
+	LCD_X_TEXT, line), BUTTON_ICON_X);
+	if (box_right < right)
+		box_right = right;
+
+	// Clear box and draw text in one window - first character in bold
+	tftstDrawTextLineInBox(&LCD_REGULAR_FONT, &LCD_BOLD_FONT, LCD_X_TEXT, y,
+			line, LCD_COLOR_TEXT, LCD_COLOR_BCKGND, box_x, y + 5,
+			box_right - box_x, LCD_ROW_HEIGHT);
 	BSP_LCD_SetTextColor(LCD_COLOR_TEXT);
 
-	// Print character until the end
-	for (uint8_t i = 0; i < MAX_ITEM_CHAR; i++)
-	{
-		// Stop if end of string
-		if ((c = text[i]) == 0)
-			break;
-		// Replace illegal characters by underscore
-		if (c < ' ' || c > '~')
-			c = '_';
-		// Draw character - first one in bold
-		font = (i == 0 ? LCD_BOLD_FONT : LCD_REGULAR_FONT);
-		tftstDrawCharWithFont(&font, x, y, c, colour, LCD_COLOR_BCKGND);
-		x += font.charData[c - FONT_INDEX_OFFSET].width;
-		x += font.charData[c - FONT_INDEX_OFFSET].left;
-	}
+	return right;
+}
+
+// Clear row and prompt text
+void prompt_menu_item(char *text, uint8_t row)
+{
+	menu_rows_code = -1;
+	draw_menu_label(text, row, 0, BUTTON_ICON_X);
 
 	return;
 }
@@ -1221,30 +1230,24 @@ void prompt_text(const char *text, uint8_t row, TFTSTCustomFontData font)
 void display_text(uint16_t x, uint16_t y, const char *text,
 		TFTSTCustomFontData font, uint16_t colour)
 {
-	char c;
-	TFTSTCustomFontCharData c_data;
+	char line[MAX_ITEM_CHAR + 1];
 
-	// Print character until the end
-	for (uint8_t i = 0; i < MAX_ITEM_CHAR; i++)
-	{
-		// Stop if end of string
-		if ((c = text[i]) == 0)
-			break;
-		// Replace illegal characters by underscore
-		if (c < ' ' || c > '~')
-			(c = '_');
-		// Draw character
-		c_data = font.charData[c - FONT_INDEX_OFFSET];
-		tftstDrawCharWithFont(&font, x, y, c, colour, LCD_COLOR_BCKGND);
-		x += c_data.left;
-		x += c_data.width;
+	// Text outside the menu rows (labels, game screens): the rows may be hidden
+	menu_rows_code = -1;
 
-	}
+	// Truncate to MAX_ITEM_CHAR (illegal characters are replaced by the renderer)
+	strncpy(line, text, MAX_ITEM_CHAR);
+	line[MAX_ITEM_CHAR] = 0;
+
+	tftstDrawTextLine(&font, NULL, x, y, line, colour, LCD_COLOR_BCKGND);
 }
 
 // same as promptBasicItem but no filling with spaces and choice of font
 void prompt_basic_text(char *text, uint8_t row, sFONT font)
 {
+	// Menu rows are no longer on screen
+	menu_rows_code = -1;
+
 	BSP_LCD_SetFont(&font);
 	uint16_t Xpos = LCD_X_TEXT;
 	uint16_t Ypos = LCD_FIXED_TOP_ROW - LCD_ROW_HEIGHT * row;
@@ -1258,17 +1261,11 @@ void prompt_basic_text(char *text, uint8_t row, sFONT font)
 	/* Get the text size */
 	while (*ptr++ && textSize++ < rowSize)
 		;
+	if (textSize > rowSize)
+		textSize = rowSize;
 
-	/* Send the string character by character on LCD
-	 * completing the row with spaces
-	 * */
-	for (uint8_t i = 0; i < textSize; i++)
-	{
-		/* Display next character on LCD */
-		BSP_LCD_DisplayChar(Xpos, Ypos, *(text++));
-		/* Increment the column position by one character width */
-		Xpos += font.Width;
-	}
+	/* Send the string on LCD in one window */
+	BSP_LCD_DisplayChars(Xpos, Ypos, (uint8_t*) text, textSize);
 
 	return;
 }
@@ -1291,16 +1288,11 @@ void display_basic_text(char *text, uint16_t Xpos, uint16_t Ypos, sFONT font,
 	/* Get the text size */
 	while (*ptr++ && textSize++ < rowSize)
 		;
-	/* Send the string character by character on LCD
-	 * completing the row with spaces
-	 * */
-	for (uint8_t i = 0; i < textSize; i++)
-	{
-		/* Display next character on LCD */
-		BSP_LCD_DisplayChar(Xpos, Ypos, *(text++));
-		/* Increment the column position by one character width */
-		Xpos += font.Width;
-	}
+	if (textSize > rowSize)
+		textSize = rowSize;
+
+	/* Send the string on LCD in one window */
+	BSP_LCD_DisplayChars(Xpos, Ypos, (uint8_t*) text, textSize);
 
 	// Reset color
 	BSP_LCD_SetTextColor(LCD_COLOR_TEXT);
@@ -1331,8 +1323,7 @@ void prompt_title(char *text)
 	if (text == root_menu.label)
 	{
 		y = LCD_Y_TITLE;
-		ili9488_DrawRGBImage8bit(x, y, (uint16_t) SMALL_LOGO_W,
-				(uint16_t) SMALL_LOGO_H, (uint8_t*) SMALL_LOGO_ADDRESS);
+		draw_asset(ASSET_SMALL_LOGO, x, y);
 	}
 
 	// General case
@@ -1460,6 +1451,97 @@ return_code_t set_current_menu(item_code_t item_code)
 	return set_menu(&current_menu, item_code);
 }
 
+/*
+ * Draw the menu rows from LCD_scroll
+ * full: clear and draw every row (and record them in menu_rows)
+ * else: only redraw labels and checks that differ from menu_rows, the row box
+ *       stops at the end of the longer of the old and new labels
+ */
+static return_code_t draw_menu_rows(bool full)
+{
+	extern menu_t current_menu;
+	return_code_t ret_val = LS_OK;
+	menu_t running_menu;
+	uint8_t index;
+	bool dynamic = current_menu.code == SET_FAVORITES
+			|| current_menu.code == SET_DEALERS_CHOICE;
+
+	// Go down row by row
+	for (uint8_t row = 0; row < LCD_N_ROWS && row < LCD_MAX_N_ROWS; row++)
+	{
+		menu_row_t *shown = &menu_rows[row];
+		index = LCD_scroll + row;
+		// Until we get to last item
+		if (index >= current_menu.n_items)
+			break;
+
+		// identify menu on current row
+		if ((ret_val = set_menu(&running_menu, current_menu.items[index]))
+				!= LS_OK)
+			goto _EXIT;
+
+		// Prompt corresponding menu label on row
+		if (full)
+			shown->right = draw_menu_label(running_menu.label, row, 0,
+			BUTTON_ICON_X);
+		else if (shown->label != running_menu.label)
+			shown->right = draw_menu_label(running_menu.label, row,
+			LCD_X_ROW_BOX, shown->right);
+		shown->label = running_menu.label;
+
+		// Special case for set favourites and set DLR's choice
+		if (dynamic)
+		{
+			uint16_t address =
+					(current_menu.code == SET_FAVORITES) ?
+					EERAM_FAVS :
+															EERAM_DLRS;
+			uint8_t currently_selected;
+			// Assess is running menu is selected
+			if ((ret_val = read_eeram_bit(address, index, &currently_selected))
+					!= LS_OK)
+				goto _EXIT;
+			// Update check accordingly
+			if (full || shown->check != (bool) currently_selected)
+				currently_selected ? prompt_check(row) : clear_check(row);
+			shown->check = currently_selected;
+		}
+	}
+
+	menu_rows_code = current_menu.code;
+	menu_rows_clears = BSP_LCD_GetClearCount();
+
+	_EXIT:
+
+	if (ret_val != LS_OK)
+		menu_rows_code = -1;
+
+	return ret_val;
+}
+
+// Redraw the menu after a scroll, previous_row is where the dot was
+static return_code_t scroll_menu(uint8_t previous_row)
+{
+	extern menu_t current_menu;
+	return_code_t ret_val;
+
+	// Full redraw if the rows on screen are not known or the screen was cleared
+	if (menu_rows_code != (int16_t) current_menu.code
+			|| menu_rows_clears != BSP_LCD_GetClearCount())
+		return prompt_menu(DEFAULT_SELECT, current_menu.code);
+
+	ret_val = draw_menu_rows(false);
+
+	// Move dot
+	if (previous_row != LCD_row)
+	{
+		clear_dot(previous_row);
+		prompt_dot(LCD_row);
+	}
+
+	return ret_val;
+}
+
 // prompt_menu displays menu using current row and offset
 // to be used on startup with ROOT_MENU
 return_code_t prompt_menu(prompt_menu_mode_t prompt_menu_mode,
@@ -1467,8 +1549,6 @@ return_code_t prompt_menu(prompt_menu_mode_t prompt_menu_mode,
 {
 	extern menu_t current_menu;
 	return_code_t ret_val = LS_OK;
-	menu_t running_menu;
-	uint8_t index;
 
 // If menu is not the current menu, set current menu to item_code and prompt title
 	if (item_code != current_menu.code)
@@ -1530,39 +1610,9 @@ return_code_t prompt_menu(prompt_menu_mode_t prompt_menu_mode,
 					(current_menu.code == ROOT_MENU) ? ICON_VOID : ICON_BACK);
 		}
 
-		// Go down row by row
-		for (uint8_t row = 0; row < LCD_N_ROWS; row++)
-		{
-			index = LCD_scroll + row;
-			// Until we get to last item
-			if (index < current_menu.n_items)
-			{
-				// identify menu on current row
-				if ((ret_val = set_menu(&running_menu,
-						current_menu.items[index])) != LS_OK)
-					goto _EXIT;
-				// Prompt corresponding menu label on row
-				prompt_menu_item(running_menu.label, row);
-				// Special case for set favourites and set DLR's choice
-				if (current_menu.code == SET_FAVORITES
-						|| current_menu.code == SET_DEALERS_CHOICE)
-				{
-					uint16_t address =
-							(current_menu.code == SET_FAVORITES) ?
-							EERAM_FAVS :
-																	EERAM_DLRS;
-					uint8_t currently_selected;
-					// Assess is running menu is selected
-					if ((ret_val = read_eeram_bit(address, index,
-							&currently_selected)) != LS_OK)
-						goto _EXIT;
-					// Update check accordingly
-					currently_selected ? prompt_check(row) : clear_check(row);
-				}
-			}
-			else
-				break;
-		}
+		// Draw all rows
+		if ((ret_val = draw_menu_rows(true)) != LS_OK)
+			goto _EXIT;
 		// Prompt dot
 		prompt_dot(LCD_row);
 	}
@@ -1584,9 +1634,12 @@ return_code_t get_calling_menu(item_code_t *p_menu_code)
 	if (current_menu.code != ROOT_MENU)
 	{
 		// Determine code of menu calling current menu_t
-		if ((ret_val = read_eeram(EERAM_CLL_MEN + current_menu.code,
-				p_menu_code, 1)) != LS_OK)
+		uint8_t code;
+
+		if ((ret_val = read_eeram(EERAM_CLL_MEN + current_menu.code, &code, 1))
+				!= LS_OK)
 			goto _EXIT;
+		*p_menu_code = code;
 	}
 	else
 		*p_menu_code = ROOT_MENU;
@@ -1600,7 +1653,7 @@ return_code_t get_calling_menu(item_code_t *p_menu_code)
 return_code_t prompt_calling_menu(void)
 {
 	extern menu_t current_menu;
-	item_code_t calling_code;
+	item_code_t calling_code = ROOT_MENU;	// If the EERAM cannot be read
 
 // Except if we are at the root already
 	if (current_menu.code != ROOT_MENU)
@@ -1627,6 +1680,7 @@ item_code_t update_menu(void)
 	extern menu_t current_menu;
 	int16_t increment = 0;
 	int8_t target = LCD_row;
+	uint8_t previous_row = LCD_row;
 
 // Check encoder position
 	if ((increment = read_encoder(CLK_WISE)))
@@ -1649,7 +1703,7 @@ item_code_t update_menu(void)
 			{
 				LCD_row = LCD_N_ROWS - 1;
 				LCD_scroll = (uint8_t) (target - LCD_row);
-				prompt_menu(DEFAULT_SELECT, current_menu.code);
+				scroll_menu(previous_row);
 			}
 		}
 		// Detect CCW turn of encoder
@@ -1670,7 +1724,7 @@ item_code_t update_menu(void)
 			{
 				LCD_row = 0;
 				LCD_scroll = (uint8_t) (target - LCD_row);
-				prompt_menu(DEFAULT_SELECT, current_menu.code);
+				scroll_menu(previous_row);
 			}
 		}
 	}
@@ -1708,9 +1762,9 @@ return_code_t menu_cycle(void)
 	extern menu_t current_menu;
 	extern bool fresh_load;
 	return_code_t ret_val = LS_OK;
-	menu_t selected_menu;
-	item_code_t running_code;
-	uint32_t start_time;
+	menu_t selected_menu = { 0 };
+	item_code_t running_code = EMPTY;
+	uint32_t start_time = 0;
 	bool cards_seen_in_shoe = false;
 	bool shoe_cleared = false;
 
@@ -1737,6 +1791,7 @@ return_code_t menu_cycle(void)
 			&& !encoder_btn.long_press && !encoder_btn.permanent_press)
 	{
 		watchdog_refresh();
+		fw_staging_poll();
 		// Update screen and check buttons
 		running_code = update_menu();
 		update_btns();
@@ -1766,7 +1821,7 @@ return_code_t menu_cycle(void)
 	}
 
 // Store selected sub-menu for later use
-	if ((ret_val = set_menu(&selected_menu, running_code) != LS_OK))
+	if ((ret_val = set_menu(&selected_menu, running_code)) != LS_OK)
 		goto _EXIT;
 
 // If any press on ENT...
@@ -1793,6 +1848,7 @@ return_code_t menu_cycle(void)
 
 			// Toggle red dot (hence the !is_selected)
 			is_selected ? clear_check(LCD_row) : prompt_check(LCD_row);
+			menu_rows[LCD_row].check = !is_selected;
 			if ((ret_val = write_eeram_bit(address, LCD_row + LCD_scroll,
 					!is_selected)) != LS_OK)
 				goto _EXIT;
@@ -1810,8 +1866,10 @@ return_code_t menu_cycle(void)
 			}
 
 			/* Update current menu as latest calling menu of selected menu_t */
+			uint8_t calling_code = current_menu.code;
+
 			if ((ret_val = write_eeram(EERAM_CLL_MEN + selected_menu.code,
-					&current_menu.code, 1)) != LS_OK)
+					&calling_code, 1)) != LS_OK)
 				goto _EXIT;
 			/* Update current row and offset as default for current menu
 			 * except for non-repeatable menus (Empty, Settings)
@@ -1891,30 +1949,22 @@ return_code_t menu_cycle(void)
 	return ret_val;
 }
 
-void prompt_animated_logo(void)
+// Start the logo animation, frames are then drawn by animation_poll()
+void start_animated_logo(void)
 {
-
-	uint16_t _w;
-	uint16_t _h;
-	uint16_t Xpos;
-	uint16_t Ypos;
-	uint8_t *_add;
-
-	_w = (uint16_t) LOGO_W;
-	_h = (uint16_t) LOGO_H;
-	_add = (uint8_t*) LOGO_ADDRESS;
-
-	Xpos = (BSP_LCD_GetXSize() - _w) / 2;
-	Ypos = (BSP_LCD_GetYSize() - _h) / 2;
+	uint16_t Xpos = (BSP_LCD_GetXSize() - LOGO_W) / 2;
+	uint16_t Ypos = (BSP_LCD_GetYSize() - LOGO_H) / 2;
 
 	BSP_LCD_Clear(LCD_COLOR_BCKGND);
-	HAL_Delay(500);
+	animation_start(ASSET_LOGO_DELTA, Xpos, Ypos, LOGO_START_DELAY);
 
-	for (uint32_t i = 0; i < LOGO_N_FRAMES; i++)
-	{
-		_add = (uint8_t*) (LOGO_ANIM_ADDRESS + i * LOGO_SIZE);
-		ili9488_DrawRGBImage8bit(Xpos, Ypos, _w, _h, _add);
-	}
+	return;
+}
+
+void prompt_animated_logo(void)
+{
+	start_animated_logo();
+	animation_finish();
 
 	return;
 }
@@ -1957,6 +2007,9 @@ void clear_text(void)
 	int top = LCD_TITLE_HEIGHT + 1;
 	int width = BSP_LCD_GetXSize() - ICON_W - LCD_RIGHT_MARGIN;
 	int height = BSP_LCD_GetYSize() - top - LCD_BOTTOM_SPACE;
+
+	// Menu rows are no longer on screen
+	menu_rows_code = -1;
 	BSP_LCD_SetTextColor(LCD_COLOR_BCKGND);
 //	BSP_LCD_SetTextColor(LCD_COLOR_GREEN); // DEBUGGING SCREEN
 	BSP_LCD_FillRect(left, top, width, height);
@@ -2112,8 +2165,8 @@ return_code_t set_param_sub_menu(item_code_t top_menuCode,
 	return LS_OK;
 }
 
-// Get icon address from code
-uint8_t* icon_address(icon_code_t code)
+// Get icon asset from code
+asset_id_t icon_asset(icon_code_t code)
 {
 	int16_t idx;
 // find icon code in (reference) icon list
@@ -2123,9 +2176,9 @@ uint8_t* icon_address(icon_code_t code)
 			break;
 	}
 	if (idx >= n_icons)
-		return NULL;
+		return ASSET_NONE;
 	else
-		return icon_list[idx].address;
+		return icon_list[idx].asset;
 }
 
 void prompt_uid(void)
@@ -2667,24 +2720,10 @@ void prompt_labels(const char *label_1, const char *label_2, uint16_t N,
 	return;
 }
 
-// Function to calculate text width
+// Function to calculate text width (see tftstTextWidth)
 uint16_t calculate_width(const char *text, TFTSTCustomFontData font)
 {
-	uint16_t width = 0;
-	char c;
-
-// Print character until the end
-	for (uint8_t i = 0; i < MAX_ITEM_CHAR; i++)
-	{
-		// Stop if end of string
-		if ((c = text[i]) == 0)
-			break;
-
-		width += font.charData[c - FONT_INDEX_OFFSET].width;
-		width += font.charData[c - FONT_INDEX_OFFSET].left;
-	}
-
-	return width;
+	return tftstTextWidth(&font, text);
 }
 
 // Function to show number
@@ -2706,15 +2745,13 @@ void show_num(uint16_t N_, uint16_t color, uint16_t x_pos,
 
 void display_encoder_icon(icon_code_t icon_code)
 {
-	ili9488_DrawRGBImage8bit(BUTTON_ICON_X, ENCODER_ICON_Y, ICON_W,
-	ICON_H, icon_address(icon_code));
+	draw_asset(icon_asset(icon_code), BUTTON_ICON_X, ENCODER_ICON_Y);
 	return;
 }
 
 void display_escape_icon(icon_code_t icon_code)
 {
-	ili9488_DrawRGBImage8bit(BUTTON_ICON_X, ESCAPE_ICON_Y, ICON_W,
-	ICON_H, icon_address(icon_code));
+	draw_asset(icon_asset(icon_code), BUTTON_ICON_X, ESCAPE_ICON_Y);
 	return;
 }
 
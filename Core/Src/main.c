@@ -23,6 +23,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 
+#include <animation.h>
 #include <bootload.h>
 #include <buttons.h>
 #include <fonts.h>
@@ -46,6 +47,7 @@
 #include <version.h>
 #include "iwdg.h"
 #include "rdp_protection.h"
+#include <rollback.h>
 
 #include "tests.h"
 
@@ -97,6 +99,10 @@ eject_report_t ER;
 load_report_t LR;
 menu_t current_menu;
 
+// Cycles from reset to main(), counted by the bootloader (v3.4+; 0 with an
+// older bootloader). Read with the debugger: /64000 for milliseconds
+volatile uint32_t boot_cycles;
+
 extern game_rules_t void_game_rules;
 extern user_prefs_t void_user_pref;
 
@@ -104,6 +110,7 @@ extern user_prefs_t void_user_pref;
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
+static void MPU_Config(void);
 /* USER CODE BEGIN PFP */
 void EnterBootloaderMode(void);
 static bool CheckServiceModeShortcut(void);
@@ -126,8 +133,13 @@ int main(void)
 	bool sel_rand_mode;
 	bool neutralise_errors = false;
 
+	boot_cycles = DWT->CYCCNT;
+
 	/* USER CODE END 1 */
 
+	/* MPU Configuration--------------------------------------------------------*/
+	MPU_Config();
+
 	/* Enable the CPU Cache */
 
 	/* Enable I-Cache---------------------------------------------------------*/
@@ -204,6 +216,9 @@ int main(void)
 	// Enable flash memory map
 	W25Q64_OSPI_EnableMemoryMappedMode(&hospi2);
 
+	// Index images in flash (asset directory or legacy layout)
+	asset_init();
+
 	// Start encoder mode on TIM2 (encoder)
 	HAL_TIM_Encoder_Start(ENCODER_TIM_CH);
 	// Start TIM12 (microseconds)
@@ -256,24 +271,29 @@ int main(void)
 		goto _ERROR_CATCH;
 	}
 
-	// Prompt animated logo
-	prompt_animated_logo();
-
-	// If ESC pressed during logo prompt, wait for buttons after logo
-	if (escape_btn.interrupt_press)
-	{
-		wait_btns();
-		reset_btns();
-	}
+	// Start animated logo, frames are drawn between the initialisation steps below
+	start_animated_logo();
+	animation_poll();
 
 	// Force latch closed
 	latch_position = LATCH_OPEN;
 	set_latch(LATCH_CLOSED);
+	animation_poll();
 
 	// Initialise carousel
 	if ((status = carousel_init()) != LS_OK)
 		goto _ERROR_CATCH;
 
+	// Play the rest of the logo
+	animation_finish();
+
+	// If ESC pressed during logo prompt, wait for buttons after logo
+	if (escape_btn.interrupt_press)
+	{
+		wait_btns();
+		reset_btns();
+	}
+
 	// Home carousel just after initialisation
 	if ((status = home_carousel()) != LS_OK)
 		goto _ERROR_CATCH;
@@ -306,6 +326,14 @@ int main(void)
 	if ((status = get_n_cards_in()) != LS_OK)
 		goto _ERROR_CATCH;
 
+	// Start-up sequence done: a new firmware on trial is kept (bootloader
+	// v3.5), otherwise the previous one comes back after a few failed boots
+	HAL_OSPI_Abort(&hospi2);
+	rollback_confirm(&hospi2);
+	W25Q64_OSPI_AutoPollingMemReady(&hospi2);
+	W25Q64_OSPI_EnableMemoryMappedMode(&hospi2);
+	W25Q64_OSPI_InvalidateMapped(&hospi2, ROLLBACK_MARKS_OFFSET, ROLLBACK_MARKS);
+
 	// Flag start_up
 	bool start_up = true;
 
@@ -934,6 +962,49 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 
 /* USER CODE END 4 */
 
+/* MPU Configuration */
+
+void MPU_Config(void)
+{
+	MPU_Region_InitTypeDef MPU_InitStruct =
+	{ 0 };
+
+	/* Disables the MPU */
+	HAL_MPU_Disable();
+
+	/** Initializes and configures the Region and the memory to be protected
+	 */
+	MPU_InitStruct.Enable = MPU_REGION_ENABLE;
+	MPU_InitStruct.Number = MPU_REGION_NUMBER0;
+	MPU_InitStruct.BaseAddress = 0x70000000;
+	MPU_InitStruct.Size = MPU_REGION_SIZE_256MB;
+	MPU_InitStruct.SubRegionDisable = 0x0;
+	MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL0;
+	MPU_InitStruct.AccessPermission = MPU_REGION_NO_ACCESS;
+	MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+	MPU_InitStruct.IsShareable = MPU_ACCESS_SHAREABLE;
+	MPU_InitStruct.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+	MPU_InitStruct.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+
+	HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+	/** Initializes and configures the Region and the memory to be protected
+	 */
+	/* External flash window: cached, so whoever erases or programs the W25Q
+	 * drops the lines of that range once the flash is mapped again
+	 * (W25Q64_OSPI_InvalidateMapped) */
+	MPU_InitStruct.Number = MPU_REGION_NUMBER1;
+	MPU_InitStruct.Size = MPU_REGION_SIZE_32MB;
+	MPU_InitStruct.AccessPermission = MPU_REGION_PRIV_RO_URO;
+	MPU_InitStruct.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+	MPU_InitStruct.IsCacheable = MPU_ACCESS_CACHEABLE;
+
+	HAL_MPU_ConfigRegion(&MPU_InitStruct);
+	/* Enables the MPU */
+	HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+
+}
+
 /**
  * @brief  This function is executed in case of error occurrence.
  * @retval None
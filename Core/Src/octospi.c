@@ -114,6 +114,9 @@ void HAL_OSPI_MspInit(OSPI_HandleTypeDef* ospiHandle)
     GPIO_InitStruct.Alternate = GPIO_AF9_OCTOSPIM_P1;
     HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
 
+    /* OCTOSPI2 interrupt Init */
+    HAL_NVIC_SetPriority(OCTOSPI2_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(OCTOSPI2_IRQn);
   /* USER CODE BEGIN OCTOSPI2_MspInit 1 */
   /* USER CODE END OCTOSPI2_MspInit 1 */
   }
@@ -146,6 +149,8 @@ void HAL_OSPI_MspDeInit(OSPI_HandleTypeDef* ospiHandle)
 
     HAL_GPIO_DeInit(GPIOD, GPIO_PIN_11|GPIO_PIN_12|GPIO_PIN_13);
 
+    /* OCTOSPI2 interrupt Deinit */
+    HAL_NVIC_DisableIRQ(OCTOSPI2_IRQn);
   /* USER CODE BEGIN OCTOSPI2_MspDeInit 1 */
   /* USER CODE END OCTOSPI2_MspDeInit 1 */
   }
@@ -56,6 +56,7 @@
 
 /* External variables --------------------------------------------------------*/
 extern PCD_HandleTypeDef hpcd_USB_OTG_HS;
+extern OSPI_HandleTypeDef hospi2;
 extern TIM_HandleTypeDef htim2;
 extern TIM_HandleTypeDef htim12;
 extern TIM_HandleTypeDef htim15;
@@ -327,6 +328,20 @@ void TIM15_IRQHandler(void)
   /* USER CODE END TIM15_IRQn 1 */
 }
 
+/**
+  * @brief This function handles OCTOSPI2 global interrupt.
+  */
+void OCTOSPI2_IRQHandler(void)
+{
+  /* USER CODE BEGIN OCTOSPI2_IRQn 0 */
+
+  /* USER CODE END OCTOSPI2_IRQn 0 */
+  HAL_OSPI_IRQHandler(&hospi2);
+  /* USER CODE BEGIN OCTOSPI2_IRQn 1 */
+
+  /* USER CODE END OCTOSPI2_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
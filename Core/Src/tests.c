@@ -45,6 +45,20 @@ return_code_t test_images(void)
 		return;
 	}
 
+	// Check image CRCs (only known with an asset directory)
+	for (asset_id_t id = 0; id < N_ASSETS; id++)
+		if (asset_get(id) != NULL && asset_verify(id) == LS_ERROR)
+		{
+			BSP_LCD_Clear(LCD_COLOR_BLACK);
+			BSP_LCD_SetFont(&LCD_FIXED_FONT);
+			snprintf(display_buf, N_DISP_MAX, "  Image %u corrompue", id);
+			BSP_LCD_DisplayStringAtLine(7, (uint8_t*) display_buf);
+			BSP_LCD_SetFont(&LCD_FIXED_SMALL_FONT);
+			HAL_Delay(L_WAIT_DELAY);
+			ret_val = LS_ERROR;
+			goto _EXIT;
+		}
+
 	// Test animated logo
 	prompt_animated_logo();
 	HAL_Delay(L_WAIT_DELAY);
@@ -59,11 +73,9 @@ return_code_t test_images(void)
 
 	// Test small logo
 	BSP_LCD_Clear(LCD_COLOR_BCKGND);
-	uint8_t *image_address = (uint8_t*) SMALL_LOGO_ADDRESS;
 	uint16_t Xpos = (BSP_LCD_GetXSize() - SMALL_LOGO_W) / 2;
 	uint16_t Ypos = (BSP_LCD_GetYSize() - SMALL_LOGO_H) / 2;
-	ili9488_DrawRGBImage8bit(Xpos, Ypos, SMALL_LOGO_W, SMALL_LOGO_H,
-			image_address);
+	draw_asset(ASSET_SMALL_LOGO, Xpos, Ypos);
 	HAL_Delay(L_WAIT_DELAY);
 	prompt_test_question("  Petit logo OK ?");
 	wait_btns();
@@ -77,21 +89,20 @@ return_code_t test_images(void)
 	// Test graphic error pictures
 	uint16_t _w = (uint16_t) SILH_W;
 	uint16_t _h = (uint16_t) SILH_H;
-	image_address = (uint8_t*) SILH_ADDRESS;
 	Xpos = (BSP_LCD_GetXSize() - _w) / 2;
 	Ypos = (BSP_LCD_GetYSize() - _h) / 2;
 
-	while (image_address <= (uint8_t*) RESTART_ADDRESS)
+	for (asset_id_t id = ASSET_SILH; id <= ASSET_RESTART; id++)
 	{
 		BSP_LCD_Clear(LCD_COLOR_BCKGND);
-		if (image_address == (uint8_t*) RESTART_ADDRESS)
+		if (id == ASSET_RESTART)
 		{
 			Xpos = (BSP_LCD_GetXSize() - RESTART_W) / 2;
 			Ypos = (BSP_LCD_GetYSize() - RESTART_H) / 2;
 			_w = RESTART_W;
 			_h = RESTART_H;
 		}
-		ili9488_DrawRGBImage8bit(Xpos, Ypos, _w, _h, image_address);
+		draw_asset(id, Xpos, Ypos);
 		HAL_Delay(M_WAIT_DELAY);
 		prompt_test_question("  Image OK ?");
 		wait_btns();
@@ -101,8 +112,6 @@ return_code_t test_images(void)
 			reset_btns();
 			goto _EXIT;
 		}
-		image_address += SILH_SIZE;
-
 	}
 
 	// Test icons
@@ -117,7 +126,7 @@ return_code_t test_images(void)
 	BSP_LCD_Clear(LCD_COLOR_BCKGND);
 	for (uint16_t i = 0; i < n_icons; i++)
 	{
-		ili9488_DrawRGBImage8bit(Xpos, Ypos, _w, _h, icon_list[i].address);
+		draw_asset(icon_list[i].asset, Xpos, Ypos);
 		Xpos += _w + space;
 		if (i == n_icons / 2)
 		{
@@ -153,36 +162,31 @@ void show_images(void)
 
 	// Test small logo
 	BSP_LCD_Clear(LCD_COLOR_BCKGND);
-	uint8_t *image_address = (uint8_t*) SMALL_LOGO_ADDRESS;
 	uint16_t Xpos = (BSP_LCD_GetXSize() - SMALL_LOGO_W) / 2;
 	uint16_t Ypos = (BSP_LCD_GetYSize() - SMALL_LOGO_H) / 2;
-	ili9488_DrawRGBImage8bit(Xpos, Ypos, SMALL_LOGO_W, SMALL_LOGO_H,
-			image_address);
+	draw_asset(ASSET_SMALL_LOGO, Xpos, Ypos);
 	display_encoder_icon(ICON_CHECK);
 	wait_btns();
 
 	// Test graphic error pictures
 	uint16_t _w = (uint16_t) SILH_W;
 	uint16_t _h = (uint16_t) SILH_H;
-	image_address = (uint8_t*) SILH_ADDRESS;
 	Xpos = (BSP_LCD_GetXSize() - _w) / 2;
 	Ypos = (BSP_LCD_GetYSize() - _h) / 2;
 
-	while (image_address <= (uint8_t*) RESTART_ADDRESS)
+	for (asset_id_t id = ASSET_SILH; id <= ASSET_RESTART; id++)
 	{
 		BSP_LCD_Clear(LCD_COLOR_BCKGND);
-		if (image_address == (uint8_t*) RESTART_ADDRESS)
+		if (id == ASSET_RESTART)
 		{
 			Xpos = (BSP_LCD_GetXSize() - RESTART_W) / 2;
 			Ypos = (BSP_LCD_GetYSize() - RESTART_H) / 2;
 			_w = RESTART_W;
 			_h = RESTART_H;
 		}
-		ili9488_DrawRGBImage8bit(Xpos, Ypos, _w, _h, image_address);
+		draw_asset(id, Xpos, Ypos);
 		display_encoder_icon(ICON_CHECK);
 		wait_btns();
-		image_address += SILH_SIZE;
-
 	}
 
 	// Test icons
@@ -197,7 +201,7 @@ void show_images(void)
 	BSP_LCD_Clear(LCD_COLOR_BCKGND);
 	for (uint16_t i = 0; i < n_icons; i++)
 	{
-		ili9488_DrawRGBImage8bit(Xpos, Ypos, _w, _h, icon_list[i].address);
+		draw_asset(icon_list[i].asset, Xpos, Ypos);
 		Xpos += _w + space;
 		if (i == n_icons / 2)
 		{
@@ -523,6 +523,7 @@ void ili9488_FillRect(uint16_t Xpos, uint16_t Ypos, uint16_t Xsize, uint16_t Ysi
 void ili9488_DrawBitmap(uint16_t Xpos, uint16_t Ypos, uint8_t *pbmp)
 {
   uint32_t index = 0, size = 0;
+  (void)Xpos;
   /* Read bitmap size */
   Ypos += pbmp[22] + (pbmp[23] << 8) - 1;
   size = *(volatile uint16_t *) (pbmp + 2);
@@ -618,6 +619,26 @@ void ili9488_DrawRGBImage8bit(uint16_t Xpos, uint16_t Ypos, uint16_t Xsize, uint
 	  ILI9488_LCDMUTEX_POP();
 }
 
+//-----------------------------------------------------------------------------
+/**
+  * @brief  Opens a picture window and starts the memory write.
+  * @param  Xpos:  Image X position in the LCD
+  * @param  Ypos:  Image Y position in the LCD
+  * @param  Xsize: Image X size in the LCD
+  * @param  Ysize: Image Y size in the LCD
+  * @retval None
+  * @brief  Draw direction: right then down
+  * @note   The pixels are then streamed with LCD_IO_WriteDataFill16 and
+  *         LCD_IO_WriteMultipleData16 (parallel interface only)
+  */
+void ili9488_StartRGBImage(uint16_t Xpos, uint16_t Ypos, uint16_t Xsize, uint16_t Ysize)
+{
+  ILI9488_LCDMUTEX_PUSH();
+  ili9488_SetDisplayWindow(Xpos, Ypos, Xsize, Ysize);
+  LCD_IO_WriteCmd8(ILI9488_RAMWR);
+  ILI9488_LCDMUTEX_POP();
+}
+
 //-----------------------------------------------------------------------------
 /**
   * @brief  Read 16bit/pixel vitmap from Lcd..
@@ -52,6 +52,7 @@ extern "C" {
 #define  ILI9488_LCD_PIXEL_HEIGHT  480
 
 void ili9488_DrawRGBImage8bit(uint16_t, uint16_t, uint16_t, uint16_t, uint8_t*);
+void ili9488_StartRGBImage(uint16_t, uint16_t, uint16_t, uint16_t);
 uint16_t ili9488_ReadID(void);
 
 #ifdef __cplusplus
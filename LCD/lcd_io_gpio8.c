@@ -440,6 +440,44 @@ void LCD_IO_WriteData16(uint16_t Data)
   LCD_CS_OFF;
 }
 
+//-----------------------------------------------------------------------------
+/* data only fill (continues a memory write started by a previous command) */
+void LCD_IO_WriteDataFill16(uint16_t Data, uint32_t Size)
+{
+  LCD_CS_ON;
+  while(Size--)
+  {
+    LCD_DATA16_WRITE(Data);
+  }
+  LCD_CS_OFF;
+}
+
+//-----------------------------------------------------------------------------
+/* data only burst (continues a memory write started by a previous command) */
+void LCD_IO_WriteMultipleData16(uint16_t *pData, uint32_t Size)
+{
+  LCD_CS_ON;
+  while(Size--)
+  {
+    LCD_DATA16_WRITE(*pData);
+    pData ++;
+  }
+  LCD_CS_OFF;
+}
+
+//-----------------------------------------------------------------------------
+/* data only burst (continues a memory write started by a previous command) */
+void LCD_IO_WriteMultipleData8(uint8_t *pData, uint32_t Size)
+{
+  LCD_CS_ON;
+  while(Size--)
+  {
+    LCD_DATA8_WRITE(*pData);
+    pData ++;
+  }
+  LCD_CS_OFF;
+}
+
 //-----------------------------------------------------------------------------
 void LCD_IO_WriteCmd8DataFill16(uint8_t Cmd, uint16_t Data, uint32_t Size)
 {
@@ -89,15 +89,13 @@ EndDependencies */
 #include <stm32_adafruit_lcd.h>
 #include "string.h"
 #include "stdbool.h"
+#include "stdint.h"
 
 /* @defgroup STM32_ADAFRUIT_LCD_Private_Defines */
 #define POLY_X(Z)             ((int32_t)((Points + (Z))->X))
 #define POLY_Y(Z)             ((int32_t)((Points + (Z))->Y))
 //#define NULL                  (void *)0
 
-#define MAX_HEIGHT_FONT       17
-#define MAX_WIDTH_FONT        24
-#define OFFSET_BITMAP         54
 
 /* @defgroup STM32_ADAFRUIT_LCD_Private_Macros */
 #define ABS(X) ((X) > 0 ? (X) : -(X))
@@ -105,10 +103,46 @@ EndDependencies */
 #define  LCD_IO_WriteData16_to_2x8(dt)    {LCD_IO_WriteData8((dt) >> 8); LCD_IO_WriteData8(dt); }
 
 
+static uint32_t clearCount = 0;
+
 uint16_t __fgColor = 0;
 uint16_t __bgColor = 0;
 uint16_t __blend[17]={0};
 
+/* Recently used blend tables (see tfstPrepareBlend) */
+#define TFTST_BLEND_CACHE_SIZE  4
+static struct {
+  uint16_t fg;
+  uint16_t bg;
+  uint16_t table[16];
+} blendCache[TFTST_BLEND_CACHE_SIZE];
+static uint8_t blendCacheCount = 0;
+static uint8_t blendCacheNext = 0;
+
+/* Line composition for tftstDrawTextLine */
+#define TFTST_LINE_MAX_CHARS    64
+#define TFTST_LINE_MAX_WIDTH    480
+
+typedef struct {
+  const uint8_t *data;      /* next RLE byte */
+  const uint8_t *end;       /* end of the RLE data */
+  uint8_t  run;             /* pixels left in the current run */
+  uint8_t  alpha;           /* alpha of the current run */
+  int16_t  x;               /* left column on screen */
+  int16_t  top;             /* first row on screen */
+  uint8_t  width;
+  uint8_t  height;
+} TFTSTGlyphStream;
+
+/* Glyph heights of the custom fonts, computed once per font from the RLE data */
+#define TFTST_HEIGHT_FONTS      4
+#define TFTST_N_GLYPHS          ('~' - ' ' + 1)
+static struct {
+  const TFTSTCustomFontCharData *charData;
+  uint8_t height[TFTST_N_GLYPHS];
+} glyphHeights[TFTST_HEIGHT_FONTS];
+static uint8_t glyphHeightsCount = 0;
+
 int TFTST_WIDTH = 320;
 int TFTST_HEIGHT = 480;
 
@@ -117,11 +151,8 @@ LCD_DrawPropTypeDef DrawProp;
 
 extern LCD_DrvTypeDef  *lcd_drv;
 
-/* Max size of bitmap will based on a font24 (17x24) */
-static uint8_t bitmap[MAX_HEIGHT_FONT * MAX_WIDTH_FONT * 2 + OFFSET_BITMAP] = {0};
-
 /* @defgroup STM32_ADAFRUIT_LCD_Private_FunctionPrototypes */ 
-static void DrawChar(uint16_t Xpos, uint16_t Ypos, const uint8_t *c);
+static void DrawChars(uint16_t Xpos, uint16_t Ypos, const uint8_t *Text, uint16_t Count);
 static void SetDisplayWindow(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height);
   
 /**
@@ -238,9 +269,20 @@ sFONT *BSP_LCD_GetFont(void)
   */
 void BSP_LCD_Clear(uint16_t Color)
 {
+  clearCount++;
   lcd_drv->FillRect(0, 0, BSP_LCD_GetXSize(), BSP_LCD_GetYSize(), Color);
 }
 
+/**
+  * @brief  Number of BSP_LCD_Clear() calls so far
+  * @note   Lets a screen that remembers what it drew notice a full clear
+  * @retval Clear count
+  */
+uint32_t BSP_LCD_GetClearCount(void)
+{
+  return clearCount;
+}
+
 /**
   * @brief  Clears the selected line.
   * @param  Line: Line to be cleared
@@ -272,8 +314,20 @@ void BSP_LCD_ClearStringLine(uint16_t Line)
   */
 void BSP_LCD_DisplayChar(uint16_t Xpos, uint16_t Ypos, uint8_t Ascii)
 {
-  DrawChar(Xpos, Ypos, &DrawProp.pFont->table[(Ascii-' ') *\
-    DrawProp.pFont->Height * ((DrawProp.pFont->Width + 7) / 8)]);
+  DrawChars(Xpos, Ypos, &Ascii, 1);
+}
+
+/**
+  * @brief  Displays a number of characters in a single display window.
+  * @param  Xpos: Start column address
+  * @param  Ypos: Line where to display the character shapes
+  * @param  Text: Pointer to the characters to display (not necessarily NUL terminated)
+  * @param  Count: Number of characters to display
+  * @retval None
+  */
+void BSP_LCD_DisplayChars(uint16_t Xpos, uint16_t Ypos, const uint8_t *Text, uint16_t Count)
+{
+  DrawChars(Xpos, Ypos, Text, Count);
 }
 
 /**
@@ -324,17 +378,14 @@ void BSP_LCD_DisplayStringAt(uint16_t Xpos, uint16_t Ypos, uint8_t *Text, Line_M
     }
   }
   
-  /* Send the string character by character on lCD */
-  while ((*Text != 0) & (((BSP_LCD_GetXSize() - (i*DrawProp.pFont->Width)) & 0xFFFF) >= DrawProp.pFont->Width))
+  /* Count the characters that fit on the line */
+  while ((Text[i] != 0) & (((BSP_LCD_GetXSize() - (i*DrawProp.pFont->Width)) & 0xFFFF) >= DrawProp.pFont->Width))
   {
-    /* Display one character on LCD */
-    BSP_LCD_DisplayChar(refcolumn, Ypos, *Text);
-    /* Decrement the column position by 16 */
-    refcolumn += DrawProp.pFont->Width;
-    /* Point on the next character */
-    Text++;
     i++;
   }
+
+  /* Send the whole string in one window */
+  DrawChars(refcolumn, Ypos, Text, i);
 }
 
 /**
@@ -825,71 +876,59 @@ void BSP_LCD_DisplayOff(void)
 *******************************************************************************/
 
 /**
-  * @brief  Draws a character on LCD.
-  * @param  Xpos: Line where to display the character shape
-  * @param  Ypos: Start column address
-  * @param  pChar: Pointer to the character data
+  * @brief  Draws characters on LCD.
+  * @note   The glyph rows are expanded from the 1-bit font into colour runs
+  *         and streamed top-down into one display window, row by row across
+  *         all the characters.
+  * @param  Xpos: Start column address
+  * @param  Ypos: Line where to display the character shapes (from the bottom)
+  * @param  Text: Pointer to the characters
+  * @param  Count: Number of characters
   * @retval None
   */
-static void DrawChar(uint16_t Xpos, uint16_t Ypos, const uint8_t *pChar)
+static void DrawChars(uint16_t Xpos, uint16_t Ypos, const uint8_t *Text, uint16_t Count)
 {
-  uint32_t counterh = 0, counterw = 0, index = 0;
-  uint16_t height = 0, width = 0;
-  uint8_t offset = 0;
-  uint8_t *pchar = NULL;
-  uint32_t line = 0;
-  
-  height = DrawProp.pFont->Height;
-  width  = DrawProp.pFont->Width;
-  
-  /* Fill bitmap header*/
-  *(uint16_t *) (bitmap + 2) = (uint16_t)(height*width*2+OFFSET_BITMAP);
-  *(uint16_t *) (bitmap + 4) = (uint16_t)((height*width*2+OFFSET_BITMAP)>>16);
-  *(uint16_t *) (bitmap + 10) = OFFSET_BITMAP;
-  *(uint16_t *) (bitmap + 18) = (uint16_t)(width);
-  *(uint16_t *) (bitmap + 20) = (uint16_t)((width)>>16);
-  *(uint16_t *) (bitmap + 22) = (uint16_t)(height);
-  *(uint16_t *) (bitmap + 24) = (uint16_t)((height)>>16);
-  
-  offset =  8 *((width + 7)/8) - width ;
-  
-  for(counterh = 0; counterh < height; counterh++)
+  uint16_t height = DrawProp.pFont->Height;
+  uint16_t width  = DrawProp.pFont->Width;
+  uint16_t bytes  = (width + 7) / 8;
+  uint16_t color  = DrawProp.BackColor;
+  uint32_t run = 0;
+
+  if((Count == 0) || (Ypos + height > BSP_LCD_GetYSize()))
   {
-    pchar = ((uint8_t *)pChar + (width + 7)/8 * counterh);
-    
-    if(((width + 7)/8) == 3)
-    {
-      line =  (pchar[0]<< 16) | (pchar[1]<< 8) | pchar[2];
-    }
-    
-    if(((width + 7)/8) == 2)
-    {
-      line =  (pchar[0]<< 8) | pchar[1];
-    }
-    
-    if(((width + 7)/8) == 1)
-    {
-      line =  pchar[0];
-    }    
-    
-    for (counterw = 0; counterw < width; counterw++)
+    return;
+  }
+
+  /* Ypos is the bottom of the characters: the window is addressed top-down */
+  SetDisplayWindow(Xpos, BSP_LCD_GetYSize() - Ypos - height, width * Count, height);
+  LCD_IO_WriteCmd8(0x2C);
+
+  for(uint16_t counterh = 0; counterh < height; counterh++)
+  {
+    for(uint16_t n = 0; n < Count; n++)
     {
-      /* Image in the bitmap is written from the bottom to the top */
-      /* Need to invert image in the bitmap */
-      index = (((height-counterh-1)*width)+(counterw))*2+OFFSET_BITMAP;
-      if(line & (1 << (width- counterw + offset- 1))) 
+      const uint8_t *pchar = &DrawProp.pFont->table[(Text[n] - ' ') * height * bytes + counterh * bytes];
+
+      for(uint16_t counterw = 0; counterw < width; counterw++)
       {
-        bitmap[index] = (uint8_t)DrawProp.TextColor;
-        bitmap[index+1] = (uint8_t)(DrawProp.TextColor >> 8);
+        uint16_t pixel = (pchar[counterw >> 3] & (0x80 >> (counterw & 7))) ? DrawProp.TextColor : DrawProp.BackColor;
+        if(pixel != color)
+        {
+          /* Flush the current run */
+          if(run)
+          {
+            LCD_IO_WriteDataFill16(color, run);
+          }
+          color = pixel;
+          run = 0;
+        }
+        run++;
       }
-      else
-      {
-        bitmap[index] = (uint8_t)DrawProp.BackColor;
-        bitmap[index+1] = (uint8_t)(DrawProp.BackColor >> 8);
-      } 
     }
   }
-  BSP_LCD_DrawBitmap(Xpos, Ypos, bitmap);
+  LCD_IO_WriteDataFill16(color, run);
+
+  SetDisplayWindow(0, 0, BSP_LCD_GetXSize(), BSP_LCD_GetYSize());
 }
 
 /**
@@ -1072,6 +1111,8 @@ void BSP_LCD_Scroll(int16_t Scroll, uint16_t TopFix, uint16_t BottonFix)
 
 /**
   * @brief  Set the color parameters
+  * @note   The last TFTST_BLEND_CACHE_SIZE colour pairs are kept, so that
+  *         alternating between a few text colours does not rebuild the table
   * @param  color1    : Foreground color
   * @param  color2    : Background color
   * @retval None
@@ -1080,6 +1121,16 @@ void tfstPrepareBlend(uint16_t color1, uint16_t color2) {
     if (__fgColor == color1 && __bgColor == color2) {
         return;
     }
+
+    for (uint8_t k = 0; k < blendCacheCount; k++) {
+        if (blendCache[k].fg == color1 && blendCache[k].bg == color2) {
+            memcpy(__blend, blendCache[k].table, sizeof(blendCache[k].table));
+            __fgColor = color1;
+            __bgColor = color2;
+            return;
+        }
+    }
+
     uint8_t color1Red = color1 >> 11;
     uint8_t color1Green = (color1 >> 5) & 0b00111111;
     uint8_t color1Blue = color1 & 0b00011111;
@@ -1098,6 +1149,12 @@ void tfstPrepareBlend(uint16_t color1, uint16_t color2) {
     }
     __fgColor = color1;
     __bgColor = color2;
+
+    blendCache[blendCacheNext].fg = color1;
+    blendCache[blendCacheNext].bg = color2;
+    memcpy(blendCache[blendCacheNext].table, __blend, sizeof(blendCache[blendCacheNext].table));
+    blendCacheNext = (blendCacheNext + 1) % TFTST_BLEND_CACHE_SIZE;
+    if (blendCacheCount < TFTST_BLEND_CACHE_SIZE) blendCacheCount++;
 }
 
 /**
@@ -1113,23 +1170,309 @@ void tfstPrepareBlend(uint16_t color1, uint16_t color2) {
 void tftstDrawCharWithFont(TFTSTCustomFontData *font, uint16_t x, uint16_t y, uint16_t c, uint16_t color, uint16_t bg){
     tfstPrepareBlend(color, bg);
     TFTSTCustomFontCharData charData = font->charData[c - 32];
-    if (charData.left >= 0){
-    	LCD_IO_WriteCmd8(0x2A); LCD_IO_WriteData16_to_2x8(x + charData.left); LCD_IO_WriteData16_to_2x8(x + charData.left + charData.width - 1);
-    	LCD_IO_WriteCmd8(0x2B); LCD_IO_WriteData16_to_2x8(y + charData.top); LCD_IO_WriteData16_to_2x8(TFTST_HEIGHT);
-    	LCD_IO_WriteCmd8(0x2C);
-    } else {
-    	LCD_IO_WriteCmd8(0x2A); LCD_IO_WriteData16_to_2x8(x + charData.left); LCD_IO_WriteData16_to_2x8(x + charData.left + charData.width - 1);
-    	LCD_IO_WriteCmd8(0x2B); LCD_IO_WriteData16_to_2x8(y + charData.top); LCD_IO_WriteData16_to_2x8(TFTST_HEIGHT);
-    	LCD_IO_WriteCmd8(0x2C);
-    }
+    LCD_IO_WriteCmd8(0x2A); LCD_IO_WriteData16_to_2x8(x + charData.left); LCD_IO_WriteData16_to_2x8(x + charData.left + charData.width - 1);
+    LCD_IO_WriteCmd8(0x2B); LCD_IO_WriteData16_to_2x8(y + charData.top); LCD_IO_WriteData16_to_2x8(TFTST_HEIGHT);
+    LCD_IO_WriteCmd8(0x2C);
 
+    /* One fill per run rather than one bus transaction per pixel */
     for (int16_t i = 0; i < charData.size; i++) {
         int16_t count = charData.compressedData[i] >> 4;
         int16_t alpha = charData.compressedData[i] & 15;
-        for (uint8_t j = 0; j < count; j++) {
-        	LCD_IO_WriteData16(__blend[alpha]);
+        if (count) {
+            LCD_IO_WriteDataFill16(__blend[alpha], count);
+        }
+    }
+}
+
+/**
+  * @brief  Decode the next pixels of a glyph stream
+  * @param  *g       : Glyph stream
+  * @param  *line    : Line buffer (NULL to skip the pixels)
+  * @param  px       : Position of the first pixel in the line buffer
+  * @param  count    : Number of pixels to decode
+  * @param  lineSize : Width of the line buffer
+  * @retval None
+  */
+static void tftstDecodeGlyphPixels(TFTSTGlyphStream *g, uint16_t *line, int16_t px, uint16_t count, uint16_t lineSize)
+{
+    while (count) {
+        if (g->run == 0) {
+            if (g->data == g->end) {
+                return;
+            }
+            g->run = *g->data >> 4;
+            g->alpha = *g->data & 15;
+            g->data++;
+            continue;
+        }
+        uint8_t n = (g->run < count) ? g->run : count;
+        /* Transparent runs leave the background (or an overlapping glyph) untouched */
+        if (line != NULL && g->alpha) {
+            for (uint8_t j = 0; j < n; j++) {
+                if (px + j >= 0 && px + j < lineSize) {
+                    line[px + j] = __blend[g->alpha];
+                }
+            }
+        }
+        px += n;
+        g->run -= n;
+        count -= n;
+    }
+}
+
+/**
+  * @brief  Height in rows of a glyph of a custom font
+  * @note   The fonts only store the RLE data, whose run lengths add up to
+  *         width x height. They are summed once per font and kept.
+  * @param  *font : Custom Font
+  * @param  c     : Character, ' ' to '~'
+  * @retval Height
+  */
+static uint8_t tftstGlyphHeight(TFTSTCustomFontData *font, char c)
+{
+    TFTSTCustomFontCharData *charData = &font->charData[c - 32];
+    uint8_t k;
+
+    for (k = 0; k < glyphHeightsCount; k++) {
+        if (glyphHeights[k].charData == font->charData) {
+            return glyphHeights[k].height[c - 32];
+        }
+    }
+
+    /* More fonts than expected: no table, sum this glyph */
+    if (glyphHeightsCount == TFTST_HEIGHT_FONTS) {
+        uint32_t pixels = 0;
+        for (uint16_t i = 0; i < charData->size; i++) pixels += charData->compressedData[i] >> 4;
+        return charData->width ? pixels / charData->width : 0;
+    }
+
+    glyphHeights[k].charData = font->charData;
+    for (uint8_t j = 0; j < TFTST_N_GLYPHS; j++) {
+        TFTSTCustomFontCharData *d = &font->charData[j];
+        uint32_t pixels = 0;
+        for (uint16_t i = 0; i < d->size; i++) pixels += d->compressedData[i] >> 4;
+        glyphHeights[k].height[j] = d->width ? pixels / d->width : 0;
+    }
+    glyphHeightsCount++;
+
+    return glyphHeights[k].height[c - 32];
+}
+
+/**
+  * @brief  Advance and right edge of a line of text
+  * @note   The glyphs are laid out as by tftstDrawTextLine from x = 0, without
+  *         clipping to the screen.
+  * @param  *font      : Custom Font
+  * @param  *firstFont : Custom Font for the first character (NULL to use font)
+  * @param  *text      : Text (String)
+  * @param  maxChars   : Characters measured at most
+  * @param  *right     : End of the last drawn glyph, relative to the origin (NULL if not needed)
+  * @retval Advance (sum of the glyph left offsets and widths)
+  */
+static uint16_t tftstMeasureText(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, const char *text,
+                                 uint16_t maxChars, int16_t *right)
+{
+    uint16_t advance = 0;
+    int16_t xMax = 0;
+
+    for (uint16_t i = 0; text[i] != 0 && i < maxChars; i++) {
+        char c = text[i];
+        if (c < ' ' || c > '~') c = '_';
+        TFTSTCustomFontData *f = (i == 0 && firstFont != NULL) ? firstFont : font;
+        TFTSTCustomFontCharData *charData = &f->charData[c - 32];
+        advance += charData->left + charData->width;
+        if (charData->width != 0 && (int16_t)advance > xMax) xMax = advance;
+    }
+    if (right != NULL) *right = xMax;
+
+    return advance;
+}
+
+/**
+  * @brief  Compose a line of text and send it in a single window
+  * @note   The window is painted row by row: each row is composed in a line
+  *         buffer (background + alpha-blended glyph runs) and sent as one
+  *         burst, so the address window and RAMWR are issued only once.
+  * @param  *font      : Custom Font
+  * @param  *firstFont : Custom Font for the first character (NULL to use font)
+  * @param  x          : X position of the text origin
+  * @param  y          : Y position of the text origin
+  * @param  *text      : Text (String)
+  * @param  color      : Text Color
+  * @param  bg         : Background Color
+  * @param  boxX       : X position of the painted window
+  * @param  boxY       : Y position of the painted window
+  * @param  boxWidth   : Width of the painted window (0 to fit the glyphs)
+  * @param  boxHeight  : Height of the painted window
+  * @retval None
+  */
+static void tftstStreamTextLine(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, uint16_t y, const char *text, uint16_t color, uint16_t bg,
+                                int16_t boxX, int16_t boxY, uint16_t boxWidth, uint16_t boxHeight)
+{
+    static TFTSTGlyphStream glyphs[TFTST_LINE_MAX_CHARS];
+    static uint16_t line[TFTST_LINE_MAX_WIDTH];
+    uint16_t xSize = BSP_LCD_GetXSize();
+    uint16_t ySize = BSP_LCD_GetYSize();
+    int16_t cursor = x;
+    int16_t xMin = INT16_MAX, xMax = INT16_MIN, yMin = INT16_MAX, yMax = INT16_MIN;
+    uint16_t n = 0;
+
+    if (xSize > TFTST_LINE_MAX_WIDTH) xSize = TFTST_LINE_MAX_WIDTH;
+
+    tfstPrepareBlend(color, bg);
+
+    /* Lay out the glyphs */
+    for (uint16_t i = 0; text[i] != 0 && n < TFTST_LINE_MAX_CHARS; i++) {
+        char c = text[i];
+        if (c < ' ' || c > '~') c = '_';
+        TFTSTCustomFontData *f = (i == 0 && firstFont != NULL) ? firstFont : font;
+        TFTSTCustomFontCharData *charData = &f->charData[c - 32];
+        int16_t gx = cursor + charData->left;
+        cursor += charData->left + charData->width;
+        if (gx + charData->width > xSize) break;
+        if (charData->width == 0) continue;
+
+        TFTSTGlyphStream *g = &glyphs[n++];
+        g->data = charData->compressedData;
+        g->end = charData->compressedData + charData->size;
+        g->run = 0;
+        g->alpha = 0;
+        g->x = gx;
+        g->top = y + charData->top;
+        g->width = charData->width;
+        g->height = tftstGlyphHeight(f, c);
+
+        if (g->x < xMin) xMin = g->x;
+        if (g->x + g->width > xMax) xMax = g->x + g->width;
+        if (g->top < yMin) yMin = g->top;
+        if (g->top + g->height > yMax) yMax = g->top + g->height;
+    }
+
+    if (boxWidth == 0) {
+        if (n == 0) return;
+        boxX = xMin; boxWidth = xMax - xMin;
+        boxY = yMin; boxHeight = yMax - yMin;
+    }
+
+    /* Clip the window to the screen */
+    if (boxX < 0) { boxWidth = (boxWidth > -boxX) ? boxWidth + boxX : 0; boxX = 0; }
+    if (boxY < 0) { boxHeight = (boxHeight > -boxY) ? boxHeight + boxY : 0; boxY = 0; }
+    if (boxX + boxWidth > xSize) boxWidth = (boxX < xSize) ? xSize - boxX : 0;
+    if (boxY + boxHeight > ySize) boxHeight = (boxY < ySize) ? ySize - boxY : 0;
+    if (boxWidth == 0 || boxHeight == 0) return;
+
+    /* Skip glyph rows above the window */
+    for (uint16_t k = 0; k < n; k++) {
+        if (glyphs[k].top < boxY) {
+            int16_t rows = boxY - glyphs[k].top;
+            if (rows > glyphs[k].height) rows = glyphs[k].height;
+            tftstDecodeGlyphPixels(&glyphs[k], NULL, 0, rows * glyphs[k].width, 0);
+        }
+    }
+
+    LCD_IO_WriteCmd8(0x2A); LCD_IO_WriteData16_to_2x8(boxX); LCD_IO_WriteData16_to_2x8(boxX + boxWidth - 1);
+    LCD_IO_WriteCmd8(0x2B); LCD_IO_WriteData16_to_2x8(boxY); LCD_IO_WriteData16_to_2x8(boxY + boxHeight - 1);
+    LCD_IO_WriteCmd8(0x2C);
+
+    for (int16_t row = boxY; row < boxY + boxHeight; row++) {
+        for (uint16_t j = 0; j < boxWidth; j++) line[j] = bg;
+        for (uint16_t k = 0; k < n; k++) {
+            TFTSTGlyphStream *g = &glyphs[k];
+            if (row >= g->top && row < g->top + g->height) {
+                tftstDecodeGlyphPixels(g, line, g->x - boxX, g->width, boxWidth);
+            }
         }
+        LCD_IO_WriteMultipleData16(line, boxWidth);
+    }
+}
+
+/**
+  * @brief  Draw a line of text with custom font(s) in one window
+  * @note   The bounding box of the glyphs is painted, including the gaps
+  *         between them
+  * @param  *font      : Custom Font
+  * @param  *firstFont : Custom Font for the first character (NULL to use font)
+  * @param  x          : X position
+  * @param  y          : Y position
+  * @param  *text      : Text (String)
+  * @param  color      : Text Color
+  * @param  bg         : Background Color
+  * @retval None
+  */
+void tftstDrawTextLine(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, uint16_t y, const char *text, uint16_t color, uint16_t bg)
+{
+    tftstStreamTextLine(font, firstFont, x, y, text, color, bg, 0, 0, 0, 0);
+}
+
+/**
+  * @brief  Draw a line of text with custom font(s), painting a whole box
+  * @note   The box is cleared with the background color and the glyphs are
+  *         clipped to it, so clearing and drawing a row is one window
+  * @param  *font      : Custom Font
+  * @param  *firstFont : Custom Font for the first character (NULL to use font)
+  * @param  x          : X position
+  * @param  y          : Y position
+  * @param  *text      : Text (String)
+  * @param  color      : Text Color
+  * @param  bg         : Background Color
+  * @param  boxX       : X position of the box
+  * @param  boxY       : Y position of the box
+  * @param  boxWidth   : Width of the box
+  * @param  boxHeight  : Height of the box
+  * @retval None
+  */
+void tftstDrawTextLineInBox(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, uint16_t y, const char *text, uint16_t color, uint16_t bg,
+                            uint16_t boxX, uint16_t boxY, uint16_t boxWidth, uint16_t boxHeight)
+{
+    if (boxWidth == 0 || boxHeight == 0) return;
+    tftstStreamTextLine(font, firstFont, x, y, text, color, bg, boxX, boxY, boxWidth, boxHeight);
+}
+
+/**
+  * @brief  Right edge of a line of text laid out as by tftstDrawTextLine
+  * @param  *font      : Custom Font
+  * @param  *firstFont : Custom Font for the first character (NULL to use font)
+  * @param  x          : X position
+  * @param  *text      : Text (String)
+  * @retval X just after the last drawn glyph, x if nothing is drawn
+  */
+uint16_t tftstTextLineRight(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, const char *text)
+{
+    uint16_t xSize = BSP_LCD_GetXSize();
+    int16_t cursor = x;
+    int16_t xMax = x;
+    int16_t right;
+
+    /* Up to the characters tftstDrawTextLine lays out */
+    tftstMeasureText(font, firstFont, text, TFTST_LINE_MAX_CHARS, &right);
+    if (right <= 0) return x;
+    if (x + right <= xSize) return x + right;
+
+    /* Clipped by the screen edge: lay out the glyphs that fit */
+    for (uint16_t i = 0; text[i] != 0 && i < TFTST_LINE_MAX_CHARS; i++) {
+        char c = text[i];
+        if (c < ' ' || c > '~') c = '_';
+        TFTSTCustomFontData *f = (i == 0 && firstFont != NULL) ? firstFont : font;
+        TFTSTCustomFontCharData *charData = &f->charData[c - 32];
+        int16_t gx = cursor + charData->left;
+        cursor += charData->left + charData->width;
+        if (gx + charData->width > xSize) break;
+        if (charData->width != 0 && gx + charData->width > xMax) xMax = gx + charData->width;
     }
+
+    return xMax;
+}
+
+/**
+  * @brief  Advance of a line of text (sum of the glyph left offsets and widths)
+  * @note   The whole string is measured, with no TFTST_LINE_MAX_CHARS limit
+  * @param  *font : Custom Font
+  * @param  *text : Text (String)
+  * @retval Width in pixels
+  */
+uint16_t tftstTextWidth(TFTSTCustomFontData *font, const char *text)
+{
+    return tftstMeasureText(font, NULL, text, UINT16_MAX, NULL);
 }
 
 /**
@@ -149,10 +149,12 @@ void     BSP_LCD_SetFont(sFONT *fonts);
 sFONT *  BSP_LCD_GetFont(void);
 
 void     BSP_LCD_Clear(uint16_t Color);
+uint32_t BSP_LCD_GetClearCount(void);
 void     BSP_LCD_ClearStringLine(uint16_t Line);
 void     BSP_LCD_DisplayStringAtLine(uint16_t Line, uint8_t *ptr);
 void     BSP_LCD_DisplayStringAt(uint16_t Xpos, uint16_t Ypos, uint8_t *Text, Line_ModeTypdef Mode);
 void     BSP_LCD_DisplayChar(uint16_t Xpos, uint16_t Ypos, uint8_t Ascii);
+void     BSP_LCD_DisplayChars(uint16_t Xpos, uint16_t Ypos, const uint8_t *Text, uint16_t Count);
 
 void     BSP_LCD_DrawPixel(uint16_t Xpos, uint16_t Ypos, uint16_t RGB_Code);
 void     BSP_LCD_DrawHLine(uint16_t Xpos, uint16_t Ypos, uint16_t Length);
@@ -178,6 +180,9 @@ void     BSP_LCD_DrawRGB16Image(uint16_t Xpos, uint16_t Ypos, uint16_t Xsize, ui
 void     BSP_LCD_ReadRGB16Image(uint16_t Xpos, uint16_t Ypos, uint16_t Xsize, uint16_t Ysize, uint16_t *pData);
 void     BSP_LCD_Scroll(int16_t Scroll, uint16_t TopFix, uint16_t BottonFix);
 void 	 LCD_IO_WriteData16(uint16_t Data);
+void     LCD_IO_WriteDataFill16(uint16_t Data, uint32_t Size);
+void     LCD_IO_WriteMultipleData16(uint16_t *pData, uint32_t Size);
+void     LCD_IO_WriteMultipleData8(uint8_t *pData, uint32_t Size);
 void 	 LCD_IO_WriteData8(uint8_t Data);
 void     LCD_IO_WriteCmd8(uint8_t Cmd);
 
@@ -185,6 +190,11 @@ void     LCD_IO_WriteCmd8(uint8_t Cmd);
 void 	 tfstPrepareBlend(uint16_t color1, uint16_t color2) ;
 void 	 tftstDrawTextWithFont(TFTSTCustomFontData *font, uint16_t x, uint16_t y, char *_text, uint16_t color, uint16_t bg);
 void 	 tftstDrawCharWithFont(TFTSTCustomFontData *font, uint16_t x, uint16_t y, uint16_t c, uint16_t color, uint16_t bg);
+void     tftstDrawTextLine(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, uint16_t y, const char *text, uint16_t color, uint16_t bg);
+void     tftstDrawTextLineInBox(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, uint16_t y, const char *text, uint16_t color, uint16_t bg,
+                                uint16_t boxX, uint16_t boxY, uint16_t boxWidth, uint16_t boxHeight);
+uint16_t tftstTextLineRight(TFTSTCustomFontData *font, TFTSTCustomFontData *firstFont, uint16_t x, const char *text);
+uint16_t tftstTextWidth(TFTSTCustomFontData *font, const char *text);
 #ifdef __cplusplus
 }
 #endif
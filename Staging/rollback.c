@@ -0,0 +1,90 @@
+#include <rollback.h>
+#include <checksum.h>
+#include <stddef.h>
+
+HAL_StatusTypeDef rollback_read_record(OSPI_HandleTypeDef *hospi,
+		rollback_record_t *record)
+{
+	if (W25Q64_OSPI_Read(hospi, (uint8_t*) record, ROLLBACK_OFFSET,
+			sizeof(rollback_record_t)) != HAL_OK)
+		return HAL_ERROR;
+
+	if (record->magic != ROLLBACK_RECORD_MAGIC
+			|| crc32_ieee(CRC32_INIT, (const uint8_t*) record,
+					offsetof(rollback_record_t, record_crc)) != record->record_crc
+			|| record->image_size == 0 || record->image_size % 32 != 0
+			|| record->image_size > ROLLBACK_IMAGE_MAX)
+		return HAL_ERROR;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef rollback_write_record(OSPI_HandleTypeDef *hospi,
+		rollback_record_t *record)
+{
+	record->magic = ROLLBACK_RECORD_MAGIC;
+	record->record_crc = crc32_ieee(CRC32_INIT, (const uint8_t*) record,
+			offsetof(rollback_record_t, record_crc));
+
+	return W25Q64_OSPI_Write(hospi, (uint8_t*) record, ROLLBACK_OFFSET,
+			sizeof(rollback_record_t));
+}
+
+static HAL_StatusTypeDef erase_sector(OSPI_HandleTypeDef *hospi,
+		uint32_t address)
+{
+	if (W25Q64_OSPI_EraseBlockStart(hospi, address, W25Q_SECTOR_SIZE)
+			!= HAL_OK)
+		return HAL_ERROR;
+
+	return W25Q64_OSPI_AutoPollingMemReady(hospi);
+}
+
+HAL_StatusTypeDef rollback_clear(OSPI_HandleTypeDef *hospi)
+{
+	return erase_sector(hospi, ROLLBACK_OFFSET);
+}
+
+HAL_StatusTypeDef rollback_read_marks(OSPI_HandleTypeDef *hospi,
+		bool marks[ROLLBACK_MARKS])
+{
+	uint8_t bytes[ROLLBACK_MARKS];
+
+	if (W25Q64_OSPI_Read(hospi, bytes, ROLLBACK_MARKS_OFFSET, ROLLBACK_MARKS)
+			!= HAL_OK)
+		return HAL_ERROR;
+
+	// A mark cut short by a reset reads as set
+	for (uint32_t i = 0; i < ROLLBACK_MARKS; i++)
+		marks[i] = bytes[i] != 0xFF;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef rollback_set_mark(OSPI_HandleTypeDef *hospi, uint32_t mark)
+{
+	uint8_t set = 0x00;
+
+	if (mark >= ROLLBACK_MARKS)
+		return HAL_ERROR;
+
+	return W25Q64_OSPI_Write(hospi, &set, ROLLBACK_MARKS_OFFSET + mark, 1);
+}
+
+HAL_StatusTypeDef rollback_new_trial(OSPI_HandleTypeDef *hospi)
+{
+	return erase_sector(hospi, ROLLBACK_MARKS_OFFSET);
+}
+
+HAL_StatusTypeDef rollback_confirm(OSPI_HandleTypeDef *hospi)
+{
+	bool marks[ROLLBACK_MARKS];
+
+	if (rollback_read_marks(hospi, marks) != HAL_OK)
+		return HAL_ERROR;
+
+	if (marks[ROLLBACK_MARK_CONFIRMED])
+		return HAL_OK;
+
+	return rollback_set_mark(hospi, ROLLBACK_MARK_CONFIRMED);
+}
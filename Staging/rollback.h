@@ -0,0 +1,120 @@
+/*
+ * rollback.h
+ *
+ * Rollback slot in the W25Q external flash: the last known-good application,
+ * kept by Bootloader_E before an install replaces it and restored when the
+ * new image does not confirm itself within ROLLBACK_TRIAL_BOOTS boots.
+ * Shared by the application (rollback_confirm()) and the bootloader
+ * (backup, trial boots, restore in bootload.c).
+ *
+ * Layout from ROLLBACK_OFFSET:
+ *   sector 0: rollback_record_t, written last, once the backup is read back
+ *   sector 1: trial marks, one byte each, programmed to 0x00 when set and
+ *             erased when a new image goes on trial
+ *   ROLLBACK_IMAGE_OFFSET: the image encrypted with the device's AES key
+ *             (CBC, record IV), then its SHA-256 encrypted in the same chain
+ *
+ * The hash is only readable with the key, so a backup altered in the W25Q
+ * is refused before the application is made valid. Both sides use the W25Q
+ * in indirect mode: the application leaves memory-mapped mode around these
+ * calls.
+ *
+ * The slot sits below the staging area, 24-bit addresses: image uploads
+ * stop at ROLLBACK_OFFSET.
+ */
+
+#ifndef ROLLBACK_H_
+#define ROLLBACK_H_
+
+#include <main.h>
+#include <stdbool.h>
+#include <W25Q64.h>
+
+#define ROLLBACK_OFFSET			0x00E00000UL	// 14 MB
+#define ROLLBACK_SIZE			0x00100000UL
+#define ROLLBACK_MARKS_OFFSET	(ROLLBACK_OFFSET + W25Q_SECTOR_SIZE)
+#define ROLLBACK_IMAGE_OFFSET	(ROLLBACK_OFFSET + W25Q_BLOCK64_SIZE)
+#define ROLLBACK_DIGEST_SIZE	32				// SHA-256 after the image
+#define ROLLBACK_IMAGE_MAX		(ROLLBACK_OFFSET + ROLLBACK_SIZE \
+		- ROLLBACK_IMAGE_OFFSET - ROLLBACK_DIGEST_SIZE)
+
+#define ROLLBACK_RECORD_MAGIC	0x4B42534C		// "LSBK" in little-endian
+
+// Boots an image on trial gets to confirm itself
+#define ROLLBACK_TRIAL_BOOTS	3
+
+// Trial marks: a byte other than 0xFF is set
+#define ROLLBACK_MARK_CONFIRMED	0				// Application booted fine
+#define ROLLBACK_MARK_RESTORE	1				// Backup being restored
+#define ROLLBACK_MARK_BOOT		2				// + n: trial boot n started
+#define ROLLBACK_MARKS			(ROLLBACK_MARK_BOOT + ROLLBACK_TRIAL_BOOTS)
+
+typedef struct __attribute__((packed))
+{
+	uint32_t magic;				// ROLLBACK_RECORD_MAGIC
+	uint32_t image_size;		// Bytes, whole flash words
+	uint32_t image_crc;			// CRC32 of the image, as in its validity record
+	uint8_t iv[16];				// AES-CBC IV of the image
+	uint32_t record_crc;		// CRC32 of the bytes above
+} rollback_record_t;
+
+/**
+ * @brief Read the rollback record
+ * @param hospi W25Q handle, indirect mode
+ * @param record Filled with the record
+ * @return HAL_OK if a complete backup is kept
+ */
+HAL_StatusTypeDef rollback_read_record(OSPI_HandleTypeDef *hospi,
+		rollback_record_t *record);
+
+/**
+ * @brief Mark the backup complete: set magic and record_crc and program the
+ *        record sector (erased by rollback_clear())
+ * @param hospi W25Q handle, indirect mode
+ * @param record image_size, image_crc and iv filled in by the caller
+ * @return HAL status
+ */
+HAL_StatusTypeDef rollback_write_record(OSPI_HandleTypeDef *hospi,
+		rollback_record_t *record);
+
+/**
+ * @brief Forget the backup (erase the record sector)
+ * @param hospi W25Q handle, indirect mode
+ * @return HAL status
+ */
+HAL_StatusTypeDef rollback_clear(OSPI_HandleTypeDef *hospi);
+
+/**
+ * @brief Read the trial marks
+ * @param hospi W25Q handle, indirect mode
+ * @param marks Filled with ROLLBACK_MARKS booleans
+ * @return HAL status
+ */
+HAL_StatusTypeDef rollback_read_marks(OSPI_HandleTypeDef *hospi,
+		bool marks[ROLLBACK_MARKS]);
+
+/**
+ * @brief Set one trial mark
+ * @param hospi W25Q handle, indirect mode
+ * @param mark ROLLBACK_MARK_*
+ * @return HAL status
+ */
+HAL_StatusTypeDef rollback_set_mark(OSPI_HandleTypeDef *hospi, uint32_t mark);
+
+/**
+ * @brief Clear all trial marks (erase their sector) for a new image
+ * @param hospi W25Q handle, indirect mode
+ * @return HAL status
+ */
+HAL_StatusTypeDef rollback_new_trial(OSPI_HandleTypeDef *hospi);
+
+/**
+ * @brief Called by the application once it has booted fine: the bootloader
+ *        then keeps it instead of restoring the backup. Programs the mark
+ *        only if it is not set yet.
+ * @param hospi W25Q handle, indirect mode
+ * @return HAL status
+ */
+HAL_StatusTypeDef rollback_confirm(OSPI_HandleTypeDef *hospi);
+
+#endif /* ROLLBACK_H_ */
@@ -0,0 +1,73 @@
+/*
+ * sfu.h
+ *
+ * Secure firmware update (.sfu) file header, written by
+ * Tools/encrypt_firmware.py and read by Bootloader_E (USB update and staged
+ * install) and by the application (staging, see staging.h).
+ *
+ * The header is followed by firmware_size bytes of AES-256-CBC ciphertext
+ * (PKCS7 padded). signature is the ECDSA P-256 signature (r || s) of the
+ * SHA-256 of that ciphertext; header_crc is the CRC32 of the 96 bytes
+ * before it.
+ *
+ * With SFU_MAGIC_LZ4 (v3.2 bootloaders) the plaintext is the firmware
+ * compressed as one LZ4 block stream whose match offsets stay within
+ * SFU_LZ4_WINDOW; it decompresses to original_size bytes. The signature
+ * still covers the ciphertext, which fixes the decompressed firmware.
+ * Older bootloaders reject the magic instead of flashing compressed data.
+ *
+ * With SFU_MAGIC_DELTA (staged installs only) the plaintext is an
+ * SFU_DeltaHeader_t followed by an LZ4 block stream of patch_size bytes: a
+ * patch that turns the installed application (base_size bytes hashing to
+ * base_sha256) into the new one (original_size bytes). The patch is a list
+ * of records, each SFU_DELTA_RECORD_SIZE bytes of little-endian
+ * add_len, insert_len and seek, then add_len bytes added (mod 256) to the
+ * base bytes at the base position, which then advances by add_len, then
+ * insert_len new bytes, after which the base position moves by seek (signed).
+ * The base position starts at 0. The new image is rebuilt in the staging
+ * area and must hash to target_sha256, signed by target_signature, before
+ * it replaces the application. Both hashes cover the images as programmed:
+ * padded with 0xFF to whole 32-byte flash words.
+ */
+
+#ifndef SFU_H_
+#define SFU_H_
+
+#include <stdint.h>
+
+#define SFU_MAGIC				0x5546534C	// "LSFU" in little-endian
+#define SFU_MAGIC_LZ4			0x5A46534C	// "LSFZ": LZ4-compressed payload
+#define SFU_LZ4_WINDOW			16384		// Largest match offset
+#define SFU_MAGIC_DELTA			0x4446534C	// "LSFD": patch of the installed image
+#define SFU_DELTA_MAGIC			0x4844534C	// "LSDH": SFU_DeltaHeader_t
+#define SFU_DELTA_RECORD_SIZE	12
+#define SFU_IV_SIZE				16
+#define SFU_SIGNATURE_SIZE		64
+#define SFU_MAX_ORIGINAL_SIZE	(768 * 1024)	// Application flash, sectors 1-6
+
+typedef struct __attribute__((packed))
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t firmware_size;		// Ciphertext bytes after the header
+	uint32_t original_size;		// Plain firmware bytes
+	uint8_t iv[SFU_IV_SIZE];
+	uint8_t signature[SFU_SIGNATURE_SIZE];
+	uint32_t header_crc;
+} SFU_Header_t;
+
+#define SFU_HEADER_CRC_SIZE		(sizeof(SFU_Header_t) - sizeof(uint32_t))
+
+// Start of a delta payload's plaintext, a whole number of AES blocks
+typedef struct __attribute__((packed))
+{
+	uint32_t magic;				// SFU_DELTA_MAGIC
+	uint32_t base_size;			// Installed image, whole flash words
+	uint8_t base_sha256[32];
+	uint8_t target_sha256[32];	// New image, original_size bytes padded
+	uint8_t target_signature[SFU_SIGNATURE_SIZE];	// Of target_sha256
+	uint32_t patch_size;		// Patch bytes, once decompressed
+	uint32_t reserved;
+} SFU_DeltaHeader_t;
+
+#endif /* SFU_H_ */
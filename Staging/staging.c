@@ -0,0 +1,68 @@
+#include <staging.h>
+#include <checksum.h>
+#include <stddef.h>
+
+bool staging_header_valid(const SFU_Header_t *header)
+{
+	if ((header->magic != SFU_MAGIC && header->magic != SFU_MAGIC_LZ4
+			&& header->magic != SFU_MAGIC_DELTA)
+			|| crc32_ieee(CRC32_INIT, (const uint8_t*) header,
+			SFU_HEADER_CRC_SIZE) != header->header_crc)
+		return false;
+
+	if (header->original_size == 0
+			|| header->original_size > SFU_MAX_ORIGINAL_SIZE
+			|| header->firmware_size % 16 != 0
+			|| header->firmware_size == 0
+			|| header->firmware_size > STAGING_PAYLOAD_MAX)
+		return false;
+
+	// A delta's payload and the image it rebuilds both fit the area
+	if (header->magic == SFU_MAGIC_DELTA)
+		return header->firmware_size > sizeof(SFU_DeltaHeader_t)
+				&& STAGING_SCRATCH_OFFSET(header->firmware_size)
+						+ header->original_size
+						<= STAGING_OFFSET + STAGING_SIZE;
+
+	// PKCS7 adds 1 to 16 bytes to whole AES blocks; compressed payloads
+	// are checked by the decompressor against original_size
+	return header->magic == SFU_MAGIC_LZ4
+			|| (header->firmware_size > header->original_size
+					&& header->firmware_size <= header->original_size + 16);
+}
+
+HAL_StatusTypeDef staging_read_record(OSPI_HandleTypeDef *hospi,
+		staging_record_t *record)
+{
+	if (W25Q64_OSPI_Read(hospi, (uint8_t*) record, STAGING_OFFSET,
+			sizeof(staging_record_t)) != HAL_OK)
+		return HAL_ERROR;
+
+	if (record->magic != STAGING_RECORD_MAGIC
+			|| crc32_ieee(CRC32_INIT, (const uint8_t*) record,
+					offsetof(staging_record_t, record_crc)) != record->record_crc
+			|| !staging_header_valid(&record->header))
+		return HAL_ERROR;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef staging_write_record(OSPI_HandleTypeDef *hospi,
+		staging_record_t *record)
+{
+	record->magic = STAGING_RECORD_MAGIC;
+	record->record_crc = crc32_ieee(CRC32_INIT, (const uint8_t*) record,
+			offsetof(staging_record_t, record_crc));
+
+	return W25Q64_OSPI_Write(hospi, (uint8_t*) record, STAGING_OFFSET,
+			sizeof(staging_record_t));
+}
+
+HAL_StatusTypeDef staging_clear(OSPI_HandleTypeDef *hospi)
+{
+	if (W25Q64_OSPI_EraseBlockStart(hospi, STAGING_OFFSET, W25Q_SECTOR_SIZE)
+			!= HAL_OK)
+		return HAL_ERROR;
+
+	return W25Q64_OSPI_AutoPollingMemReady(hospi);
+}
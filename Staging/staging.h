@@ -0,0 +1,89 @@
+/*
+ * staging.h
+ *
+ * Firmware staging area in the W25Q external flash, shared by the
+ * application (fills it in the background, fw_staging.c) and Bootloader_E
+ * (installs from it, InstallStagedFirmware()).
+ *
+ * Layout from STAGING_OFFSET:
+ *   sector 0: staging_record_t, written last, once the payload is verified
+ *   sector 1+: the .sfu ciphertext (firmware_size bytes), as received
+ *   next sector: for a delta (SFU_MAGIC_DELTA), the scratch area where the
+ *                bootloader rebuilds the new image (original_size bytes)
+ *
+ * The record says the payload is complete, read back intact (payload_crc)
+ * and signed; without it nothing is installed. Both sides use the W25Q in
+ * indirect mode: the application leaves memory-mapped mode around these
+ * calls.
+ *
+ * The area sits below 16 MB because the driver uses 24-bit addresses, and
+ * above every asset and the rollback slot (rollback.h): image uploads stop
+ * at ROLLBACK_OFFSET.
+ */
+
+#ifndef STAGING_H_
+#define STAGING_H_
+
+#include <main.h>
+#include <stdbool.h>
+#include <W25Q64.h>
+#include <sfu.h>
+
+#define STAGING_OFFSET			0x00F00000UL	// 15 MB
+#define STAGING_SIZE			0x00100000UL
+#define STAGING_PAYLOAD_OFFSET	(STAGING_OFFSET + W25Q_SECTOR_SIZE)
+#define STAGING_PAYLOAD_MAX		(STAGING_SIZE - W25Q_SECTOR_SIZE)
+
+// Delta scratch area: the first sector after the payload
+#define STAGING_SCRATCH_OFFSET(firmware_size) \
+	(STAGING_PAYLOAD_OFFSET + ((firmware_size) + W25Q_SECTOR_SIZE - 1) \
+			/ W25Q_SECTOR_SIZE * W25Q_SECTOR_SIZE)
+
+#define STAGING_RECORD_MAGIC	0x4754534C		// "LSTG" in little-endian
+#define STAGING_INSTALL_MAGIC	0xFEEDBEEF		// RTC BKP0R: install staged image
+
+typedef struct __attribute__((packed))
+{
+	uint32_t magic;				// STAGING_RECORD_MAGIC
+	uint32_t payload_crc;		// CRC32 of the ciphertext as read back
+	SFU_Header_t header;
+	uint32_t record_crc;		// CRC32 of the bytes above
+} staging_record_t;
+
+/**
+ * @brief Check an .sfu header before anything is staged or installed:
+ *        magic, header CRC, and sizes that fit the application flash and
+ *        the staging area
+ * @param header .sfu header
+ * @return true if the header can be used
+ */
+bool staging_header_valid(const SFU_Header_t *header);
+
+/**
+ * @brief Read the staging record
+ * @param hospi W25Q handle, indirect mode
+ * @param record Filled with the record
+ * @return HAL_OK if a complete, verified image is staged
+ */
+HAL_StatusTypeDef staging_read_record(OSPI_HandleTypeDef *hospi,
+		staging_record_t *record);
+
+/**
+ * @brief Mark the payload complete: set magic and record_crc and program
+ *        the record sector (erased by staging_clear())
+ * @param hospi W25Q handle, indirect mode
+ * @param record payload_crc and header filled in by the caller
+ * @return HAL status
+ */
+HAL_StatusTypeDef staging_write_record(OSPI_HandleTypeDef *hospi,
+		staging_record_t *record);
+
+/**
+ * @brief Forget the staged image (erase the record sector). The payload is
+ *        left as it is and erased when the next image is staged.
+ * @param hospi W25Q handle, indirect mode
+ * @return HAL status
+ */
+HAL_StatusTypeDef staging_clear(OSPI_HandleTypeDef *hospi);
+
+#endif /* STAGING_H_ */
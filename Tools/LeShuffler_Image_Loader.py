@@ -7,6 +7,11 @@ Usage:
     python image_loader.py              # Upload all .h files from C_headers/
     python image_loader.py --erase      # Erase external flash only
     python image_loader.py --list       # List available ports
+    python image_loader.py --compress   # Upload images LSIC-compressed
+                                        # (all uploads write the asset directory)
+    python image_loader.py --changed    # Send only the images that differ from the
+                                        # last upload from this folder, and the directory
+    python image_loader.py --report     # Round-trip C_headers through the codec (no device)
     python image_loader.py COM5         # Use specific port
 
 The script looks for a "C_headers" folder in the same directory.
@@ -18,6 +23,9 @@ import re
 import glob
 import time
 import platform
+import struct
+import binascii
+import json
 
 try:
     import serial
@@ -29,15 +37,51 @@ except ImportError:
     sys.exit(1)
 
 # Protocol constants
-CHUNK_SIZE = 2043
+PACKET_SIZE = 2048
+CHUNK_SIZE = PACKET_SIZE - 7  # [type][seq][size] header, CRC16 trailer
+WINDOW = 4                    # DATA packets in flight (device receive ring holds 4)
 BAUD_RATE = 115200
 TIMEOUT = 10
 
 # Packet types
-PACKET_DATA = 0x01
+PACKET_DATA = 0x07            # windowed, sequence-numbered (0x01 is the legacy stop-and-wait)
 PACKET_END_FILE = 0x04
+PACKET_SET_OFFSET = 0x06
 PACKET_ERASE = 0x43
 
+# LSIC image codec (see Core/Inc/image_codec.h)
+LSIC_MAGIC = b'LSIC'
+LSIC_HEADER_SIZE = 12
+
+# Asset directory (see Core/Inc/assets.h)
+ASSET_DIR_MAGIC = 0x4441534C  # "LSAD"
+ASSET_DIR_VERSION = 1
+ASSET_DIR_SIZE = 0x1000
+ASSET_ALIGN = 0x1000
+FORMAT_RGB565 = 0
+FORMAT_LSIC = 1
+FORMAT_LSAN = 2
+ASSET_LOGO_DELTA = 58
+MANIFEST_FILE = "last_upload.json"  # what the device holds after the last upload
+
+# LSAN logo animation (see Core/Inc/animation.h)
+LSAN_MAGIC = b'LSAN'
+LOGO_FRAMES = 36
+LOGO_BACKGROUND = 0x0000      # LCD_COLOR_BCKGND
+LOGO_FRAME_PERIOD = 4         # ms, the speed of the full-frame logo (animation.h)
+LSAN_BAND = 8                 # rows compared together
+LSAN_GAP = 16                 # changed spans closer than this are merged
+
+# Assets in asset_id_t order, i.e. C_headers sorted by name: (name, width, height)
+ASSETS = ([(f"logo_{i}", 340, 102) for i in range(36)]
+          + [("small_logo", 140, 24)]
+          + [(name, 40, 40) for name in ("void", "back", "card", "check", "cross", "edit",
+                                         "flame", "player", "red_card", "red_cross", "save")]
+          + [(name, 200, 115) for name in ("silh", "cso_entry", "cso_exit", "check_tray",
+                                           "content", "pick_up_cards", "sh_empty", "sh_full",
+                                           "tray_empty")]
+          + [("restart", 100, 100)])
+
 
 def get_script_dir():
     """Get directory containing this script (works for exe too)"""
@@ -146,64 +190,290 @@ def parse_h_file(filepath):
 
 
 def calc_crc16(data):
-    """Calculate CRC-16 CCITT"""
-    crc = 0xFFFF
-    poly = 0x1021
-    for byte in data:
-        crc ^= byte << 8
-        for _ in range(8):
-            if crc & 0x8000:
-                crc = (crc << 1) ^ poly
+    """Calculate CRC-16 CCITT (init 0xFFFF, as crc16_ccitt() in Checksum/checksum.c)"""
+    return binascii.crc_hqx(bytes(data), 0xFFFF)
+
+
+def lsic_hash(pixel):
+    """Table slot of an RGB565 pixel"""
+    return ((pixel >> 11) * 3 + ((pixel >> 5) & 0x3F) * 5 + (pixel & 0x1F) * 7) & 0x3F
+
+
+def encode_lsic(data):
+    """Compress raw big-endian RGB565 bytes into an LSIC image"""
+    pixels = [(data[i] << 8) | data[i + 1] for i in range(0, len(data) - 1, 2)]
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    literals = []
+
+    def flush_literals():
+        while literals:
+            block = literals[:64]
+            del literals[:64]
+            out.append(0x40 | (len(block) - 1))
+            for p in block:
+                out.extend(((p >> 8) & 0xFF, p & 0xFF))
+
+    i = 0
+    n = len(pixels)
+    while i < n:
+        p = pixels[i]
+        if p == prev:
+            run = 1
+            while i + run < n and pixels[i + run] == prev and run < 0x3FFF + 65:
+                run += 1
+            flush_literals()
+            if run > 64:
+                extra = run - 65
+                out.extend((0xC0 | (extra >> 8), extra & 0xFF))
             else:
-                crc = crc << 1
-            crc &= 0xFFFF
-    return crc
-
-
-def send_chunk(ser, data):
-    """Send a data chunk with header and CRC, wait for ACK"""
-    size = len(data)
-    size_bytes = [(size >> 8) & 0xFF, size & 0xFF]
-    crc = calc_crc16(data)
-    crc_bytes = [(crc >> 8) & 0xFF, crc & 0xFF]
-
-    # Pad to chunk size if needed
-    padded_data = list(data) + [0x00] * (CHUNK_SIZE - size) if size < CHUNK_SIZE else list(data)
-
-    packet = [PACKET_DATA] + size_bytes + padded_data + crc_bytes
-    ser.write(bytes(packet))
+                out.append(run - 1)
+            i += run
+            continue
+        if index[lsic_hash(p)] == p:
+            flush_literals()
+            out.append(0x80 | lsic_hash(p))
+        else:
+            index[lsic_hash(p)] = p
+            literals.append(p)
+        prev = p
+        i += 1
+    flush_literals()
+
+    header = LSIC_MAGIC + n.to_bytes(4, 'little') + len(out).to_bytes(4, 'little')
+    return list(header + out)
+
+
+def decode_lsic(data):
+    """Decompress an LSIC image back to raw big-endian RGB565 bytes"""
+    data = bytes(data)
+    if data[:4] != LSIC_MAGIC:
+        raise ValueError("not an LSIC image")
+    n = int.from_bytes(data[4:8], 'little')
+    end = LSIC_HEADER_SIZE + int.from_bytes(data[8:12], 'little')
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    i = LSIC_HEADER_SIZE
+    while i < end:
+        op = data[i]
+        i += 1
+        tag = op & 0xC0
+        if tag == 0x40:
+            for _ in range((op & 0x3F) + 1):
+                prev = (data[i] << 8) | data[i + 1]
+                i += 2
+                index[lsic_hash(prev)] = prev
+                out.extend((prev >> 8, prev & 0xFF))
+            continue
+        if tag == 0x80:
+            prev = index[op & 0x3F]
+            out.extend((prev >> 8, prev & 0xFF))
+            continue
+        if tag == 0x00:
+            run = (op & 0x3F) + 1
+        else:
+            run = (((op & 0x3F) << 8) | data[i]) + 65
+            i += 1
+        out.extend(bytes((prev >> 8, prev & 0xFF)) * run)
+    if len(out) != 2 * n:
+        raise ValueError("pixel count mismatch")
+    return list(out)
+
+
+def encode_asset(data, compress):
+    """Return (format, stored bytes) of an image, LSIC only if it is smaller"""
+    if compress:
+        encoded = encode_lsic(data)
+        if len(encoded) < len(data):
+            return FORMAT_LSIC, encoded
+    return FORMAT_RGB565, list(data)
+
+
+def build_layout(images):
+    """Place assets on sector boundaries after the directory
+
+    images: list of (asset_id, width, height, format, stored bytes)
+    Returns the directory sector and a list of (offset, stored bytes).
+    """
+    entries = b''
+    placed = []
+    offset = ASSET_DIR_SIZE
+    for asset_id, width, height, fmt, data in images:
+        crc = binascii.crc32(bytes(data)) & 0xFFFFFFFF
+        entries += struct.pack('<HBBHHIII', asset_id, fmt, 0xFF, width, height,
+                               offset, len(data), crc)
+        placed.append((offset, data))
+        offset += (len(data) + ASSET_ALIGN - 1) // ASSET_ALIGN * ASSET_ALIGN
+
+    header = struct.pack('<IHHII', ASSET_DIR_MAGIC, ASSET_DIR_VERSION, len(images),
+                         binascii.crc32(entries) & 0xFFFFFFFF, 0xFFFFFFFF)
+    directory = header + entries
+    directory += b'\xFF' * (ASSET_DIR_SIZE - len(directory))
+    return list(directory), placed
+
+
+def changed_rects(prev, cur, width, height):
+    """Rectangles covering the pixels that differ between two frames"""
+    rects = []
+    for y0 in range(0, height, LSAN_BAND):
+        y1 = min(y0 + LSAN_BAND, height)
+        cols = [x for x in range(width)
+                if any(prev[y * width + x] != cur[y * width + x] for y in range(y0, y1))]
+        spans = []
+        for x in cols:
+            if spans and x - spans[-1][1] <= LSAN_GAP:
+                spans[-1][1] = x
+            else:
+                spans.append([x, x])
+        for xa, xb in spans:
+            rows = [y for y in range(y0, y1)
+                    if any(prev[y * width + x] != cur[y * width + x] for x in range(xa, xb + 1))]
+            rect = [xa, rows[0], xb - xa + 1, rows[-1] - rows[0] + 1]
+            # Extend the rectangle above when it has the same columns and touches it
+            above = next((r for r in rects if r[0] == rect[0] and r[2] == rect[2]
+                          and r[1] + r[3] == rect[1]), None)
+            if above:
+                above[3] += rect[3]
+            else:
+                rects.append(rect)
+    return rects
+
+
+def encode_lsan(frames, width, height, period=LOGO_FRAME_PERIOD):
+    """Build an LSAN animation from raw big-endian RGB565 frames"""
+    out = bytearray(LSAN_MAGIC + struct.pack('<HHHHHH', width, height, len(frames),
+                                             period, LOGO_BACKGROUND, 0xFFFF))
+    prev = [LOGO_BACKGROUND] * (width * height)
+    for data in frames:
+        cur = [(data[i] << 8) | data[i + 1] for i in range(0, 2 * width * height, 2)]
+        rects = changed_rects(prev, cur, width, height)
+        out += struct.pack('<H', len(rects))
+        for x, y, w, h in rects:
+            raw = []
+            for row in range(y, y + h):
+                for p in cur[row * width + x:row * width + x + w]:
+                    raw += [p >> 8, p & 0xFF]
+            _, stored = encode_asset(raw, True)
+            out += struct.pack('<HHHHI', x, y, w, h, len(stored)) + bytes(stored)
+        prev = cur
+    return list(out)
+
+
+def play_lsan(data):
+    """Replay an LSAN animation, return the raw frames it produces"""
+    data = bytes(data)
+    width, height, n_frames, _, background, _ = struct.unpack('<HHHHHH', data[4:16])
+    screen = [background] * (width * height)
+    frames = []
+    i = 16
+    for _ in range(n_frames):
+        (n_rects,) = struct.unpack('<H', data[i:i + 2])
+        i += 2
+        for _ in range(n_rects):
+            x, y, w, h, size = struct.unpack('<HHHHI', data[i:i + 12])
+            i += 12
+            image = data[i:i + size]
+            i += size
+            # The format is in the size: LSIC is only kept when smaller than raw
+            raw = decode_lsic(image) if size < 2 * w * h else list(image)
+            for row in range(h):
+                for col in range(w):
+                    k = 2 * (row * w + col)
+                    screen[(y + row) * width + x + col] = (raw[k] << 8) | raw[k + 1]
+        frames.append([b for p in screen for b in (p >> 8, p & 0xFF)])
+    return frames
+
+
+def codec_report(folder_path):
+    """Round-trip every image through the codec and print sizes/throughput"""
+    h_files = [f for f in os.listdir(folder_path) if f.endswith('.h')]
+    h_files.sort(key=natural_sort_key)
+    if not h_files:
+        print(f"\n  No .h files found in {folder_path}")
+        return False
 
-    # Wait for ACK
-    response = ser.read(1)
-    if response == b'A':
-        return True
-    elif response == b'N':
-        return False  # NAK - retry
-    else:
-        return False  # Timeout or unknown
+    total_raw = total_lsic = 0
+    t_enc = t_dec = 0.0
+    ok = True
+    print(f"\n  {'file':<32}{'raw':>10}{'lsic':>10}{'ratio':>8}")
+    for filename in h_files:
+        data = parse_h_file(os.path.join(folder_path, filename))
+        if data is None:
+            return False
+        t0 = time.perf_counter()
+        encoded = encode_lsic(data)
+        t1 = time.perf_counter()
+        decoded = decode_lsic(encoded)
+        t2 = time.perf_counter()
+        t_enc += t1 - t0
+        t_dec += t2 - t1
+        if decoded != list(data[:len(data) & ~1]):
+            print(f"  {filename}: ROUND-TRIP MISMATCH")
+            ok = False
+        total_raw += len(data)
+        total_lsic += len(encoded)
+        print(f"  {filename:<32}{len(data):>10,}{len(encoded):>10,}{len(encoded) / len(data):>8.2f}")
+
+    print(f"\n  Total: {total_raw:,} -> {total_lsic:,} bytes ({total_lsic / total_raw:.2%})")
+
+    if len(h_files) == len(ASSETS):
+        frames = [parse_h_file(os.path.join(folder_path, f)) for f in h_files[:LOGO_FRAMES]]
+        width, height = ASSETS[0][1], ASSETS[0][2]
+        animation = encode_lsan(frames, width, height)
+        replay_ok = play_lsan(animation) == [list(f) for f in frames]
+        ok = ok and replay_ok
+        print(f"  Logo animation: {LOGO_FRAMES * 2 * width * height:,} -> {len(animation):,} bytes, "
+              f"replay " + ("OK" if replay_ok else "MISMATCH"))
+    print(f"  Host encode {total_raw / 1e6 / t_enc:.2f} MB/s, decode {total_raw / 1e6 / t_dec:.2f} MB/s")
+    print("  Round-trip: " + ("OK" if ok else "FAILED"))
+    return ok
+
+
+def data_packet(seq, data):
+    """DATA packet: sequence number, size, payload padded, CRC16 of all but type and padding"""
+    header = struct.pack('>HH', seq, len(data))
+    crc = calc_crc16(header + bytes(data))
+    return (bytes([PACKET_DATA]) + header + bytes(data)
+            + bytes(CHUNK_SIZE - len(data)) + struct.pack('>H', crc))
 
 
 def send_file_data(ser, data, filename, progress_callback=None):
-    """Send file data in chunks"""
+    """Send file data keeping up to WINDOW packets in flight (go-back-N)
+
+    The device answers every stored packet with b'K' + next expected sequence
+    number (cumulative), a corrupt or out-of-order one with b'N' + the same,
+    after which sending restarts from that packet.
+    """
     total = len(data)
-    sent = 0
+    n_packets = (total + CHUNK_SIZE - 1) // CHUNK_SIZE
+    acked = 0       # packets stored by the device
+    sent = 0        # packets written to the port
     retries = 0
     max_retries = 5
 
-    while sent < total:
-        end = min(sent + CHUNK_SIZE, total)
-        chunk = data[sent:end]
+    while acked < n_packets:
+        while sent < n_packets and sent - acked < WINDOW:
+            ser.write(data_packet(sent, data[sent * CHUNK_SIZE:(sent + 1) * CHUNK_SIZE]))
+            sent += 1
 
-        if send_chunk(ser, chunk):
-            sent = end
+        response = ser.read(3)
+        if len(response) == 3 and response[0] == ord('K'):
+            acked = max(acked, min((response[1] << 8) | response[2], sent))
             retries = 0
             if progress_callback:
-                progress_callback(sent, total)
-        else:
-            retries += 1
-            if retries >= max_retries:
-                print(f"\n  ERROR: Max retries reached for {filename}")
-                return False
+                progress_callback(min(acked * CHUNK_SIZE, total), total)
+            continue
+
+        # NAK or timeout: resend from the first packet not stored
+        if len(response) == 3 and response[0] == ord('N'):
+            acked = max(acked, (response[1] << 8) | response[2])
+        sent = acked
+        retries += 1
+        if retries >= max_retries:
+            print(f"\n  ERROR: Max retries reached for {filename}")
+            return False
 
     return True
 
@@ -220,6 +490,18 @@ def send_end_file(ser):
     return None, None
 
 
+def send_set_offset(ser, offset, size=0):
+    """Set the flash offset and size of the next file, wait for ACK
+
+    The device erases the sectors of the file as it arrives, the size lets it
+    use 32/64 KB block erases and start them ahead of the data.
+    """
+    packet = [PACKET_SET_OFFSET] + list(offset.to_bytes(4, 'big')) + list(size.to_bytes(4, 'big'))
+    packet += [0x00] * (2048 - len(packet))
+    ser.write(bytes(packet))
+    return ser.read(1) == b'A'
+
+
 def erase_flash(ser):
     """Erase external flash memory"""
     packet = [PACKET_ERASE] * 2048
@@ -236,8 +518,27 @@ def print_progress(current, total, width=40):
     sys.stdout.flush()
 
 
-def upload_folder(port, folder_path):
-    """Upload all .h files from folder"""
+def load_manifest(folder_path):
+    """(offset, size, crc32) of every asset of the last upload, empty if none"""
+    try:
+        with open(os.path.join(folder_path, MANIFEST_FILE)) as f:
+            return {tuple(entry) for entry in json.load(f)}
+    except (OSError, ValueError, TypeError):
+        return set()
+
+
+def save_manifest(folder_path, placed):
+    with open(os.path.join(folder_path, MANIFEST_FILE), 'w') as f:
+        json.dump([[offset, len(data), binascii.crc32(bytes(data)) & 0xFFFFFFFF]
+                   for offset, data in placed], f)
+
+
+def upload_folder(port, folder_path, compress=False, changed_only=False):
+    """Upload all .h files from folder
+
+    changed_only: skip the images already on the device at the same place
+    according to the manifest of the last upload (the directory is always sent)
+    """
     # Get list of .h files
     h_files = [f for f in os.listdir(folder_path) if f.endswith('.h')]
     h_files.sort(key=natural_sort_key)
@@ -248,17 +549,44 @@ def upload_folder(port, folder_path):
 
     print(f"\n  Found {len(h_files)} files to upload")
 
-    # Calculate total size
+    if len(h_files) != len(ASSETS):
+        print(f"\n  ERROR: expected {len(ASSETS)} images, found {len(h_files)}")
+        return False
+
+    # Encode images and lay out the asset directory
     print("  Calculating total size...")
-    all_data = []
-    for filename in h_files:
+    images = []
+    names = []
+    for asset_id, (filename, (name, width, height)) in enumerate(zip(h_files, ASSETS)):
         filepath = os.path.join(folder_path, filename)
         data = parse_h_file(filepath)
         if data is None:
             return False
-        all_data.append((filename, data))
-
-    total_bytes = sum(len(d) for _, d in all_data)
+        if len(data) != 2 * width * height:
+            print(f"\n  ERROR: {filename} is {len(data):,} bytes, expected {name} {width}x{height}")
+            return False
+        fmt, stored = encode_asset(data, compress)
+        images.append((asset_id, width, height, fmt, stored))
+        names.append(filename)
+
+    # The logo frames are shipped as one frame-diff animation
+    animation = encode_lsan([img[4] if img[3] == FORMAT_RGB565 else decode_lsic(img[4])
+                             for img in images[:LOGO_FRAMES]], ASSETS[0][1], ASSETS[0][2])
+    images = images[LOGO_FRAMES:] + [(ASSET_LOGO_DELTA, ASSETS[0][1], ASSETS[0][2],
+                                      FORMAT_LSAN, animation)]
+    names = names[LOGO_FRAMES:] + ["logo animation"]
+
+    directory, placed = build_layout(images)
+    # Directory goes last: an interrupted upload leaves no valid directory
+    all_data = [(n, offset, d) for n, (offset, d) in zip(names, placed)]
+    if changed_only:
+        previous = load_manifest(folder_path)
+        all_data = [(n, offset, d) for n, offset, d in all_data
+                    if (offset, len(d), binascii.crc32(bytes(d)) & 0xFFFFFFFF) not in previous]
+        print(f"  {len(all_data)} of {len(placed)} images changed since the last upload")
+    all_data.append(("asset directory", 0, directory))
+
+    total_bytes = sum(len(d) for _, _, d in all_data)
     print(f"  Total size: {total_bytes:,} bytes")
 
     # Connect to device
@@ -272,13 +600,18 @@ def upload_folder(port, folder_path):
     uploaded_bytes = 0
 
     try:
-        for filename, data in all_data:
+        for filename, offset, data in all_data:
             file_size = len(data)
 
             def progress(sent, total):
                 nonlocal uploaded_bytes
                 print_progress(uploaded_bytes + sent, total_bytes)
 
+            if not send_set_offset(ser, offset, file_size):
+                print(f"\n  ERROR: device did not accept offset {offset:#x} for {filename}")
+                ser.close()
+                return False
+
             if not send_file_data(ser, data, filename, progress):
                 ser.close()
                 return False
@@ -295,6 +628,7 @@ def upload_folder(port, folder_path):
         return False
 
     ser.close()
+    save_manifest(folder_path, placed)
     print(f"\n  Upload complete! ({total_bytes:,} bytes)")
     return True
 
@@ -309,12 +643,21 @@ def main():
     specified_port = None
     erase_only = False
     list_only = False
+    compress = False
+    report_only = False
+    changed_only = False
 
     for arg in args:
         if arg == '--erase':
             erase_only = True
         elif arg == '--list':
             list_only = True
+        elif arg == '--compress':
+            compress = True
+        elif arg == '--report':
+            report_only = True
+        elif arg == '--changed':
+            changed_only = True
         elif arg in ['--help', '-h']:
             print(__doc__)
             input("\nPress Enter to exit...")
@@ -332,6 +675,12 @@ def main():
         input("\nPress Enter to exit...")
         return 0
 
+    # Codec report only (no device needed)
+    if report_only:
+        ok = codec_report(os.path.join(get_script_dir(), "C_headers"))
+        input("\nPress Enter to exit...")
+        return 0 if ok else 1
+
     # Select port
     if specified_port:
         port = specified_port
@@ -373,7 +722,7 @@ def main():
     print(f"\n  Source folder: {headers_folder}")
 
     # Upload
-    success = upload_folder(port, headers_folder)
+    success = upload_folder(port, headers_folder, compress, changed_only)
 
     if success:
         print("\n" + "=" * 50)
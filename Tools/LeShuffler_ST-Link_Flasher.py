@@ -7,7 +7,7 @@ Requires: STM32CubeProgrammer installed (uses STM32_Programmer_CLI.exe)
 
 Memory Map:
   - Bootloader: 0x08000000 (up to 128KB)
-  - Application: 0x08020000 (up to ~900KB)
+  - Application: 0x08020000 (up to 768KB; sector 7 holds the bootloader's validity log)
 
 Usage:
   1. Connect ST-LINK to device
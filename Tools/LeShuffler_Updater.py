@@ -3,6 +3,9 @@
 LeShuffler Firmware Updater v3.0 (Encrypted Only)
 Updates firmware using encrypted .sfu files (requires bootloader v3.0+).
 
+Bootloader v3.2+ is updated in streamed 4 KB chunks, older v3.x bootloaders
+in 256-byte packets.
+
 File format:
 - .sfu: Encrypted firmware created by encrypt_firmware.py
         Uses AES-256-CBC encryption + ECDSA-P256 signature
@@ -12,6 +15,7 @@ Usage:
     python firmware_updater.py COM5              # Direct mode
     python firmware_updater.py --list            # List ports
     python firmware_updater.py --file X.sfu      # Specific file
+    python firmware_updater.py --stage COM5      # Stage in the running app, then install
 """
 
 import sys
@@ -20,6 +24,7 @@ import time
 import os
 import platform
 import glob
+import binascii
 
 try:
     import serial
@@ -49,14 +54,45 @@ PACKET_TYPE_STATUS = 0x04      # Query bootloader status (version detection)
 PACKET_TYPE_ENC_START = 0x10   # Contains SFU header
 PACKET_TYPE_ENC_DATA = 0x11    # Contains encrypted data chunk
 PACKET_TYPE_ENC_END = 0x12     # Triggers signature verification
+PACKET_TYPE_STREAM_START = 0x13  # v3.2: SFU header + chunk size negotiation
+PACKET_TYPE_STREAM_DATA = 0x14   # v3.2: one chunk frame
 
 PACKET_DATA_SIZE = 256
 STATUS_RESPONSE_SIZE = 24
 
+# Streaming (bootloader v3.2+, see Bootloader_E/Core/Inc/bootload.h)
+STREAM_CHUNK_SIZE = 4096      # Requested; the bootloader grants 256..8192
+STREAM_WINDOW = 2             # Chunks in flight: one programmed, one received
+STREAM_FRAME_HEADER_SIZE = 16
+
 # SFU Header constants (must match crypto.h)
 SFU_MAGIC = 0x5546534C  # "LSFU" in little-endian
+SFU_MAGIC_LZ4 = 0x5A46534C  # "LSFZ": LZ4-compressed payload, bootloader v3.2+
+SFU_MAGIC_DELTA = 0x4446534C  # "LSFD": patch of the installed image, staged only, v3.3+
 SFU_HEADER_SIZE = 100   # 4+4+4+4+16+64+4 = 100 bytes
 
+# Background staging in the running application (see Core/Inc/fw_staging.h,
+# requires bootloader v3.1+)
+STAGE_BEGIN = 0x21
+STAGE_DATA = 0x22
+STAGE_END = 0x23
+STAGE_INSTALL = 0x24
+STAGE_PACKET_SIZE = 2048
+STAGE_CHUNK_SIZE = STAGE_PACKET_SIZE - 7  # [type][seq][size] header, CRC16 trailer
+STAGE_WINDOW = 4                          # DATA packets in flight (device receive ring holds 4)
+STAGE_TIMEOUT = 10.0                      # The device only polls while waiting for the user
+STAGE_VERIFY_TIMEOUT = 30.0               # Read-back, SHA-256 and ECDSA in software
+STAGE_MAX_RETRIES = 5
+STAGE_ERRORS = {
+    1: "Invalid .sfu header",
+    2: "Bootloader cannot install staged firmware (v3.1+ required)",
+    3: "External flash error",
+    4: "Incomplete transfer",
+    5: "Stored data does not match what was sent",
+    6: "Invalid ECDSA signature",
+    7: "No verified firmware staged",
+}
+
 # Timing
 PACKET_DELAY_MS = 50
 MAX_RECONNECT_WAIT = 15
@@ -187,6 +223,8 @@ class SFUFile:
         self.header = None
         self.encrypted_data = None
         self.valid = False
+        self.compressed = False
+        self.delta = False
         self.error = None
 
     def load(self):
@@ -202,9 +240,11 @@ class SFUFile:
             # Parse header
             magic, version, firmware_size, original_size = struct.unpack('<IIII', data[0:16])
 
-            if magic != SFU_MAGIC:
+            if magic not in (SFU_MAGIC, SFU_MAGIC_LZ4, SFU_MAGIC_DELTA):
                 self.error = f"Invalid magic: 0x{magic:08X} (expected 0x{SFU_MAGIC:08X})"
                 return False
+            self.compressed = magic == SFU_MAGIC_LZ4
+            self.delta = magic == SFU_MAGIC_DELTA
 
             iv = data[16:32]
             signature = data[32:96]
@@ -256,6 +296,10 @@ class SFUFile:
 
         print(f"  Firmware version: {self.get_version_string()}")
         print(f"  Size: {self.header['original_size']} bytes")
+        if self.compressed:
+            print(f"  Compressed: {self.header['firmware_size']} bytes (LZ4, bootloader v3.2+)")
+        if self.delta:
+            print(f"  Delta: {self.header['firmware_size']} bytes, installs only over the firmware it was made from")
 
 
 class EncryptedFirmwareUpdater:
@@ -266,6 +310,9 @@ class EncryptedFirmwareUpdater:
         self.is_windows = platform.system() == 'Windows'
         self.bootloader_version = None
         self.is_v3 = False
+        self.supports_streaming = False
+        self.update_start = None
+        self.first_data_time = None
 
     def find_device_port(self):
         ports = list(serial.tools.list_ports.comports())
@@ -371,7 +418,10 @@ class EncryptedFirmwareUpdater:
                     version_minor = response[3]
                     self.bootloader_version = f"{version_major}.{version_minor}"
                     self.is_v3 = version_major >= 3
+                    self.supports_streaming = (version_major, version_minor) >= (3, 2)
                     protocol = "encrypted" if self.is_v3 else "legacy"
+                    if self.supports_streaming:
+                        protocol = "encrypted, streaming"
                     print(f" v{self.bootloader_version} ({protocol})")
                     return True
 
@@ -423,7 +473,8 @@ class EncryptedFirmwareUpdater:
                     'progress': response[3],
                     'state': response[4],
                     'packet_type': response[1],
-                    'error_code': response[5] if len(response) > 5 else 0
+                    'error_code': response[5] if len(response) > 5 else 0,
+                    'value': response[5] | (response[6] << 8)
                 }
             return None
         except:
@@ -646,8 +697,134 @@ class EncryptedFirmwareUpdater:
             # Verification will confirm if update succeeded
             return 'usb_disconnect_after_end'
 
+    def send_stream_start_packet(self, sfu_header):
+        """Send STREAM_START packet with SFU header, return the granted chunk size (0 on error)"""
+        print(f"  Sending STREAM_START packet (header + erase flash)...")
+
+        packet = struct.pack('<III', PACKET_TYPE_STREAM_START, STREAM_CHUNK_SIZE, SFU_HEADER_SIZE)
+        packet += struct.pack('<I', 0)  # CRC not used for header
+        packet += sfu_header + b'\xFF' * (PACKET_DATA_SIZE - len(sfu_header))
+
+        try:
+            self.ser.write(packet)
+            self.ser.flush()
+        except Exception as e:
+            print(f"  Failed to send STREAM_START: {e}")
+            return 0
+
+        # Wait longer for flash erase + header validation
+        response = self.wait_for_response(timeout=15.0)
+        if response and response['success'] and response['error_code']:
+            chunk_size = response['error_code'] * 256
+            print(f"  Header validated, flash erased, streaming {chunk_size}-byte chunks")
+            return chunk_size
+
+        print(f"  STREAM_START failed: Header validation failed")
+        return 0
+
+    def send_stream_end_packet(self):
+        """Send ENC_END after the last chunk
+        Returns: 'success', 'usb_disconnect_after_end' or 'signature_failed'
+        """
+        print("\n  Verifying signature...", end='', flush=True)
+
+        packet = struct.pack('<III', PACKET_TYPE_ENC_END, 0, 0)
+        packet += struct.pack('<I', 0)
+        packet += b'\xFF' * PACKET_DATA_SIZE
+
+        try:
+            self.ser.write(packet)
+            self.ser.flush()
+            # ECDSA verification takes ~1-2 seconds
+            response = self.wait_for_response(timeout=10.0)
+        except Exception:
+            return 'usb_disconnect_after_end'
+
+        if response and response['success']:
+            print(" signature valid")
+            return 'success'
+        print(" failed")
+        print(f"  ENC_END failed: Invalid ECDSA signature")
+        return 'signature_failed'
+
+    def do_stream_transfer(self, sfu_file):
+        """Stream the encrypted firmware in large chunks (bootloader v3.2+)
+
+        Up to STREAM_WINDOW chunks are in flight: the bootloader receives the
+        next one while it decrypts and programs the current one, and answers
+        each with the number of chunks stored.
+        """
+        encrypted_data = sfu_file.encrypted_data
+        total_size = len(encrypted_data)
+
+        chunk_size = self.send_stream_start_packet(sfu_file.header['raw'])
+        if not chunk_size:
+            return 'error'
+
+        total_chunks = (total_size + chunk_size - 1) // chunk_size
+        print(f"  Streaming {total_chunks} chunks...")
+
+        sent = 0
+        acked = 0
+        try:
+            while acked < total_chunks:
+                while sent < total_chunks and sent - acked < STREAM_WINDOW:
+                    offset = sent * chunk_size
+                    chunk = encrypted_data[offset:offset + chunk_size]
+                    frame = struct.pack('<IIII', PACKET_TYPE_STREAM_DATA, offset, len(chunk),
+                                        binascii.crc32(chunk) & 0xFFFFFFFF)
+                    frame += chunk + b'\xFF' * (chunk_size - len(chunk))
+                    self.ser.write(frame)
+                    sent += 1
+
+                response = self.wait_for_response(timeout=10.0)
+                if response is None:
+                    return 'disconnect'
+                if not response['success'] or response['value'] != acked + 1:
+                    print(f"\n  Chunk {acked} rejected")
+                    return 'disconnect'  # Restart from STREAM_START
+                acked += 1
+                self.mark_first_data()
+
+                percent = (acked * 100) // total_chunks
+                filled = (percent * 40) // 100
+                bar = '=' * filled + '-' * (40 - filled)
+                bytes_sent = min(acked * chunk_size, total_size)
+                print(f"\r  [{bar}] {percent}% ({bytes_sent}/{total_size})", end='', flush=True)
+
+        except (serial.SerialException, OSError):
+            return 'disconnect'
+
+        print()
+
+        end_result = self.send_stream_end_packet()
+        if end_result == 'success':
+            return 'success'
+        elif end_result == 'usb_disconnect_after_end':
+            return 'likely_success'
+        return 'signature_failed'
+
+    def mark_first_data(self):
+        """Note when the bootloader accepted the first firmware data"""
+        if self.first_data_time is None and self.update_start is not None:
+            self.first_data_time = time.time() - self.update_start
+
+    def report_update_time(self, sfu):
+        """Print the end-to-end update time (erase, transfer, verification)"""
+        if self.update_start is None:
+            return
+        elapsed = time.time() - self.update_start
+        rate = sfu.header['original_size'] / 1024 / elapsed if elapsed > 0 else 0
+        mode = "streaming" if self.supports_streaming else "packets"
+        if self.first_data_time is not None:
+            print(f"  Connect to first data: {self.first_data_time:.1f}s")
+        print(f"  Update time: {elapsed:.1f}s ({rate:.0f} KB/s, {mode})")
+
     def do_encrypted_transfer(self, sfu_file):
         """Perform encrypted firmware transfer"""
+        if self.supports_streaming:
+            return self.do_stream_transfer(sfu_file)
+
         encrypted_data = sfu_file.encrypted_data
         total_size = len(encrypted_data)
         total_packets = (total_size + PACKET_DATA_SIZE - 1) // PACKET_DATA_SIZE
@@ -675,6 +852,7 @@ class EncryptedFirmwareUpdater:
             if not success:
                 print(f"\n  Failed at packet {packet_num}")
                 return 'error'
+            self.mark_first_data()
 
             # Progress display
             percent = ((packet_num + 1) * 100) // total_packets
@@ -747,6 +925,26 @@ class EncryptedFirmwareUpdater:
             sfu.print_info()
             firmware_size = sfu.header['original_size']
 
+            # A delta is rebuilt in the W25Q staging area, never sent to the bootloader
+            if sfu.delta:
+                print("\n" + "=" * 60)
+                print("  CANNOT START UPDATE")
+                print("=" * 60)
+                print("  This .sfu is a delta of the installed firmware.")
+                print("  Install it with --stage (bootloader v3.3+), or use a full .sfu.")
+                print("=" * 60)
+                return 'unsupported_bootloader'
+
+            # Older bootloaders reject the compressed image's magic
+            if sfu.compressed and not self.supports_streaming:
+                print("\n" + "=" * 60)
+                print("  CANNOT START UPDATE")
+                print("=" * 60)
+                print(f"  Bootloader v{self.bootloader_version} cannot install compressed firmware.")
+                print("  Use an .sfu made without --compress, or bootloader v3.2+.")
+                print("=" * 60)
+                return 'unsupported_bootloader'
+
             if firmware_size > MAX_FIRMWARE_SIZE:
                 print("\n" + "=" * 60)
                 print("  CANNOT START UPDATE")
@@ -782,6 +980,8 @@ class EncryptedFirmwareUpdater:
     def _do_encrypted_update(self, sfu):
         """Handle encrypted firmware update (v3.0+ bootloaders)"""
         restart_count = 0
+        self.update_start = time.time()
+        self.first_data_time = None
 
         while restart_count <= MAX_RESTART_ATTEMPTS:
             if restart_count > 0:
@@ -794,12 +994,14 @@ class EncryptedFirmwareUpdater:
                 print("  FIRMWARE UPDATE SUCCESSFUL")
                 print("=" * 60)
                 print("  Signature verified. Device is rebooting.")
+                self.report_update_time(sfu)
                 print("=" * 60)
                 return True
 
             elif result == 'likely_success':
                 # USB disconnected after ENC_END - verify device is not in bootloader mode
                 print(" signature valid")
+                self.report_update_time(sfu)
                 print("  Verifying update...", end='', flush=True)
 
                 # Close current connection
@@ -909,6 +1111,130 @@ class EncryptedFirmwareUpdater:
         return False
 
 
+def calc_crc16(data):
+    """Calculate CRC-16 CCITT (init 0xFFFF, as crc16_ccitt() in Checksum/checksum.c)"""
+    return binascii.crc_hqx(bytes(data), 0xFFFF)
+
+
+class StagingUpdater:
+    """Stage an .sfu in the running application, which keeps shuffling
+
+    The application stores the ciphertext in external flash, verifies it and
+    only then, on STAGE_INSTALL, resets into the bootloader to install it.
+    """
+
+    def __init__(self, updater):
+        self.updater = updater
+
+    @property
+    def ser(self):
+        return self.updater.ser
+
+    def command(self, code, payload=b''):
+        """Command packet: code, payload, CRC16 of the payload at the end"""
+        packet = bytes([code]) + payload
+        packet += bytes(STAGE_PACKET_SIZE - 2 - len(packet))
+        return packet + struct.pack('>H', calc_crc16(packet[1:1 + len(payload)]))
+
+    def data_packet(self, seq, data):
+        """DATA packet: sequence number, size, ciphertext, CRC16 of all but type and padding"""
+        header = struct.pack('>HH', seq, len(data))
+        crc = calc_crc16(header + data)
+        return (bytes([STAGE_DATA]) + header + data
+                + bytes(STAGE_CHUNK_SIZE - len(data)) + struct.pack('>H', crc))
+
+    def send_command(self, code, payload=b'', timeout=STAGE_TIMEOUT):
+        """Send a command, return None on success or an error message"""
+        self.ser.reset_input_buffer()
+        self.ser.write(self.command(code, payload))
+        self.ser.flush()
+        old_timeout = self.ser.timeout
+        self.ser.timeout = timeout
+        response = self.ser.read(3)
+        self.ser.timeout = old_timeout
+
+        if len(response) == 3 and response[0] == ord('A'):
+            return None
+        if len(response) == 3 and response[0] == ord('E'):
+            return STAGE_ERRORS.get(response[1], f"Error {response[1]}")
+        return "No response (is the shuffler waiting on a menu?)"
+
+    def send_data(self, data):
+        """Send the ciphertext keeping up to STAGE_WINDOW packets in flight (go-back-N)"""
+        total = len(data)
+        n_packets = (total + STAGE_CHUNK_SIZE - 1) // STAGE_CHUNK_SIZE
+        acked = 0
+        sent = 0
+        retries = 0
+        old_timeout = self.ser.timeout
+        self.ser.timeout = STAGE_TIMEOUT
+
+        try:
+            while acked < n_packets:
+                while sent < n_packets and sent - acked < STAGE_WINDOW:
+                    chunk = data[sent * STAGE_CHUNK_SIZE:(sent + 1) * STAGE_CHUNK_SIZE]
+                    self.ser.write(self.data_packet(sent, chunk))
+                    sent += 1
+
+                response = self.ser.read(3)
+                if len(response) == 3 and response[0] == ord('K'):
+                    acked = max(acked, min((response[1] << 8) | response[2], sent))
+                    retries = 0
+                    percent = (acked * 100) // n_packets
+                    filled = (percent * 40) // 100
+                    bar = '=' * filled + '-' * (40 - filled)
+                    done = min(acked * STAGE_CHUNK_SIZE, total)
+                    print(f"\r  [{bar}] {percent}% ({done}/{total})", end='', flush=True)
+                    continue
+
+                # NAK or timeout: resend from the first packet not stored
+                if len(response) == 3 and response[0] == ord('N'):
+                    acked = max(acked, (response[1] << 8) | response[2])
+                sent = acked
+                retries += 1
+                if retries >= STAGE_MAX_RETRIES:
+                    print(f"\n  Failed at packet {acked}")
+                    return False
+        finally:
+            self.ser.timeout = old_timeout
+
+        print()
+        return True
+
+    def stage(self, sfu, install=True):
+        """Stage, verify and optionally install; returns True on success"""
+        start = time.time()
+
+        print("  Starting staging...", end='', flush=True)
+        error = self.send_command(STAGE_BEGIN, sfu.header['raw'])
+        if error:
+            print(f" failed: {error}")
+            return False
+        print(" OK")
+
+        print(f"  Sending {len(sfu.encrypted_data)} encrypted bytes (shuffler stays usable)...")
+        if not self.send_data(sfu.encrypted_data):
+            return False
+
+        print("  Verifying signature on device...", end='', flush=True)
+        error = self.send_command(STAGE_END, timeout=STAGE_VERIFY_TIMEOUT)
+        if error:
+            print(f" failed: {error}")
+            return False
+        print(f" OK ({time.time() - start:.1f}s)")
+
+        if not install:
+            return True
+
+        print("  Requesting install...", end='', flush=True)
+        error = self.send_command(STAGE_INSTALL)
+        if error:
+            print(f" failed: {error}")
+            return False
+        print(" OK, device is installing and will restart")
+        return True
+
+
 def print_header():
     print()
     print("=" * 60)
@@ -931,6 +1257,7 @@ def main():
 
     firmware_file = None
     selected_port = None
+    stage_mode = None
 
     # Parse arguments
     args = sys.argv[1:]
@@ -944,6 +1271,8 @@ def main():
             print("  LeShuffler_Updater <port>       Direct mode")
             print("  LeShuffler_Updater --list       List ports")
             print("  LeShuffler_Updater --file X.sfu Use specific file")
+            print("  LeShuffler_Updater --stage      Stage in the running app, then install")
+            print("  LeShuffler_Updater --stage-only Stage without installing")
             print("\nNote: Requires bootloader v3.0+ (encrypted updates only)")
             print("      For legacy bootloaders, use LeShuffler_Legacy_Updater")
             print("\nExamples:")
@@ -972,6 +1301,9 @@ def main():
                 print("\n  Usage: --file <filename>")
                 sys.exit(1)
 
+        elif arg in ['--stage', '--stage-only']:
+            stage_mode = arg
+
         elif not arg.startswith('-'):
             selected_port = arg
 
@@ -1029,6 +1361,25 @@ def main():
         input("\n  Press Enter to exit...")
         sys.exit(1)
 
+    if stage_mode:
+        try:
+            print(f"\n  Firmware: {os.path.basename(firmware_path)}")
+            sfu = SFUFile(firmware_path)
+            if not sfu.load():
+                print(f"  {sfu.error}")
+                result = False
+            else:
+                sfu.print_info()
+                result = StagingUpdater(updater).stage(sfu, install=(stage_mode == '--stage'))
+            if not result:
+                print("\n" + "=" * 60)
+                print("  FIRMWARE STAGING FAILED")
+                print("=" * 60)
+            input("\n  Press Enter to exit...")
+            sys.exit(0 if result else 1)
+        finally:
+            updater.disconnect()
+
     try:
         result = updater.update_firmware(firmware_path)
 
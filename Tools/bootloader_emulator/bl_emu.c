@@ -0,0 +1,822 @@
+/*
+ * bl_emu: Bootloader_E's USB update protocol on Linux, behind a
+ * pseudo-terminal
+ *
+ * Runs the unmodified Bootloader_E/Core/Src/bootload.c, validity.c and
+ * USB_DEVICE/App/usbd_cdc_if.c on the emulated flash, CRYP and HASH of
+ * Tools/crypto_emulator, in a copy of the main loop of Core/Src/main.c. The
+ * CDC interface is a PTY linked at --link, so the unmodified
+ * LeShuffler_Updater.py can update it:
+ *
+ *   bl_emu --link /tmp/leshuffler --image LeShuffler.bin &
+ *   python3 Tools/LeShuffler_Updater.py --file LeShuffler.sfu /tmp/leshuffler
+ *
+ * Time: the bootloader runs on crypto_emu's virtual clock. Flash word
+ * programming, sector erase, CRYP and HASH are costed there, and ECDSA,
+ * decompression and CRC32 are charged assumed costs here. Responses leave
+ * when the wall clock reaches the virtual clock, so the host sees the
+ * device's timing. Host bytes reach the device in 64-byte full-speed
+ * packets, no faster than --usb-kbps. Responses reach the host
+ * --latency-us after they are sent.
+ *
+ * Faults, each with a probability per USB packet in both directions
+ * (--seed): drop, duplicate, corrupt (one bit flipped), disconnect (the PTY
+ * is closed and a new one linked at the same path, as on re-enumeration).
+ * --fault-at scripts one on a given host to device packet instead, so a run
+ * can be sure to meet each of them.
+ *
+ * The run ends with the reset after a completed update, on SIGTERM or
+ * SIGINT, or after --timeout seconds. The programmed flash is compared with
+ * --image and the validity record must let the next power-on jump to the
+ * application; without a completed update it must keep the next power-on
+ * in the bootloader. Reported: image bytes per second from the first
+ * START, restarts, faults and the device time by activity. Exit status 0
+ * for a correct update, 3 for none (the host gave up), 1 otherwise, also
+ * when a fault asked for never happened. See update_roundtrip.sh.
+ *
+ * Usage: bl_emu [--link PATH] [--image FILE] [--timeout S] [--seed N]
+ *               [--drop P] [--dup P] [--corrupt P] [--disconnect P]
+ *               [--fault-at N:FAULT ...] [--usb-kbps N] [--latency-us US] [--as-version M.m]
+ *               [--tprog-us US] [--terase-ms MS] [--ecdsa-ms MS]
+ *               [--lz4-cycles N]
+ *   --link PATH       symlink to the PTY (default /tmp/leshuffler_bl)
+ *   --image FILE      firmware the update must leave in flash
+ *   --timeout S       give up after S seconds (default 600)
+ *   --drop P ...      fault probabilities per USB packet (default 0)
+ *   --fault-at N:FAULT  FAULT (drop, dup, corrupt or disconnect) on the
+ *                     Nth USB packet from the host, from 1; repeatable
+ *   --usb-kbps N      host to device rate (default 1216: 19 packets per
+ *                     1 ms frame, full speed bulk)
+ *   --latency-us US   response delay (default 1000, one frame)
+ *   --as-version M.m  version the STATUS response reports (3.0 or 3.1
+ *                     make the updater send 256-byte ENC_DATA packets)
+ *   --tprog-us US     flash word programming (default 16, assumed)
+ *   --terase-ms MS    128 KB sector erase (default 1000, assumed)
+ *   --ecdsa-ms MS     signature verification (default 1500, assumed)
+ *   --lz4-cycles N    decompression CPU cycles per output byte (default 12,
+ *                     assumed)
+ */
+
+#define _GNU_SOURCE		// posix_openpt(), ptsname()
+
+#include <bootload.h>
+#include <checksum.h>
+#include <crypto.h>
+#include <main.h>
+#include <octospi.h>
+#include <usbd_cdc_if.h>
+#include <validity.h>
+#include <W25Q64.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "crypto_emu.h"
+
+#undef CR1		// termios.h output delay flag, not FLASH->CR1
+
+#define USB_PACKET			64		// Full speed bulk max packet size
+#define QUEUE_SIZE			(256 * 1024)
+#define RESPONSES_MAX		64
+#define SCRIPTED_MAX		16
+
+static crypto_emu_timing_t timing;
+static double usb_kbps = 1216;
+static double latency_us = 1000;
+static double ecdsa_ms = 1500;
+static double lz4_cycles = 12;
+static double crc_cycles = 1;		// CRC unit fed by MDMA, assumed
+static double p_drop, p_dup, p_corrupt, p_disconnect;
+static int as_major = -1, as_minor;
+
+/* Peripherals the bootloader touches directly ------------------------------*/
+
+RTC_HandleTypeDef hrtc;
+OSPI_HandleTypeDef hospi2;
+USBD_HandleTypeDef hUsbDeviceHS;
+static USBD_CDC_HandleTypeDef cdc;
+
+// FLASH->CR1 (lock), FLASH->CCR1 (flag clear), SCB->CCR (validity.c's
+// guarded reads) and IWDG1->KR are written directly: their pages are real
+// memory
+static void map_registers(uintptr_t address)
+{
+	uintptr_t page = address & ~(uintptr_t) 0xFFF;
+
+	if (mmap((void*) page, 0x1000, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+			!= (void*) page)
+	{
+		perror("bl_emu: registers");
+		exit(2);
+	}
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	FLASH->CR1 &= ~FLASH_CR_LOCK;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	FLASH->CR1 |= FLASH_CR_LOCK;
+	return HAL_OK;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	crypto_emu_cpu(Delay * 1e6);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+		GPIO_PinState PinState)
+{
+	(void) GPIOx;
+	(void) GPIO_Pin;
+	(void) PinState;
+}
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+}
+
+void HAL_RTCEx_BKUPWrite(const RTC_HandleTypeDef *hrtc, uint32_t BackupRegister,
+		uint32_t Data)
+{
+	(void) hrtc;
+	(void) BackupRegister;
+	(void) Data;
+}
+
+// No W25Q: staged installs and restores run at power-on, not over USB, and
+// without it updates keep no backup (the image is not put on trial)
+void MX_OCTOSPI2_Init(void)
+{
+}
+
+HAL_StatusTypeDef W25Q64_OCTO_SPI_Init(OSPI_HandleTypeDef *hospi)
+{
+	(void) hospi;
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_Read(OSPI_HandleTypeDef *hospi, uint8_t *pData,
+		uint32_t ReadAddr, uint32_t Size)
+{
+	(void) hospi;
+	(void) pData;
+	(void) ReadAddr;
+	(void) Size;
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef *hospi, uint8_t *pData,
+		uint32_t WriteAddr, uint32_t Size)
+{
+	(void) hospi;
+	(void) pData;
+	(void) WriteAddr;
+	(void) Size;
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_EraseBlockStart(OSPI_HandleTypeDef *hospi,
+		uint32_t BlockAddress, uint32_t BlockSize)
+{
+	(void) hospi;
+	(void) BlockAddress;
+	(void) BlockSize;
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_AutoPollingMemReady(OSPI_HandleTypeDef *hospi)
+{
+	(void) hospi;
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_EraseRange(OSPI_HandleTypeDef *hospi,
+		uint32_t StartAddress, uint32_t EndAddress)
+{
+	(void) hospi;
+	(void) StartAddress;
+	(void) EndAddress;
+
+	return HAL_ERROR;
+}
+
+/* Costs of what runs natively (linked with --wrap) -------------------------*/
+
+static double ecdsa_ns, lz4_ns, crc_ns;
+
+int32_t __real_Crypto_ECDSA_VerifyHash(const uint8_t *hash,
+		const uint8_t *signature);
+int32_t __real_Decompress_Feed(const uint8_t *data, uint32_t length);
+uint32_t __real_crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length);
+int32_t __real_ProcessFirmwarePacket(FirmwarePacket_t *packet);
+
+int32_t __wrap_Crypto_ECDSA_VerifyHash(const uint8_t *hash,
+		const uint8_t *signature)
+{
+	crypto_emu_cpu(ecdsa_ms * 1e6);
+	ecdsa_ns += ecdsa_ms * 1e6;
+	return __real_Crypto_ECDSA_VerifyHash(hash, signature);
+}
+
+// Charged per byte programmed while it ran: the decompressed output
+int32_t __wrap_Decompress_Feed(const uint8_t *data, uint32_t length)
+{
+	crypto_emu_stats_t before, after;
+
+	crypto_emu_get_stats(&before);
+	int32_t result = __real_Decompress_Feed(data, length);
+	crypto_emu_get_stats(&after);
+
+	double ns = (after.flash_bytes - before.flash_bytes) * lz4_cycles * 1000
+			/ timing.cpu_mhz;
+	crypto_emu_cpu(ns);
+	lz4_ns += ns;
+	return result;
+}
+
+uint32_t __wrap_crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	double ns = length * crc_cycles * 1000 / timing.cpu_mhz;
+
+	crypto_emu_cpu(ns);
+	crc_ns += ns;
+	return __real_crc32_ieee(crc, data, length);
+}
+
+/* Sessions -----------------------------------------------------------------*/
+
+static uint32_t starts, packets;
+static double first_start_ns = -1;
+static double idle_ns;			// waiting for the host since the first START
+
+int32_t __wrap_ProcessFirmwarePacket(FirmwarePacket_t *packet)
+{
+	uint32_t type = packet->packet_type;
+
+	packets++;
+	if (type == PACKET_TYPE_START || type == PACKET_TYPE_ENC_START
+			|| type == PACKET_TYPE_STREAM_START)
+	{
+		starts++;
+		if (first_start_ns < 0)
+			first_start_ns = crypto_emu_now_ns();
+	}
+	return __real_ProcessFirmwarePacket(packet);
+}
+
+/* Link: PTY, USB packets, faults -------------------------------------------*/
+
+typedef struct
+{
+	double due;				// virtual ns
+	uint32_t length;
+	uint8_t data[USB_PACKET];
+} response_t;
+
+static const char *link_path = "/tmp/leshuffler_bl";
+static int master = -1, slave = -1;
+
+static uint8_t out_queue[QUEUE_SIZE];	// host to device, not yet delivered
+static uint32_t out_length;
+static double link_free;				// end of the last delivered packet
+
+static response_t responses[RESPONSES_MAX];
+static uint32_t response_count;
+
+typedef enum
+{
+	FAULT_NONE, FAULT_DROP, FAULT_DUP, FAULT_CORRUPT, FAULT_DISCONNECT
+} fault_t;
+
+static const char *const fault_names[] =
+{ "none", "drop", "dup", "corrupt", "disconnect" };
+
+static struct
+{
+	uint32_t packet;		// usb_packets_out
+	fault_t fault;
+} scripted[SCRIPTED_MAX];
+static uint32_t scripted_count;
+
+static uint32_t dropped, duplicated, corrupted, disconnects;
+static uint32_t usb_packets_out, usb_packets_in;
+static uint64_t bytes_out;
+static bool disconnect_pending;
+
+static struct timespec wall_start;
+
+static double wall_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - wall_start.tv_sec) * 1e9
+			+ (now.tv_nsec - wall_start.tv_nsec);
+}
+
+static bool chance(double p)
+{
+	return p > 0 && rand() < p * ((double) RAND_MAX + 1);
+}
+
+// Fault scripted on host to device packet n (--fault-at)
+static fault_t scripted_fault(uint32_t n)
+{
+	for (uint32_t i = 0; i < scripted_count; i++)
+		if (scripted[i].packet == n)
+			return scripted[i].fault;
+	return FAULT_NONE;
+}
+
+// Copies of the packet to pass on (0 dropped, 2 duplicated); may flip a bit.
+// The random draws come first: a scripted fault leaves the sequence as is
+static int inject(uint8_t *data, uint32_t length, fault_t fault)
+{
+	if (chance(p_disconnect) || fault == FAULT_DISCONNECT)
+		disconnect_pending = true;
+	if (chance(p_drop) || fault == FAULT_DROP)
+	{
+		dropped++;
+		return 0;
+	}
+	if (chance(p_corrupt) || fault == FAULT_CORRUPT)
+	{
+		data[rand() % length] ^= 1 << (rand() % 8);
+		corrupted++;
+	}
+	if (chance(p_dup) || fault == FAULT_DUP)
+	{
+		duplicated++;
+		return 2;
+	}
+	return 1;
+}
+
+static void link_open(void)
+{
+	struct termios raw;
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master))
+	{
+		perror("bl_emu: pty");
+		exit(2);
+	}
+	// Kept open: the updater closing its side is not a hang-up
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0 || tcgetattr(slave, &raw))
+	{
+		perror("bl_emu: pty slave");
+		exit(2);
+	}
+	cfmakeraw(&raw);
+	tcsetattr(slave, TCSANOW, &raw);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	unlink(link_path);
+	if (symlink(ptsname(master), link_path))
+	{
+		perror(link_path);
+		exit(2);
+	}
+}
+
+static void link_close(void)
+{
+	close(master);
+	close(slave);
+	master = slave = -1;
+}
+
+// USB disconnect and re-enumeration: the host sees its port vanish
+static void reconnect(void)
+{
+	USBD_Interface_fops_HS.DeInit();
+	link_close();
+	out_length = 0;
+	response_count = 0;
+	disconnects++;
+	disconnect_pending = false;
+	link_open();
+	USBD_Interface_fops_HS.Init();
+}
+
+static void host_read(void)
+{
+	ssize_t n;
+
+	while (out_length < QUEUE_SIZE
+			&& (n = read(master, out_queue + out_length,
+					QUEUE_SIZE - out_length)) > 0)
+		out_length += n;
+}
+
+// Packets whose time has come, to the CDC receive callback
+static void usb_deliver(void)
+{
+	double packet_ns = USB_PACKET * 1e9 / (usb_kbps * 1024);
+
+	while (out_length > 0 && link_free <= crypto_emu_now_ns()
+			&& !disconnect_pending)
+	{
+		uint8_t packet[USB_PACKET];
+		uint32_t length = out_length < USB_PACKET ? out_length : USB_PACKET;
+
+		memcpy(packet, out_queue, length);
+		out_length -= length;
+		memmove(out_queue, out_queue + length, out_length);
+		if (link_free < crypto_emu_now_ns() - packet_ns)
+			link_free = crypto_emu_now_ns() - packet_ns;
+		link_free += packet_ns;
+		usb_packets_out++;
+		bytes_out += length;
+
+		for (int copies = inject(packet, length,
+				scripted_fault(usb_packets_out)); copies > 0; copies--)
+		{
+			uint32_t received = length;
+			USBD_Interface_fops_HS.Receive(packet, &received);
+		}
+	}
+}
+
+// Responses whose time has come, to the host
+static void host_write(void)
+{
+	uint32_t i = 0;
+
+	while (i < response_count && responses[i].due <= wall_ns())
+	{
+		if (write(master, responses[i].data, responses[i].length) < 0
+				&& errno != EAGAIN)
+			break;
+		i++;
+	}
+	memmove(responses, responses + i, (response_count - i) * sizeof(response_t));
+	response_count -= i;
+}
+
+static void sleep_until(double ns)
+{
+	double wait = ns - wall_ns();
+
+	if (wait > 0)
+	{
+		struct timespec t = { (time_t) (wait / 1e9), (long) (wait
+				- (time_t) (wait / 1e9) * 1e9) };
+		nanosleep(&t, NULL);
+	}
+}
+
+/* USB device stack ---------------------------------------------------------*/
+
+static uint8_t *tx_buffer;
+static uint32_t tx_length;
+
+uint8_t USBD_CDC_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff,
+		uint32_t length)
+{
+	(void) pdev;
+
+	tx_buffer = pbuff;
+	tx_length = length;
+	return USBD_OK;
+}
+
+uint8_t USBD_CDC_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff)
+{
+	(void) pdev;
+	(void) pbuff;
+
+	return USBD_OK;
+}
+
+uint8_t USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev)
+{
+	(void) pdev;
+
+	return USBD_OK;
+}
+
+// The IN transfer completes at once (TxState stays 0): queued for the host
+uint8_t USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev)
+{
+	response_t *r = &responses[response_count];
+
+	(void) pdev;
+
+	if (response_count == RESPONSES_MAX || tx_length > USB_PACKET)
+		return USBD_FAIL;
+
+	memcpy(r->data, tx_buffer, tx_length);
+	r->length = tx_length;
+	if (as_major >= 0 && r->length == sizeof(BootloaderStatus_t)
+			&& r->data[1] == PACKET_TYPE_STATUS)
+	{
+		r->data[2] = as_major;
+		r->data[3] = as_minor;
+	}
+	usb_packets_in++;
+
+	int copies = inject(r->data, r->length, FAULT_NONE);
+	r->due = crypto_emu_now_ns() + latency_us * 1000;
+	response_count += copies > 0;
+	if (copies == 2 && response_count < RESPONSES_MAX)
+	{
+		responses[response_count] = *r;
+		response_count++;
+	}
+	return USBD_OK;
+}
+
+/* Main loop (Core/Src/main.c) ----------------------------------------------*/
+
+static bool complete;
+static double complete_ns;
+static volatile sig_atomic_t stopped;
+
+static void on_signal(int signal)
+{
+	(void) signal;
+
+	stopped = 1;
+}
+
+static void main_loop_pass(void)
+{
+	CDC_ProcessPacket();
+	EraseAhead();
+
+	FirmwareUpdateState_t fw_state = GetFirmwareUpdateState();
+
+	if (fw_state == FW_ERROR)
+	{
+		// Reset state, 5 fast beeps
+		ResetFirmwareUpdate();
+		HAL_Delay(5 * 100);
+	}
+
+	if (fw_state == FW_COMPLETE)
+	{
+		// 2 long beeps, then reset
+		complete_ns = crypto_emu_now_ns();
+		HAL_Delay(2 * 800);
+		complete = true;
+	}
+}
+
+/* Report -------------------------------------------------------------------*/
+
+static uint8_t *read_file(const char *path, uint32_t *size)
+{
+	FILE *f = fopen(path, "rb");
+	static uint8_t data[768 * 1024 + 1];
+
+	if (!f)
+		return NULL;
+	*size = fread(data, 1, sizeof(data), f);
+	fclose(f);
+	return *size <= 768 * 1024 ? data : NULL;
+}
+
+static int report(const char *image_path)
+{
+	crypto_emu_stats_t s;
+	uint32_t image_size = GetBytesReceived();
+	int failed = 0;
+
+	crypto_emu_get_stats(&s);
+
+	if (complete)
+	{
+		double seconds = (complete_ns - first_start_ns) / 1e9;
+		printf("Update complete: %u bytes in %.2f s from the first START, "
+				"%.1f KB/s\n", image_size, seconds,
+				image_size / 1024.0 / seconds);
+	}
+	else
+		printf("No completed update\n");
+
+	printf("  starts %u (%u restarts), packets %u, USB packets %u out / "
+			"%u in, %llu bytes from the host\n", starts,
+			starts ? starts - 1 : 0, packets, usb_packets_out, usb_packets_in,
+			(unsigned long long) bytes_out);
+	printf("  faults: %u dropped, %u duplicated, %u corrupted, "
+			"%u disconnects\n", dropped, duplicated, corrupted, disconnects);
+	printf("  device: flash %.0f ms (%u words), erase %.0f ms (%u sectors), "
+			"CRYP %.0f ms, HASH %.0f ms, ECDSA %.0f ms, LZ4 %.0f ms, "
+			"CRC %.0f ms, waiting for the host %.0f ms, %u violations\n",
+			s.flash_ns / 1e6, s.flash_bytes / 32, s.erase_ns / 1e6,
+			s.erase_sectors, s.cryp_ns / 1e6, s.hash_ns / 1e6, ecdsa_ns / 1e6,
+			lz4_ns / 1e6, crc_ns / 1e6, idle_ns / 1e6, s.violations);
+
+	if (complete && image_path)
+	{
+		uint32_t size;
+		const uint8_t *image = read_file(image_path, &size);
+		bool match = image && size == image_size
+				&& memcmp(crypto_emu_flash(), image, size) == 0;
+
+		printf("  flash %s %s\n", match ? "matches" : "DIFFERS FROM",
+				image_path);
+		failed |= !match;
+	}
+	if (complete)
+	{
+		// Accumulated while programming: recorded without reading the flash
+		bool crc_ok = GetApplicationCRC() == __real_crc32_ieee(CRC32_INIT,
+				crypto_emu_flash(), (image_size + 31) / 32 * 32);
+
+		printf("  image CRC %s\n", crc_ok ? "is the flash's" : "DIFFERS");
+		failed |= !crc_ok;
+	}
+	bool jumps = Validity_Check() == VALIDITY_OK;
+
+	if (complete)
+		printf("  validity record: %s\n", jumps ?
+				"OK, next power-on jumps to the application" : "NOT OK");
+	else
+		printf("  validity record: %s\n", jumps ?
+				"OK WITHOUT AN UPDATE" :
+				"not OK, next power-on stays in the bootloader");
+	failed |= jumps != complete || s.violations != 0;
+
+	// A fault asked for that never happened: the run did not test it
+	const uint32_t counts[] =
+	{ 0, dropped, duplicated, corrupted, disconnects };
+	const double p[] = { 0, p_drop, p_dup, p_corrupt, p_disconnect };
+	for (fault_t f = FAULT_DROP; f <= FAULT_DISCONNECT; f++)
+	{
+		bool asked = p[f] > 0;
+
+		for (uint32_t i = 0; i < scripted_count; i++)
+			asked |= scripted[i].fault == f;
+		if (asked && counts[f] == 0)
+		{
+			printf("  NO %s fault happened\n", fault_names[f]);
+			failed = 1;
+		}
+	}
+	return failed ? 1 : complete ? 0 : 3;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *image_path = NULL;
+	double timeout_s = 600;
+	unsigned seed = 1;
+
+	timing = crypto_emu_typical;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--link") == 0 && i + 1 < argc)
+			link_path = argv[++i];
+		else if (strcmp(argv[i], "--image") == 0 && i + 1 < argc)
+			image_path = argv[++i];
+		else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+			timeout_s = atof(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "--drop") == 0 && i + 1 < argc)
+			p_drop = atof(argv[++i]);
+		else if (strcmp(argv[i], "--dup") == 0 && i + 1 < argc)
+			p_dup = atof(argv[++i]);
+		else if (strcmp(argv[i], "--corrupt") == 0 && i + 1 < argc)
+			p_corrupt = atof(argv[++i]);
+		else if (strcmp(argv[i], "--disconnect") == 0 && i + 1 < argc)
+			p_disconnect = atof(argv[++i]);
+		else if (strcmp(argv[i], "--fault-at") == 0 && i + 1 < argc
+				&& scripted_count < SCRIPTED_MAX)
+		{
+			char name[16];
+			fault_t f = FAULT_NONE;
+
+			if (sscanf(argv[++i], "%u:%15s", &scripted[scripted_count].packet,
+					name) == 2)
+				for (f = FAULT_DISCONNECT; f > FAULT_NONE; f--)
+					if (strcmp(name, fault_names[f]) == 0)
+						break;
+			if (f == FAULT_NONE || scripted[scripted_count].packet == 0)
+			{
+				fprintf(stderr, "--fault-at N:drop|dup|corrupt|disconnect, "
+						"N from 1\n");
+				return 2;
+			}
+			scripted[scripted_count++].fault = f;
+		}
+		else if (strcmp(argv[i], "--usb-kbps") == 0 && i + 1 < argc)
+			usb_kbps = atof(argv[++i]);
+		else if (strcmp(argv[i], "--latency-us") == 0 && i + 1 < argc)
+			latency_us = atof(argv[++i]);
+		else if (strcmp(argv[i], "--as-version") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d.%d", &as_major, &as_minor) != 2)
+				as_major = -1;
+		}
+		else if (strcmp(argv[i], "--tprog-us") == 0 && i + 1 < argc)
+			timing.tprog_us = atof(argv[++i]);
+		else if (strcmp(argv[i], "--terase-ms") == 0 && i + 1 < argc)
+			timing.terase_ms = atof(argv[++i]);
+		else if (strcmp(argv[i], "--ecdsa-ms") == 0 && i + 1 < argc)
+			ecdsa_ms = atof(argv[++i]);
+		else if (strcmp(argv[i], "--lz4-cycles") == 0 && i + 1 < argc)
+			lz4_cycles = atof(argv[++i]);
+		else
+		{
+			fprintf(stderr, "Usage: %s [--link PATH] [--image FILE] "
+					"[--timeout S] [--seed N] [--drop P] [--dup P] "
+					"[--corrupt P] [--disconnect P] [--fault-at N:FAULT ...] "
+					"[--usb-kbps N] [--latency-us US] [--as-version M.m] "
+					"[--tprog-us US] [--terase-ms MS] [--ecdsa-ms MS] "
+					"[--lz4-cycles N]\n",
+					argv[0]);
+			return 2;
+		}
+	}
+	if (usb_kbps <= 0)
+	{
+		fprintf(stderr, "--usb-kbps must be positive\n");
+		return 2;
+	}
+	srand(seed);
+	signal(SIGTERM, on_signal);
+	signal(SIGINT, on_signal);
+
+	// Power-on: erased application, flash locked, crypto ready
+	crypto_emu_reset(&timing);
+	map_registers((uintptr_t) FLASH);
+	map_registers((uintptr_t) IWDG1);
+	map_registers((uintptr_t) SCB);
+	FLASH->CR1 = FLASH_CR_LOCK;
+	hUsbDeviceHS.pClassData = &cdc;
+	Crypto_Init();
+	ResetFirmwareUpdate();
+
+	clock_gettime(CLOCK_MONOTONIC, &wall_start);
+	link_open();
+	USBD_Interface_fops_HS.Init();
+	printf("Bootloader v%d.%d on %s\n", BOOTLOADER_VERSION_MAJOR,
+			BOOTLOADER_VERSION_MINOR, link_path);
+	fflush(stdout);
+
+	while (!complete && !stopped && wall_ns() < timeout_s * 1e9)
+	{
+		// Waiting for the host: the device clock follows the wall clock
+		double wait = wall_ns() - crypto_emu_now_ns();
+		if (wait > 0)
+		{
+			crypto_emu_cpu(wait);
+			if (first_start_ns >= 0)
+				idle_ns += wait;
+		}
+
+		host_read();
+		usb_deliver();
+		main_loop_pass();
+
+		// Responses leave once the device has got there
+		sleep_until(crypto_emu_now_ns());
+		host_write();
+		if (disconnect_pending)
+			reconnect();
+
+		if (out_length == 0 || link_free > crypto_emu_now_ns())
+		{
+			struct pollfd p = { master, POLLIN, 0 };
+			poll(&p, 1, 1);
+		}
+	}
+
+	// Last responses out, then the reset drops the link
+	sleep_until(crypto_emu_now_ns());
+	while (complete && response_count > 0)
+	{
+		sleep_until(responses[0].due);
+		host_write();
+	}
+	usleep(100000);
+	link_close();
+	unlink(link_path);
+
+	return report(image_path);
+}
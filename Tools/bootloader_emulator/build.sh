@@ -0,0 +1,45 @@
+#!/bin/sh
+# Build bl_emu on Linux (gcc, no other dependency)
+# Usage: Tools/bootloader_emulator/build.sh [output] [keys directory], from anywhere
+# The keys directory holds the crypto_keys.h to compile in (update_roundtrip.sh
+# makes one with a throwaway public key); the key template by default, never
+# Bootloader_E's crypto_keys.h.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+EMU=$ROOT/Tools/crypto_emulator
+OUT=${1:-$HERE/bl_emu}
+KEYS=$2
+if [ -z "$KEYS" ]; then
+	KEYS=$(mktemp -d)
+	trap 'rm -rf "$KEYS"' EXIT
+	cp "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$KEYS/crypto_keys.h"
+fi
+
+cd "$ROOT"
+# -no-pie: HAL_FLASH_Program takes buffer addresses as 32-bit values
+# __ASM: the CMSIS core functions hold ARM instructions, never called here
+# -include: __set_FAULTMASK() for validity.c (cmsis_host.h)
+# --wrap: costs of ECDSA, LZ4 and CRC32, and the START count (see bl_emu.c)
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+gcc -std=gnu11 -O2 -Wall -Wextra -no-pie \
+  -DSTM32H733xx -DUSE_HAL_DRIVER -DCRC_SOFTWARE '-D__ASM=if (1) {} else __asm__' \
+  -I"$KEYS" -I"$EMU" -include cmsis_host.h -IBootloader_E/Core/Inc -IChecksum -IuECC -IStaging -IW25Q64 \
+  -IBootloader_E/USB_DEVICE/App -IBootloader_E/USB_DEVICE/Target \
+  -isystem Bootloader_E/Middlewares/ST/STM32_USB_Device_Library/Core/Inc \
+  -isystem Bootloader_E/Middlewares/ST/STM32_USB_Device_Library/Class/CDC/Inc \
+  -isystem Bootloader_E/Drivers/CMSIS/Device/ST/STM32H7xx/Include \
+  -isystem Bootloader_E/Drivers/CMSIS/Include \
+  -isystem Bootloader_E/Drivers/STM32H7xx_HAL_Driver/Inc \
+  -Wl,--wrap=Crypto_ECDSA_VerifyHash,--wrap=Decompress_Feed \
+  -Wl,--wrap=crc32_ieee,--wrap=ProcessFirmwarePacket \
+  "$HERE/bl_emu.c" "$EMU/crypto_emu.c" \
+  Bootloader_E/Core/Src/bootload.c Bootloader_E/Core/Src/validity.c \
+  Bootloader_E/USB_DEVICE/App/usbd_cdc_if.c \
+  Bootloader_E/Core/Src/crypto.c Bootloader_E/Core/Src/decompress.c \
+  Bootloader_E/Core/Src/delta.c Staging/staging.c Staging/rollback.c \
+  Checksum/checksum.c Checksum/sha256.c uECC/uECC.c \
+  -o "$OUT"
+
+echo "$OUT"
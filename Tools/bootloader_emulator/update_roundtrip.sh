@@ -0,0 +1,98 @@
+#!/bin/sh
+# Update bl_emu over its PTY with the unmodified LeShuffler_Updater.py:
+# streamed and compressed, packet mode (as a v3.1 bootloader), and streamed
+# with drops, duplicates, corruption and disconnects on the USB link.
+# Usage: Tools/bootloader_emulator/update_roundtrip.sh [firmware.bin]
+# Without an image a synthetic 160 KB one stands in (the real LeShuffler.bin
+# needs the ARM toolchain): a vector table, then Thumb-like code. The key
+# template's AES key and a throwaway ECDSA key are used, never the real keys.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+if [ $# -eq 1 ]; then
+	IMAGE=$1
+else
+	IMAGE=$TMP/firmware.bin
+	python3 - "$IMAGE" <<'PY'
+import random, struct, sys
+random.seed(1)
+vectors = struct.pack('<2I', 0x24050000, 0x08020299) + bytes(0x290)
+ops = [0x4770, 0xB580, 0x2000, 0x6803, 0xF000, 0xE7FE]
+code = b''.join(struct.pack('<H', random.choice(ops) if random.random() < 0.6
+                            else random.getrandbits(16)) for _ in range(80000))
+open(sys.argv[1], 'wb').write((vectors + code)[:160 * 1024])
+PY
+fi
+echo "Image: $(wc -c < "$IMAGE") bytes"
+
+# Throwaway ECDSA key, the template's AES key, and a crypto_keys.h to match
+python3 "$ROOT/Tools/encrypt_firmware.py" --generate-keys "$TMP/keys.json" > /dev/null
+python3 - "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$TMP/keys.json" "$TMP/crypto_keys.h" <<'PY'
+import json, re, sys
+text = open(sys.argv[1]).read()
+body = re.search(r'AES_KEY\s*\[\s*32\s*\]\s*=\s*\{(.*?)\}', text, re.S).group(1)
+key = bytes(int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{2})', re.sub(r'/\*.*?\*/', '', body)))
+keys = json.load(open(sys.argv[2]))
+keys['aes_key'] = key.hex()
+json.dump(keys, open(sys.argv[2], 'w'))
+public = bytes.fromhex(keys['ecdsa_public_key'])
+rows = ',\n'.join('    ' + ', '.join('0x%02X' % b for b in public[i:i + 8]) for i in range(0, 64, 8))
+text = re.sub(r'(ECDSA_PUBLIC_KEY\s*\[\s*64\s*\]\s*=\s*\{).*?\}', lambda m: m.group(1) + '\n' + rows + ',\n}', text, flags=re.S)
+open(sys.argv[3], 'w').write(text)
+PY
+
+"$HERE/build.sh" "$TMP/bl_emu" "$TMP" > /dev/null
+
+python3 "$ROOT/Tools/encrypt_firmware.py" "$IMAGE" "$TMP/plain.sfu" \
+	--keys "$TMP/keys.json" > /dev/null
+python3 "$ROOT/Tools/encrypt_firmware.py" "$IMAGE" "$TMP/compressed.sfu" \
+	--keys "$TMP/keys.json" --compress > /dev/null
+
+FAILED=0
+
+# update NAME SFU [bl_emu options]: one update, bl_emu's report; it must
+# complete with the image in flash (bl_emu exit status 0)
+update() {
+	NAME=$1
+	SFU=$2
+	shift 2
+	echo
+	echo "== $NAME"
+	"$TMP/bl_emu" --link "$TMP/port" --image "$IMAGE" --timeout 600 "$@" \
+		> "$TMP/emu.log" &
+	EMU=$!
+	while [ ! -e "$TMP/port" ] && kill -0 $EMU 2> /dev/null; do sleep 0.1; done
+	printf 'y\n\n\n' | python3 "$ROOT/Tools/LeShuffler_Updater.py" \
+		--file "$SFU" "$TMP/port" > "$TMP/updater.log" 2>&1 || true
+	sleep 3
+	kill $EMU 2> /dev/null || true
+	STATUS=0
+	wait $EMU || STATUS=$?
+	tail -n +2 "$TMP/emu.log"
+	if [ $STATUS -ne 0 ]; then
+		tr '\r' '\n' < "$TMP/updater.log" | grep -av '^ *\[' | tail -n 20
+		FAILED=1
+	fi
+}
+
+update "Streamed, LZ4" "$TMP/compressed.sfu"
+update "Streamed" "$TMP/plain.sfu"
+update "Packet mode (as v3.1)" "$TMP/plain.sfu" --as-version 3.1
+# One fault of each kind, 400 USB packets apart: each makes the updater
+# restart, and the next one falls in the data of the new session (a fault
+# on STREAM_START would end the update)
+update "Streamed, LZ4, faults" "$TMP/compressed.sfu" \
+	--fault-at 300:drop --fault-at 700:dup --fault-at 1100:corrupt \
+	--fault-at 1500:disconnect
+
+echo
+if [ $FAILED -eq 0 ]; then
+	echo "all updates OK"
+else
+	echo "FAILED"
+	exit 1
+fi
@@ -0,0 +1,16 @@
+#!/bin/sh
+# Build checksum_test on Linux (gcc, no other dependency)
+# Usage: Tools/checksum_test/build.sh [output], from anywhere
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT=${1:-$HERE/checksum_test}
+
+cd "$ROOT"
+gcc -std=gnu11 -O2 -Wall -Wextra -DCRC_SOFTWARE \
+  -IChecksum \
+  "$HERE/checksum_test.c" Checksum/checksum.c \
+  -o "$OUT"
+
+echo "$OUT"
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Check Checksum/checksum.c against binascii.crc32 and binascii.crc_hqx
+# (CRC-16/CCITT-FALSE) with checksum_test: random buffers from 0 B to 300 KB,
+# lengths around the 8-byte slices and the 4 KB MDMA threshold, and the
+# CRC16 check string.
+# Usage: Tools/checksum_test/checksum_roundtrip.sh
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+python3 - "$TMP/vectors" <<'PY'
+import binascii, random, struct, sys
+random.seed(1)
+lengths = list(range(0, 20)) + [31, 32, 33, 255, 256, 2043, 4095, 4096, 4097,
+                                 8191, 65535, 65536, 100003, 300 * 1024]
+lengths += [random.randrange(1, 300 * 1024) for _ in range(20)]
+buffers = [b'123456789'] + [bytes(random.getrandbits(8) for _ in range(n)) for n in lengths]
+with open(sys.argv[1], 'wb') as f:
+    for data in buffers:
+        f.write(struct.pack('<IIH', len(data), binascii.crc32(data),
+                            binascii.crc_hqx(data, 0xFFFF)) + data)
+assert binascii.crc_hqx(b'123456789', 0xFFFF) == 0x29B1
+PY
+
+"$HERE/build.sh" "$TMP/checksum_test" > /dev/null
+"$TMP/checksum_test" "$TMP/vectors"
@@ -0,0 +1,162 @@
+/*
+ * checksum_test: check Checksum/checksum.c (CRC_SOFTWARE path) against
+ * Python's binascii and the loader's former CRC16
+ *
+ * Reads the vectors written by checksum_roundtrip.sh: for each buffer its
+ * length, binascii.crc32() and binascii.crc_hqx(data, 0xFFFF). Every buffer
+ * is checked at the four start alignments, in one call and chained at
+ * three split points; CRC16 also against Calculate_CRC(), the bitwise
+ * version image_utility.c had before checksum.c (lengths up to 65535, its
+ * uint16_t limit). Then times both CRC16 versions on one loader packet.
+ *
+ * The target path (CRC unit, MDMA) is not covered: it needs the device.
+ *
+ * Usage: checksum_test VECTORS
+ */
+
+#include <checksum.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOADER_PACKET	2043	// Header after the sequence byte + 2 KB of data
+
+static int failures;
+
+// image_utility.c before checksum.c, unchanged
+static uint16_t Calculate_CRC(uint8_t *data, uint16_t length)
+{
+	uint16_t CRC16 = 0xFFFF;
+	uint16_t Poly = 0x1021;
+	for (uint16_t i = 0; i < length; i++)
+	{
+		CRC16 ^= (data[i] << 8);   //XOR byte into the CRC register
+		for (uint8_t j = 0; j < 8; j++)
+		{  // Process each bit
+			if (CRC16 & 0x8000)
+			{				  // Check if the MSB is set
+				CRC16 = (CRC16 << 1) ^ Poly;  // Shift left and XOR Polynomial
+			}
+			else
+			{
+				CRC16 = CRC16 << 1;  //Just shift left
+			}
+		}
+	}
+	return CRC16; //Final CRC
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void fail(const char *what, uint32_t length, uint32_t align,
+		uint32_t got, uint32_t expected)
+{
+	if (failures++ < 10)
+		printf("  %s, %u bytes at +%u: %08X, expected %08X\n", what,
+				(unsigned) length, (unsigned) align, (unsigned) got,
+				(unsigned) expected);
+}
+
+static void check(const uint8_t *data, uint32_t length, uint32_t crc32,
+		uint16_t crc16)
+{
+	static uint8_t buffer[512 * 1024 + 4];
+	uint32_t splits[3] = { 1, length / 3, length - length % 8 };
+
+	for (uint32_t align = 0; align < 4; align++)
+	{
+		uint8_t *p = buffer + align;
+
+		memcpy(p, data, length);
+		if (crc32_ieee(CRC32_INIT, p, length) != crc32)
+			fail("crc32", length, align, crc32_ieee(CRC32_INIT, p, length),
+					crc32);
+		if (crc16_ccitt(CRC16_CCITT_INIT, p, length) != crc16)
+			fail("crc16", length, align,
+					crc16_ccitt(CRC16_CCITT_INIT, p, length), crc16);
+
+		for (int i = 0; i < 3; i++)
+		{
+			uint32_t s = splits[i] > length ? length : splits[i];
+			uint32_t c32 = crc32_ieee(crc32_ieee(CRC32_INIT, p, s), p + s,
+					length - s);
+			uint16_t c16 = crc16_ccitt(crc16_ccitt(CRC16_CCITT_INIT, p, s),
+					p + s, length - s);
+
+			if (c32 != crc32)
+				fail("crc32 chained", length, align, c32, crc32);
+			if (c16 != crc16)
+				fail("crc16 chained", length, align, c16, crc16);
+		}
+	}
+
+	// The last copy is at +3
+	if (length <= 0xFFFF && Calculate_CRC(buffer + 3, length) != crc16)
+		fail("Calculate_CRC", length, 3, Calculate_CRC(buffer + 3, length),
+				crc16);
+}
+
+int main(int argc, char *argv[])
+{
+	static uint8_t data[512 * 1024];
+	static uint8_t packet[LOADER_PACKET];
+	uint8_t header[10];
+	uint32_t buffers = 0;
+	volatile uint16_t sink = 0;
+	FILE *f;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s VECTORS\n", argv[0]);
+		return 2;
+	}
+	if ((f = fopen(argv[1], "rb")) == NULL)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+
+	// Little-endian length, crc32, crc16, then the data
+	while (fread(header, 1, sizeof(header), f) == sizeof(header))
+	{
+		uint32_t length = header[0] | header[1] << 8 | header[2] << 16
+				| (uint32_t) header[3] << 24;
+		uint32_t crc32 = header[4] | header[5] << 8 | header[6] << 16
+				| (uint32_t) header[7] << 24;
+		uint16_t crc16 = header[8] | header[9] << 8;
+
+		if (length > sizeof(data) || fread(data, 1, length, f) != length)
+		{
+			fprintf(stderr, "%s: truncated\n", argv[1]);
+			return 2;
+		}
+		check(data, length, crc32, crc16);
+		buffers++;
+	}
+	fclose(f);
+	printf("%u buffers, 4 alignments, 3 splits: %d mismatches\n",
+			(unsigned) buffers, failures);
+
+	for (uint32_t i = 0; i < sizeof(packet); i++)
+		packet[i] = i * 7;
+	double t0 = now_us();
+	for (int i = 0; i < 1000; i++)
+		sink += Calculate_CRC(packet, sizeof(packet));
+	double t1 = now_us();
+	for (int i = 0; i < 1000; i++)
+		sink += crc16_ccitt(CRC16_CCITT_INIT, packet, sizeof(packet));
+	double t2 = now_us();
+	printf("CRC16 of %d bytes on the host: bitwise %.1f us, "
+			"slicing-by-8 %.1f us\n", LOADER_PACKET, (t1 - t0) / 1000,
+			(t2 - t1) / 1000);
+
+	printf("%s\n", failures ? "FAILED" : "all checks OK");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Build the CRYP/HASH emulator benchmark on Linux (gcc, no other dependency)
+# Usage: Tools/crypto_emulator/build.sh [output], from anywhere
+# The key template is compiled in, never Bootloader_E's crypto_keys.h.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT=${1:-$HERE/crypto_bench}
+KEYS=$(mktemp -d)
+trap 'rm -rf "$KEYS"' EXIT
+cp "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$KEYS/crypto_keys.h"
+
+cd "$ROOT"
+# -no-pie: HAL_FLASH_Program takes buffer addresses as 32-bit values
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+gcc -std=gnu11 -O2 -Wall -Wextra -no-pie \
+  -DSTM32H733xx -DUSE_HAL_DRIVER \
+  -I"$KEYS" -I"$HERE" -IBootloader_E/Core/Inc -IChecksum -IuECC -IStaging \
+  -isystem Bootloader_E/Drivers/CMSIS/Device/ST/STM32H7xx/Include \
+  -isystem Bootloader_E/Drivers/CMSIS/Include \
+  -isystem Bootloader_E/Drivers/STM32H7xx_HAL_Driver/Inc \
+  "$HERE/crypto_bench.c" "$HERE/crypto_emu.c" \
+  Bootloader_E/Core/Src/crypto.c Bootloader_E/Core/Src/decompress.c \
+  Checksum/sha256.c uECC/uECC.c \
+  -o "$OUT"
+
+echo "$OUT"
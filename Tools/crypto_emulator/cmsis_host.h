@@ -0,0 +1,14 @@
+/*
+ * cmsis_host.h: CMSIS core functions the host builds link in place of
+ * the target's. cmsis_gcc.h defines __set_FAULTMASK() for ARMv7-M only;
+ * crypto_emu.c stands in for it. Force-included (-include) into the
+ * bootloader sources, so it includes nothing: a file's feature macros
+ * must still come before the first system header.
+ */
+
+#ifndef CMSIS_HOST_H_
+#define CMSIS_HOST_H_
+
+void __set_FAULTMASK(unsigned int faultMask);
+
+#endif /* CMSIS_HOST_H_ */
@@ -0,0 +1,395 @@
+/*
+ * crypto_bench: run Bootloader_E/Core/Src/crypto.c on the emulated CRYP,
+ * HASH and DMA1
+ *
+ * Streams an AES-256-CBC image in chunks, as ProcessFirmwareChunk() does,
+ * once through the blocking path (hash, decrypt, then program each chunk)
+ * and once through Crypto_PipelineBlock() (decrypt and hash of a chunk by
+ * DMA while the previous one is programmed). Checks the programmed flash
+ * against the plaintext and the digest against a software SHA-256, then
+ * reports the time of each stage and of the whole stream on the virtual
+ * clock. Chunks arrive in two receive buffers that are overwritten as
+ * soon as a call returns, like the USB slots. See build.sh.
+ *
+ * With --sfu, streams a .sfu made by encrypt_firmware.py with the key
+ * template's AES key instead, through the pipeline and, for a compressed
+ * image, Bootloader_E/Core/Src/decompress.c as ProgramStreamChunk() does;
+ * the programmed flash must equal --image. Decompression runs natively and
+ * is charged --lz4-cycles per output byte. See sfu_roundtrip.sh.
+ *
+ * Usage: crypto_bench [--kb N] [--chunk BYTES] [--usb-us US]
+ *                     [--tprog-us US] [--cpu-mhz MHZ]
+ *                     [--sfu FILE --image FILE] [--lz4-cycles N]
+ *   --kb N          image size in KB (default 512)
+ *   --chunk BYTES   chunk size, multiple of 32 (default 4096, STREAM_CHUNK_MAX)
+ *   --usb-us US     CPU time to receive the next chunk (default 0)
+ *   --tprog-us US   flash word programming time (default 16, assumed)
+ *   --cpu-mhz MHZ   core and AHB clock (default 64, HSI)
+ *   --sfu FILE      stream this .sfu instead of a random image
+ *   --image FILE    the plain firmware the .sfu was made from
+ *   --lz4-cycles N  decompression CPU cycles per output byte (default 12,
+ *                   assumed)
+ */
+
+#include <crypto.h>
+#include <crypto_keys.h>
+#include <decompress.h>
+#include <main.h>
+#include <sha256.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto_emu.h"
+
+#define FLASH_BASE_ADDR		0x08020000UL
+#define FLASH_WORD			32
+
+static crypto_emu_timing_t timing;
+static double usb_us = 0;
+static uint32_t chunk_size = 4096;
+
+static uint8_t plain[896 * 1024];
+static uint8_t cipher[sizeof(plain)];
+static uint8_t rx[2][CRYPTO_PIPELINE_BLOCK_MAX] __attribute__((aligned(32)));
+static uint8_t dec[CRYPTO_PIPELINE_BLOCK_MAX + 32] __attribute__((aligned(32)));
+static const uint8_t image_iv[16] = { 0x10, 0x32, 0x54, 0x76, 0x98, 0xBA,
+		0xDC, 0xFE, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF };
+
+static uint32_t written;
+static int fail_at = -1;		// program callback call that fails
+static int program_calls;
+
+static uint8_t sfu_file[sizeof(SFU_Header_t) + sizeof(plain) + 4096];
+static SFU_Header_t sfu;
+static double lz4_cycles = 12;
+static uint32_t decrypted;		// .sfu payload bytes decrypted
+
+// WriteFlash() of the stream path: whole 32-byte words, in order
+static HAL_StatusTypeDef program(uint8_t *data, uint32_t length)
+{
+	if (program_calls++ == fail_at)
+		return HAL_ERROR;
+	for (uint32_t i = 0; i < length; i += FLASH_WORD)
+	{
+		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD,
+				FLASH_BASE_ADDR + written + i,
+				(uint32_t) (uintptr_t) (data + i)) != HAL_OK)
+			return HAL_ERROR;
+	}
+	written += length;
+	return HAL_OK;
+}
+
+// ProgramImageData() of bootload.c: trim PKCS7 padding, pad a flash word
+static HAL_StatusTypeDef program_image(uint8_t *data, uint32_t length)
+{
+	uint32_t remaining = sfu.original_size - written;
+
+	if (sfu.magic == SFU_MAGIC_LZ4)
+		crypto_emu_cpu(length * lz4_cycles * 1000 / timing.cpu_mhz);
+	if (length > remaining)
+		length = remaining;
+	memset(data + length, 0xFF, (FLASH_WORD - length % FLASH_WORD) % FLASH_WORD);
+	return program(data, (length + FLASH_WORD - 1) / FLASH_WORD * FLASH_WORD);
+}
+
+// ProgramStreamChunk() and FeedCompressed() of bootload.c
+static HAL_StatusTypeDef program_sfu_chunk(uint8_t *data, uint32_t length)
+{
+	if (sfu.magic != SFU_MAGIC_LZ4)
+		return program_image(data, length);
+
+	decrypted += length;
+	if (decrypted == sfu.firmware_size)
+	{
+		uint8_t pad = data[length - 1];
+
+		if (pad == 0 || pad > 16 || pad > length)
+			return HAL_ERROR;
+		length -= pad;
+	}
+	if (Decompress_Feed(data, length) != DECOMPRESS_OK
+			|| (decrypted == sfu.firmware_size
+					&& Decompress_Finish() != DECOMPRESS_OK))
+		return HAL_ERROR;
+	return HAL_OK;
+}
+
+// FIPS-197 C.3: AES-256, one block (CBC with a zero IV)
+static int check_aes(void)
+{
+	static const uint8_t expected[16] = { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67,
+			0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 };
+	uint8_t key[32], iv[16] = { 0 }, pt[16], ct[16];
+
+	for (int i = 0; i < 32; i++)
+		key[i] = i;
+	for (int i = 0; i < 16; i++)
+		pt[i] = i * 0x11;
+	crypto_emu_encrypt(key, iv, pt, ct, 16);
+	return memcmp(ct, expected, 16) == 0;
+}
+
+// Stream size bytes of ciphertext; returns the chunk that failed, or -1
+static int run(int pipelined, const uint8_t *src, uint32_t size,
+		const uint8_t start_iv[16], Crypto_ProgramFn program_fn,
+		uint8_t digest[32])
+{
+	uint8_t iv[16];
+	uint32_t done = 0;
+	int n = 0;
+
+	memcpy(iv, start_iv, 16);
+	written = 0;
+	program_calls = 0;
+	Crypto_Reset();
+	if (Crypto_SHA256_Start() != CRYPTO_OK)
+		return 0;
+
+	for (; done < size; n++)
+	{
+		uint32_t length = size - done < chunk_size ? size - done : chunk_size;
+		uint8_t *buf = rx[n & 1];
+		uint8_t last = (done + length == size);
+
+		crypto_emu_cpu(usb_us * 1000);
+		memcpy(buf, src + done, length);
+
+		if (pipelined)
+		{
+			if (Crypto_PipelineBlock(buf, length, iv, last, program_fn)
+					!= CRYPTO_OK)
+				return n;
+		}
+		else
+		{
+			if (Crypto_SHA256_Update(buf, length) != CRYPTO_OK
+					|| Crypto_DecryptFirmwareBlock(buf, dec, length, iv)
+							!= CRYPTO_OK || program_fn(dec, length) != HAL_OK)
+				return n;
+		}
+
+		// The receive slot is reused at once
+		memset(buf, 0xA5, length);
+		done += length;
+	}
+
+	return Crypto_SHA256_Finish(digest) == CRYPTO_OK ? -1 : n;
+}
+
+static double kbps(uint32_t bytes, double ns)
+{
+	return ns > 0 ? bytes / 1024.0 / (ns / 1e9) : 0;
+}
+
+static int bench(const char *name, int pipelined, uint32_t size,
+		const uint8_t expected[32])
+{
+	uint8_t digest[32];
+	crypto_emu_stats_t s;
+	int failed;
+
+	crypto_emu_reset(&timing);
+	failed = run(pipelined, cipher, size, image_iv, program, digest);
+	crypto_emu_get_stats(&s);
+	double total = crypto_emu_now_ns();
+
+	if (failed >= 0)
+	{
+		printf("%-10s error at chunk %d\n", name, failed);
+		return 1;
+	}
+	if (memcmp(crypto_emu_flash(), plain, size) != 0
+			|| memcmp(digest, expected, 32) != 0 || s.violations)
+	{
+		printf("%-10s FAILED (flash %s, digest %s, %u violations)\n", name,
+				memcmp(crypto_emu_flash(), plain, size) ? "differs" : "OK",
+				memcmp(digest, expected, 32) ? "differs" : "OK", s.violations);
+		return 1;
+	}
+
+	printf("%-10s %9.0f %9.0f %9.0f %9.1f %9.0f\n", name,
+			kbps(s.cryp_bytes, s.cryp_ns), kbps(s.hash_bytes, s.hash_ns),
+			kbps(s.flash_bytes, s.flash_ns), total / 1e6, kbps(size, total));
+	return 0;
+}
+
+// A programming error on chunk N is reported by the call for chunk N+1
+static int check_error(uint32_t size)
+{
+	uint8_t digest[32];
+	int failed;
+
+	crypto_emu_reset(&timing);
+	fail_at = 2;
+	failed = run(1, cipher, size, image_iv, program, digest);
+	fail_at = -1;
+	printf("%-10s programming error on chunk 2 %s at chunk %d\n", "error",
+			failed == 3 ? "reported" : "NOT reported", failed);
+	return failed != 3;
+}
+
+static long load(const char *path, uint8_t *buf, uint32_t max)
+{
+	FILE *f = fopen(path, "rb");
+	long size;
+
+	if (!f)
+		return -1;
+	size = fread(buf, 1, max, f);
+	if (fgetc(f) != EOF)
+		size = -1;
+	fclose(f);
+	return size;
+}
+
+// Stream a .sfu through the pipeline, and the decompressor if compressed
+static int bench_sfu(const char *sfu_path, const char *image_path)
+{
+	const uint8_t *payload = sfu_file + sizeof(SFU_Header_t);
+	uint8_t digest[32], expected[32];
+	long sfu_size, image_size;
+	crypto_emu_stats_t s;
+	sha256_t sha;
+	int failed;
+
+	sfu_size = load(sfu_path, sfu_file, sizeof(sfu_file));
+	image_size = load(image_path, plain, sizeof(plain));
+	if (sfu_size < (long) sizeof(SFU_Header_t) || image_size <= 0)
+	{
+		fprintf(stderr, "Cannot read %s or %s\n", sfu_path, image_path);
+		return 2;
+	}
+	memcpy(&sfu, sfu_file, sizeof(sfu));
+	if ((sfu.magic != SFU_MAGIC && sfu.magic != SFU_MAGIC_LZ4)
+			|| sfu.firmware_size != sfu_size - sizeof(SFU_Header_t)
+			|| sfu.firmware_size % 16 || sfu.original_size != image_size)
+	{
+		fprintf(stderr, "%s: bad header or not made from %s\n", sfu_path,
+				image_path);
+		return 2;
+	}
+
+	sha256_start(&sha);
+	sha256_update(&sha, payload, sfu.firmware_size);
+	sha256_finish(&sha, expected);
+
+	crypto_emu_reset(&timing);
+	decrypted = 0;
+	if (sfu.magic == SFU_MAGIC_LZ4)
+		Decompress_Start(sfu.original_size, program_image);
+	failed = run(1, payload, sfu.firmware_size, sfu.iv, program_sfu_chunk,
+			digest);
+	crypto_emu_get_stats(&s);
+	double total = crypto_emu_now_ns();
+
+	const char *name = strrchr(sfu_path, '/');
+
+	printf("%s: %s, %u bytes, image %u bytes (%.1f%%)\n",
+			name ? name + 1 : sfu_path,
+			sfu.magic == SFU_MAGIC_LZ4 ? "LZ4" : "plain",
+			(unsigned) sfu.firmware_size, (unsigned) sfu.original_size,
+			100.0 * sfu.firmware_size / sfu.original_size);
+	if (failed >= 0 || memcmp(crypto_emu_flash(), plain, image_size) != 0
+			|| memcmp(digest, expected, 32) != 0 || s.violations)
+	{
+		printf("FAILED (chunk %d, flash %s, digest %s, %u violations)\n",
+				failed, memcmp(crypto_emu_flash(), plain, image_size) ?
+						"differs" : "OK",
+				memcmp(digest, expected, 32) ? "differs" : "OK", s.violations);
+		return 1;
+	}
+	printf("flash matches the image, digest OK: %.1f ms, %.0f KB/s of image\n",
+			total / 1e6, kbps(sfu.original_size, total));
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *sfu_path = NULL, *image_path = NULL;
+	uint32_t size = 512 * 1024;
+	uint8_t expected[32];
+	sha256_t sha;
+	int errors = 0;
+
+	timing = crypto_emu_typical;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--kb") == 0 && i + 1 < argc)
+			size = atof(argv[++i]) * 1024;
+		else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+			chunk_size = strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "--usb-us") == 0 && i + 1 < argc)
+			usb_us = atof(argv[++i]);
+		else if (strcmp(argv[i], "--tprog-us") == 0 && i + 1 < argc)
+			timing.tprog_us = atof(argv[++i]);
+		else if (strcmp(argv[i], "--cpu-mhz") == 0 && i + 1 < argc)
+			timing.cpu_mhz = timing.hclk_mhz = atof(argv[++i]);
+		else if (strcmp(argv[i], "--sfu") == 0 && i + 1 < argc)
+			sfu_path = argv[++i];
+		else if (strcmp(argv[i], "--image") == 0 && i + 1 < argc)
+			image_path = argv[++i];
+		else if (strcmp(argv[i], "--lz4-cycles") == 0 && i + 1 < argc)
+			lz4_cycles = atof(argv[++i]);
+		else
+		{
+			fprintf(stderr,
+					"Usage: %s [--kb N] [--chunk BYTES] [--usb-us US] "
+							"[--tprog-us US] [--cpu-mhz MHZ]\n"
+							"       [--sfu FILE --image FILE] [--lz4-cycles N]\n",
+					argv[0]);
+			return 2;
+		}
+	}
+	if (sfu_path || image_path)
+	{
+		if (!sfu_path || !image_path || chunk_size == 0
+				|| chunk_size % FLASH_WORD
+				|| chunk_size > CRYPTO_PIPELINE_BLOCK_MAX)
+		{
+			fprintf(stderr, "--sfu and --image go together, chunks of 32 to "
+					"%u bytes\n", CRYPTO_PIPELINE_BLOCK_MAX);
+			return 2;
+		}
+		printf("%u-byte chunks, CPU %.0f MHz, tprog %.0f us, next chunk "
+				"%.0f us, LZ4 %.0f cycles/byte\n", (unsigned) chunk_size,
+				timing.cpu_mhz, timing.tprog_us, usb_us, lz4_cycles);
+		return bench_sfu(sfu_path, image_path);
+	}
+	size &= ~(uint32_t) (FLASH_WORD - 1);
+	if (size == 0 || size > sizeof(plain) || chunk_size == 0
+			|| chunk_size % FLASH_WORD || chunk_size > CRYPTO_PIPELINE_BLOCK_MAX)
+	{
+		fprintf(stderr, "Image up to %u KB, chunks of 32 to %u bytes\n",
+				(unsigned) (sizeof(plain) / 1024), CRYPTO_PIPELINE_BLOCK_MAX);
+		return 2;
+	}
+
+	crypto_emu_reset(&timing);
+	if (!check_aes())
+	{
+		printf("AES-256 FIPS-197 vector FAILED\n");
+		return 1;
+	}
+	srand(1);
+	for (uint32_t i = 0; i < size; i++)
+		plain[i] = rand();
+	crypto_emu_encrypt(AES_KEY, image_iv, plain, cipher, size);
+	sha256_start(&sha);
+	sha256_update(&sha, cipher, size);
+	sha256_finish(&sha, expected);
+
+	printf("%u KB in %u-byte chunks, CPU %.0f MHz, tprog %.0f us, "
+			"next chunk %.0f us\n\n", (unsigned) (size / 1024),
+			(unsigned) chunk_size, timing.cpu_mhz, timing.tprog_us, usb_us);
+	printf("%-10s %9s %9s %9s %9s %9s\n", "stream", "CRYP", "HASH", "flash",
+			"total ms", "KB/s");
+	printf("%-10s %9s %9s %9s %9s %9s\n", "", "KB/s", "KB/s", "KB/s", "", "");
+	errors += bench("blocking", 0, size, expected);
+	errors += bench("pipelined", 1, size, expected);
+	printf("\n");
+	errors += check_error(size);
+
+	return errors ? 1 : 0;
+}
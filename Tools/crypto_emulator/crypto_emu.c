@@ -0,0 +1,692 @@
+/*
+ * CRYP, HASH and DMA1 emulated on Linux (host only), see crypto_emu.h
+ *
+ * Replaces the HAL CRYP / HASH / RNG drivers and Core/Src/cryp.c, hash.c
+ * for Bootloader_E/Core/Src/crypto.c. Only AES-256-CBC decryption with
+ * 8-bit data and SHA-256 are modelled.
+ */
+
+#include <cryp.h>
+#include <hash.h>
+#include <main.h>
+#include <rng.h>
+#include <sha256.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "crypto_emu.h"
+
+#define EMU_BANK_BASE		0x08000000UL	// Bank 1: bootloader sector, then the application
+#define EMU_BANK_SIZE		(1024 * 1024)
+#define EMU_SECTOR_SIZE		(128 * 1024)
+#define EMU_FLASH_BASE		0x08020000UL	// APPLICATION_START_ADDRESS
+#define EMU_FLASH_WORD		32
+
+const crypto_emu_timing_t crypto_emu_typical =
+{
+	// Bootloader clocks (HSI 64 MHz, HCLK = SYSCLK); peripheral figures are
+	// assumptions in the order of the reference manual, not measurements
+	.cpu_mhz = 64, .hclk_mhz = 64, .aes_block_cycles = 18, .sha_block_cycles =
+			66, .dma_word_cycles = 4, .cryp_poll_cycles = 160,
+	.hash_poll_cycles = 12, .call_cycles = 600, .tick_cycles = 20,
+	.tprog_us = 16, .terase_ms = 1000 };
+
+CRYP_HandleTypeDef hcryp;
+HASH_HandleTypeDef hhash;
+RNG_HandleTypeDef hrng;
+
+static crypto_emu_timing_t t;
+static crypto_emu_stats_t stats;
+static double now;				// virtual clock, ns
+static uint8_t *flash;			// application sectors, inside the bank mapping
+
+// CRYP: expanded key and chaining value, as in the key and IV registers
+static uint8_t round_keys[240];
+static uint8_t cryp_iv[16];
+
+typedef struct
+{
+	bool running;
+	double end;
+	const uint8_t *in;
+	uint8_t *out;
+	uint32_t size;
+	bool mdmat;			// HASH: digest stays open for the next buffer
+} dma_job_t;
+
+static dma_job_t cryp_job, hash_job;
+
+// HASH: running digest, and the final one once the last block is in
+static sha256_t sha;
+static bool sha_open;
+static uint8_t digest[32];
+static bool digest_ready;
+
+/* AES-256 -----------------------------------------------------------------*/
+
+static uint8_t sbox[256], inv_sbox[256];
+
+static uint8_t xtime(uint8_t x)
+{
+	return (x << 1) ^ (x & 0x80 ? 0x1B : 0);
+}
+
+static uint8_t mul(uint8_t a, uint8_t b)
+{
+	uint8_t r = 0;
+
+	while (b)
+	{
+		if (b & 1)
+			r ^= a;
+		a = xtime(a);
+		b >>= 1;
+	}
+	return r;
+}
+
+static uint8_t rotl8(uint8_t x, int n)
+{
+	return (x << n) | (x >> (8 - n));
+}
+
+static void aes_tables(void)
+{
+	uint8_t p = 1, q = 1;
+
+	// p runs through the multiplicative group, q through its inverses
+	do
+	{
+		p = p ^ xtime(p);
+		q ^= q << 1;
+		q ^= q << 2;
+		q ^= q << 4;
+		if (q & 0x80)
+			q ^= 0x09;
+		sbox[p] = 0x63 ^ q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3)
+				^ rotl8(q, 4);
+	} while (p != 1);
+	sbox[0] = 0x63;
+
+	for (int i = 0; i < 256; i++)
+		inv_sbox[sbox[i]] = i;
+}
+
+static void aes_expand(const uint8_t key[32])
+{
+	uint8_t rcon = 1;
+
+	memcpy(round_keys, key, 32);
+	for (int i = 32; i < 240; i += 4)
+	{
+		uint8_t w[4];
+
+		memcpy(w, round_keys + i - 4, 4);
+		if (i % 32 == 0)
+		{
+			uint8_t w0 = w[0];
+
+			w[0] = sbox[w[1]] ^ rcon;
+			w[1] = sbox[w[2]];
+			w[2] = sbox[w[3]];
+			w[3] = sbox[w0];
+			rcon = xtime(rcon);
+		}
+		else if (i % 32 == 16)
+		{
+			for (int k = 0; k < 4; k++)
+				w[k] = sbox[w[k]];
+		}
+		for (int k = 0; k < 4; k++)
+			round_keys[i + k] = round_keys[i - 32 + k] ^ w[k];
+	}
+}
+
+static void add_round_key(uint8_t s[16], int round)
+{
+	for (int i = 0; i < 16; i++)
+		s[i] ^= round_keys[round * 16 + i];
+}
+
+static void aes_encrypt_block(uint8_t s[16])
+{
+	uint8_t u[16];
+
+	add_round_key(s, 0);
+	for (int round = 1; round <= 14; round++)
+	{
+		// SubBytes and ShiftRows (state is column major)
+		for (int c = 0; c < 4; c++)
+			for (int r = 0; r < 4; r++)
+				u[c * 4 + r] = sbox[s[((c + r) % 4) * 4 + r]];
+		if (round < 14)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				uint8_t *a = u + c * 4;
+
+				s[c * 4 + 0] = xtime(a[0]) ^ mul(a[1], 3) ^ a[2] ^ a[3];
+				s[c * 4 + 1] = a[0] ^ xtime(a[1]) ^ mul(a[2], 3) ^ a[3];
+				s[c * 4 + 2] = a[0] ^ a[1] ^ xtime(a[2]) ^ mul(a[3], 3);
+				s[c * 4 + 3] = mul(a[0], 3) ^ a[1] ^ a[2] ^ xtime(a[3]);
+			}
+		}
+		else
+			memcpy(s, u, 16);
+		add_round_key(s, round);
+	}
+}
+
+static void aes_decrypt_block(uint8_t s[16])
+{
+	uint8_t u[16];
+
+	add_round_key(s, 14);
+	for (int round = 13; round >= 0; round--)
+	{
+		// InvShiftRows and InvSubBytes
+		for (int c = 0; c < 4; c++)
+			for (int r = 0; r < 4; r++)
+				u[((c + r) % 4) * 4 + r] = inv_sbox[s[c * 4 + r]];
+		memcpy(s, u, 16);
+		add_round_key(s, round);
+		if (round > 0)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				uint8_t a[4];
+
+				memcpy(a, s + c * 4, 4);
+				s[c * 4 + 0] = mul(a[0], 14) ^ mul(a[1], 11) ^ mul(a[2], 13)
+						^ mul(a[3], 9);
+				s[c * 4 + 1] = mul(a[0], 9) ^ mul(a[1], 14) ^ mul(a[2], 11)
+						^ mul(a[3], 13);
+				s[c * 4 + 2] = mul(a[0], 13) ^ mul(a[1], 9) ^ mul(a[2], 14)
+						^ mul(a[3], 11);
+				s[c * 4 + 3] = mul(a[0], 11) ^ mul(a[1], 13) ^ mul(a[2], 9)
+						^ mul(a[3], 14);
+			}
+		}
+	}
+}
+
+// CBC with the IV register; in and out may be the same buffer
+static void cbc_decrypt(const uint8_t *in, uint8_t *out, uint32_t size)
+{
+	uint8_t block[16], next_iv[16];
+
+	for (uint32_t i = 0; i < size; i += 16)
+	{
+		memcpy(block, in + i, 16);
+		memcpy(next_iv, block, 16);
+		aes_decrypt_block(block);
+		for (int k = 0; k < 16; k++)
+			out[i + k] = block[k] ^ cryp_iv[k];
+		memcpy(cryp_iv, next_iv, 16);
+	}
+}
+
+static void cbc_encrypt(const uint8_t *in, uint8_t *out, uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i += 16)
+	{
+		for (int k = 0; k < 16; k++)
+			out[i + k] = in[i + k] ^ cryp_iv[k];
+		aes_encrypt_block(out + i);
+		memcpy(cryp_iv, out + i, 16);
+	}
+}
+
+void crypto_emu_encrypt(const uint8_t key[32], const uint8_t iv[16],
+		const uint8_t *in, uint8_t *out, uint32_t size)
+{
+	uint8_t chain[16];
+
+	aes_expand(key);
+	memcpy(chain, iv, 16);
+	for (uint32_t i = 0; i < size; i += 16)
+	{
+		for (int k = 0; k < 16; k++)
+			out[i + k] = in[i + k] ^ chain[k];
+		aes_encrypt_block(out + i);
+		memcpy(chain, out + i, 16);
+	}
+}
+
+/* Virtual clock -----------------------------------------------------------*/
+
+static double cpu_ns(double cycles)
+{
+	return cycles * 1000 / t.cpu_mhz;
+}
+
+static double hclk_ns(double cycles)
+{
+	return cycles * 1000 / t.hclk_mhz;
+}
+
+// Finish the DMA transfers whose time has come
+static void run_dma(void)
+{
+	if (cryp_job.running && now >= cryp_job.end)
+	{
+		cryp_job.running = false;
+		cbc_decrypt(cryp_job.in, cryp_job.out, cryp_job.size);
+		hcryp.State = HAL_CRYP_STATE_READY;
+	}
+	if (hash_job.running && now >= hash_job.end)
+	{
+		hash_job.running = false;
+		sha256_update(&sha, hash_job.in, hash_job.size);
+		if (!hash_job.mdmat)
+		{
+			sha256_finish(&sha, digest);
+			sha_open = false;
+			digest_ready = true;
+		}
+		hhash.State = HAL_HASH_STATE_READY;
+	}
+}
+
+static void cpu(double ns)
+{
+	now += ns;
+	run_dma();
+}
+
+void crypto_emu_cpu(double ns)
+{
+	cpu(ns);
+}
+
+double crypto_emu_now_ns(void)
+{
+	return now;
+}
+
+void crypto_emu_reset(const crypto_emu_timing_t *timing)
+{
+	static bool mapped;
+
+	t = *timing;
+	now = 0;
+	memset(&stats, 0, sizeof(stats));
+	memset(&cryp_job, 0, sizeof(cryp_job));
+	memset(&hash_job, 0, sizeof(hash_job));
+	sha_open = digest_ready = false;
+	aes_tables();
+
+	// The HAL macros set MDMAT in HASH->CR directly
+	if (!mapped)
+	{
+		uintptr_t page = (uintptr_t) HASH & ~(uintptr_t) 0xFFF;
+
+		if (mmap((void*) page, 0x1000, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+				!= (void*) page)
+		{
+			perror("crypto_emu: HASH registers");
+			exit(2);
+		}
+
+		// Flash at its address: code that reads it directly sees what was
+		// programmed (the sector 0 part holds only what is programmed there)
+		if (mmap((void*) EMU_BANK_BASE, EMU_BANK_SIZE, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+				!= (void*) EMU_BANK_BASE)
+		{
+			perror("crypto_emu: flash bank");
+			exit(2);
+		}
+		flash = (uint8_t*) EMU_FLASH_BASE;
+		mapped = true;
+	}
+	HASH->CR = 0;
+	memset((void*) EMU_BANK_BASE, 0xFF, EMU_BANK_SIZE);
+
+	hcryp.Instance = CRYP;
+	hcryp.State = HAL_CRYP_STATE_RESET;
+	hhash.State = HAL_HASH_STATE_RESET;
+	hrng.Instance = RNG;
+}
+
+void crypto_emu_get_stats(crypto_emu_stats_t *s)
+{
+	*s = stats;
+}
+
+uint8_t* crypto_emu_flash(void)
+{
+	return flash;
+}
+
+/* Core --------------------------------------------------------------------*/
+
+static uint32_t faultmask;
+
+void __set_FAULTMASK(unsigned int faultMask)
+{
+	faultmask = faultMask & 1;
+}
+
+uint32_t crypto_emu_faultmask(void)
+{
+	return faultmask;
+}
+
+/* HAL ---------------------------------------------------------------------*/
+
+uint32_t HAL_GetTick(void)
+{
+	cpu(cpu_ns(t.tick_cycles));
+	return (uint32_t) (now / 1e6);
+}
+
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef *h,
+		uint32_t *random32bit)
+{
+	(void) h;
+	*random32bit = rand();
+	return HAL_OK;
+}
+
+static void be_bytes(const uint32_t *words, uint8_t *bytes, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		bytes[i * 4] = words[i] >> 24;
+		bytes[i * 4 + 1] = words[i] >> 16;
+		bytes[i * 4 + 2] = words[i] >> 8;
+		bytes[i * 4 + 3] = words[i];
+	}
+}
+
+HAL_StatusTypeDef HAL_CRYP_Init(CRYP_HandleTypeDef *h)
+{
+	uint8_t key[32];
+
+	cpu(cpu_ns(t.call_cycles));
+	if (cryp_job.running)
+		stats.violations++;		// reconfigured under a running transfer
+	if (h->Init.Algorithm != CRYP_AES_CBC
+			|| h->Init.KeySize != CRYP_KEYSIZE_256B
+			|| h->Init.DataType != CRYP_DATATYPE_8B)
+		return HAL_ERROR;
+
+	be_bytes(h->Init.pKey, key, 8);
+	be_bytes(h->Init.pInitVect, cryp_iv, 4);
+	aes_expand(key);
+	h->State = HAL_CRYP_STATE_READY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CRYP_DeInit(CRYP_HandleTypeDef *h)
+{
+	cryp_job.running = false;
+	h->State = HAL_CRYP_STATE_RESET;
+	return HAL_OK;
+}
+
+HAL_CRYP_STATETypeDef HAL_CRYP_GetState(CRYP_HandleTypeDef *h)
+{
+	cpu(cpu_ns(t.tick_cycles));
+	return h->State;
+}
+
+HAL_StatusTypeDef HAL_CRYP_Decrypt(CRYP_HandleTypeDef *h, uint32_t *Input,
+		uint16_t Size, uint32_t *Output, uint32_t Timeout)
+{
+	uint32_t size = Size * 4, blocks = size / 16;
+
+	(void) Timeout;
+
+	if (h->State != HAL_CRYP_STATE_READY || size % 16)
+		return HAL_ERROR;
+
+	// The CPU feeds and drains the FIFOs: both wait for each other
+	double ns = blocks
+			* (hclk_ns(t.aes_block_cycles) + cpu_ns(t.cryp_poll_cycles));
+	cpu(ns);
+	cbc_decrypt((uint8_t*) Input, (uint8_t*) Output, size);
+	stats.cryp_ns += ns;
+	stats.cryp_bytes += size;
+	return HAL_OK;
+}
+
+// Same costs as decryption
+HAL_StatusTypeDef HAL_CRYP_Encrypt(CRYP_HandleTypeDef *h, uint32_t *Input,
+		uint16_t Size, uint32_t *Output, uint32_t Timeout)
+{
+	uint32_t size = Size * 4, blocks = size / 16;
+
+	(void) Timeout;
+
+	if (h->State != HAL_CRYP_STATE_READY || size % 16)
+		return HAL_ERROR;
+
+	double ns = blocks
+			* (hclk_ns(t.aes_block_cycles) + cpu_ns(t.cryp_poll_cycles));
+	cpu(ns);
+	cbc_encrypt((uint8_t*) Input, (uint8_t*) Output, size);
+	stats.cryp_ns += ns;
+	stats.cryp_bytes += size;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CRYP_Decrypt_DMA(CRYP_HandleTypeDef *h, uint32_t *Input,
+		uint16_t Size, uint32_t *Output)
+{
+	uint32_t size = Size * 4, blocks = size / 16;
+
+	cpu(cpu_ns(t.call_cycles));
+	if (h->State != HAL_CRYP_STATE_READY || size % 16 || size == 0)
+		return HAL_ERROR;
+
+	// Core and DMA words in and out overlap, the slower sets the pace
+	double core = hclk_ns(blocks * t.aes_block_cycles);
+	double dma = hclk_ns(2 * Size * t.dma_word_cycles);
+	double ns = core > dma ? core : dma;
+
+	cryp_job = (dma_job_t ) { .running = true, .end = now + ns, .in =
+					(uint8_t*) Input, .out = (uint8_t*) Output, .size = size };
+	h->State = HAL_CRYP_STATE_BUSY;
+	stats.cryp_ns += ns;
+	stats.cryp_bytes += size;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASH_Init(HASH_HandleTypeDef *h)
+{
+	cpu(cpu_ns(t.call_cycles));
+	if (hash_job.running)
+		stats.violations++;
+	if (h->Init.DataType != HASH_DATATYPE_8B)
+		return HAL_ERROR;
+	HASH->CR &= ~HASH_CR_MDMAT;
+	h->Phase = HAL_HASH_PHASE_READY;
+	h->State = HAL_HASH_STATE_READY;
+	sha_open = digest_ready = false;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASH_DeInit(HASH_HandleTypeDef *h)
+{
+	hash_job.running = false;
+	h->Phase = HAL_HASH_PHASE_READY;
+	h->State = HAL_HASH_STATE_RESET;
+	sha_open = digest_ready = false;
+	return HAL_OK;
+}
+
+HAL_HASH_StateTypeDef HAL_HASH_GetState(HASH_HandleTypeDef *h)
+{
+	cpu(cpu_ns(t.tick_cycles));
+	return h->State;
+}
+
+static void hash_open(HASH_HandleTypeDef *h)
+{
+	if (h->Phase == HAL_HASH_PHASE_READY)
+	{
+		sha256_start(&sha);
+		sha_open = true;
+		digest_ready = false;
+		h->Phase = HAL_HASH_PHASE_PROCESS;
+	}
+}
+
+// Polling: the CPU writes every word, the core runs meanwhile
+static double hash_poll_ns(uint32_t size)
+{
+	double feed = cpu_ns((size + 3) / 4 * t.hash_poll_cycles);
+	double core = hclk_ns((size + 63) / 64 * t.sha_block_cycles);
+
+	return feed > core ? feed : core;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Accmlt(HASH_HandleTypeDef *h,
+		uint8_t *pInBuffer, uint32_t Size)
+{
+	if (h->State != HAL_HASH_STATE_READY || Size % 4)
+		return HAL_ERROR;
+	hash_open(h);
+
+	double ns = hash_poll_ns(Size);
+	cpu(ns);
+	sha256_update(&sha, pInBuffer, Size);
+	stats.hash_ns += ns;
+	stats.hash_bytes += Size;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Accmlt_End(HASH_HandleTypeDef *h,
+		uint8_t *pInBuffer, uint32_t Size, uint8_t *pOutBuffer,
+		uint32_t Timeout)
+{
+	(void) Timeout;
+	if (h->State != HAL_HASH_STATE_READY)
+		return HAL_ERROR;
+	hash_open(h);
+
+	double ns = hash_poll_ns(Size) + hclk_ns(t.sha_block_cycles);
+	cpu(ns);
+	sha256_update(&sha, pInBuffer, Size);
+	sha256_finish(&sha, pOutBuffer);
+	sha_open = false;
+	h->Phase = HAL_HASH_PHASE_READY;
+	stats.hash_ns += ns;
+	stats.hash_bytes += Size;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Start(HASH_HandleTypeDef *h,
+		uint8_t *pInBuffer, uint32_t Size, uint8_t *pOutBuffer,
+		uint32_t Timeout)
+{
+	return HAL_HASHEx_SHA256_Accmlt_End(h, pInBuffer, Size, pOutBuffer,
+			Timeout);
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Start_DMA(HASH_HandleTypeDef *h,
+		uint8_t *pInBuffer, uint32_t Size)
+{
+	bool mdmat = (HASH->CR & HASH_CR_MDMAT) != 0;
+
+	cpu(cpu_ns(t.call_cycles));
+	if (h->State != HAL_HASH_STATE_READY || Size == 0)
+		return HAL_ERROR;
+	if (mdmat && Size % 4)
+		stats.violations++;		// digest corrupted (reference manual)
+	hash_open(h);
+
+	double core = hclk_ns((Size + 63) / 64 * t.sha_block_cycles);
+	double dma = hclk_ns((Size + 3) / 4 * t.dma_word_cycles);
+	double ns = core > dma ? core : dma;
+
+	hash_job = (dma_job_t ) { .running = true, .end = now + ns, .in =
+					pInBuffer, .size = Size, .mdmat = mdmat };
+	h->State = HAL_HASH_STATE_BUSY;
+	stats.hash_ns += ns;
+	stats.hash_bytes += Size;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Finish(HASH_HandleTypeDef *h,
+		uint8_t *pOutBuffer, uint32_t Timeout)
+{
+	if (h->State != HAL_HASH_STATE_READY)
+		return HAL_ERROR;
+
+	// DCIS only rises after a last buffer fed with MDMAT reset
+	if (!digest_ready)
+	{
+		stats.violations++;
+		cpu(Timeout * 1e6);
+		return HAL_TIMEOUT;
+	}
+	cpu(hclk_ns(t.sha_block_cycles));
+	memcpy(pOutBuffer, digest, 32);
+	digest_ready = false;
+	h->Phase = HAL_HASH_PHASE_READY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t FlashAddress,
+		uint32_t DataAddress)
+{
+	uint8_t *dst = (uint8_t*) (uintptr_t) FlashAddress;
+
+	(void) TypeProgram;
+
+	// Past the bootloader sector: application, then the validity log
+	if (FlashAddress < EMU_FLASH_BASE
+			|| FlashAddress + EMU_FLASH_WORD > EMU_BANK_BASE + EMU_BANK_SIZE
+			|| FlashAddress % EMU_FLASH_WORD)
+	{
+		stats.violations++;
+		return HAL_ERROR;
+	}
+	for (int i = 0; i < EMU_FLASH_WORD; i++)
+	{
+		if (dst[i] != 0xFF)
+		{
+			stats.violations++;		// not erased
+			return HAL_ERROR;
+		}
+	}
+
+	// The CPU stalls on the busy bank, DMA transfers go on
+	memcpy(dst, (const void*) (uintptr_t) DataAddress, EMU_FLASH_WORD);
+	cpu(cpu_ns(t.call_cycles / 4) + t.tprog_us * 1000);
+	stats.flash_ns += t.tprog_us * 1000;
+	stats.flash_bytes += EMU_FLASH_WORD;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *e,
+		uint32_t *SectorError)
+{
+	*SectorError = 0xFFFFFFFF;
+
+	// Sectors of bank 1 past the bootloader's
+	if (e->TypeErase != FLASH_TYPEERASE_SECTORS || e->Banks != FLASH_BANK_1
+			|| e->Sector < 1 || e->NbSectors == 0
+			|| e->Sector + e->NbSectors > EMU_BANK_SIZE / EMU_SECTOR_SIZE)
+	{
+		stats.violations++;
+		return HAL_ERROR;
+	}
+
+	for (uint32_t i = 0; i < e->NbSectors; i++)
+	{
+		memset((uint8_t*) EMU_BANK_BASE + (e->Sector + i) * EMU_SECTOR_SIZE,
+				0xFF, EMU_SECTOR_SIZE);
+		cpu(cpu_ns(t.call_cycles) + t.terase_ms * 1e6);
+		stats.erase_ns += t.terase_ms * 1e6;
+		stats.erase_sectors++;
+	}
+	return HAL_OK;
+}
@@ -0,0 +1,75 @@
+/*
+ * CRYP, HASH and DMA1 of the bootloader, emulated on Linux (host only)
+ *
+ * crypto_emu.c implements the HAL_CRYP_*, HAL_HASH* and HAL_FLASH_Program
+ * functions that Bootloader_E/Core/Src/crypto.c and the benchmark call:
+ * AES-256-CBC (both ways) and SHA-256 in software, costed on a virtual clock.
+ * Polling calls cost CPU time. DMA transfers run beside the CPU and
+ * finish at a time set by the slower of the peripheral core and the DMA
+ * words; their results are computed from the buffers as they are at that
+ * time, so a buffer reused too early shows up as wrong data. Flash word
+ * programming and sector erase (HAL_FLASHEx_Erase) stall the CPU (single
+ * bank), not the DMA. Flash bank 1 is mapped at its address, 0x08000000:
+ * code that reads flash directly sees what was programmed.
+ *
+ * HASH->CR (MDMAT) is a real page mapped at its address; the rest of the
+ * peripherals exist only behind the HAL calls.
+ *
+ * Calls the HAL would refuse or that would corrupt a transfer (init while
+ * a DMA runs, digest read before the last block) count as violations.
+ */
+
+#ifndef CRYPTO_EMU_H_
+#define CRYPTO_EMU_H_
+
+#include <stdint.h>
+
+#include "cmsis_host.h"
+
+typedef struct
+{
+	double cpu_mhz;				// core clock
+	double hclk_mhz;			// AHB clock of CRYP, HASH and DMA1
+	double aes_block_cycles;	// AES-256 per 16-byte block, HCLK
+	double sha_block_cycles;	// SHA-256 per 64-byte block, HCLK
+	double dma_word_cycles;		// one DMA word, memory to peripheral or back
+	double cryp_poll_cycles;	// HAL_CRYP_Decrypt per block, CPU feeding FIFOs
+	double hash_poll_cycles;	// HAL_HASHEx_SHA256_Accmlt per word
+	double call_cycles;			// one HAL_*_Init or DMA start
+	double tick_cycles;			// one state or tick read in a wait loop
+	double tprog_us;			// 256-bit flash word programming
+	double terase_ms;			// 128 KB sector erase
+} crypto_emu_timing_t;
+
+typedef struct
+{
+	double cryp_ns;			// CRYP busy (polling or DMA)
+	double hash_ns;			// HASH busy (polling or DMA)
+	double flash_ns;		// flash programming
+	double erase_ns;		// sector erase
+	uint32_t cryp_bytes;
+	uint32_t hash_bytes;
+	uint32_t flash_bytes;
+	uint32_t erase_sectors;
+	uint32_t violations;
+} crypto_emu_stats_t;
+
+extern const crypto_emu_timing_t crypto_emu_typical;
+
+void crypto_emu_reset(const crypto_emu_timing_t *timing);
+void crypto_emu_get_stats(crypto_emu_stats_t *stats);
+double crypto_emu_now_ns(void);
+void crypto_emu_cpu(double ns);		// CPU busy elsewhere
+
+// Application flash (sectors 1-6) as programmed, then the validity log
+// (sector 7), erased to 0xFF by reset
+uint8_t* crypto_emu_flash(void);
+
+// FAULTMASK as the code set it last (__set_FAULTMASK(), cmsis_host.h)
+uint32_t crypto_emu_faultmask(void);
+
+// Software AES-256-CBC, to prepare test images
+void crypto_emu_encrypt(const uint8_t key[32], const uint8_t iv[16],
+		const uint8_t *in, uint8_t *out, uint32_t size);
+
+#endif /* CRYPTO_EMU_H_ */
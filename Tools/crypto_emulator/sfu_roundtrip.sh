@@ -0,0 +1,55 @@
+#!/bin/sh
+# Make a plain and an LZ4-compressed .sfu of a firmware image with
+# encrypt_firmware.py, stream both through crypto_bench (pipeline and
+# decompress.c) and check the programmed flash against the image.
+# Usage: Tools/crypto_emulator/sfu_roundtrip.sh [image.bin] [crypto_bench options]
+# Without an image, the LCD fonts' data compiled on the host stands in: the
+# real LeShuffler.bin needs the ARM toolchain. The key template's AES key and
+# a throwaway ECDSA key are used, never the real keys.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+IMAGE=
+case "$1" in
+	""|-*) ;;
+	*) IMAGE=$1; shift ;;
+esac
+
+"$HERE/build.sh" "$TMP/crypto_bench" > /dev/null
+
+if [ -z "$IMAGE" ]; then
+	IMAGE=$TMP/fonts.bin
+	for f in "$ROOT"/LCD/Fonts/*.c; do
+		o=$TMP/$(basename "$f" .c).o
+		gcc -c -O2 -I"$ROOT/LCD/Fonts" -I"$ROOT/LCD" "$f" -o "$o"
+		objcopy -O binary -j .rodata -j .data "$o" "$o.bin"
+		cat "$o.bin" >> "$IMAGE"
+	done
+	echo "Image: LCD/Fonts data, $(wc -c < "$IMAGE") bytes (host-compiled stand-in)"
+else
+	echo "Image: $IMAGE, $(wc -c < "$IMAGE") bytes"
+fi
+
+python3 "$ROOT/Tools/encrypt_firmware.py" --generate-keys "$TMP/keys.json" > /dev/null
+python3 - "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$TMP/keys.json" <<'PY'
+import json, re, sys
+text = open(sys.argv[1]).read()
+body = re.search(r'AES_KEY\s*\[\s*32\s*\]\s*=\s*\{(.*?)\}', text, re.S).group(1)
+key = bytes(int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{2})', re.sub(r'/\*.*?\*/', '', body)))
+keys = json.load(open(sys.argv[2]))
+keys['aes_key'] = key.hex()
+json.dump(keys, open(sys.argv[2], 'w'))
+PY
+
+for mode in plain compressed; do
+	opt=
+	[ $mode = compressed ] && opt=--compress
+	python3 "$ROOT/Tools/encrypt_firmware.py" "$IMAGE" "$TMP/$mode.sfu" \
+		--keys "$TMP/keys.json" $opt > "$TMP/$mode.log" || { cat "$TMP/$mode.log"; exit 1; }
+	echo
+	"$TMP/crypto_bench" --sfu "$TMP/$mode.sfu" --image "$IMAGE" "$@"
+done
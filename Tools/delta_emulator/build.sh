@@ -0,0 +1,35 @@
+#!/bin/sh
+# Build delta_apply on Linux (gcc, no other dependency)
+# Usage: Tools/delta_emulator/build.sh [output] [keys directory], from anywhere
+# The keys directory holds the crypto_keys.h to compile in (delta_roundtrip.sh
+# makes one with a throwaway public key); the key template by default, never
+# Bootloader_E's crypto_keys.h.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+EMU=$ROOT/Tools/crypto_emulator
+OUT=${1:-$HERE/delta_apply}
+KEYS=$2
+if [ -z "$KEYS" ]; then
+	KEYS=$(mktemp -d)
+	trap 'rm -rf "$KEYS"' EXIT
+	cp "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$KEYS/crypto_keys.h"
+fi
+
+cd "$ROOT"
+# -no-pie: HAL_FLASH_Program takes buffer addresses as 32-bit values
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+gcc -std=gnu11 -O2 -Wall -Wextra -no-pie \
+  -DSTM32H733xx -DUSE_HAL_DRIVER -DCRC_SOFTWARE \
+  -I"$KEYS" -I"$EMU" -IBootloader_E/Core/Inc -IChecksum -IuECC -IStaging -IW25Q64 \
+  -isystem Bootloader_E/Drivers/CMSIS/Device/ST/STM32H7xx/Include \
+  -isystem Bootloader_E/Drivers/CMSIS/Include \
+  -isystem Bootloader_E/Drivers/STM32H7xx_HAL_Driver/Inc \
+  "$HERE/delta_apply.c" "$EMU/crypto_emu.c" \
+  Bootloader_E/Core/Src/crypto.c Bootloader_E/Core/Src/decompress.c \
+  Bootloader_E/Core/Src/delta.c Staging/staging.c \
+  Checksum/checksum.c Checksum/sha256.c uECC/uECC.c \
+  -o "$OUT"
+
+echo "$OUT"
@@ -0,0 +1,607 @@
+/*
+ * delta_apply: install a delta .sfu (SFU_MAGIC_DELTA) on an emulated W25Q
+ * and application flash, as InstallStagedFirmware() does
+ *
+ * The .sfu is staged like the application does it (payload, then the
+ * record) with the base image in application flash. The delta install of
+ * Bootloader_E/Core/Src/bootload.c is mirrored below, function for
+ * function, over the real crypto.c (on the emulated CRYP and HASH of
+ * Tools/crypto_emulator), decompress.c, delta.c and Staging/staging.c.
+ * Scenarios, each from a fresh W25Q and flash:
+ *   install      the application becomes --target, the record is cleared;
+ *                the image CRC accumulated while programming is the flash's
+ *   wrong base   another image is installed: refused, flash untouched,
+ *                record cleared
+ *   tampered     one ciphertext byte flipped: refused as above
+ *   rebuild cut  power lost while the scratch area is written, then reset:
+ *                rebuilt from the base again
+ *   commit cut   power lost while the application is programmed, then
+ *                reset: installed from the scratch area, the base is gone
+ * Power loss is a budget of W25Q or flash writes; once spent, every
+ * W25Q and flash operation fails until the next "reset".
+ *
+ * Usage: delta_apply --sfu FILE --base FILE --target FILE
+ * The bootloader's public key must be the one the .sfu was signed with and
+ * its AES key the template's: see delta_roundtrip.sh.
+ */
+
+#include <checksum.h>
+#include <crypto.h>
+#include <decompress.h>
+#include <delta.h>
+#include <main.h>
+#include <staging.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto_emu.h"
+
+#define APP_ADDRESS			0x08020000UL	// APPLICATION_START_ADDRESS
+#define APP_SIZE			(768 * 1024)	// Sectors 1-6
+#define APP_SECTOR_SIZE		0x20000
+#define FLASH_WORD_SIZE		32
+#define STAGED_CHUNK_SIZE	4096
+#define W25Q_SIZE			0x01000000UL	// 24-bit addresses
+
+OSPI_HandleTypeDef hospi2;
+
+static uint8_t w25q[W25Q_SIZE];
+static uint8_t sfu_file[sizeof(SFU_Header_t) + STAGING_PAYLOAD_MAX];
+static uint8_t base_image[APP_SIZE];
+static uint8_t target_image[APP_SIZE];
+static long sfu_size, base_size, target_size;
+
+static long power_budget = -1;		// writes left before power loss, -1: none
+static int powered = 1;
+static uint32_t scratch_writes, flash_words;
+
+// Emulated power: a write past the budget fails and cuts everything
+static int spend(void)
+{
+	if (!powered)
+		return 0;
+	if (power_budget == 0)
+	{
+		powered = 0;
+		return 0;
+	}
+	if (power_budget > 0)
+		power_budget--;
+	return 1;
+}
+
+/* W25Q64 --------------------------------------------------------------------*/
+
+HAL_StatusTypeDef W25Q64_OSPI_Read(OSPI_HandleTypeDef *h, uint8_t *data,
+		uint32_t address, uint32_t size)
+{
+	(void) h;
+
+	if (!powered || address + size > W25Q_SIZE)
+		return HAL_ERROR;
+	memcpy(data, w25q + address, size);
+	return HAL_OK;
+}
+
+// Programming clears bits only: a write to an unerased sector shows up
+HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef *h, uint8_t *data,
+		uint32_t address, uint32_t size)
+{
+	(void) h;
+
+	if (address + size > W25Q_SIZE || !spend())
+		return HAL_ERROR;
+	for (uint32_t i = 0; i < size; i++)
+		w25q[address + i] &= data[i];
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_EraseBlockStart(OSPI_HandleTypeDef *h,
+		uint32_t address, uint32_t size)
+{
+	(void) h;
+
+	if (address % size || address + size > W25Q_SIZE || !spend())
+		return HAL_ERROR;
+	memset(w25q + address, 0xFF, size);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_AutoPollingMemReady(OSPI_HandleTypeDef *h)
+{
+	(void) h;
+
+	return powered ? HAL_OK : HAL_ERROR;
+}
+
+/* Application flash ---------------------------------------------------------*/
+
+static uint8_t* app(void)
+{
+	return crypto_emu_flash();
+}
+
+static HAL_StatusTypeDef EraseSingleSector(uint32_t i)
+{
+	if (!spend())
+		return HAL_ERROR;
+	memset(app() + i * APP_SECTOR_SIZE, 0xFF, APP_SECTOR_SIZE);
+	return HAL_OK;
+}
+
+static uint8_t SectorBlank(uint32_t i)
+{
+	for (uint32_t j = 0; j < APP_SECTOR_SIZE; j++)
+	{
+		if (app()[i * APP_SECTOR_SIZE + j] != 0xFF)
+			return 0;
+	}
+	return 1;
+}
+
+static HAL_StatusTypeDef WriteFlash(uint32_t address, uint8_t *data,
+		uint32_t length)
+{
+	for (uint32_t i = 0; i < length; i += FLASH_WORD_SIZE)
+	{
+		if (!spend() || HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD,
+				address + i, (uint32_t) (uintptr_t) (data + i)) != HAL_OK
+				|| memcmp(app() + (address + i - APP_ADDRESS), data + i,
+						FLASH_WORD_SIZE) != 0)
+			return HAL_ERROR;
+		flash_words++;
+	}
+	return HAL_OK;
+}
+
+/* bootload.c, staged install ------------------------------------------------*/
+
+static uint8_t staged_enc_buffer[STAGED_CHUNK_SIZE] __attribute__((aligned(32)));
+static uint8_t staged_dec_buffer[STAGED_CHUNK_SIZE] __attribute__((aligned(32)));
+static uint8_t staged_first_word[FLASH_WORD_SIZE] __attribute__((aligned(32)));
+static uint32_t staged_written;
+static uint32_t image_crc;
+
+static SFU_DeltaHeader_t delta_header __attribute__((aligned(4)));
+static uint8_t delta_hash[32] __attribute__((aligned(4)));
+static uint32_t scratch_address;
+
+static HAL_StatusTypeDef FeedCompressed(const uint8_t *data, uint32_t length,
+		uint8_t last)
+{
+	if (last)
+	{
+		uint8_t pad = data[length - 1];
+
+		if (pad == 0 || pad > AES_BLOCK_SIZE || pad > length)
+			return HAL_ERROR;
+		length -= pad;
+	}
+	if (Decompress_Feed(data, length) != DECOMPRESS_OK)
+		return HAL_ERROR;
+	if (last && Decompress_Finish() != DECOMPRESS_OK)
+		return HAL_ERROR;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef HashStaged(uint32_t address, uint32_t length,
+		uint8_t *hash)
+{
+	uint32_t size;
+
+	Crypto_Reset();
+	if (Crypto_SHA256_Start() != CRYPTO_OK)
+		return HAL_ERROR;
+	for (uint32_t offset = 0; offset < length; offset += size)
+	{
+		size = length - offset;
+		if (size > STAGED_CHUNK_SIZE)
+			size = STAGED_CHUNK_SIZE;
+		if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer, address + offset,
+				size) != HAL_OK
+				|| Crypto_SHA256_Update(staged_enc_buffer, size) != CRYPTO_OK)
+		{
+			Crypto_Reset();
+			return HAL_ERROR;
+		}
+	}
+	return Crypto_SHA256_Finish(hash) == CRYPTO_OK ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef VerifyStagedFirmware(const SFU_Header_t *header)
+{
+	static uint8_t staged_hash[32] __attribute__((aligned(4)));
+
+	if (HashStaged(STAGING_PAYLOAD_OFFSET, header->firmware_size, staged_hash)
+			!= HAL_OK)
+		return HAL_ERROR;
+	return Crypto_ECDSA_VerifyHash(staged_hash, header->signature) == CRYPTO_OK ?
+			HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef ProgramStagedData(uint8_t *data, uint32_t length)
+{
+	uint32_t padded_size = (length + FLASH_WORD_SIZE - 1) / FLASH_WORD_SIZE
+			* FLASH_WORD_SIZE;
+	uint32_t skip = 0;
+
+	memset(data + length, 0xFF, padded_size - length);
+	if (staged_written == 0)
+	{
+		memcpy(staged_first_word, data, FLASH_WORD_SIZE);
+		skip = FLASH_WORD_SIZE;
+	}
+	if (WriteFlash(APP_ADDRESS + staged_written + skip, data + skip,
+			padded_size - skip) != HAL_OK)
+		return HAL_ERROR;
+	image_crc = crc32_ieee(image_crc, data, padded_size);
+	staged_written += length;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef EraseForStagedImage(uint32_t image_size)
+{
+	uint32_t sectors = (image_size + APP_SECTOR_SIZE - 1) / APP_SECTOR_SIZE;
+
+	for (uint32_t i = 0; i < APP_SIZE / APP_SECTOR_SIZE; i++)
+	{
+		if ((i < sectors || !SectorBlank(i)) && EraseSingleSector(i) != HAL_OK)
+			return HAL_ERROR;
+	}
+	staged_written = 0;
+	image_crc = CRC32_INIT;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef CommitStagedImage(void)
+{
+	if (WriteFlash(APP_ADDRESS, staged_first_word, FLASH_WORD_SIZE) != HAL_OK)
+		return HAL_ERROR;
+	return HAL_OK;
+}
+
+static uint32_t FlashWordPadded(uint32_t size)
+{
+	return (size + FLASH_WORD_SIZE - 1) / FLASH_WORD_SIZE * FLASH_WORD_SIZE;
+}
+
+static HAL_StatusTypeDef WriteScratch(const uint8_t *data, uint32_t length)
+{
+	if (W25Q64_OSPI_EraseBlockStart(&hospi2, scratch_address, W25Q_SECTOR_SIZE)
+			!= HAL_OK || W25Q64_OSPI_AutoPollingMemReady(&hospi2) != HAL_OK
+			|| W25Q64_OSPI_Write(&hospi2, (uint8_t*) data, scratch_address,
+					length) != HAL_OK)
+		return HAL_ERROR;
+	scratch_address += W25Q_SECTOR_SIZE;
+	scratch_writes++;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef PatchOutput(uint8_t *data, uint32_t length)
+{
+	return Delta_Feed(data, length) == DELTA_OK ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef ReadDeltaHeader(const SFU_Header_t *header)
+{
+	static uint8_t iv[AES_IV_SIZE] __attribute__((aligned(4)));
+
+	memcpy(iv, header->iv, AES_IV_SIZE);
+	if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer, STAGING_PAYLOAD_OFFSET,
+			sizeof(SFU_DeltaHeader_t)) != HAL_OK
+			|| Crypto_DecryptFirmwareBlock(staged_enc_buffer,
+					(uint8_t*) &delta_header, sizeof(SFU_DeltaHeader_t), iv)
+					!= CRYPTO_OK)
+		return HAL_ERROR;
+	if (delta_header.magic != SFU_DELTA_MAGIC || delta_header.base_size == 0
+			|| delta_header.base_size % FLASH_WORD_SIZE != 0
+			|| delta_header.base_size > SFU_MAX_ORIGINAL_SIZE
+			|| delta_header.patch_size == 0)
+		return HAL_ERROR;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef CheckDeltaBase(void)
+{
+	Crypto_Reset();
+	if (Crypto_SHA256_Start() != CRYPTO_OK
+			|| Crypto_SHA256_Update(app(), delta_header.base_size) != CRYPTO_OK
+			|| Crypto_SHA256_Finish(delta_hash) != CRYPTO_OK)
+	{
+		Crypto_Reset();
+		return HAL_ERROR;
+	}
+	return memcmp(delta_hash, delta_header.base_sha256, 32) == 0 ?
+			HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef CheckScratch(const SFU_Header_t *header)
+{
+	if (HashStaged(STAGING_SCRATCH_OFFSET(header->firmware_size),
+			FlashWordPadded(header->original_size), delta_hash) != HAL_OK)
+		return HAL_ERROR;
+	return memcmp(delta_hash, delta_header.target_sha256, 32) == 0 ?
+			HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef RebuildDeltaImage(const SFU_Header_t *header)
+{
+	static uint8_t iv[AES_IV_SIZE] __attribute__((aligned(4)));
+	uint32_t size;
+
+	scratch_address = STAGING_SCRATCH_OFFSET(header->firmware_size);
+	Delta_Start(app(), delta_header.base_size, header->original_size,
+			WriteScratch);
+	Decompress_Start(delta_header.patch_size, PatchOutput);
+
+	memcpy(iv, header->iv, AES_IV_SIZE);
+	for (uint32_t offset = 0; offset < header->firmware_size; offset += size)
+	{
+		size = header->firmware_size - offset;
+		if (size > STAGED_CHUNK_SIZE)
+			size = STAGED_CHUNK_SIZE;
+		if (W25Q64_OSPI_Read(&hospi2, staged_enc_buffer,
+				STAGING_PAYLOAD_OFFSET + offset, size) != HAL_OK
+				|| Crypto_DecryptFirmwareBlock(staged_enc_buffer,
+						staged_dec_buffer, size, iv) != CRYPTO_OK)
+			return HAL_ERROR;
+
+		uint32_t skip = offset == 0 ? sizeof(SFU_DeltaHeader_t) : 0;
+
+		if (FeedCompressed(staged_dec_buffer + skip, size - skip,
+				offset + size == header->firmware_size) != HAL_OK)
+			return HAL_ERROR;
+	}
+	return Delta_Finish() == DELTA_OK ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef ProgramFromScratch(const SFU_Header_t *header)
+{
+	uint32_t scratch = STAGING_SCRATCH_OFFSET(header->firmware_size);
+	uint32_t padded_size = FlashWordPadded(header->original_size);
+	uint32_t size;
+
+	if (EraseForStagedImage(header->original_size) != HAL_OK)
+		return HAL_ERROR;
+	for (uint32_t offset = 0; offset < header->original_size; offset += size)
+	{
+		size = header->original_size - offset;
+		if (size > STAGED_CHUNK_SIZE)
+			size = STAGED_CHUNK_SIZE;
+		if (W25Q64_OSPI_Read(&hospi2, staged_dec_buffer, scratch + offset, size)
+				!= HAL_OK || ProgramStagedData(staged_dec_buffer, size) != HAL_OK)
+			return HAL_ERROR;
+	}
+
+	Crypto_Reset();
+	if (Crypto_SHA256_Start() != CRYPTO_OK
+			|| Crypto_SHA256_Update(staged_first_word, FLASH_WORD_SIZE) != CRYPTO_OK
+			|| (padded_size > FLASH_WORD_SIZE
+					&& Crypto_SHA256_Update(app() + FLASH_WORD_SIZE,
+							padded_size - FLASH_WORD_SIZE) != CRYPTO_OK)
+			|| Crypto_SHA256_Finish(delta_hash) != CRYPTO_OK)
+	{
+		Crypto_Reset();
+		return HAL_ERROR;
+	}
+	if (memcmp(delta_hash, delta_header.target_sha256, 32) != 0)
+		return HAL_ERROR;
+	return CommitStagedImage();
+}
+
+static HAL_StatusTypeDef InstallDelta(const SFU_Header_t *header,
+		uint8_t *committing)
+{
+	*committing = 0;
+	if (ReadDeltaHeader(header) != HAL_OK)
+		return HAL_ERROR;
+	if (Crypto_ECDSA_VerifyHash(delta_header.target_sha256,
+			delta_header.target_signature) != CRYPTO_OK)
+		return HAL_ERROR;
+	if (CheckScratch(header) != HAL_OK)
+	{
+		if (CheckDeltaBase() != HAL_OK || RebuildDeltaImage(header) != HAL_OK
+				|| CheckScratch(header) != HAL_OK)
+			return HAL_ERROR;
+	}
+	*committing = 1;
+	return ProgramFromScratch(header);
+}
+
+static HAL_StatusTypeDef InstallStagedFirmware(void)
+{
+	static staging_record_t record;
+	uint8_t committing;
+
+	if (staging_read_record(&hospi2, &record) != HAL_OK)
+		return HAL_ERROR;
+	if (VerifyStagedFirmware(&record.header) != HAL_OK)
+	{
+		staging_clear(&hospi2);
+		return HAL_ERROR;
+	}
+	if (record.header.magic != SFU_MAGIC_DELTA)
+		return HAL_ERROR;		// Not a delta: out of scope here
+	if (InstallDelta(&record.header, &committing) != HAL_OK)
+	{
+		if (!committing)
+			staging_clear(&hospi2);
+		return HAL_ERROR;
+	}
+	staging_clear(&hospi2);
+	return HAL_OK;
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static int failures;
+
+// Fresh W25Q with the .sfu staged, flash holding image
+static void power_on(const uint8_t *image, long size, int tamper)
+{
+	static staging_record_t record;
+
+	crypto_emu_reset(&crypto_emu_typical);
+	memcpy(app(), image, size);
+	memset(w25q, 0xFF, sizeof(w25q));
+	memcpy(w25q + STAGING_PAYLOAD_OFFSET, sfu_file + sizeof(SFU_Header_t),
+			sfu_size - sizeof(SFU_Header_t));
+	if (tamper)
+		w25q[STAGING_PAYLOAD_OFFSET + (sfu_size - sizeof(SFU_Header_t)) / 2] ^= 0x01;
+	memset(&record, 0, sizeof(record));
+	memcpy(&record.header, sfu_file, sizeof(SFU_Header_t));
+	staging_write_record(&hospi2, &record);
+	power_budget = -1;
+	powered = 1;
+	scratch_writes = flash_words = 0;
+}
+
+// Next boot: power back, flash and W25Q as they were left
+static void reset(void)
+{
+	power_budget = -1;
+	powered = 1;
+	Crypto_Reset();
+}
+
+static int staged(void)
+{
+	staging_record_t record;
+
+	return staging_read_record(&hospi2, &record) == HAL_OK;
+}
+
+static void expect(const char *what, int ok)
+{
+	printf("  %-44s %s\n", what, ok ? "OK" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+static int app_is(const uint8_t *image, long size)
+{
+	for (long i = size; i < APP_SIZE; i++)
+	{
+		if (app()[i] != 0xFF)
+			return 0;
+	}
+	return memcmp(app(), image, size) == 0;
+}
+
+// The CRC the validity record gets, accumulated while programming
+static int image_crc_is_flash(long size)
+{
+	return image_crc == crc32_ieee(CRC32_INIT, app(), FlashWordPadded(size));
+}
+
+static long load(const char *path, uint8_t *buf, long max)
+{
+	FILE *f = fopen(path, "rb");
+	long size;
+
+	if (!f)
+		return -1;
+	size = fread(buf, 1, max, f);
+	if (fgetc(f) != EOF)
+		size = -1;
+	fclose(f);
+	return size;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *sfu_path = NULL, *base_path = NULL, *target_path = NULL;
+	static uint8_t other[APP_SIZE];
+	crypto_emu_stats_t s;
+	SFU_Header_t header;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--sfu") == 0 && i + 1 < argc)
+			sfu_path = argv[++i];
+		else if (strcmp(argv[i], "--base") == 0 && i + 1 < argc)
+			base_path = argv[++i];
+		else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc)
+			target_path = argv[++i];
+		else
+			sfu_path = NULL, i = argc;
+	}
+	if (!sfu_path || !base_path || !target_path)
+	{
+		fprintf(stderr, "Usage: %s --sfu FILE --base FILE --target FILE\n",
+				argv[0]);
+		return 2;
+	}
+
+	sfu_size = load(sfu_path, sfu_file, sizeof(sfu_file));
+	base_size = load(base_path, base_image, sizeof(base_image));
+	target_size = load(target_path, target_image, sizeof(target_image));
+	memcpy(&header, sfu_file, sizeof(header));
+	if (sfu_size < (long) sizeof(SFU_Header_t) || base_size <= 0
+			|| target_size <= 0 || header.magic != SFU_MAGIC_DELTA
+			|| !staging_header_valid(&header)
+			|| header.firmware_size != sfu_size - sizeof(SFU_Header_t)
+			|| header.original_size != target_size)
+	{
+		fprintf(stderr, "%s: not a delta .sfu of %s\n", sfu_path, target_path);
+		return 2;
+	}
+	printf("delta %u bytes, target %ld bytes, base %ld bytes\n",
+			(unsigned) header.firmware_size, target_size, base_size);
+
+	printf("install\n");
+	power_on(base_image, base_size, 0);
+	expect("installed", InstallStagedFirmware() == HAL_OK);
+	expect("application is the target", app_is(target_image, target_size));
+	expect("image CRC is the flash's", image_crc_is_flash(target_size));
+	expect("record cleared", !staged());
+	crypto_emu_get_stats(&s);
+	expect("no emulator violations", s.violations == 0);
+	uint32_t total_scratch = scratch_writes, total_words = flash_words;
+	printf("  %u scratch sectors, %u flash words, %.1f ms (virtual clock)\n",
+			(unsigned) total_scratch, (unsigned) total_words,
+			crypto_emu_now_ns() / 1e6);
+
+	printf("wrong base\n");
+	memcpy(other, base_image, base_size);
+	other[base_size / 2] ^= 0x01;
+	power_on(other, base_size, 0);
+	expect("refused", InstallStagedFirmware() != HAL_OK);
+	expect("application untouched", app_is(other, base_size));
+	expect("record cleared", !staged());
+
+	printf("tampered\n");
+	power_on(base_image, base_size, 1);
+	expect("refused", InstallStagedFirmware() != HAL_OK);
+	expect("application untouched", app_is(base_image, base_size));
+	expect("record cleared", !staged());
+
+	printf("rebuild cut\n");
+	power_on(base_image, base_size, 0);
+	power_budget = total_scratch;		// half the sectors (erase + write)
+	expect("power lost", InstallStagedFirmware() != HAL_OK);
+	expect("application untouched", app_is(base_image, base_size));
+	reset();
+	expect("record kept", staged());
+	expect("installed after reset", InstallStagedFirmware() == HAL_OK);
+	expect("application is the target", app_is(target_image, target_size));
+	expect("record cleared", !staged());
+
+	printf("commit cut\n");
+	power_on(base_image, base_size, 0);
+	power_budget = 2 * total_scratch + APP_SIZE / APP_SECTOR_SIZE
+			+ total_words / 2;
+	expect("power lost", InstallStagedFirmware() != HAL_OK);
+	expect("application invalid (first word erased)",
+			memcmp(app(), "\xFF\xFF\xFF\xFF", 4) == 0);
+	reset();
+	expect("record kept", staged());
+	expect("installed after reset", InstallStagedFirmware() == HAL_OK);
+	expect("application is the target", app_is(target_image, target_size));
+	expect("image CRC is the flash's", image_crc_is_flash(target_size));
+	expect("record cleared", !staged());
+
+	printf("%s\n", failures ? "FAILED" : "all scenarios OK");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+#!/bin/sh
+# Make a delta .sfu of a firmware update with encrypt_firmware.py --base and
+# install it with delta_apply (normal, wrong base, tampered, power cuts).
+# Usage: Tools/delta_emulator/delta_roundtrip.sh [old.bin new.bin]
+# Without images, a synthetic pair stands in (the real LeShuffler.bin needs
+# the ARM toolchain): Thumb-like code with a pointer table, and the same
+# with 700 bytes inserted mid-code and the pointers past them moved. The key
+# template's AES key and a throwaway ECDSA key are used, never the real keys.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+if [ $# -eq 2 ]; then
+	BASE=$1
+	TARGET=$2
+else
+	BASE=$TMP/old.bin
+	TARGET=$TMP/new.bin
+	python3 - "$BASE" "$TARGET" <<'PY'
+import random, struct, sys
+random.seed(1)
+ops = [0x4770, 0xB580, 0x2000, 0x6803, 0xF000, 0xE7FE]
+code = b''.join(struct.pack('<H', random.choice(ops) if random.random() < 0.6
+                            else random.getrandbits(16)) for _ in range(100000))
+ptrs = [0x08020000 + random.randrange(len(code)) for _ in range(5000)]
+cut, new = 60000, bytes(random.getrandbits(8) for _ in range(700))
+moved = [p + len(new) if p - 0x08020000 >= cut else p for p in ptrs]
+open(sys.argv[1], 'wb').write(code + b''.join(struct.pack('<I', p) for p in ptrs))
+open(sys.argv[2], 'wb').write(code[:cut] + new + code[cut:]
+                              + b''.join(struct.pack('<I', p) for p in moved))
+PY
+	echo "Images: synthetic, $(wc -c < "$BASE") -> $(wc -c < "$TARGET") bytes"
+fi
+
+# Throwaway ECDSA key, the template's AES key, and a crypto_keys.h to match
+python3 "$ROOT/Tools/encrypt_firmware.py" --generate-keys "$TMP/keys.json" > /dev/null
+python3 - "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$TMP/keys.json" "$TMP/crypto_keys.h" <<'PY'
+import json, re, sys
+text = open(sys.argv[1]).read()
+body = re.search(r'AES_KEY\s*\[\s*32\s*\]\s*=\s*\{(.*?)\}', text, re.S).group(1)
+key = bytes(int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{2})', re.sub(r'/\*.*?\*/', '', body)))
+keys = json.load(open(sys.argv[2]))
+keys['aes_key'] = key.hex()
+json.dump(keys, open(sys.argv[2], 'w'))
+public = bytes.fromhex(keys['ecdsa_public_key'])
+rows = ',\n'.join('    ' + ', '.join('0x%02X' % b for b in public[i:i + 8]) for i in range(0, 64, 8))
+text = re.sub(r'(ECDSA_PUBLIC_KEY\s*\[\s*64\s*\]\s*=\s*\{).*?\}', lambda m: m.group(1) + '\n' + rows + ',\n}', text, flags=re.S)
+open(sys.argv[3], 'w').write(text)
+PY
+
+"$HERE/build.sh" "$TMP/delta_apply" "$TMP" > /dev/null
+
+python3 "$ROOT/Tools/encrypt_firmware.py" "$TARGET" "$TMP/full.sfu" \
+	--keys "$TMP/keys.json" --compress > /dev/null
+python3 "$ROOT/Tools/encrypt_firmware.py" "$TARGET" "$TMP/delta.sfu" \
+	--keys "$TMP/keys.json" --base "$BASE" > "$TMP/delta.log" || { cat "$TMP/delta.log"; exit 1; }
+grep -E "^(Base|Patch)" "$TMP/delta.log"
+echo "Full compressed .sfu: $(wc -c < "$TMP/full.sfu") bytes, delta .sfu: $(wc -c < "$TMP/delta.sfu") bytes"
+echo
+"$TMP/delta_apply" --sfu "$TMP/delta.sfu" --base "$BASE" --target "$TARGET"
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Build the comb-table ECDSA benchmark on Linux (gcc and python3)
+# Usage: Tools/ecdsa_bench/build.sh [output], from anywhere
+# The Q table is generated from the RFC 6979 A.2.5 test key, never crypto_keys.h.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT=${1:-$HERE/ecdsa_bench}
+GEN=$(mktemp -d)
+trap 'rm -rf "$GEN"' EXIT
+
+cat > "$GEN/crypto_keys.h" <<'KEY'
+static const uint8_t ECDSA_PUBLIC_KEY[64] = {
+    0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D, 0x31, 0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D, 0x68,
+    0xC0, 0x49, 0xB8, 0x92, 0x3B, 0x61, 0xFA, 0x6C, 0xE6, 0x69, 0x62, 0x2E, 0x60, 0xF2, 0x9F, 0xB6,
+    0x79, 0x03, 0xFE, 0x10, 0x08, 0xB8, 0xBC, 0x99, 0xA4, 0x1A, 0xE9, 0xE9, 0x56, 0x28, 0xBC, 0x64,
+    0xF2, 0xF1, 0xB2, 0x0C, 0x2D, 0x7E, 0x9F, 0x51, 0x77, 0xA3, 0xC2, 0x94, 0xD4, 0x46, 0x22, 0x99,
+};
+KEY
+python3 "$ROOT/Tools/ecdsa_comb_table.py" --keys-h "$GEN/crypto_keys.h" \
+  -o "$GEN/ecdsa_table.h" > /dev/null
+
+cd "$ROOT"
+gcc -std=gnu11 -O2 -Wall -Wextra \
+  -I"$GEN" -IuECC \
+  "$HERE/ecdsa_bench.c" uECC/ecdsa_comb.c uECC/ecdsa_comb_g.c uECC/uECC.c \
+  -o "$OUT"
+
+echo "$OUT"
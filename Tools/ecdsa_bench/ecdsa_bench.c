@@ -0,0 +1,285 @@
+/*
+ * ecdsa_bench: check and time uECC/ecdsa_comb.c against uECC_verify()
+ *
+ * Checks the generated tables (ecdsa_comb_g.c, and ecdsa_table.h made by
+ * build.sh from the RFC 6979 A.2.5 key) against ecdsa_comb_build(), then
+ * verifies the RFC 6979 signature and random keys and signatures with both
+ * paths, valid and corrupted; they must agree every time. Keys 1 and n - 1
+ * (Q = G, Q = -G) reach the doubling and infinity cases of the additions;
+ * uECC_verify() rejects every signature of these two (its G + Q is the
+ * doubling or infinity), so only the comb path is checked there. Then times
+ * both on the host. See build.sh.
+ *
+ * Usage: ecdsa_bench [--keys N] [--runs N]
+ *   --keys N   random keys, 8 signatures each (default 20)
+ *   --runs N   verifications timed per path (default 200)
+ */
+
+#include <ecdsa_comb.h>
+#include <ecdsa_table.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <uECC.h>
+
+static int failures;
+static int comb_only;		// uECC_verify() cannot handle the key
+
+static int rng(uint8_t *dest, unsigned size)
+{
+	while (size--)
+		*dest++ = rand();
+	return 1;
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void hex(uint8_t *out, const char *s)
+{
+	for (; *s; s += 2)
+		sscanf(s, "%2hhx", out++);
+}
+
+// Both paths must give the expected answer
+static void check(const char *what, const ecdsa_comb_point_t *table,
+		const uint8_t *key, const uint8_t *hash, const uint8_t *sig,
+		int expected)
+{
+	int generic = uECC_verify(key, hash, 32, sig, uECC_secp256r1());
+	int comb = ecdsa_comb_verify(table, hash, sig);
+
+	if ((!comb_only && generic != expected) || comb != expected)
+	{
+		if (failures++ < 10)
+			printf("FAILED %s: uECC %d, comb %d, expected %d\n", what, generic,
+					comb, expected);
+	}
+}
+
+// A signature and every one-bit corruption of hash, r and s
+static void check_signature(const char *what, const ecdsa_comb_point_t *table,
+		const uint8_t *key, const uint8_t *hash, const uint8_t *sig)
+{
+	uint8_t h[32], s[64];
+
+	check(what, table, key, hash, sig, 1);
+	for (int bit = 0; bit < 3 * 256; bit += 37)
+	{
+		memcpy(h, hash, 32);
+		memcpy(s, sig, 64);
+		if (bit < 256)
+			h[bit / 8] ^= 1 << (bit % 8);
+		else
+			s[(bit - 256) / 8] ^= 1 << (bit % 8);
+		check(what, table, key, h, s, 0);
+	}
+}
+
+static void check_tables(void)
+{
+	static ecdsa_comb_point_t table[ECDSA_COMB_POINTS];
+	uint8_t g[64];
+
+	uECC_vli_nativeToBytes(g, 32, uECC_curve_G(uECC_secp256r1()));
+	uECC_vli_nativeToBytes(g + 32, 32, uECC_curve_G(uECC_secp256r1()) + 8);
+	if (!ecdsa_comb_build(table, g)
+			|| memcmp(table, ecdsa_comb_g, sizeof(table)) != 0)
+	{
+		printf("FAILED ecdsa_comb_g.c differs from ecdsa_comb_build(G)\n");
+		failures++;
+	}
+	if (!ecdsa_comb_build(table, ECDSA_TABLE_KEY)
+			|| memcmp(table, ECDSA_Q_TABLE, sizeof(table)) != 0)
+	{
+		printf("FAILED generated ecdsa_table.h differs from ecdsa_comb_build()\n");
+		failures++;
+	}
+}
+
+// RFC 6979 A.2.5, P-256, SHA-256, message "sample"
+static void check_rfc6979(void)
+{
+	uint8_t hash[32], sig[64];
+
+	hex(hash,
+			"af2bdbe1aa9b6ec1e2ade1d694f41fc71a831d0268e9891562113d8a62add1bf");
+	hex(sig,
+			"efd48b2aacb6a8fd1140dd9cd45e81d69d2c877b56aaf991c34d0ea84eaf3716"
+			"f7cb1c942d657c41d436c7a1b6e29f65f3e900dbb9aff4064dc4ab2f843acda8");
+	check_signature("RFC 6979", ECDSA_Q_TABLE, ECDSA_TABLE_KEY, hash, sig);
+}
+
+// r or s out of [1, n - 1]
+static void check_range(const ecdsa_comb_point_t *table, const uint8_t *key,
+		const uint8_t *hash, const uint8_t *sig)
+{
+	uint8_t n[32], s[64];
+
+	uECC_vli_nativeToBytes(n, 32, uECC_curve_n(uECC_secp256r1()));
+	for (int i = 0; i < 4; i++)
+	{
+		memcpy(s, sig, 64);
+		if (i & 2)
+			memcpy(s + (i & 1) * 32, n, 32);
+		else
+			memset(s + (i & 1) * 32, 0, 32);
+		check("r, s range", table, key, hash, s, 0);
+	}
+}
+
+// A signature whose hash is r: u1 = u2, so with Q = G the first addition
+// of a Q entry meets the same G entry (the doubling case). For key n - 1,
+// s would be 0.
+static void sign_hash_r(const uint8_t *priv, uint8_t *hash, uint8_t *sig)
+{
+	const uECC_word_t *n = uECC_curve_n(uECC_secp256r1());
+	uECC_word_t k[8], d[8], r[8], s[8], t[8];
+	uint8_t kb[32], point[64];
+
+	do
+	{
+		rng(kb, 32);
+		uECC_vli_bytesToNative(k, kb, 32);
+	} while (uECC_vli_cmp(n, k, 8) != 1
+			|| !uECC_compute_public_key(kb, point, uECC_secp256r1()));
+
+	// r = x(kG) mod n, s = (r + r d) / k
+	uECC_vli_bytesToNative(r, point, 32);
+	if (uECC_vli_cmp(n, r, 8) != 1)
+		uECC_vli_sub(r, r, n, 8);
+	uECC_vli_bytesToNative(d, priv, 32);
+	uECC_vli_modMult(t, r, d, n, 8);
+	uECC_vli_modAdd(t, t, r, n, 8);
+	uECC_vli_modInv(k, k, n, 8);
+	uECC_vli_modMult(s, t, k, n, 8);
+	uECC_vli_nativeToBytes(hash, 32, r);
+	uECC_vli_nativeToBytes(sig, 32, r);
+	uECC_vli_nativeToBytes(sig + 32, 32, s);
+}
+
+// key NULL: the public key of priv
+static void check_key(const char *what, const uint8_t *priv,
+		const uint8_t *key, int signatures)
+{
+	static ecdsa_comb_point_t table[ECDSA_COMB_POINTS];
+	uint8_t public_key[64], hash[32], sig[64];
+
+	if (!key)
+	{
+		uECC_compute_public_key(priv, public_key, uECC_secp256r1());
+		key = public_key;
+	}
+	if (!ecdsa_comb_build(table, key))
+	{
+		printf("FAILED %s: key\n", what);
+		failures++;
+		return;
+	}
+	for (int i = 0; i < signatures; i++)
+	{
+		rng(hash, 32);
+		if (i == 0)
+			memset(hash, 0xFF, 32);		// above n: reduced
+		uECC_sign(priv, hash, 32, sig, uECC_secp256r1());
+		check_signature(what, table, key, hash, sig);
+		if (i == 1)
+			check_range(table, key, hash, sig);
+	}
+	if (comb_only && priv[31] == 1)
+	{
+		sign_hash_r(priv, hash, sig);
+		check(what, table, key, hash, sig, 1);
+	}
+}
+
+static void bench(int runs)
+{
+	uint8_t priv[32], key[64], hash[32], sig[64];
+	static ecdsa_comb_point_t table[ECDSA_COMB_POINTS];
+	volatile int ok = 0;
+
+	uECC_make_key(key, priv, uECC_secp256r1());
+	ecdsa_comb_build(table, key);
+	rng(hash, 32);
+	uECC_sign(priv, hash, 32, sig, uECC_secp256r1());
+
+	double t0 = now_us();
+	for (int i = 0; i < runs; i++)
+		ok += uECC_verify(key, hash, 32, sig, uECC_secp256r1());
+	double t1 = now_us();
+	for (int i = 0; i < runs; i++)
+		ok += ecdsa_comb_verify(table, hash, sig);
+	double t2 = now_us();
+
+	double generic = (t1 - t0) / runs, comb = (t2 - t1) / runs;
+
+	printf("\n%-14s %10s\n", "verify", "us (host)");
+	printf("%-14s %10.1f\n", "uECC_verify", generic);
+	printf("%-14s %10.1f  %.2fx faster\n", "comb tables", comb,
+			generic / comb);
+	printf("\ntables: G %u bytes (ecdsa_comb_g.c), Q %u bytes (ecdsa_table.h)\n",
+			(unsigned) sizeof(ecdsa_comb_g), (unsigned) sizeof(ECDSA_Q_TABLE));
+	if (ok != 2 * runs)
+		failures++;
+}
+
+int main(int argc, char *argv[])
+{
+	int keys = 20, runs = 200;
+	uint8_t priv[32], g[64];
+	uECC_word_t y[8];
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc)
+			keys = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+			runs = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "Usage: %s [--keys N] [--runs N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	srand(1);
+	uECC_set_rng(rng);
+
+	check_tables();
+	check_rfc6979();
+
+	// Q = G and Q = -G (uECC does not compute these public keys)
+	uECC_vli_nativeToBytes(g, 32, uECC_curve_G(uECC_secp256r1()));
+	uECC_vli_nativeToBytes(g + 32, 32, uECC_curve_G(uECC_secp256r1()) + 8);
+	memset(priv, 0, 32);
+	priv[31] = 1;
+	comb_only = 1;
+	check_key("key 1", priv, g, 64);
+	uECC_vli_sub(y, uECC_curve_p(uECC_secp256r1()),
+			uECC_curve_G(uECC_secp256r1()) + 8, 8);
+	uECC_vli_nativeToBytes(g + 32, 32, y);
+	uECC_vli_nativeToBytes(priv, 32, uECC_curve_n(uECC_secp256r1()));
+	priv[31] -= 1;
+	check_key("key n - 1", priv, g, 64);
+	comb_only = 0;
+
+	for (int i = 0; i < keys; i++)
+	{
+		uint8_t key[64];
+
+		uECC_make_key(key, priv, uECC_secp256r1());
+		check_key("random key", priv, key, 8);
+	}
+	printf("tables, RFC 6979, keys 1 and n - 1, %d random keys: %s\n", keys,
+			failures ? "FAILED" : "OK");
+
+	bench(runs);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+ecdsa_comb_table.py - Precomputed P-256 comb tables for signature verification
+
+Usage:
+    python ecdsa_comb_table.py                 # Q table from crypto_keys.h
+    python ecdsa_comb_table.py --generator     # G table (uECC/ecdsa_comb_g.c)
+
+The bootloader verifies u1*G + u2*Q with two fixed-base comb tables (see
+uECC/ecdsa_comb.h). The G table is part of the source tree. The Q table
+depends on ECDSA_PUBLIC_KEY, so it is generated next to crypto_keys.h as
+Bootloader_E/Core/Inc/ecdsa_table.h (gitignored like crypto_keys.h) each
+time the keys are pasted in. Without it, or if it was made for another key,
+the bootloader falls back to uECC_verify().
+"""
+
+import os
+import re
+import sys
+import argparse
+
+# Must match uECC/ecdsa_comb.h
+COMB_TEETH = 6
+COMB_SPACING = 43       # ceil(256 / COMB_TEETH)
+COMB_POINTS = (1 << COMB_TEETH) - 1
+
+# secp256r1
+P = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF
+B = 0x5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604B
+GX = 0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296
+GY = 0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+KEYS_H = os.path.join(SCRIPT_DIR, '..', 'Bootloader_E', 'Core', 'Inc', 'crypto_keys.h')
+TABLE_H = os.path.join(SCRIPT_DIR, '..', 'Bootloader_E', 'Core', 'Inc', 'ecdsa_table.h')
+G_TABLE_C = os.path.join(SCRIPT_DIR, '..', 'uECC', 'ecdsa_comb_g.c')
+
+
+def on_curve(pt):
+    x, y = pt
+    return (y * y - (x * x * x - 3 * x + B)) % P == 0
+
+
+def point_add(a, b):
+    """Affine addition, None is the point at infinity"""
+    if a is None:
+        return b
+    if b is None:
+        return a
+    if a[0] == b[0]:
+        if (a[1] + b[1]) % P == 0:
+            return None
+        lam = (3 * a[0] * a[0] - 3) * pow(2 * a[1], -1, P) % P
+    else:
+        lam = (b[1] - a[1]) * pow(b[0] - a[0], -1, P) % P
+    x = (lam * lam - a[0] - b[0]) % P
+    return (x, (lam * (a[0] - x) - a[1]) % P)
+
+
+def comb_table(pt):
+    """Entry j-1 = sum of 2^(i*COMB_SPACING) * pt over the bits i set in j"""
+    teeth = [pt]
+    for _ in range(COMB_TEETH - 1):
+        q = teeth[-1]
+        for _ in range(COMB_SPACING):
+            q = point_add(q, q)
+        teeth.append(q)
+
+    table = []
+    for j in range(1, COMB_POINTS + 1):
+        q = None
+        for i in range(COMB_TEETH):
+            if j & (1 << i):
+                q = point_add(q, teeth[i])
+        table.append(q)
+    return table
+
+
+def words(value):
+    """uECC native order: 8 32-bit words, least significant first"""
+    return [(value >> (32 * i)) & 0xFFFFFFFF for i in range(8)]
+
+
+def format_table(table, indent='\t'):
+    lines = []
+    for pt in table:
+        w = words(pt[0]) + words(pt[1])
+        lines.append(indent + '{ ' + ', '.join('0x%08X' % v for v in w[:8]) + ',')
+        lines.append(indent + '  ' + ', '.join('0x%08X' % v for v in w[8:]) + ' },')
+    return '\n'.join(lines)
+
+
+def read_public_key(path):
+    """ECDSA_PUBLIC_KEY[64] from crypto_keys.h: x || y, big-endian"""
+    with open(path, 'r') as f:
+        text = f.read()
+    m = re.search(r'ECDSA_PUBLIC_KEY\s*\[\s*64\s*\]\s*=\s*\{(.*?)\}', text, re.S)
+    if not m:
+        raise ValueError(f"ECDSA_PUBLIC_KEY[64] not found in {path}")
+    body = re.sub(r'/\*.*?\*/', '', m.group(1), flags=re.S)
+    key = bytes(int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{1,2})', body))
+    if len(key) != 64:
+        raise ValueError(f"ECDSA_PUBLIC_KEY has {len(key)} bytes, expected 64")
+    return key
+
+
+def write_q_table(key, output):
+    pt = (int.from_bytes(key[:32], 'big'), int.from_bytes(key[32:], 'big'))
+    if not on_curve(pt):
+        raise ValueError("ECDSA_PUBLIC_KEY is not a P-256 point (template placeholders?)")
+
+    key_lines = []
+    for i in range(0, 64, 8):
+        key_lines.append('    ' + ', '.join('0x%02X' % b for b in key[i:i + 8]) + ',')
+
+    with open(output, 'w', newline='\n') as f:
+        f.write('/*\n'
+                ' * ecdsa_table.h\n'
+                ' *\n'
+                ' * GENERATED by Tools/ecdsa_comb_table.py from crypto_keys.h - do not edit.\n'
+                ' * Comb table of ECDSA_PUBLIC_KEY for Crypto_ECDSA_VerifyHash(); keep it\n'
+                ' * LOCAL (gitignored) and regenerate it whenever the key changes.\n'
+                ' */\n\n'
+                '#ifndef INC_ECDSA_TABLE_H_\n'
+                '#define INC_ECDSA_TABLE_H_\n\n'
+                '#include "ecdsa_comb.h"\n\n'
+                '/* Public key the table was built for, checked against ECDSA_PUBLIC_KEY */\n'
+                'static const uint8_t ECDSA_TABLE_KEY[64] = {\n')
+        f.write('\n'.join(key_lines) + '\n};\n\n')
+        f.write('static const ecdsa_comb_point_t ECDSA_Q_TABLE[ECDSA_COMB_POINTS] = {\n')
+        f.write(format_table(comb_table(pt), '    ') + '\n};\n\n')
+        f.write('#endif /* INC_ECDSA_TABLE_H_ */\n')
+
+
+def write_g_table(output):
+    with open(output, 'w', newline='\n') as f:
+        f.write('/*\n'
+                ' * Comb table of the P-256 generator, see ecdsa_comb.h\n'
+                ' * GENERATED by Tools/ecdsa_comb_table.py --generator - do not edit\n'
+                ' */\n\n'
+                '#include <ecdsa_comb.h>\n\n'
+                'const ecdsa_comb_point_t ecdsa_comb_g[ECDSA_COMB_POINTS] =\n{\n')
+        f.write(format_table(comb_table((GX, GY))) + '\n};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Generate the P-256 comb tables used by the bootloader to verify signatures')
+    parser.add_argument('--generator', action='store_true',
+                        help='write the G table (uECC/ecdsa_comb_g.c) instead of the Q table')
+    parser.add_argument('--keys-h', metavar='FILE', default=KEYS_H,
+                        help='crypto_keys.h holding ECDSA_PUBLIC_KEY (default: Bootloader_E)')
+    parser.add_argument('-o', '--output', metavar='FILE',
+                        help='output file (default: ecdsa_table.h next to crypto_keys.h)')
+    args = parser.parse_args()
+
+    try:
+        if args.generator:
+            output = args.output or G_TABLE_C
+            write_g_table(output)
+        else:
+            output = args.output or TABLE_H
+            write_q_table(read_public_key(args.keys_h), output)
+    except (OSError, ValueError) as e:
+        print(f"ERROR: {e}")
+        sys.exit(1)
+
+    print(f"{COMB_POINTS} points ({COMB_POINTS * 64} bytes) -> {os.path.normpath(output)}")
+
+
+if __name__ == '__main__':
+    main()
@@ -3,11 +3,16 @@
 encrypt_firmware.py - Create encrypted .sfu firmware files for LeShuffler
 
 Usage:
-    python encrypt_firmware.py input.bin output.sfu [--keys keyfile.json]
+    python encrypt_firmware.py input.bin output.sfu [--keys keyfile.json] [--compress | --base old.bin]
     python encrypt_firmware.py --generate-keys keyfile.json
 
 This tool encrypts firmware with AES-256-CBC and signs with ECDSA-P256.
 The output .sfu file can be flashed via the encrypted bootloader (v3.0+).
+With --compress the firmware is LZ4-compressed before encryption (magic
+"LSFZ"); the bootloader decompresses it while programming (v3.2+).
+With --base the file is a patch of old.bin (magic "LSFD", see
+firmware_delta.py), installed only over that image by a staged update
+(v3.3+).
 """
 
 import sys
@@ -32,6 +37,11 @@ except ImportError:
 
 # Constants matching bootloader crypto.h
 SFU_MAGIC = 0x5546534C  # "LSFU" in little-endian
+SFU_MAGIC_LZ4 = 0x5A46534C  # "LSFZ": LZ4-compressed payload
+SFU_LZ4_WINDOW = 16384  # Largest match offset (Staging/sfu.h)
+SFU_MAGIC_DELTA = 0x4446534C  # "LSFD": patch of the installed image
+SFU_DELTA_MAGIC = 0x4844534C  # "LSDH": SFU_DeltaHeader_t
+FLASH_WORD_SIZE = 32  # Delta hashes cover images padded to flash words
 AES_KEY_SIZE = 32
 AES_IV_SIZE = 16
 AES_BLOCK_SIZE = 16
@@ -88,6 +98,111 @@ def pkcs7_pad(data, block_size=AES_BLOCK_SIZE):
     return data + bytes([padding_len] * padding_len)
 
 
+# LZ4 block format, as decoded by Bootloader_E/Core/Src/decompress.c
+LZ4_MIN_MATCH = 4
+LZ4_LAST_LITERALS = 5   # The last 5 bytes are always literals
+LZ4_MFLIMIT = 12        # No match starts in the last 12 bytes
+LZ4_CHAIN = 64          # Candidates tried per position
+
+
+def lz4_compress(data, window=SFU_LZ4_WINDOW):
+    """LZ4 block, hash chains over 4-byte prefixes, offsets up to window"""
+    n = len(data)
+    out = bytearray()
+    chains = {}
+    limit = n - LZ4_MFLIMIT
+
+    def emit(lit_start, lit_end, offset=0, match_len=0):
+        lit_len = lit_end - lit_start
+        ml = match_len - LZ4_MIN_MATCH if offset else 0
+        out.append((min(lit_len, 15) << 4) | min(ml, 15))
+        if lit_len >= 15:
+            rest = lit_len - 15
+            while rest >= 255:
+                out.append(255)
+                rest -= 255
+            out.append(rest)
+        out.extend(data[lit_start:lit_end])
+        if offset:
+            out.extend(struct.pack('<H', offset))
+            if ml >= 15:
+                rest = ml - 15
+                while rest >= 255:
+                    out.append(255)
+                    rest -= 255
+                out.append(rest)
+
+    i = anchor = 0
+    while i < limit:
+        key = data[i:i + 4]
+        candidates = chains.setdefault(key, [])
+        best_len = best_offset = 0
+        max_len = n - LZ4_LAST_LITERALS - i
+        for p in reversed(candidates[-LZ4_CHAIN:]):
+            offset = i - p
+            if offset > window:
+                break
+            # Only a longer match helps: check its last byte first
+            if best_len and data[p + best_len] != data[i + best_len]:
+                continue
+            length = LZ4_MIN_MATCH
+            while length < max_len and data[p + length] == data[i + length]:
+                length += 1
+            if length > best_len:
+                best_len, best_offset = length, offset
+                if length >= max_len:
+                    break
+        candidates.append(i)
+
+        if best_len >= LZ4_MIN_MATCH:
+            emit(anchor, i, best_offset, best_len)
+            end = i + best_len
+            for j in range(i + 1, min(end, limit)):
+                chains.setdefault(data[j:j + 4], []).append(j)
+            i = anchor = end
+        else:
+            i += 1
+
+    emit(anchor, n)
+    return bytes(out)
+
+
+def lz4_decompress(src, size):
+    """Reference decoder, to check the compressor's output"""
+    out = bytearray()
+    i = 0
+    while True:
+        token = src[i]
+        i += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                i += 1
+                lit_len += src[i - 1]
+                if src[i - 1] != 255:
+                    break
+        out += src[i:i + lit_len]
+        i += lit_len
+        if len(out) >= size:
+            break
+        offset = src[i] | (src[i + 1] << 8)
+        i += 2
+        match_len = token & 15
+        if match_len == 15:
+            while True:
+                i += 1
+                match_len += src[i - 1]
+                if src[i - 1] != 255:
+                    break
+        if offset == 0 or offset > min(len(out), SFU_LZ4_WINDOW):
+            raise ValueError("LZ4: bad offset")
+        for _ in range(match_len + LZ4_MIN_MATCH):
+            out.append(out[-offset])
+    if i != len(src) or len(out) != size:
+        raise ValueError("LZ4: stream does not end with the image")
+    return bytes(out)
+
+
 def generate_keys(output_file):
     """Generate new AES and ECDSA key pair"""
     import secrets
@@ -177,7 +292,36 @@ def sign_data(data, private_key_bytes):
     return signature_raw
 
 
-def encrypt_firmware(input_file, output_file, keys):
+def flash_padded(image):
+    """Image as programmed: 0xFF up to a whole flash word"""
+    return image + b'\xFF' * (-len(image) % FLASH_WORD_SIZE)
+
+
+def delta_payload(base, firmware, keys):
+    """SFU_DeltaHeader_t + LZ4 patch, see Staging/sfu.h"""
+    from firmware_delta import make_patch, apply_patch
+
+    base = flash_padded(base)
+    patch = make_patch(base, firmware)
+    if apply_patch(base, patch, len(firmware)) != firmware:
+        raise ValueError("patch round trip failed")
+    compressed = lz4_compress(patch)
+    if lz4_decompress(compressed, len(patch)) != patch:
+        raise ValueError("LZ4 round trip failed")
+
+    target = flash_padded(firmware)
+    header = struct.pack('<II', SFU_DELTA_MAGIC, len(base))
+    header += hashlib.sha256(base).digest() + hashlib.sha256(target).digest()
+    header += sign_data(target, keys['ecdsa_private_key'])
+    header += struct.pack('<II', len(patch), 0)
+
+    print(f"Base size: {len(base)} bytes (padded), SHA-256 {hashlib.sha256(base).hexdigest()[:16]}...")
+    print(f"Patch size: {len(patch)} bytes, {len(compressed)} compressed "
+          f"({100.0 * len(compressed) / len(firmware):.1f}% of the firmware)")
+    return header + compressed
+
+
+def encrypt_firmware(input_file, output_file, keys, compress=False, base_file=None):
     """Encrypt firmware and create .sfu file"""
 
     # Get firmware version from version.h
@@ -192,8 +336,23 @@ def encrypt_firmware(input_file, output_file, keys):
     print(f"Input firmware: {input_file}")
     print(f"Original size: {original_size} bytes")
 
+    # Compress (bootloader v3.2+), checked against the reference decoder
+    payload = firmware
+    magic = SFU_MAGIC
+    if base_file:
+        with open(base_file, 'rb') as f:
+            payload = delta_payload(f.read(), firmware, keys)
+        magic = SFU_MAGIC_DELTA
+    elif compress:
+        payload = lz4_compress(firmware)
+        if lz4_decompress(payload, original_size) != firmware:
+            raise ValueError("LZ4 round trip failed")
+        magic = SFU_MAGIC_LZ4
+        print(f"Compressed size: {len(payload)} bytes "
+              f"({100.0 * len(payload) / original_size:.1f}%, LZ4, {SFU_LZ4_WINDOW // 1024} KB window)")
+
     # Pad firmware to AES block size
-    padded_firmware = pkcs7_pad(firmware)
+    padded_firmware = pkcs7_pad(payload)
     encrypted_size = len(padded_firmware)
     print(f"Padded size: {encrypted_size} bytes")
 
@@ -215,7 +374,7 @@ def encrypt_firmware(input_file, output_file, keys):
     # Build SFU header (without CRC first)
     # struct: magic(4) + version(4) + firmware_size(4) + original_size(4) + iv(16) + signature(64) + crc(4)
     header_without_crc = struct.pack('<IIII',
-        SFU_MAGIC,
+        magic,
         fw_version,  # Firmware version from version.h
         encrypted_size,
         original_size
@@ -256,6 +415,12 @@ Examples:
   Encrypt firmware with generated keys:
     python encrypt_firmware.py LeShuffler.bin LeShuffler.sfu --keys keys.json
 
+  Compressed image (bootloader v3.2+):
+    python encrypt_firmware.py LeShuffler.bin LeShuffler.sfu --keys keys.json --compress
+
+  Delta of the installed firmware (staged update only, bootloader v3.3+):
+    python encrypt_firmware.py LeShuffler.bin LeShuffler.sfu --keys keys.json --base old.bin
+
   Encrypt firmware with default test keys:
     python encrypt_firmware.py LeShuffler.bin LeShuffler.sfu
 """
@@ -265,6 +430,10 @@ Examples:
                         help='Generate new key pair and save to FILE')
     parser.add_argument('--keys', metavar='FILE',
                         help='Load keys from FILE (JSON format)')
+    parser.add_argument('--compress', action='store_true',
+                        help='LZ4-compress the firmware (bootloader v3.2+)')
+    parser.add_argument('--base', metavar='FILE',
+                        help='make a patch of the installed firmware FILE (staged update, v3.3+)')
     parser.add_argument('input', nargs='?', help='Input .bin firmware file')
     parser.add_argument('output', nargs='?', help='Output .sfu encrypted file')
 
@@ -284,6 +453,13 @@ Examples:
         print(f"ERROR: Input file not found: {args.input}")
         return 1
 
+    if args.base and args.compress:
+        print("ERROR: --base images are always compressed, drop --compress")
+        return 1
+    if args.base and not os.path.exists(args.base):
+        print(f"ERROR: Base file not found: {args.base}")
+        return 1
+
     # Load keys
     if args.keys:
         if not os.path.exists(args.keys):
@@ -307,7 +483,7 @@ Examples:
 
     # Encrypt firmware
     try:
-        encrypt_firmware(args.input, args.output, keys)
+        encrypt_firmware(args.input, args.output, keys, args.compress, args.base)
         return 0
     except Exception as e:
         print(f"ERROR: {e}")
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""
+firmware_delta.py - Patches between two firmware images for delta .sfu files
+
+Usage:
+    python firmware_delta.py OLD.bin NEW.bin      # patch size and check only
+
+encrypt_firmware.py --base OLD.bin builds the delta .sfu with make_patch();
+the bootloader applies it with Bootloader_E/Core/Src/delta.c. The patch
+format is described in Staging/sfu.h: records of add_len, insert_len, seek
+(little-endian, 12 bytes), then add_len bytes added to the base, then
+insert_len new bytes.
+
+Matching is bsdiff-like: a region starts at an exact match (8-byte hash
+index of the base, or the offset of the previous region) and is extended
+forward and backward while most bytes still agree. Code that moved keeps
+its bytes, and pointers into moved code differ by small amounts; both give
+an add stream of mostly zeros, which LZ4 then compresses.
+"""
+
+import sys
+import struct
+import argparse
+
+RECORD_SIZE = 12            # SFU_DELTA_RECORD_SIZE
+KEY_SIZE = 8                # Bytes hashed by the base index
+MIN_MATCH = 12              # Exact bytes needed to start a region
+INDEX_DEPTH = 8             # Base positions kept per key (most recent)
+EXTEND_LOOKAHEAD = 64       # Extension stops this far past its best score
+
+
+def build_index(base):
+    index = {}
+    for i in range(len(base) - KEY_SIZE + 1):
+        positions = index.setdefault(base[i:i + KEY_SIZE], [])
+        if len(positions) == INDEX_DEPTH:
+            positions.pop(0)
+        positions.append(i)
+    return index
+
+
+def common_length(a, ai, b, bi):
+    """Length of the common prefix of a[ai:] and b[bi:]"""
+    limit = min(len(a) - ai, len(b) - bi)
+    n = 0
+    step = 64
+    while n < limit:
+        step = min(step, limit - n)
+        if a[ai + n:ai + n + step] == b[bi + n:bi + n + step]:
+            n += step
+            continue
+        if step == 1:
+            break
+        step //= 2
+    return n
+
+
+def extend_forward(base, target, t, b, limit):
+    """Bytes past t (at most limit - t) worth patching against b: best 2*matches - length"""
+    best, best_score, score = 0, 0, 0
+    i = 0
+    while t + i < limit and b + i < len(base) and i - best < EXTEND_LOOKAHEAD:
+        score += 1 if target[t + i] == base[b + i] else -1
+        i += 1
+        if score > best_score:
+            best, best_score = i, score
+    return best
+
+
+def extend_backward(base, target, t, b, floor):
+    """Same as extend_forward, going down from t (not below floor) and b"""
+    best, best_score, score = 0, 0, 0
+    i = 0
+    while t - i > floor and b - i > 0 and i - best < EXTEND_LOOKAHEAD:
+        score += 1 if target[t - i - 1] == base[b - i - 1] else -1
+        i += 1
+        if score > best_score:
+            best, best_score = i, score
+    return best
+
+
+def find_regions(base, target):
+    """(target_start, base_start, length) regions, in target order, not overlapping"""
+    index = build_index(base)
+    regions = []
+    t = 0
+    offset = 0              # base - target of the last region
+    done = 0                # End of the last region in the target
+    while t + KEY_SIZE <= len(target):
+        candidates = [t + offset] + index.get(target[t:t + KEY_SIZE], [])
+        best_b, best_len = None, 0
+        for b in candidates:
+            if 0 <= b < len(base):
+                n = common_length(target, t, base, b)
+                if n > best_len:
+                    best_b, best_len = b, n
+        if best_len < MIN_MATCH:
+            t += 1
+            continue
+
+        back = extend_backward(base, target, t, best_b, done)
+        start, b = t - back, best_b - back
+        end = t + best_len
+        end += extend_forward(base, target, end, best_b + best_len, len(target))
+        regions.append((start, b, end - start))
+        offset = b - start
+        done = t = end
+    return regions
+
+
+def make_patch(base, target):
+    """Patch turning base into target"""
+    regions = find_regions(base, target)
+    patch = bytearray()
+
+    def record(add_from, add_len, t, insert_end, seek):
+        diff = bytes((target[t + i] - base[add_from + i]) & 0xFF for i in range(add_len))
+        patch.extend(struct.pack('<IIi', add_len, insert_end - t - add_len, seek))
+        patch.extend(diff)
+        patch.extend(target[t + add_len:insert_end])
+
+    # The base position starts at 0: a first record moves it to the first region
+    if not regions or regions[0][0] > 0 or regions[0][1] > 0:
+        first_t = regions[0][0] if regions else len(target)
+        first_b = regions[0][1] if regions else 0
+        record(0, 0, 0, first_t, first_b)
+
+    for k, (t, b, length) in enumerate(regions):
+        if k + 1 < len(regions):
+            insert_end, seek = regions[k + 1][0], regions[k + 1][1] - (b + length)
+        else:
+            insert_end, seek = len(target), 0
+        record(b, length, t, insert_end, seek)
+
+    return bytes(patch)
+
+
+def apply_patch(base, patch, target_size):
+    """Reference decoder, with the checks of delta.c"""
+    out = bytearray()
+    pos = 0
+    i = 0
+    while i < len(patch):
+        if len(patch) - i < RECORD_SIZE:
+            raise ValueError("truncated record")
+        add_len, insert_len, seek = struct.unpack_from('<IIi', patch, i)
+        i += RECORD_SIZE
+        if (add_len + insert_len > target_size - len(out)
+                or add_len > len(base) - pos
+                or add_len + insert_len > len(patch) - i):
+            raise ValueError("record out of range")
+        out.extend((base[pos + j] + patch[i + j]) & 0xFF for j in range(add_len))
+        pos += add_len
+        i += add_len
+        out.extend(patch[i:i + insert_len])
+        i += insert_len
+        pos += seek
+        if not 0 <= pos <= len(base):
+            raise ValueError("seek out of range")
+    if len(out) != target_size:
+        raise ValueError("patch ends early")
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Size of the patch between two firmware images (see encrypt_firmware.py --base)')
+    parser.add_argument('base', help='installed firmware .bin')
+    parser.add_argument('target', help='new firmware .bin')
+    args = parser.parse_args()
+
+    with open(args.base, 'rb') as f:
+        base = f.read()
+    with open(args.target, 'rb') as f:
+        target = f.read()
+
+    patch = make_patch(base, target)
+    if apply_patch(base, patch, len(target)) != target:
+        print("ERROR: patch round trip failed")
+        sys.exit(1)
+
+    regions = find_regions(base, target)
+    patched = sum(r[2] for r in regions)
+    print(f"{len(regions)} regions, {patched} of {len(target)} bytes patched, "
+          f"{len(target) - patched} inserted")
+    print(f"Patch: {len(patch)} bytes (before LZ4)")
+
+
+if __name__ == '__main__':
+    main()
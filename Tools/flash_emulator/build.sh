@@ -0,0 +1,21 @@
+#!/bin/sh
+# Build the W25Q flash emulator benchmark on Linux (gcc, no other dependency)
+# Usage: Tools/flash_emulator/build.sh [output], from anywhere
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT=${1:-$HERE/flash_bench}
+
+cd "$ROOT"
+# __ASM: the CMSIS core functions hold ARM instructions, never called here
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+gcc -std=gnu11 -O2 -Wall -Wextra \
+  -DSTM32H733xx -DUSE_HAL_DRIVER '-D__ASM=if (1) {} else __asm__' \
+  -I"$HERE" -ICore/Inc -IW25Q64 \
+  -isystem Drivers/CMSIS/Device/ST/STM32H7xx/Include -isystem Drivers/CMSIS/Include \
+  -isystem Drivers/STM32H7xx_HAL_Driver/Inc \
+  "$HERE/flash_bench.c" "$HERE/w25q_emu.c" W25Q64/W25Q64.c \
+  -o "$OUT"
+
+echo "$OUT"
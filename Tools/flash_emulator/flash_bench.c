@@ -0,0 +1,230 @@
+/*
+ * flash_bench: run W25Q64/W25Q64.c on the emulated W25Q flash
+ *
+ * Checks that W25Q64_OSPI_Write() and W25Q64_OSPI_WriteStart() store what
+ * they are given at any address and size, then times an image upload
+ * (DATA packets of the image utility, written one after the other) and
+ * the erase of an image region on the virtual clock. See build.sh.
+ *
+ * Usage: flash_bench [--mb N] [--offset A] [--usb-us US] [--cpu-mhz MHZ]
+ *                    [--tpp-us US]
+ *   --mb N        upload size in MB (default 1)
+ *   --offset A    upload address (default 0x1000, the first asset)
+ *   --usb-us US   time to receive the next packet (default 100)
+ *   --cpu-mhz MHZ CPU clock for the legacy page search loop (default 64)
+ *   --tpp-us US   page program time (default 400, datasheet typical)
+ */
+
+#include <main.h>
+#include <octospi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <W25Q64.h>
+
+#include "w25q_emu.h"
+
+#define PACKET_PAYLOAD	2041	// DATA_PAYLOAD_SIZE of image_utility.c
+#define LOOP_CYCLES		4		// per iteration of the legacy page search
+
+static w25q_emu_timing_t timing;
+static double cpu_mhz = 64;
+static double usb_us = 100;
+static uint32_t upload_offset = 0x1000;
+
+/* W25Q64_OSPI_Write() before the page program engine, for comparison.
+ * Same OSPI sequence; the page search loop from address 0 costs CPU time
+ * on the target, charged here at LOOP_CYCLES per iteration. */
+static HAL_StatusTypeDef legacy_write(OSPI_HandleTypeDef *hospi,
+		uint8_t *pData, uint32_t WriteAddr, uint32_t Size)
+{
+	OSPI_RegularCmdTypeDef sCommand = { 0 };
+	uint32_t end_addr, current_size, current_addr = 0;
+
+	while (current_addr <= WriteAddr)
+		current_addr += W25Q_PAGE_SIZE;
+	w25q_emu_cpu(current_addr / W25Q_PAGE_SIZE * LOOP_CYCLES * 1000 / cpu_mhz);
+	current_size = current_addr - WriteAddr;
+	if (current_size > Size)
+		current_size = Size;
+	current_addr = WriteAddr;
+	end_addr = WriteAddr + Size;
+
+	do
+	{
+		sCommand.OperationType = HAL_OSPI_OPTYPE_COMMON_CFG;
+		sCommand.FlashId = HAL_OSPI_FLASH_ID_1;
+		sCommand.InstructionMode = HAL_OSPI_INSTRUCTION_1_LINE;
+		sCommand.InstructionSize = HAL_OSPI_INSTRUCTION_8_BITS;
+		sCommand.AddressSize = HAL_OSPI_ADDRESS_24_BITS;
+		sCommand.Instruction = W25Q_PAGE_PROGRAM_QUAD_INP_CMD;
+		sCommand.AddressMode = HAL_OSPI_ADDRESS_1_LINE;
+		sCommand.Address = current_addr;
+		sCommand.DataMode = HAL_OSPI_DATA_4_LINES;
+		sCommand.NbData = current_size;
+
+		if (current_size == 0)
+			return HAL_OK;
+		if (W25Q64_OSPI_WriteEnable(hospi) != HAL_OK
+				|| HAL_OSPI_Command(hospi, &sCommand,
+				HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK
+				|| HAL_OSPI_Transmit(hospi, pData,
+				HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK
+				|| W25Q64_OSPI_AutoPollingMemReady(hospi) != HAL_OK)
+			return HAL_ERROR;
+
+		current_addr += current_size;
+		pData += current_size;
+		current_size = ((current_addr + W25Q_PAGE_SIZE) > end_addr) ?
+				(end_addr - current_addr) : W25Q_PAGE_SIZE;
+	} while (current_addr <= end_addr);
+
+	return HAL_OK;
+}
+
+typedef HAL_StatusTypeDef (*write_fn)(OSPI_HandleTypeDef*, uint8_t*, uint32_t,
+		uint32_t);
+
+// Random writes of random sizes into erased flash, compared with a reference
+static int check_writes(const char *name, write_fn write)
+{
+	static uint8_t ref[0x40000];
+	uint8_t data[3000];
+	w25q_emu_stats_t s;
+	uint32_t address = 0;
+
+	w25q_emu_reset(&timing);
+	memset(ref, 0xFF, sizeof(ref));
+	srand(1);
+
+	while (1)
+	{
+		uint32_t size = 1 + rand() % sizeof(data);
+
+		address += rand() % 300;
+		if (address + size > sizeof(ref))
+			break;
+		for (uint32_t i = 0; i < size; i++)
+			data[i] = rand();
+		memcpy(ref + address, data, size);
+
+		if (write(&hospi2, data, address, size) != HAL_OK)
+		{
+			printf("%-22s write error at %#lx\n", name, (unsigned long) address);
+			return 1;
+		}
+		// Data may be reused as soon as WriteStart returns
+		memset(data, 0, size);
+		address += size;
+	}
+	if (W25Q64_OSPI_WaitWrite(&hospi2) != HAL_OK)
+		return 1;
+
+	w25q_emu_get_stats(&s);
+	if (memcmp(ref, w25q_emu_memory(), sizeof(ref)) != 0 || s.violations)
+	{
+		printf("%-22s FAILED (%u violations)\n", name, s.violations);
+		return 1;
+	}
+	printf("%-22s OK, %u pages\n", name, s.pages);
+	return 0;
+}
+
+// Image upload: receive a packet, program it, next
+static void upload(const char *name, write_fn write, uint32_t total)
+{
+	static uint8_t packet[PACKET_PAYLOAD];
+	w25q_emu_stats_t s;
+	uint32_t n_packets = 0;
+	double start;
+
+	w25q_emu_reset(&timing);
+	for (uint32_t i = 0; i < sizeof(packet); i++)
+		packet[i] = i * 7;
+	start = w25q_emu_now_ns();
+
+	for (uint32_t offset = 0; offset < total; offset += PACKET_PAYLOAD)
+	{
+		uint32_t size = total - offset < PACKET_PAYLOAD ?
+				total - offset : PACKET_PAYLOAD;
+
+		w25q_emu_cpu(usb_us * 1000);
+		if (write(&hospi2, packet, upload_offset + offset, size) != HAL_OK)
+		{
+			printf("%-22s write error\n", name);
+			return;
+		}
+		n_packets++;
+	}
+	W25Q64_OSPI_WaitWrite(&hospi2);
+
+	w25q_emu_get_stats(&s);
+	double ms = (w25q_emu_now_ns() - start) / 1e6;
+	printf("%-22s %9.1f %9.0f %8.2f %8.1f %9.1f %5u\n", name,
+			ms * 1000 / n_packets, total / ms, (double) s.commands / s.pages,
+			(double) s.polls / s.pages, s.bus_ns / 1e6, s.violations);
+}
+
+static void erase(const char *name, int range, uint32_t total)
+{
+	w25q_emu_stats_t s;
+
+	w25q_emu_reset(&timing);
+	if ((range ?
+			W25Q64_OSPI_EraseRange(&hospi2, upload_offset,
+			upload_offset + total) :
+			W25Q64_OSPI_EraseSector(&hospi2, upload_offset,
+			upload_offset + total - 1)) != HAL_OK)
+		printf("%-22s erase error\n", name);
+	w25q_emu_get_stats(&s);
+	printf("%-22s %9.1f ms, %u erase commands, %u violations\n", name,
+			w25q_emu_now_ns() / 1e6, s.erases, s.violations);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t total = 1 << 20;
+	int failed = 0;
+
+	timing = w25q_emu_typical;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--mb") == 0 && i + 1 < argc)
+			total = atof(argv[++i]) * (1 << 20);
+		else if (strcmp(argv[i], "--offset") == 0 && i + 1 < argc)
+			upload_offset = strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "--usb-us") == 0 && i + 1 < argc)
+			usb_us = atof(argv[++i]);
+		else if (strcmp(argv[i], "--cpu-mhz") == 0 && i + 1 < argc)
+			cpu_mhz = atof(argv[++i]);
+		else if (strcmp(argv[i], "--tpp-us") == 0 && i + 1 < argc)
+			timing.tpp_us = atof(argv[++i]);
+		else
+		{
+			fprintf(stderr,
+					"usage: %s [--mb N] [--offset A] [--usb-us US] [--cpu-mhz MHZ] "
+							"[--tpp-us US]\n",
+					argv[0]);
+			return 2;
+		}
+	}
+
+	printf("OSPI %.0f MHz, tPP %.0f us, next packet %.0f us, upload at %#lx\n\n",
+			timing.bus_mhz, timing.tpp_us, usb_us, (unsigned long) upload_offset);
+
+	failed += check_writes("legacy write", legacy_write);
+	failed += check_writes("W25Q64_OSPI_Write", W25Q64_OSPI_Write);
+	failed += check_writes("W25Q64_OSPI_WriteStart", W25Q64_OSPI_WriteStart);
+
+	printf("\n%-22s %9s %9s %8s %8s %9s %5s\n", "upload", "us/packet", "kB/s",
+			"cmd/page", "poll/pg", "bus ms", "viol");
+	upload("legacy write", legacy_write, total);
+	upload("W25Q64_OSPI_Write", W25Q64_OSPI_Write, total);
+	upload("W25Q64_OSPI_WriteStart", W25Q64_OSPI_WriteStart, total);
+
+	printf("\n");
+	erase("EraseSector (4 KB)", 0, total);
+	erase("EraseRange (64 KB)", 1, total);
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,414 @@
+/*
+ * W25Q flash behind OCTOSPI2, emulated on Linux (host only), see w25q_emu.h
+ *
+ * Replaces the HAL OSPI driver and Core/Src/octospi.c for W25Q64/W25Q64.c.
+ * Only what the W25Q64 driver uses is modelled: single / quad SPI phases,
+ * indirect write and read, auto-polling of status register 1.
+ */
+
+#include <iwdg.h>
+#include <main.h>
+#include <octospi.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <W25Q64.h>
+
+#include "w25q_emu.h"
+
+#define EMU_SIZE		W25Q_FLASH_SIZE
+#define EMU_ADDR_MASK	0xFFFFFF	// 24 bit addressing, as configured
+#define EMU_SR1_BUSY	0x01
+#define EMU_SR1_WEL		0x02
+#define EMU_TRST_US		30
+
+const w25q_emu_timing_t w25q_emu_typical =
+{
+	// OSPI on D1HCLK (64 MHz, prescaler 1), W25Q256JV datasheet typicals
+	.bus_mhz = 64, .call_ns = 1000, .tick_ns = 100, .tpp_us = 400, .tse_us =
+			45000, .tbe32_us = 120000, .tbe64_us = 150000, .tce_us = 80e6 };
+
+OSPI_HandleTypeDef hospi2;
+
+static w25q_emu_timing_t t;
+static w25q_emu_stats_t stats;
+static uint8_t *mem;
+static double now;				// virtual clock, ns
+static double busy_until;		// end of the running program / erase
+static bool wel;
+static bool reset_enabled;
+static OSPI_RegularCmdTypeDef cmd;	// waiting for its data phase
+static bool cmd_pending;
+static double irq_at;			// status match of HAL_OSPI_AutoPolling_IT
+static bool irq_armed;
+
+static uint8_t lines(uint32_t mode, uint32_t pos)
+{
+	uint8_t m = (mode >> pos) & 7;
+
+	return m == 3 ? 4 : m == 4 ? 8 : m;
+}
+
+static double cycles_ns(double cycles)
+{
+	return cycles * 1000 / t.bus_mhz;
+}
+
+// Bus time of the instruction, address and dummy phases, then n data bytes
+static double phase_ns(const OSPI_RegularCmdTypeDef *c, uint32_t n)
+{
+	double cycles = 0;
+
+	if (c->InstructionMode != HAL_OSPI_INSTRUCTION_NONE)
+		cycles += 8.0 / lines(c->InstructionMode, OCTOSPI_CCR_IMODE_Pos);
+	if (c->AddressMode != HAL_OSPI_ADDRESS_NONE)
+		cycles += 24.0 / lines(c->AddressMode, OCTOSPI_CCR_ADMODE_Pos);
+	cycles += c->DummyCycles;
+	if (c->DataMode != HAL_OSPI_DATA_NONE)
+		cycles += 8.0 * n / lines(c->DataMode, OCTOSPI_CCR_DMODE_Pos);
+
+	return cycles_ns(cycles);
+}
+
+static void bus(double ns)
+{
+	now += ns;
+	stats.bus_ns += ns;
+}
+
+static bool busy(void)
+{
+	return now < busy_until;
+}
+
+static uint8_t sr1_at(double time)
+{
+	return (time < busy_until ? EMU_SR1_BUSY : 0) | (wel ? EMU_SR1_WEL : 0);
+}
+
+// Deliver the status match interrupt if its time has come
+static void run_irq(void)
+{
+	if (irq_armed && now >= irq_at)
+	{
+		irq_armed = false;
+		hospi2.State = HAL_OSPI_STATE_READY;
+		HAL_OSPI_StatusMatchCallback(&hospi2);
+	}
+}
+
+static bool refuse(OSPI_HandleTypeDef *hospi)
+{
+	now += t.call_ns;
+	run_irq();
+	if (hospi->State != HAL_OSPI_STATE_READY)
+	{
+		stats.violations++;
+		return true;
+	}
+	return false;
+}
+
+static void start_busy(double us)
+{
+	busy_until = now + us * 1000;
+	wel = false;
+}
+
+static void erase(uint32_t address, uint32_t size, double us)
+{
+	address &= EMU_ADDR_MASK & ~(size - 1);
+	memset(mem + address, 0xFF, size);
+	start_busy(us);
+	stats.erases++;
+}
+
+// Instruction without data phase
+static void execute(const OSPI_RegularCmdTypeDef *c)
+{
+	uint8_t op = c->Instruction;
+
+	if (busy() && op != W25Q_READ_SR1_CMD && op != W25Q_RESET_CMD
+			&& op != W25Q_ENABLE_RST_CMD)
+	{
+		stats.violations++;
+		return;
+	}
+
+	switch (op)
+	{
+		case W25Q_WRITE_ENABLE_CMD:
+			wel = true;
+			break;
+		case W25Q_WRITE_DISABLE_CMD:
+			wel = false;
+			break;
+		case W25Q_ENABLE_RST_CMD:
+			reset_enabled = true;
+			return;
+		case W25Q_RESET_CMD:
+			if (reset_enabled)
+			{
+				busy_until = now + EMU_TRST_US * 1000;
+				wel = false;
+			}
+			break;
+		case W25Q_SECTOR_ERASE_CMD:
+		case W25Q_32KB_BLOCK_ERASE_CMD:
+		case W25Q_64KB_BLOCK_ERASE_CMD:
+		case W25Q_CHIP_ERASE_CMD:
+			if (!wel)
+			{
+				stats.violations++;
+				break;
+			}
+			if (op == W25Q_SECTOR_ERASE_CMD)
+				erase(c->Address, W25Q_SECTOR_SIZE, t.tse_us);
+			else if (op == W25Q_32KB_BLOCK_ERASE_CMD)
+				erase(c->Address, W25Q_BLOCK32_SIZE, t.tbe32_us);
+			else if (op == W25Q_64KB_BLOCK_ERASE_CMD)
+				erase(c->Address, W25Q_BLOCK64_SIZE, t.tbe64_us);
+			else
+				erase(0, EMU_SIZE, t.tce_us);
+			break;
+		default:
+			break;
+	}
+	reset_enabled = false;
+}
+
+void w25q_emu_reset(const w25q_emu_timing_t *timing)
+{
+	t = *timing;
+	if (mem == NULL && (mem = malloc(EMU_SIZE)) == NULL)
+	{
+		perror("w25q_emu");
+		exit(2);
+	}
+	memset(mem, 0xFF, EMU_SIZE);
+	now = busy_until = 0;
+	wel = reset_enabled = cmd_pending = irq_armed = false;
+	hospi2.State = HAL_OSPI_STATE_READY;
+	w25q_emu_clear_stats();
+}
+
+void w25q_emu_clear_stats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+void w25q_emu_get_stats(w25q_emu_stats_t *s)
+{
+	*s = stats;
+}
+
+double w25q_emu_now_ns(void)
+{
+	return now;
+}
+
+void w25q_emu_cpu(double ns)
+{
+	now += ns;
+	run_irq();
+}
+
+const uint8_t* w25q_emu_memory(void)
+{
+	return mem;
+}
+
+// HAL OSPI
+HAL_StatusTypeDef HAL_OSPI_Command(OSPI_HandleTypeDef *hospi,
+		OSPI_RegularCmdTypeDef *c, uint32_t timeout)
+{
+	(void) timeout;
+
+	if (refuse(hospi))
+		return HAL_BUSY;
+	stats.commands++;
+
+	// With a data phase the command goes out with Transmit / Receive / polling
+	if (c->DataMode != HAL_OSPI_DATA_NONE)
+	{
+		cmd = *c;
+		cmd_pending = true;
+		return HAL_OK;
+	}
+
+	bus(phase_ns(c, 0));
+	execute(c);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPI_Transmit(OSPI_HandleTypeDef *hospi, uint8_t *data,
+		uint32_t timeout)
+{
+	uint32_t base, offset;
+	uint8_t op = cmd.Instruction;
+
+	(void) timeout;
+	if (refuse(hospi) || !cmd_pending)
+		return HAL_ERROR;
+	cmd_pending = false;
+	bus(phase_ns(&cmd, cmd.NbData));
+
+	if (op == W25Q_WRITE_SR1_CMD || op == W25Q_WRITE_SR2_CMD
+			|| op == W25Q_WRITE_SR3_CMD)
+	{
+		wel = false;
+		return HAL_OK;
+	}
+	if (op != W25Q_PAGE_PROGRAM_CMD && op != W25Q_PAGE_PROGRAM_QUAD_INP_CMD)
+		return HAL_OK;
+
+	if (busy() || !wel)
+	{
+		stats.violations++;
+		return HAL_OK;
+	}
+
+	// Past the end of the page the chip wraps to its start
+	base = cmd.Address & EMU_ADDR_MASK & ~(W25Q_PAGE_SIZE - 1);
+	offset = cmd.Address % W25Q_PAGE_SIZE;
+	if (offset + cmd.NbData > W25Q_PAGE_SIZE)
+		stats.violations++;
+	for (uint32_t i = 0; i < cmd.NbData; i++)
+		mem[base + (offset + i) % W25Q_PAGE_SIZE] &= data[i];
+
+	start_busy(t.tpp_us);
+	stats.pages++;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPI_Receive(OSPI_HandleTypeDef *hospi, uint8_t *data,
+		uint32_t timeout)
+{
+	uint8_t op = cmd.Instruction;
+
+	(void) timeout;
+	if (refuse(hospi) || !cmd_pending)
+		return HAL_ERROR;
+	cmd_pending = false;
+	bus(phase_ns(&cmd, cmd.NbData));
+
+	if (op == W25Q_READ_SR1_CMD)
+		memset(data, sr1_at(now), cmd.NbData);
+	else if (op == W25Q_READ_SR2_CMD)
+		memset(data, W25Q_SR_Quad_Enable, cmd.NbData);
+	else if (op == W25Q_READ_SR3_CMD)
+		memset(data, 0, cmd.NbData);
+	else if (busy())
+		stats.violations++;
+	else
+		for (uint32_t i = 0; i < cmd.NbData; i++)
+			data[i] = mem[(cmd.Address + i) & EMU_ADDR_MASK];
+
+	return HAL_OK;
+}
+
+// Time of the first status read that matches, 0 if none ever will
+static double poll_match(const OSPI_AutoPollingTypeDef *cfg)
+{
+	double period = phase_ns(&cmd, 1) + cycles_ns(cfg->Interval);
+	double first = now + phase_ns(&cmd, 1);
+	double after;
+
+	if ((sr1_at(first) & cfg->Mask) == cfg->Match)
+	{
+		stats.polls++;
+		return first;
+	}
+
+	// The status only changes when BUSY ends
+	after = first + period * (uint64_t) ((busy_until - first) / period + 1);
+	if (busy_until <= first || (sr1_at(after) & cfg->Mask) != cfg->Match)
+		return 0;
+	stats.polls += (uint32_t) ((after - first) / period) + 1;
+	return after;
+}
+
+HAL_StatusTypeDef HAL_OSPI_AutoPolling(OSPI_HandleTypeDef *hospi,
+		OSPI_AutoPollingTypeDef *cfg, uint32_t timeout)
+{
+	double match;
+
+	if (refuse(hospi) || !cmd_pending)
+		return HAL_ERROR;
+	cmd_pending = false;
+
+	if ((match = poll_match(cfg)) == 0)
+	{
+		bus(timeout * 1e6);
+		return HAL_TIMEOUT;
+	}
+	bus(match - now);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPI_AutoPolling_IT(OSPI_HandleTypeDef *hospi,
+		OSPI_AutoPollingTypeDef *cfg)
+{
+	double match;
+
+	if (refuse(hospi) || !cmd_pending)
+		return HAL_ERROR;
+	cmd_pending = false;
+
+	// A status that never matches polls until aborted
+	match = poll_match(cfg);
+	irq_at = match != 0 ? match : 1e300;
+	irq_armed = true;
+	stats.bus_ns += match != 0 ? match - now : 0;
+	hospi->State = HAL_OSPI_STATE_BUSY_AUTO_POLLING;
+	return HAL_OK;
+}
+
+// Memory-mapped reads are not modelled
+HAL_StatusTypeDef HAL_OSPI_MemoryMapped(OSPI_HandleTypeDef *hospi,
+		OSPI_MemoryMappedTypeDef *cfg)
+{
+	(void) cfg;
+	if (refuse(hospi) || !cmd_pending)
+		return HAL_ERROR;
+	cmd_pending = false;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPI_Abort(OSPI_HandleTypeDef *hospi)
+{
+	now += t.call_ns;
+	irq_armed = cmd_pending = false;
+	hospi->State = HAL_OSPI_STATE_READY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPI_DeInit(OSPI_HandleTypeDef *hospi)
+{
+	return HAL_OSPI_Abort(hospi);
+}
+
+void MX_OCTOSPI2_Init(void)
+{
+	hospi2.Instance = OCTOSPI2;
+	hospi2.State = HAL_OSPI_STATE_READY;
+}
+
+// HAL ticks on the virtual clock, wait loops let the interrupt in
+uint32_t HAL_GetTick(void)
+{
+	now += t.tick_ns;
+	run_irq();
+	return (uint32_t) (now / 1e6);
+}
+
+void HAL_Delay(uint32_t delay)
+{
+	now += delay * 1e6;
+	run_irq();
+}
+
+void watchdog_refresh(void)
+{
+}
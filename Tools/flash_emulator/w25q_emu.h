@@ -0,0 +1,53 @@
+/*
+ * W25Q flash behind OCTOSPI2, emulated on Linux (host only)
+ *
+ * w25q_emu.c implements the HAL_OSPI_* functions that W25Q64/W25Q64.c calls
+ * on a model of the chip: 32 MB of NOR cells (program clears bits, erase
+ * sets them), status register 1 (BUSY, WEL) and datasheet program / erase
+ * times on a virtual clock. Every OSPI phase costs its bus cycles at the
+ * configured clock, auto-polling advances the clock to the end of BUSY and
+ * the status match interrupt of HAL_OSPI_AutoPolling_IT() is delivered
+ * from HAL_GetTick() once the virtual clock has passed it.
+ *
+ * Commands the chip would ignore (busy, WEL not set) or the HAL would
+ * refuse (auto-polling still running) are counted as violations.
+ */
+
+#ifndef W25Q_EMU_H_
+#define W25Q_EMU_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+	double bus_mhz;		// OSPI clock
+	double call_ns;		// CPU cost of one HAL_OSPI_* call
+	double tick_ns;		// CPU cost of one HAL_GetTick() in a wait loop
+	double tpp_us;		// page program
+	double tse_us;		// 4 KB sector erase
+	double tbe32_us;	// 32 KB block erase
+	double tbe64_us;	// 64 KB block erase
+	double tce_us;		// chip erase
+} w25q_emu_timing_t;
+
+typedef struct
+{
+	uint32_t commands;		// HAL_OSPI_Command() calls
+	uint32_t polls;			// status reads of auto-polling
+	uint32_t pages;			// page programs
+	uint32_t erases;		// sector / block / chip erases
+	uint32_t violations;	// commands ignored by the chip or refused by the HAL
+	double bus_ns;			// time the OSPI bus was active
+} w25q_emu_stats_t;
+
+extern const w25q_emu_timing_t w25q_emu_typical;
+
+void w25q_emu_reset(const w25q_emu_timing_t *timing);
+void w25q_emu_clear_stats(void);
+void w25q_emu_get_stats(w25q_emu_stats_t *stats);
+
+double w25q_emu_now_ns(void);
+void w25q_emu_cpu(double ns);	// CPU busy elsewhere (the interrupt may fire)
+const uint8_t* w25q_emu_memory(void);
+
+#endif /* W25Q_EMU_H_ */
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Build the headless LCD emulator on Linux (gcc, no other dependency)
+# Usage: Tools/lcd_emulator/build.sh [output], from anywhere
+# Staging/ holds staging.h and rollback.h, included by assets.c; its CRC32
+# comes from Checksum/ (table version, CRC_SOFTWARE)
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT=${1:-$HERE/lcd_emulator}
+
+cd "$ROOT"
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+gcc -std=gnu11 -O2 -Wall -Wextra -no-pie \
+  -DSTM32H733xx -DUSE_HAL_DRIVER -DCRC_SOFTWARE \
+  -I"$HERE" -ICore/Inc -ILCD -IW25Q64 -IPSRAM -IMotors -IStaging -IChecksum \
+  -isystem Drivers/CMSIS/Device/ST/STM32H7xx/Include -isystem Drivers/CMSIS/Include \
+  -isystem Drivers/STM32H7xx_HAL_Driver/Inc -IUSB_DEVICE/App \
+  -isystem Middlewares/ST/STM32_USB_Device_Library/Core/Inc \
+  -isystem Middlewares/ST/STM32_USB_Device_Library/Class/CDC/Inc \
+  "$HERE/lcd_emulator.c" "$HERE/lcd_io_emu.c" "$HERE/emu_stubs.c" \
+  Core/Src/interface.c Core/Src/assets.c Core/Src/animation.c \
+  Core/Src/image_codec.c LCD/ili9488.c LCD/stm32_adafruit_lcd.c \
+  Checksum/checksum.c LCD/Fonts/*.c \
+  -o "$OUT"
+
+echo "$OUT"
@@ -0,0 +1,327 @@
+/*
+ * Host stand-ins for the firmware that Core/Src/interface.c links against
+ * (EERAM, buttons, encoder, motors, ticks, image prefetch, background
+ * staging), just enough to run its screen functions in the emulator. EERAM
+ * is a zeroed RAM array, the encoder returns the steps queued with
+ * emu_turn_encoder().
+ */
+
+#include <basic_operations.h>
+#include <bootload.h>
+#include <buttons.h>
+#include <fw_staging.h>
+#include <games.h>
+#include <i2c.h>
+#include <interface.h>
+#include <image_prefetch.h>
+#include <iwdg.h>
+#include <lcd_emu.h>
+#include <main.h>
+#include <PSRAM.h>
+#include <servo_motor.h>
+#include <stdio.h>
+#include <string.h>
+#include <utilities.h>
+#include <version.h>
+
+#include "emu_stubs.h"
+
+// Globals of main.c, games.c and i2c.c
+context_t context;
+bool fresh_load = true;
+button encoder_btn;
+button escape_btn;
+uint8_t n_cards_in;
+menu_t current_menu;
+union machine_state_t machine_state;
+game_rules_t rules_list[1];
+uint16_t n_presets = 0;
+I2C_HandleTypeDef hi2c3;
+
+static uint8_t eeram[0x10000];
+static uint32_t tick;
+static double clock_ns;		// Virtual clock: HAL_Delay() and tick reads
+static bool clock_on;
+static int16_t encoder_steps;
+
+// Image prefetch: copies are immediate, their OSPI time is set against the
+// LCD bus time to find how long the CPU would wait for them
+static struct
+{
+	bool off;
+	double wr_ns;
+	double ospi_ns;
+	uint8_t *pending;
+	double ready_ns;	// bus time at which the pending copy is done
+	double stall_ns;	// time spent in prefetch_wait()
+	uint64_t bytes;		// copied
+} prefetch;
+
+void emu_reset_firmware(void)
+{
+	memset(eeram, 0, sizeof(eeram));
+	tick = 0;
+	encoder_steps = 0;
+}
+
+void emu_turn_encoder(int16_t steps)
+{
+	encoder_steps += steps;
+}
+
+void emu_write_eeram(uint16_t address, uint8_t value)
+{
+	eeram[address] = value;
+}
+
+void emu_prefetch_model(bool on, double wr_ns, double ospi_ns)
+{
+	prefetch.off = !on;
+	prefetch.wr_ns = wr_ns;
+	prefetch.ospi_ns = ospi_ns;
+}
+
+void emu_prefetch_stats(uint64_t *bytes, double *stall_ns, bool clear)
+{
+	*bytes = prefetch.bytes;
+	*stall_ns = prefetch.stall_ns;
+	if (clear)
+		prefetch.bytes = prefetch.stall_ns = 0;
+}
+
+// Time on the target since the scene started: bus writes, direct flash
+// reads (the CPU waits for each cache line) and prefetch waits
+static double prefetch_now_ns(void)
+{
+	lcd_emu_stats_t s;
+
+	lcd_emu_get_stats(&s);
+	return s.wr_strobes * prefetch.wr_ns + s.flash_bytes * prefetch.ospi_ns
+			+ prefetch.stall_ns;
+}
+
+return_code_t prefetch_start(uint8_t *buffer, const uint8_t *address,
+		uint32_t size)
+{
+	if (prefetch.off || ((uintptr_t) address & 3) || size == 0
+			|| size > PREFETCH_LINE_SIZE || prefetch.pending != NULL)
+		return LS_ERROR;
+
+	size = (size + 3) & ~3UL;
+	memcpy(buffer, address, size);
+	prefetch.pending = buffer;
+	prefetch.ready_ns = prefetch_now_ns() + size * prefetch.ospi_ns;
+	prefetch.bytes += size;
+	return LS_OK;
+}
+
+return_code_t prefetch_wait(void)
+{
+	double now = prefetch_now_ns();
+
+	if (prefetch.pending == NULL)
+		return LS_ERROR;
+	if (prefetch.ready_ns > now)
+		prefetch.stall_ns += prefetch.ready_ns - now;
+	prefetch.pending = NULL;
+	return LS_OK;
+}
+
+// Virtual clock from now on: HAL_Delay(), 1 us per tick read and the
+// drawing time of prefetch_now_ns(). Returns the time so far in ms.
+double emu_virtual_clock(bool on)
+{
+	double ms = (clock_ns + prefetch_now_ns()) / 1e6;
+
+	clock_on = on;
+	clock_ns = -prefetch_now_ns();
+	return ms;
+}
+
+// HAL
+uint32_t HAL_GetTick(void)
+{
+	if (!clock_on)
+		return tick++;
+
+	clock_ns += 1000;
+	return (uint32_t) ((clock_ns + prefetch_now_ns()) / 1e6);
+}
+
+void HAL_Delay(uint32_t delay)
+{
+	tick += delay;
+	clock_ns += delay * 1e6;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(const GPIO_TypeDef *port, uint16_t pin)
+{
+	(void) port;
+	(void) pin;
+	return GPIO_PIN_SET;
+}
+
+uint32_t HAL_GetUIDw0(void)
+{
+	return 0x00390025;
+}
+
+uint32_t HAL_GetUIDw1(void)
+{
+	return 0x33305114;
+}
+
+uint32_t HAL_GetUIDw2(void)
+{
+	return 0x32383730;
+}
+
+// EERAM
+HAL_StatusTypeDef EERAM_ReadSRAMData(I2C_HandleTypeDef *hi2c, uint16_t address,
+		uint8_t *data, uint16_t size)
+{
+	(void) hi2c;
+	if ((uint32_t) address + size > sizeof(eeram))
+		return HAL_ERROR;
+	memcpy(data, &eeram[address], size);
+	return HAL_OK;
+}
+
+return_code_t read_eeram(uint16_t address, uint8_t *p_data, uint16_t size)
+{
+	return EERAM_ReadSRAMData(&hi2c3, address, p_data, size) == HAL_OK ?
+			LS_OK : EERAM_ERROR;
+}
+
+return_code_t write_eeram(uint16_t address, uint8_t *p_data, uint16_t size)
+{
+	if ((uint32_t) address + size > sizeof(eeram))
+		return EERAM_ERROR;
+	memcpy(&eeram[address], p_data, size);
+	return LS_OK;
+}
+
+return_code_t read_eeram_bit(uint16_t address, uint16_t index, uint8_t *pBit)
+{
+	*pBit = (eeram[(uint16_t) (address + index / BYTE)] >> (index % BYTE)) & 1;
+	return LS_OK;
+}
+
+return_code_t write_eeram_bit(uint16_t address, uint16_t index, uint8_t bit)
+{
+	uint8_t *p = &eeram[(uint16_t) (address + index / BYTE)];
+	*p = bit ? *p | (1 << (index % BYTE)) : *p & ~(1 << (index % BYTE));
+	return LS_OK;
+}
+
+// Buttons and encoder
+int16_t read_encoder(bool direction)
+{
+	int16_t steps = encoder_steps;
+
+	encoder_steps = 0;
+	return direction ? steps : -steps;
+}
+
+void reset_encoder(void)
+{
+	encoder_steps = 0;
+}
+
+void reset_btns(void)
+{
+}
+
+void update_btns()
+{
+}
+
+void wait_btns(void)
+{
+}
+
+// Machine
+GPIO_PinState read_sensor(sensor_code_t sensor)
+{
+	(void) sensor;
+	return GPIO_PIN_RESET;
+}
+
+return_code_t read_n_cards_in(void)
+{
+	return LS_OK;
+}
+
+return_code_t cards_in_shoe(void)
+{
+	return LS_OK;
+}
+
+return_code_t cards_in_tray(void)
+{
+	return LS_OK;
+}
+
+return_code_t home_carousel(void)
+{
+	return LS_OK;
+}
+
+void carousel_enable(void)
+{
+}
+
+void carousel_disable(void)
+{
+}
+
+void flap_close(void)
+{
+}
+
+void flap_mid(void)
+{
+}
+
+void beep(uint32_t duration)
+{
+	(void) duration;
+}
+
+void watchdog_refresh(void)
+{
+}
+
+// Messages and versions
+error_type_t error_type(return_code_t code)
+{
+	return code == LS_OK ? NON_ERROR : ERROR_NOT_FOUND;
+}
+
+char* error_message(return_code_t code)
+{
+	(void) code;
+	return "Emulated error";
+}
+
+return_code_t read_custom_game_name(char text[GAME_NAME_MAX_CHAR + 1],
+		item_code_t code)
+{
+	snprintf(text, GAME_NAME_MAX_CHAR + 1, "Custom %d", (int) code);
+	return LS_OK;
+}
+
+uint16_t GetBootloaderVersion(void)
+{
+	return 0x0300;
+}
+
+const char* GetFirmwareVersionDisplay(void)
+{
+	return "emulator";
+}
+
+// Background staging: no USB link in the emulator, nothing to receive
+void fw_staging_poll(void)
+{
+}
@@ -0,0 +1,18 @@
+/*
+ * Host stand-ins for the firmware around interface.c (see emu_stubs.c)
+ */
+
+#ifndef EMU_STUBS_H_
+#define EMU_STUBS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void emu_reset_firmware(void);
+void emu_turn_encoder(int16_t);
+void emu_write_eeram(uint16_t, uint8_t);
+void emu_prefetch_model(bool, double, double);
+void emu_prefetch_stats(uint64_t*, double*, bool);
+double emu_virtual_clock(bool);
+
+#endif /* EMU_STUBS_H_ */
@@ -0,0 +1,47 @@
+/*
+ * Headless ILI9488 emulator (host only)
+ *
+ * lcd_io_emu.c implements the LCD_IO_* link functions of LCD/lcd_io_gpio8.c
+ * on Linux. Every byte the firmware would put on the 8 bit bus is decoded
+ * like the panel does (CASET, PASET, RAMWR, RAMWRCONT, RAMRD, MADCTL,
+ * VSCRDEF, VSCRSADD) into a 320 x 480 RGB565 panel memory, and counted.
+ *
+ * The screen is the panel memory seen through the MADCTL written by
+ * ili9488_Init(), so PNG dumps and pixel reads use the firmware's
+ * coordinates (480 x 320 landscape with ILI9488_ORIENTATION 1).
+ */
+
+#ifndef LCD_EMU_H_
+#define LCD_EMU_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Bus cost since the last lcd_emu_clear_stats() */
+typedef struct
+{
+  uint32_t transactions;  /* CS low periods (LCD_IO_* calls) */
+  uint64_t cmd_bytes;     /* bytes written with RS = 0 */
+  uint64_t data_bytes;    /* bytes written with RS = 1 */
+  uint64_t wr_strobes;    /* WR pulses, cmd_bytes + data_bytes on this bus */
+  uint64_t rd_strobes;    /* RD pulses, dummy reads included */
+  uint64_t pixels;        /* pixels stored by RAMWR / RAMWRCONT */
+  uint64_t flash_bytes;   /* burst bytes read straight from the flash window */
+  uint32_t windows;       /* CASET + PASET commands */
+  uint32_t madctl;        /* MADCTL commands */
+} lcd_emu_stats_t;
+
+void     lcd_emu_reset(void);
+void     lcd_emu_clear_stats(void);
+void     lcd_emu_get_stats(lcd_emu_stats_t *stats);
+void     lcd_emu_trace(FILE *f);
+void     lcd_emu_null_bus(int on);
+void     lcd_emu_flash_window(const void *base, uint32_t size);
+
+uint16_t lcd_emu_width(void);
+uint16_t lcd_emu_height(void);
+uint16_t lcd_emu_pixel(uint16_t x, uint16_t y);
+uint32_t lcd_emu_crc(void);
+int      lcd_emu_write_png(const char *path);
+
+#endif /* LCD_EMU_H_ */
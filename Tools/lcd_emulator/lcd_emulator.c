@@ -0,0 +1,407 @@
+/*
+ * lcd_emulator: run interface.c screen functions on the headless ILI9488
+ *
+ * Each scene calls the firmware's own drawing code and reports what it cost
+ * on the LCD bus, with a CRC of the resulting screen so rendering changes
+ * can be regression-checked. See build.sh for the build.
+ *
+ * Usage: lcd_emulator [--png DIR] [--flash FILE] [--wr-ns NS] [--ospi-ns NS]
+ *                     [--no-prefetch] [--cpu N] [--boot] [--trace FILE]
+ *                     [--save FILE | --check FILE]
+ *   --png DIR    write DIR/<scene>.png after every scene
+ *   --flash FILE image region (raw dump of the external flash), default erased;
+ *                assets are indexed below ROLLBACK_OFFSET only, as on the
+ *                device
+ *   --wr-ns NS   WR strobe period in ns, adds an estimated bus time column
+ *   --ospi-ns NS memory-mapped OSPI read time per byte, adds the bytes read
+ *                from flash by the LCD writer and an estimated drawing time
+ *                (bus writes + direct reads + waits for the MDMA prefetch)
+ *   --no-prefetch draw raw images straight from the flash window
+ *   --cpu N      time N redraws of some screens with the bus writes dropped
+ *                (host CPU time of the firmware side, not of the target)
+ *   --boot       time main() from the logo to homing on a virtual clock:
+ *                the HAL_Delay() of the latch and carousel_init() plus the
+ *                estimated drawing time (use with --wr-ns and --ospi-ns)
+ *   --trace FILE log every panel command
+ *   --save FILE  write the scene CRCs to FILE
+ *   --check FILE compare the scene CRCs with FILE, exit 1 on any difference
+ */
+
+#include <animation.h>
+#include <assets.h>
+#include <interface.h>
+#include <lcd_emu.h>
+#include <rollback.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stm32_adafruit_lcd.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "emu_stubs.h"
+
+#define MAX_SCENES		64
+#define SCENE_NAME_LEN	32
+
+typedef struct
+{
+	char name[SCENE_NAME_LEN];
+	uint32_t crc;
+} scene_t;
+
+static scene_t scenes[MAX_SCENES];
+static uint16_t n_scenes;
+static const char *png_dir;
+static double wr_ns;
+static double ospi_ns;
+
+// Map the external flash where the firmware expects it (memory-mapped OSPI)
+static int map_flash(const char *path)
+{
+	uint8_t *flash = mmap((void*) IMAGE_START_ADDRESS, W25Q_FLASH_SIZE,
+	PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+			-1, 0);
+
+	if (flash != (uint8_t*) IMAGE_START_ADDRESS)
+	{
+		fprintf(stderr, "cannot map flash at %#lx\n", IMAGE_START_ADDRESS);
+		return -1;
+	}
+	memset(flash, 0xFF, W25Q_FLASH_SIZE);
+	lcd_emu_flash_window(flash, W25Q_FLASH_SIZE);
+
+	if (path != NULL)
+	{
+		FILE *f = fopen(path, "rb");
+		if (f == NULL)
+		{
+			perror(path);
+			return -1;
+		}
+		size_t n = fread(flash, 1, W25Q_FLASH_SIZE, f);
+		fclose(f);
+		printf("flash: %zu bytes from %s\n", n, path);
+		// Rollback slot and staging area from there (Staging/)
+		if (n > ROLLBACK_OFFSET - FLASH_FACTORY_OFFSET)
+			printf("flash: data from %#lx on is in the rollback slot and "
+					"staging area, not indexed as assets\n",
+					(unsigned long) ROLLBACK_OFFSET);
+	}
+
+	return 0;
+}
+
+static void begin_scene(void)
+{
+	uint64_t bytes;
+	double stall_ns;
+
+	lcd_emu_clear_stats();
+	emu_prefetch_stats(&bytes, &stall_ns, true);
+}
+
+// Report the bus cost of the scene and record its screen CRC
+static void end_scene(const char *name)
+{
+	lcd_emu_stats_t s;
+	scene_t *scene = &scenes[n_scenes];
+	uint64_t prefetched;
+	double stall_ns;
+
+	lcd_emu_get_stats(&s);
+	emu_prefetch_stats(&prefetched, &stall_ns, false);
+	if (n_scenes < MAX_SCENES)
+	{
+		snprintf(scene->name, SCENE_NAME_LEN, "%s", name);
+		scene->crc = lcd_emu_crc();
+		n_scenes++;
+	}
+
+	printf("%-24s %8u %6u %6llu %10llu %10llu %9llu  %08X", name,
+			s.transactions, s.windows, (unsigned long long) s.cmd_bytes,
+			(unsigned long long) s.data_bytes,
+			(unsigned long long) s.wr_strobes, (unsigned long long) s.pixels,
+			lcd_emu_crc());
+	if (wr_ns > 0)
+		printf(" %9.2f", s.wr_strobes * wr_ns / 1e6);
+	if (ospi_ns > 0)
+		printf(" %8.1f %9.2f", (s.flash_bytes + prefetched) / 1024.0,
+				(s.wr_strobes * wr_ns + s.flash_bytes * ospi_ns + stall_ns)
+						/ 1e6);
+	printf("\n");
+
+	if (png_dir != NULL)
+	{
+		char path[256];
+		snprintf(path, sizeof(path), "%s/%s.png", png_dir, name);
+		if (lcd_emu_write_png(path) != 0)
+			fprintf(stderr, "cannot write %s\n", path);
+	}
+}
+
+// Turn the encoder one detent at a time and report every detent
+static void scroll_scene(const char *name, int16_t step, uint8_t n_detents)
+{
+	char scene_name[SCENE_NAME_LEN];
+
+	for (uint8_t i = 0; i < n_detents; i++)
+	{
+		snprintf(scene_name, sizeof(scene_name), "%s_%02u", name, i + 1);
+		begin_scene();
+		emu_turn_encoder(step);
+		update_menu();
+		end_scene(scene_name);
+	}
+}
+
+static void run_scenes(void)
+{
+	extern menu_t current_menu;
+
+	begin_scene();
+	BSP_LCD_Init();
+	BSP_LCD_Clear(LCD_COLOR_BCKGND);
+	end_scene("init");
+
+	begin_scene();
+	prompt_animated_logo();
+	end_scene("logo");
+
+	// As main() at boot
+	begin_scene();
+	set_current_menu(ROOT_MENU);
+	prompt_title(current_menu.label);
+	prompt_menu(DEFAULT_SELECT, ROOT_MENU);
+	end_scene("root_menu");
+
+	scroll_scene("root_down", 1, 3);
+
+	// Some games already checked
+	emu_write_eeram(EERAM_FAVS, 0x25);
+	emu_write_eeram(EERAM_FAVS + 1, 0x81);
+
+	begin_scene();
+	prompt_menu(DEFAULT_SELECT, SET_FAVORITES);
+	end_scene("favorites_menu");
+
+	scroll_scene("favorites_down", 1, LCD_N_ROWS + 3);
+	scroll_scene("favorites_up", -1, 4);
+
+	// Cleared outside the menu code: the next scroll redraws the whole menu
+	begin_scene();
+	BSP_LCD_Clear(LCD_COLOR_BCKGND);
+	emu_turn_encoder(LCD_N_ROWS);
+	update_menu();
+	end_scene("favorites_after_clear");
+
+	begin_scene();
+	prompt_message("Place the cards in the tray and press the encoder button.");
+	end_scene("message");
+
+	begin_scene();
+	clear_message(TEXT_ERROR);
+	end_scene("clear_message");
+
+	// Graphic prompt of prompt_interface()
+	begin_scene();
+	draw_asset(ASSET_SILH, (BSP_LCD_GetXSize() - SILH_W) / 2, SILH_Y);
+	end_scene("silhouette");
+}
+
+// As main() from the logo to homing, the actuators reduced to their delays
+static void run_boot(void)
+{
+	begin_scene();
+	emu_virtual_clock(true);
+
+	start_animated_logo();
+	animation_poll();
+	HAL_Delay(SOLENOID_IMPULSE_CLOSE);	// set_latch(LATCH_CLOSED)
+	animation_poll();
+	HAL_Delay(15 + 130 + 70);			// carousel_init(): tmc2209_init(), PWM_OFS_AUTO
+	animation_finish();
+
+	printf("\nboot: logo start to homing %.1f ms\n", emu_virtual_clock(false));
+}
+
+static double now_us(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+// Redraw a menu n times on a null bus, report the mean time per redraw
+static void cpu_menu(const char *name, item_code_t code, uint32_t n)
+{
+	double start;
+
+	prompt_menu(DEFAULT_SELECT, code);
+	start = now_us();
+	for (uint32_t i = 0; i < n; i++)
+		prompt_menu(DEFAULT_SELECT, code);
+	printf("%-24s %10.2f us\n", name, (now_us() - start) / n);
+}
+
+static void run_cpu(uint32_t n)
+{
+	double start;
+
+	lcd_emu_null_bus(1);
+	printf("\n%-24s %13s\n", "cpu (host)", "per redraw");
+
+	cpu_menu("root_menu", ROOT_MENU, n);
+	cpu_menu("favorites_menu", SET_FAVORITES, n);
+
+	start = now_us();
+	for (uint32_t i = 0; i < n; i++)
+		prompt_labels("Deal", "card", i % 3, 30);
+	printf("%-24s %10.2f us\n", "prompt_labels", (now_us() - start) / n);
+
+	lcd_emu_null_bus(0);
+}
+
+static int save_crcs(const char *path)
+{
+	FILE *f = fopen(path, "w");
+
+	if (f == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+	for (uint16_t i = 0; i < n_scenes; i++)
+		fprintf(f, "%s %08X\n", scenes[i].name, scenes[i].crc);
+	fclose(f);
+
+	return 0;
+}
+
+// Number of scenes whose CRC differs from (or is missing in) the file
+static int check_crcs(const char *path)
+{
+	FILE *f = fopen(path, "r");
+	char name[SCENE_NAME_LEN];
+	unsigned crc;
+	int n_diff = 0;
+
+	if (f == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	for (uint16_t i = 0; i < n_scenes; i++)
+	{
+		bool found = false;
+
+		rewind(f);
+		while (fscanf(f, "%31s %X", name, &crc) == 2)
+			if (strcmp(name, scenes[i].name) == 0)
+			{
+				found = true;
+				break;
+			}
+
+		if (!found || crc != scenes[i].crc)
+		{
+			printf("DIFF %s: %08X, expected %s\n", scenes[i].name,
+					scenes[i].crc, found ? "another CRC" : "no scene");
+			n_diff++;
+		}
+	}
+	fclose(f);
+
+	return n_diff;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *flash_path = NULL;
+	const char *save_path = NULL;
+	const char *check_path = NULL;
+	uint32_t cpu_runs = 0;
+	bool prefetch = true;
+	bool boot = false;
+	FILE *trace = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--png") == 0 && i + 1 < argc)
+			png_dir = argv[++i];
+		else if (strcmp(argv[i], "--flash") == 0 && i + 1 < argc)
+			flash_path = argv[++i];
+		else if (strcmp(argv[i], "--wr-ns") == 0 && i + 1 < argc)
+			wr_ns = atof(argv[++i]);
+		else if (strcmp(argv[i], "--ospi-ns") == 0 && i + 1 < argc)
+			ospi_ns = atof(argv[++i]);
+		else if (strcmp(argv[i], "--no-prefetch") == 0)
+			prefetch = false;
+		else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc)
+			cpu_runs = strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "--boot") == 0)
+			boot = true;
+		else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+			save_path = argv[++i];
+		else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+			check_path = argv[++i];
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+		{
+			if ((trace = fopen(argv[++i], "w")) == NULL)
+			{
+				perror(argv[i]);
+				return 2;
+			}
+		}
+		else
+		{
+			fprintf(stderr,
+					"usage: %s [--png DIR] [--flash FILE] [--wr-ns NS] "
+							"[--ospi-ns NS] [--no-prefetch] [--cpu N] [--boot] "
+							"[--trace FILE] [--save FILE | --check FILE]\n",
+					argv[0]);
+			return 2;
+		}
+	}
+
+	if (map_flash(flash_path) != 0)
+		return 2;
+
+	emu_reset_firmware();
+	emu_prefetch_model(prefetch, wr_ns, ospi_ns);
+	lcd_emu_reset();
+	lcd_emu_trace(trace);
+	printf("assets: %s\n",
+			asset_init() == LS_OK ? "directory" : "legacy layout");
+
+	printf("%-24s %8s %6s %6s %10s %10s %9s  %-8s%s%s\n", "scene", "calls",
+			"window", "cmd", "data", "WR", "pixels", "CRC",
+			wr_ns > 0 ? "   bus ms" : "",
+			ospi_ns > 0 ? "  ospi kB    est ms" : "");
+	run_scenes();
+
+	if (cpu_runs > 0)
+		run_cpu(cpu_runs);
+
+	if (boot)
+		run_boot();
+
+	if (trace != NULL)
+		fclose(trace);
+
+	if (save_path != NULL && save_crcs(save_path) != 0)
+		return 2;
+
+	if (check_path != NULL)
+	{
+		int n_diff = check_crcs(check_path);
+		if (n_diff < 0)
+			return 2;
+		printf("%d of %u scenes differ\n", n_diff, n_scenes);
+		return n_diff ? 1 : 0;
+	}
+
+	return 0;
+}
@@ -0,0 +1,732 @@
+/*
+ * Headless ILI9488 emulator (host only), see lcd_emu.h
+ *
+ * Replaces LCD/lcd_io_gpio8.c: the LCD_IO_* functions below put the same
+ * bytes in the same order on an emulated bus (LCD_REVERSE16 == 0, high
+ * byte first) and the bus feeds a small ILI9488 command decoder.
+ */
+
+#include <lcd.h>
+#include <lcd_emu.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EMU_MEM_W         320   /* panel columns (ILI9488_LCD_PIXEL_WIDTH) */
+#define EMU_MEM_H         480   /* panel rows (ILI9488_LCD_PIXEL_HEIGHT) */
+
+#define EMU_SWRESET       0x01
+#define EMU_RDDID         0x04
+#define EMU_CASET         0x2A
+#define EMU_PASET         0x2B
+#define EMU_RAMWR         0x2C
+#define EMU_RAMRD         0x2E
+#define EMU_VSCRDEF       0x33
+#define EMU_MADCTL        0x36
+#define EMU_VSCRSADD      0x37
+#define EMU_RAMWRCONT     0x3C
+#define EMU_RAMRDCONT     0x3E
+
+#define EMU_MAD_MY        0x80
+#define EMU_MAD_MX        0x40
+#define EMU_MAD_MV        0x20
+
+/* Panel state */
+static uint16_t mem[EMU_MEM_H][EMU_MEM_W];
+static uint8_t  madctl;
+static uint8_t  view_madctl;          /* MADCTL that defines the screen */
+static bool     view_set;
+static uint16_t sc, ec, sp, ep;       /* window (column / page addresses) */
+static uint16_t cc, cp;               /* RAM write / read pointer */
+static uint16_t tfa, vsa = EMU_MEM_H, vsp;
+
+/* Decoder state */
+static uint8_t  cmd;
+static uint8_t  param[8];
+static uint32_t n_param;
+static uint8_t  pixel_hi;
+static bool     pixel_half;
+static uint32_t n_read;
+
+static lcd_emu_stats_t stats;
+static FILE *trace;
+static bool null_bus;
+static const uint8_t *flash_base;
+static uint32_t flash_size;
+
+/* Writes are dropped without decoding or counting (CPU time measurements) */
+#define EMU_NULL_BUS      if(null_bus) return
+
+uint8_t  lcd_data8;
+
+//-----------------------------------------------------------------------------
+/* Count the bytes of a burst the CPU reads straight from the flash window */
+static void emu_source(const void *p, uint32_t size)
+{
+  if(flash_size && (const uint8_t *)p >= flash_base
+     && (const uint8_t *)p < flash_base + flash_size)
+    stats.flash_bytes += size;
+}
+
+//-----------------------------------------------------------------------------
+/* Column / page address to panel memory, as set by MADCTL */
+static bool emu_map(uint8_t mad, uint16_t c, uint16_t p, uint16_t *col, uint16_t *row)
+{
+  uint16_t x = c, y = p;
+
+  if(mad & EMU_MAD_MV)
+  {
+    x = p;
+    y = c;
+  }
+  if(x >= EMU_MEM_W || y >= EMU_MEM_H)
+    return false;
+  *col = (mad & EMU_MAD_MX) ? EMU_MEM_W - 1 - x : x;
+  *row = (mad & EMU_MAD_MY) ? EMU_MEM_H - 1 - y : y;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/* Advance the RAM pointer in the window, wrapping like the panel does */
+static void emu_next(void)
+{
+  if(cc++ >= ec)
+  {
+    cc = sc;
+    if(cp++ >= ep)
+      cp = sp;
+  }
+}
+
+//-----------------------------------------------------------------------------
+static void emu_store(uint16_t rgb)
+{
+  uint16_t col, row;
+
+  if(emu_map(madctl, cc, cp, &col, &row))
+    mem[row][col] = rgb;
+  stats.pixels++;
+  emu_next();
+}
+
+//-----------------------------------------------------------------------------
+static void emu_cmd(uint8_t c)
+{
+  stats.cmd_bytes++;
+  stats.wr_strobes++;
+  cmd = c;
+  n_param = 0;
+  pixel_half = false;
+  n_read = 0;
+
+  switch(c)
+  {
+    case EMU_SWRESET:
+      madctl = 0;
+      view_set = false;
+      tfa = 0; vsa = EMU_MEM_H; vsp = 0;
+      break;
+    case EMU_CASET:
+    case EMU_PASET:
+      stats.windows++;
+      break;
+    case EMU_MADCTL:
+      stats.madctl++;
+      break;
+    case EMU_RAMWR:
+    case EMU_RAMRD:
+      cc = sc;
+      cp = sp;
+      break;
+  }
+
+  if(trace)
+    fprintf(trace, "CMD %02X\n", c);
+}
+
+//-----------------------------------------------------------------------------
+static void emu_data(uint8_t d)
+{
+  stats.data_bytes++;
+  stats.wr_strobes++;
+
+  if(cmd == EMU_RAMWR || cmd == EMU_RAMWRCONT)
+  {
+    /* 16 bpp: high byte first */
+    if(!pixel_half)
+      pixel_hi = d;
+    else
+      emu_store((pixel_hi << 8) | d);
+    pixel_half = !pixel_half;
+    return;
+  }
+
+  if(n_param < sizeof(param))
+    param[n_param] = d;
+  n_param++;
+
+  switch(cmd)
+  {
+    case EMU_CASET:
+      if(n_param == 4)
+      {
+        sc = (param[0] << 8) | param[1];
+        ec = (param[2] << 8) | param[3];
+        if(trace)
+          fprintf(trace, "  CASET %u..%u\n", sc, ec);
+      }
+      break;
+    case EMU_PASET:
+      if(n_param == 4)
+      {
+        sp = (param[0] << 8) | param[1];
+        ep = (param[2] << 8) | param[3];
+        if(trace)
+          fprintf(trace, "  PASET %u..%u\n", sp, ep);
+      }
+      break;
+    case EMU_MADCTL:
+      if(n_param == 1)
+      {
+        madctl = d;
+        /* The first MADCTL after reset is the one ili9488_Init() leaves */
+        if(!view_set)
+        {
+          view_madctl = d;
+          view_set = true;
+        }
+        if(trace)
+          fprintf(trace, "  MADCTL %02X\n", d);
+      }
+      break;
+    case EMU_VSCRDEF:
+      if(n_param == 6)
+      {
+        tfa = (param[0] << 8) | param[1];
+        vsa = (param[2] << 8) | param[3];
+      }
+      break;
+    case EMU_VSCRSADD:
+      if(n_param == 2)
+        vsp = (param[0] << 8) | param[1];
+      break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+static uint8_t emu_read(void)
+{
+  uint8_t d = 0;
+  uint32_t i = n_read++;
+
+  stats.rd_strobes++;
+
+  /* Every read command starts with a dummy byte */
+  if(i == 0)
+    return 0;
+  i--;
+
+  if(cmd == EMU_RDDID)
+  {
+    static const uint8_t id[3] = {0x54, 0x80, 0x66};
+    if(i < 3)
+      d = id[i];
+  }
+  else if(cmd == EMU_RAMRD || cmd == EMU_RAMRDCONT)
+  {
+    uint16_t col, row, rgb = 0;
+    if(emu_map(madctl, cc, cp, &col, &row))
+      rgb = mem[row][col];
+    if((i & 1) == 0)
+      d = rgb >> 8;
+    else
+    {
+      d = rgb;
+      emu_next();
+    }
+  }
+
+  return d;
+}
+
+//=============================================================================
+/* LCD_IO_* link functions (same byte sequences as lcd_io_gpio8.c) */
+
+void LCD_IO_Delay(uint32_t c)
+{
+  (void)c;
+}
+
+//-----------------------------------------------------------------------------
+void LCD_Delay(uint32_t Delay)
+{
+  (void)Delay;
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_Bl_OnOff(uint8_t Bl)
+{
+  (void)Bl;
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_Init(void)
+{
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd8(uint8_t Cmd)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_cmd(Cmd);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd16(uint16_t Cmd)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteData8(uint8_t Data)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_data(Data);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteData16(uint16_t Data)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_data(Data >> 8);
+  emu_data(Data);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteDataFill16(uint16_t Data, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  while(Size--)
+  {
+    emu_data(Data >> 8);
+    emu_data(Data);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteMultipleData16(uint16_t *pData, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  while(Size--)
+  {
+    emu_data(*pData >> 8);
+    emu_data(*pData);
+    pData++;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteMultipleData8(uint8_t *pData, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_source(pData, Size);
+  while(Size--)
+    emu_data(*pData++);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd8DataFill16(uint8_t Cmd, uint16_t Data, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_cmd(Cmd);
+  while(Size--)
+  {
+    emu_data(Data >> 8);
+    emu_data(Data);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd8MultipleData8(uint8_t Cmd, uint8_t *pData, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_source(pData, Size);
+  emu_cmd(Cmd);
+  while(Size--)
+    emu_data(*pData++);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd8MultipleData16(uint8_t Cmd, uint16_t *pData, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_cmd(Cmd);
+  while(Size--)
+  {
+    emu_data(*pData >> 8);
+    emu_data(*pData);
+    pData++;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd16DataFill16(uint16_t Cmd, uint16_t Data, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+  while(Size--)
+  {
+    emu_data(Data >> 8);
+    emu_data(Data);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd16MultipleData8(uint16_t Cmd, uint8_t *pData, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_source(pData, Size);
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+  while(Size--)
+    emu_data(*pData++);
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_WriteCmd16MultipleData16(uint16_t Cmd, uint16_t *pData, uint32_t Size)
+{
+  EMU_NULL_BUS;
+  stats.transactions++;
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+  while(Size--)
+  {
+    emu_data(*pData >> 8);
+    emu_data(*pData);
+    pData++;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_ReadCmd8MultipleData8(uint8_t Cmd, uint8_t *pData, uint32_t Size, uint32_t DummySize)
+{
+  stats.transactions++;
+  emu_cmd(Cmd);
+  while(DummySize--)
+    emu_read();
+  while(Size--)
+    *pData++ = emu_read();
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_ReadCmd8MultipleData16(uint8_t Cmd, uint16_t *pData, uint32_t Size, uint32_t DummySize)
+{
+  stats.transactions++;
+  emu_cmd(Cmd);
+  while(DummySize--)
+    emu_read();
+  while(Size--)
+  {
+    uint8_t dh = emu_read();
+    uint8_t dl = emu_read();
+    *pData++ = (dh << 8) | dl;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_ReadCmd8MultipleData24to16(uint8_t Cmd, uint16_t *pData, uint32_t Size, uint32_t DummySize)
+{
+  /* The panel runs at 16 bpp: read 16 bit pixels, still 3 strobes each */
+  stats.transactions++;
+  emu_cmd(Cmd);
+  while(DummySize--)
+    emu_read();
+  while(Size--)
+  {
+    uint8_t dh = emu_read();
+    uint8_t dl = emu_read();
+    stats.rd_strobes++;
+    *pData++ = (dh << 8) | dl;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_ReadCmd16MultipleData8(uint16_t Cmd, uint8_t *pData, uint32_t Size, uint32_t DummySize)
+{
+  stats.transactions++;
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+  while(DummySize--)
+    emu_read();
+  while(Size--)
+    *pData++ = emu_read();
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_ReadCmd16MultipleData16(uint16_t Cmd, uint16_t *pData, uint32_t Size, uint32_t DummySize)
+{
+  stats.transactions++;
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+  while(DummySize--)
+    emu_read();
+  while(Size--)
+  {
+    uint8_t dh = emu_read();
+    uint8_t dl = emu_read();
+    *pData++ = (dh << 8) | dl;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LCD_IO_ReadCmd16MultipleData24to16(uint16_t Cmd, uint16_t *pData, uint32_t Size, uint32_t DummySize)
+{
+  stats.transactions++;
+  emu_cmd(Cmd >> 8);
+  emu_cmd(Cmd);
+  while(DummySize--)
+    emu_read();
+  while(Size--)
+  {
+    uint8_t dh = emu_read();
+    uint8_t dl = emu_read();
+    stats.rd_strobes++;
+    *pData++ = (dh << 8) | dl;
+  }
+}
+
+//=============================================================================
+/* Emulator control */
+
+/**
+  * @brief  Power-on state: black panel memory, default MADCTL, stats cleared
+  */
+void lcd_emu_reset(void)
+{
+  memset(mem, 0, sizeof(mem));
+  madctl = view_madctl = 0;
+  view_set = false;
+  sc = sp = cc = cp = 0;
+  ec = EMU_MEM_W - 1;
+  ep = EMU_MEM_H - 1;
+  tfa = 0; vsa = EMU_MEM_H; vsp = 0;
+  cmd = 0;
+  n_param = 0;
+  pixel_half = false;
+  lcd_emu_clear_stats();
+}
+
+//-----------------------------------------------------------------------------
+void lcd_emu_clear_stats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------
+void lcd_emu_get_stats(lcd_emu_stats_t *s)
+{
+  *s = stats;
+}
+
+//-----------------------------------------------------------------------------
+/* Bursts read from [base, base + size) are counted in flash_bytes */
+void lcd_emu_flash_window(const void *base, uint32_t size)
+{
+  flash_base = base;
+  flash_size = size;
+}
+
+//-----------------------------------------------------------------------------
+/* Drop all writes (1) to time the firmware side alone, or decode them (0) */
+void lcd_emu_null_bus(int on)
+{
+  null_bus = on;
+}
+
+//-----------------------------------------------------------------------------
+/* Log every command and address window to f, NULL to stop */
+void lcd_emu_trace(FILE *f)
+{
+  trace = f;
+}
+
+//-----------------------------------------------------------------------------
+uint16_t lcd_emu_width(void)
+{
+  return (view_madctl & EMU_MAD_MV) ? EMU_MEM_H : EMU_MEM_W;
+}
+
+//-----------------------------------------------------------------------------
+uint16_t lcd_emu_height(void)
+{
+  return (view_madctl & EMU_MAD_MV) ? EMU_MEM_W : EMU_MEM_H;
+}
+
+//-----------------------------------------------------------------------------
+/**
+  * @brief  Pixel as seen on the screen, vertical scrolling applied
+  * @param  x, y: screen coordinates (firmware orientation)
+  * @retval RGB565 colour
+  */
+uint16_t lcd_emu_pixel(uint16_t x, uint16_t y)
+{
+  uint16_t col, row;
+
+  if(!emu_map(view_madctl, x, y, &col, &row))
+    return 0;
+
+  /* The scroll area shows memory rows tfa + vsp .. wrapped in the area */
+  if(vsa && row >= tfa && row < tfa + vsa && vsp >= tfa && vsp < tfa + vsa)
+    row = tfa + (row - tfa + vsp - tfa) % vsa;
+
+  return mem[row][col];
+}
+
+//-----------------------------------------------------------------------------
+/* CRC32 (zlib) over bytes */
+static uint32_t emu_crc32(uint32_t crc, const uint8_t *p, uint32_t n)
+{
+  crc = ~crc;
+  while(n--)
+  {
+    crc ^= *p++;
+    for(int k = 0; k < 8; k++)
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+//-----------------------------------------------------------------------------
+/* CRC32 of the screen, RGB565 big-endian row by row */
+uint32_t lcd_emu_crc(void)
+{
+  uint32_t crc = 0;
+
+  for(uint16_t y = 0; y < lcd_emu_height(); y++)
+    for(uint16_t x = 0; x < lcd_emu_width(); x++)
+    {
+      uint16_t rgb = lcd_emu_pixel(x, y);
+      uint8_t b[2] = {rgb >> 8, rgb};
+      crc = emu_crc32(crc, b, 2);
+    }
+  return crc;
+}
+
+//-----------------------------------------------------------------------------
+static void png_u32(uint8_t *p, uint32_t v)
+{
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+//-----------------------------------------------------------------------------
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t size)
+{
+  uint8_t b[4];
+  uint32_t crc;
+
+  png_u32(b, size);
+  fwrite(b, 1, 4, f);
+  fwrite(type, 1, 4, f);
+  fwrite(data, 1, size, f);
+  crc = emu_crc32(0, (const uint8_t *)type, 4);
+  crc = emu_crc32(crc, data, size);
+  png_u32(b, crc);
+  fwrite(b, 1, 4, f);
+}
+
+//-----------------------------------------------------------------------------
+/**
+  * @brief  Dump the screen as an 8 bit RGB PNG (zlib stored blocks, no deps)
+  * @retval 0 if written, -1 on error
+  */
+int lcd_emu_write_png(const char *path)
+{
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  uint16_t w = lcd_emu_width(), h = lcd_emu_height();
+  uint32_t raw_size = (uint32_t)h * (1 + 3 * w);
+  uint32_t n_blocks = (raw_size + 0xFFFE) / 0xFFFF;
+  uint8_t ihdr[13];
+  uint8_t *raw, *z, *q;
+  uint32_t a = 1, b = 0;
+  FILE *f;
+
+  raw = malloc(raw_size);
+  z = malloc(2 + raw_size + 5 * n_blocks + 4);
+  if(raw == NULL || z == NULL)
+  {
+    free(raw);
+    free(z);
+    return -1;
+  }
+
+  /* Filter byte 0, then RGB888 with the low bits replicated */
+  q = raw;
+  for(uint16_t y = 0; y < h; y++)
+  {
+    *q++ = 0;
+    for(uint16_t x = 0; x < w; x++)
+    {
+      uint16_t rgb = lcd_emu_pixel(x, y);
+      uint8_t r = (rgb >> 11) & 0x1F, g = (rgb >> 5) & 0x3F, bl = rgb & 0x1F;
+      *q++ = (r << 3) | (r >> 2);
+      *q++ = (g << 2) | (g >> 4);
+      *q++ = (bl << 3) | (bl >> 2);
+    }
+  }
+
+  /* zlib stream of stored blocks */
+  q = z;
+  *q++ = 0x78;
+  *q++ = 0x01;
+  for(uint32_t i = 0; i < raw_size; i += 0xFFFF)
+  {
+    uint32_t n = raw_size - i < 0xFFFF ? raw_size - i : 0xFFFF;
+    *q++ = (i + n == raw_size);
+    *q++ = n; *q++ = n >> 8;
+    *q++ = ~n; *q++ = ~n >> 8;
+    memcpy(q, raw + i, n);
+    q += n;
+  }
+  for(uint32_t i = 0; i < raw_size; i++)
+  {
+    a = (a + raw[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  png_u32(q, (b << 16) | a);
+  q += 4;
+
+  png_u32(ihdr, w);
+  png_u32(ihdr + 4, h);
+  ihdr[8] = 8;      /* bit depth */
+  ihdr[9] = 2;      /* RGB */
+  ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+  f = fopen(path, "wb");
+  if(f != NULL)
+  {
+    fwrite(signature, 1, sizeof(signature), f);
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    png_chunk(f, "IDAT", z, q - z);
+    png_chunk(f, "IEND", NULL, 0);
+    fclose(f);
+  }
+
+  free(raw);
+  free(z);
+  return f != NULL ? 0 : -1;
+}
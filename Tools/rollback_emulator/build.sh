@@ -0,0 +1,46 @@
+#!/bin/sh
+# Build rollback_test on Linux (gcc, no other dependency)
+# Usage: Tools/rollback_emulator/build.sh [output] [keys directory], from anywhere
+# The keys directory holds the crypto_keys.h to compile in
+# (rollback_roundtrip.sh makes one with a throwaway public key); the key
+# template by default, never Bootloader_E's crypto_keys.h.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+EMU=$ROOT/Tools/crypto_emulator
+OUT=${1:-$HERE/rollback_test}
+KEYS=$2
+if [ -z "$KEYS" ]; then
+	KEYS=$(mktemp -d)
+	trap 'rm -rf "$KEYS"' EXIT
+	cp "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$KEYS/crypto_keys.h"
+fi
+
+cd "$ROOT"
+# -no-pie: HAL_FLASH_Program takes buffer addresses as 32-bit values
+# __ASM: the CMSIS core functions hold ARM instructions, never called here
+# -include: __set_FAULTMASK() for validity.c (cmsis_host.h)
+# --wrap: power loss on flash writes, costs of ECDSA and CRC32, and the
+# backup time (see rollback_test.c)
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+gcc -std=gnu11 -O2 -Wall -Wextra -no-pie \
+  -DSTM32H733xx -DUSE_HAL_DRIVER -DCRC_SOFTWARE '-D__ASM=if (1) {} else __asm__' \
+  -I"$KEYS" -I"$EMU" -include cmsis_host.h -IBootloader_E/Core/Inc -IChecksum -IuECC -IStaging -IW25Q64 \
+  -IBootloader_E/USB_DEVICE/App -IBootloader_E/USB_DEVICE/Target \
+  -isystem Bootloader_E/Middlewares/ST/STM32_USB_Device_Library/Core/Inc \
+  -isystem Bootloader_E/Middlewares/ST/STM32_USB_Device_Library/Class/CDC/Inc \
+  -isystem Bootloader_E/Drivers/CMSIS/Device/ST/STM32H7xx/Include \
+  -isystem Bootloader_E/Drivers/CMSIS/Include \
+  -isystem Bootloader_E/Drivers/STM32H7xx_HAL_Driver/Inc \
+  -Wl,--wrap=HAL_FLASH_Program,--wrap=HAL_FLASHEx_Erase \
+  -Wl,--wrap=Crypto_ECDSA_VerifyHash,--wrap=crc32_ieee \
+  -Wl,--wrap=rollback_clear,--wrap=rollback_write_record \
+  "$HERE/rollback_test.c" "$EMU/crypto_emu.c" \
+  Bootloader_E/Core/Src/bootload.c Bootloader_E/Core/Src/validity.c \
+  Bootloader_E/Core/Src/crypto.c Bootloader_E/Core/Src/decompress.c \
+  Bootloader_E/Core/Src/delta.c Staging/staging.c Staging/rollback.c \
+  Checksum/checksum.c Checksum/sha256.c uECC/uECC.c \
+  -o "$OUT"
+
+echo "$OUT"
@@ -0,0 +1,59 @@
+#!/bin/sh
+# Install an old and a new firmware with rollback_test: backup, trial boots,
+# confirmation, restore after unconfirmed boots, power cuts mid-restore and
+# a tampered backup.
+# Usage: Tools/rollback_emulator/rollback_roundtrip.sh [old.bin new.bin]
+# Without images a synthetic pair stands in (the real LeShuffler.bin needs
+# the ARM toolchain): a vector table, then Thumb-like code, 384 KB and
+# 400 KB. The key template's AES key and a throwaway ECDSA key are used,
+# never the real keys.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+if [ $# -eq 2 ]; then
+	OLD=$1
+	NEW=$2
+else
+	OLD=$TMP/old.bin
+	NEW=$TMP/new.bin
+	python3 - "$OLD" "$NEW" <<'PY'
+import random, struct, sys
+ops = [0x4770, 0xB580, 0x2000, 0x6803, 0xF000, 0xE7FE]
+for seed, path, size in ((1, sys.argv[1], 384 * 1024), (2, sys.argv[2], 400 * 1024)):
+    random.seed(seed)
+    vectors = struct.pack('<2I', 0x24050000, 0x08020299) + bytes(0x290)
+    code = b''.join(struct.pack('<H', random.choice(ops) if random.random() < 0.6
+                                else random.getrandbits(16)) for _ in range(size // 2))
+    open(path, 'wb').write((vectors + code)[:size])
+PY
+fi
+
+# Throwaway ECDSA key, the template's AES key, and a crypto_keys.h to match
+python3 "$ROOT/Tools/encrypt_firmware.py" --generate-keys "$TMP/keys.json" > /dev/null
+python3 - "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$TMP/keys.json" "$TMP/crypto_keys.h" <<'PY'
+import json, re, sys
+text = open(sys.argv[1]).read()
+body = re.search(r'AES_KEY\s*\[\s*32\s*\]\s*=\s*\{(.*?)\}', text, re.S).group(1)
+key = bytes(int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{2})', re.sub(r'/\*.*?\*/', '', body)))
+keys = json.load(open(sys.argv[2]))
+keys['aes_key'] = key.hex()
+json.dump(keys, open(sys.argv[2], 'w'))
+public = bytes.fromhex(keys['ecdsa_public_key'])
+rows = ',\n'.join('    ' + ', '.join('0x%02X' % b for b in public[i:i + 8]) for i in range(0, 64, 8))
+text = re.sub(r'(ECDSA_PUBLIC_KEY\s*\[\s*64\s*\]\s*=\s*\{).*?\}', lambda m: m.group(1) + '\n' + rows + ',\n}', text, flags=re.S)
+open(sys.argv[3], 'w').write(text)
+PY
+
+"$HERE/build.sh" "$TMP/rollback_test" "$TMP" > /dev/null
+
+python3 "$ROOT/Tools/encrypt_firmware.py" "$OLD" "$TMP/old.sfu" \
+	--keys "$TMP/keys.json" > /dev/null
+python3 "$ROOT/Tools/encrypt_firmware.py" "$NEW" "$TMP/new.sfu" \
+	--keys "$TMP/keys.json" --compress > /dev/null
+
+"$TMP/rollback_test" --old "$OLD" --old-sfu "$TMP/old.sfu" \
+	--new "$NEW" --new-sfu "$TMP/new.sfu"
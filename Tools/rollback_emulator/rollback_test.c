@@ -0,0 +1,696 @@
+/*
+ * rollback_test: Bootloader_E's rollback slot and trial boots on Linux
+ *
+ * Runs the unmodified Bootloader_E/Core/Src/bootload.c and validity.c, and
+ * Staging/rollback.c and staging.c, on the emulated flash, CRYP and HASH of
+ * Tools/crypto_emulator and a W25Q in RAM. Each "boot" follows the decisions
+ * of Bootloader_E/Core/Src/main.c after a reset; when it starts the
+ * application, the application confirms itself (rollback_confirm()) or not,
+ * as the scenario wants. Scenarios, from an erased flash and W25Q:
+ *   first install  --old is installed from the staging area: nothing to
+ *                  back up, not on trial
+ *   install        --new is staged and installed over it: the old image is
+ *                  backed up first and the new one goes on trial
+ *   confirmed      the new image confirms itself at its first boot: the
+ *                  next boot records it and it stays
+ *   not confirmed  the new image never confirms itself: after
+ *                  ROLLBACK_TRIAL_BOOTS boots the old image is restored
+ *   restore cut    power lost at points spread over the restore, then
+ *                  reset: the restore runs again and the old image is back
+ *   tampered       one byte of the backup flipped: refused, backup dropped,
+ *                  the bootloader stays in USB mode
+ * Power loss is a budget of W25Q and flash writes and erases; once spent,
+ * every W25Q and flash operation fails until the next boot.
+ *
+ * Time: crypto_emu's virtual clock. Flash word programming, sector erase,
+ * CRYP and HASH are costed there; W25Q reads (quad output at 64 MHz),
+ * page programs (400 us) and erases (45 / 120 / 150 ms for 4 / 32 / 64 KB)
+ * are charged the typical figures of Tools/flash_emulator, and ECDSA and
+ * CRC32 the assumed costs of bl_emu. Reported: backup and restore times.
+ *
+ * Usage: rollback_test --old FILE --old-sfu FILE --new FILE --new-sfu FILE
+ * The bootloader's public key must be the one the .sfu files were signed
+ * with and its AES key the template's: see rollback_roundtrip.sh.
+ */
+
+#include <bootload.h>
+#include <checksum.h>
+#include <crypto.h>
+#include <main.h>
+#include <rollback.h>
+#include <staging.h>
+#include <validity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "crypto_emu.h"
+
+#define APPLICATION_ADDRESS	0x08020000UL	// Bootloader_E main.c
+#define APP_SIZE			(768 * 1024)	// Sectors 1-6, the validity log after
+#define BANK_BASE			0x08000000UL	// Bootloader sector, then the application
+#define BANK_SIZE			(1024 * 1024)
+#define W25Q_SIZE			0x01000000UL	// 24-bit addresses
+
+// W25Q typicals (Tools/flash_emulator), bootloader-side assumptions (bl_emu)
+#define W25Q_BUS_MHZ		64.0
+#define W25Q_CALL_NS		1000.0
+#define W25Q_TPP_NS			400e3
+#define W25Q_TSE_NS			45e6
+#define W25Q_TBE32_NS		120e6
+#define W25Q_TBE64_NS		150e6
+#define ECDSA_NS			1500e6
+#define CRC_NS_PER_BYTE		(1 / 64e-3)		// 1 cycle per byte at 64 MHz
+
+/* Peripherals the bootloader touches directly ------------------------------*/
+
+RTC_HandleTypeDef hrtc;
+OSPI_HandleTypeDef hospi2;
+
+// FLASH->CR1 (lock), FLASH->CCR1 (flag clear), SCB->CCR (validity.c's
+// guarded reads) and IWDG1->KR are written directly: their pages are real
+// memory
+static void map_registers(uintptr_t address)
+{
+	uintptr_t page = address & ~(uintptr_t) 0xFFF;
+
+	if (mmap((void*) page, 0x1000, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+			!= (void*) page)
+	{
+		perror("rollback_test: registers");
+		exit(2);
+	}
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	FLASH->CR1 &= ~FLASH_CR_LOCK;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	FLASH->CR1 |= FLASH_CR_LOCK;
+	return HAL_OK;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	crypto_emu_cpu(Delay * 1e6);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+		GPIO_PinState PinState)
+{
+	(void) GPIOx;
+	(void) GPIO_Pin;
+	(void) PinState;
+}
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+}
+
+void HAL_RTCEx_BKUPWrite(const RTC_HandleTypeDef *hrtc, uint32_t BackupRegister,
+		uint32_t Data)
+{
+	(void) hrtc;
+	(void) BackupRegister;
+	(void) Data;
+}
+
+// No USB session here: the update protocol is bl_emu's
+void CDC_ClearPacketState(void)
+{
+}
+
+void CDC_SetStreamMode(uint32_t frame_size)
+{
+	(void) frame_size;
+}
+
+/* Power ---------------------------------------------------------------------*/
+
+static long power_budget = -1;		// writes left before power loss, -1: none
+static long next_budget = -1;		// power_budget of the next boot
+static int powered = 1;
+static long spent;					// writes and erases since the last boot
+
+// Emulated power: a write past the budget fails and cuts everything
+static int spend(void)
+{
+	if (!powered)
+		return 0;
+	if (power_budget == 0)
+	{
+		powered = 0;
+		return 0;
+	}
+	if (power_budget > 0)
+		power_budget--;
+	spent++;
+	return 1;
+}
+
+/* W25Q64 --------------------------------------------------------------------*/
+
+static uint8_t w25q[W25Q_SIZE];
+static double w25q_busy_until;		// end of the running program / erase
+static double w25q_read_ns, w25q_program_ns, w25q_erase_ns;
+
+// Every command waits for the one before (BUSY polled), then its bus phases
+static void w25q_command(double bus_cycles)
+{
+	double wait = w25q_busy_until - crypto_emu_now_ns();
+
+	if (wait > 0)
+		crypto_emu_cpu(wait);
+	crypto_emu_cpu(W25Q_CALL_NS + bus_cycles * 1e3 / W25Q_BUS_MHZ);
+}
+
+void MX_OCTOSPI2_Init(void)
+{
+}
+
+HAL_StatusTypeDef W25Q64_OCTO_SPI_Init(OSPI_HandleTypeDef *hospi)
+{
+	(void) hospi;
+
+	return powered ? HAL_OK : HAL_ERROR;
+}
+
+// Fast read quad output: command, address, dummy cycles, 2 clocks per byte
+HAL_StatusTypeDef W25Q64_OSPI_Read(OSPI_HandleTypeDef *hospi, uint8_t *pData,
+		uint32_t ReadAddr, uint32_t Size)
+{
+	double start = crypto_emu_now_ns();
+
+	(void) hospi;
+
+	if (!powered || ReadAddr + Size > W25Q_SIZE)
+		return HAL_ERROR;
+	w25q_command(8 + 24 + 8 + 2.0 * Size);
+	memcpy(pData, w25q + ReadAddr, Size);
+	w25q_read_ns += crypto_emu_now_ns() - start;
+	return HAL_OK;
+}
+
+// Page by page, each programmed before the next is sent. Programming
+// clears bits only: a write to an unerased sector shows up.
+HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef *hospi, uint8_t *pData,
+		uint32_t WriteAddr, uint32_t Size)
+{
+	double start = crypto_emu_now_ns();
+
+	(void) hospi;
+
+	if (WriteAddr + Size > W25Q_SIZE || !spend())
+		return HAL_ERROR;
+	while (Size > 0)
+	{
+		uint32_t n = W25Q_PAGE_SIZE - WriteAddr % W25Q_PAGE_SIZE;
+
+		if (n > Size)
+			n = Size;
+		w25q_command(8 + 8 + 24 + 2.0 * n);
+		for (uint32_t i = 0; i < n; i++)
+			w25q[WriteAddr + i] &= pData[i];
+		w25q_busy_until = crypto_emu_now_ns() + W25Q_TPP_NS;
+		WriteAddr += n;
+		pData += n;
+		Size -= n;
+	}
+	w25q_command(0);
+	w25q_program_ns += crypto_emu_now_ns() - start;
+	return HAL_OK;
+}
+
+// Returns while the erase runs, as the driver does
+HAL_StatusTypeDef W25Q64_OSPI_EraseBlockStart(OSPI_HandleTypeDef *hospi,
+		uint32_t BlockAddress, uint32_t BlockSize)
+{
+	double t = BlockSize == W25Q_BLOCK64_SIZE ? W25Q_TBE64_NS :
+				BlockSize == W25Q_BLOCK32_SIZE ? W25Q_TBE32_NS :
+				BlockSize == W25Q_SECTOR_SIZE ? W25Q_TSE_NS : -1;
+
+	(void) hospi;
+	if (t < 0 || BlockAddress % BlockSize
+			|| BlockAddress + BlockSize > W25Q_SIZE || !spend())
+		return HAL_ERROR;
+	w25q_command(8 + 8 + 24);
+	memset(w25q + BlockAddress, 0xFF, BlockSize);
+	w25q_busy_until = crypto_emu_now_ns() + t;
+	w25q_erase_ns += t;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef W25Q64_OSPI_AutoPollingMemReady(OSPI_HandleTypeDef *hospi)
+{
+	(void) hospi;
+
+	if (!powered)
+		return HAL_ERROR;
+	w25q_command(16);
+	return HAL_OK;
+}
+
+// As W25Q64/W25Q64.c: the largest block that fits, sectors at the ends
+HAL_StatusTypeDef W25Q64_OSPI_EraseRange(OSPI_HandleTypeDef *hospi,
+		uint32_t StartAddress, uint32_t EndAddress)
+{
+	uint32_t address = StartAddress - StartAddress % W25Q_SECTOR_SIZE;
+
+	EndAddress = (EndAddress + W25Q_SECTOR_SIZE - 1) / W25Q_SECTOR_SIZE
+			* W25Q_SECTOR_SIZE;
+	while (address < EndAddress)
+	{
+		uint32_t size = W25Q_SECTOR_SIZE;
+
+		if (address % W25Q_BLOCK64_SIZE == 0
+				&& EndAddress >= address + W25Q_BLOCK64_SIZE)
+			size = W25Q_BLOCK64_SIZE;
+		else if (address % W25Q_BLOCK32_SIZE == 0
+				&& EndAddress >= address + W25Q_BLOCK32_SIZE)
+			size = W25Q_BLOCK32_SIZE;
+		if (W25Q64_OSPI_EraseBlockStart(hospi, address, size) != HAL_OK)
+			return HAL_ERROR;
+		address += size;
+	}
+	return W25Q64_OSPI_AutoPollingMemReady(hospi);
+}
+
+/* Power and costs of what runs natively (linked with --wrap) ----------------*/
+
+static double backup_start_ns, backup_ns;
+
+HAL_StatusTypeDef __real_HAL_FLASH_Program(uint32_t TypeProgram,
+		uint32_t FlashAddress, uint32_t DataAddress);
+HAL_StatusTypeDef __real_HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+		uint32_t *SectorError);
+int32_t __real_Crypto_ECDSA_VerifyHash(const uint8_t *hash,
+		const uint8_t *signature);
+uint32_t __real_crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length);
+HAL_StatusTypeDef __real_rollback_clear(OSPI_HandleTypeDef *hospi);
+HAL_StatusTypeDef __real_rollback_write_record(OSPI_HandleTypeDef *hospi,
+		rollback_record_t *record);
+
+HAL_StatusTypeDef __wrap_HAL_FLASH_Program(uint32_t TypeProgram,
+		uint32_t FlashAddress, uint32_t DataAddress)
+{
+	if (!spend())
+		return HAL_ERROR;
+	return __real_HAL_FLASH_Program(TypeProgram, FlashAddress, DataAddress);
+}
+
+HAL_StatusTypeDef __wrap_HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+		uint32_t *SectorError)
+{
+	if (!spend())
+		return HAL_ERROR;
+	return __real_HAL_FLASHEx_Erase(pEraseInit, SectorError);
+}
+
+int32_t __wrap_Crypto_ECDSA_VerifyHash(const uint8_t *hash,
+		const uint8_t *signature)
+{
+	crypto_emu_cpu(ECDSA_NS);
+	return __real_Crypto_ECDSA_VerifyHash(hash, signature);
+}
+
+uint32_t __wrap_crc32_ieee(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	crypto_emu_cpu(length * CRC_NS_PER_BYTE);
+	return __real_crc32_ieee(crc, data, length);
+}
+
+// A backup starts by erasing the record and ends by writing it
+HAL_StatusTypeDef __wrap_rollback_clear(OSPI_HandleTypeDef *hospi)
+{
+	backup_start_ns = crypto_emu_now_ns();
+	return __real_rollback_clear(hospi);
+}
+
+HAL_StatusTypeDef __wrap_rollback_write_record(OSPI_HandleTypeDef *hospi,
+		rollback_record_t *record)
+{
+	HAL_StatusTypeDef status = __real_rollback_write_record(hospi, record);
+
+	if (status == HAL_OK)
+		backup_ns = crypto_emu_now_ns() - backup_start_ns;
+	return status;
+}
+
+/* Boots ---------------------------------------------------------------------*/
+
+typedef enum
+{
+	BOOT_APP,		// Application started
+	BOOT_RESET,		// Bootloader reset the device
+	BOOT_USB		// Bootloader waits for a USB update
+} boot_t;
+
+static uint8_t old_image[APP_SIZE], new_image[APP_SIZE];
+static long old_size, new_size;
+static uint8_t old_sfu[sizeof(SFU_Header_t) + STAGING_PAYLOAD_MAX];
+static uint8_t new_sfu[sizeof(SFU_Header_t) + STAGING_PAYLOAD_MAX];
+static long old_sfu_size, new_sfu_size;
+
+static int new_confirms;			// The new image confirms itself when run
+static int old_runs, new_runs;
+
+static uint8_t* app(void)
+{
+	return crypto_emu_flash();
+}
+
+static int app_is(const uint8_t *image, long size)
+{
+	for (long i = size; i < APP_SIZE; i++)
+	{
+		if (app()[i] != 0xFF)
+			return 0;
+	}
+	return memcmp(app(), image, size) == 0;
+}
+
+// The application started: which one, and does it confirm itself
+static void run_application(void)
+{
+	if (app_is(new_image, new_size))
+	{
+		new_runs++;
+		if (new_confirms)
+			rollback_confirm(&hospi2);
+	}
+	else if (app_is(old_image, old_size))
+		old_runs++;
+}
+
+// Bootloader_E/Core/Src/main.c from a reset, without the USB session
+static boot_t boot(uint8_t install_requested)
+{
+	uint8_t application_valid;
+
+	power_budget = next_budget;
+	next_budget = -1;
+	powered = 1;
+	spent = 0;
+	FLASH->CR1 = FLASH_CR_LOCK;
+
+	// Early jump, before any init
+	ValidityState_t validity = Validity_Check();
+	uint32_t early_app_stack = *((uint32_t*) APPLICATION_ADDRESS);
+	if (!install_requested
+			&& (validity == VALIDITY_OK
+					|| (validity == VALIDITY_NONE
+							&& ((early_app_stack & 0xFFF00000) == 0x20000000
+									|| (early_app_stack & 0xFFF00000)
+											== 0x24000000))))
+		return BOOT_APP;
+
+	Crypto_Init();
+	application_valid = Validity_ApplicationValid(Validity_Check());
+	if (application_valid && !install_requested
+			&& Validity_Check() == VALIDITY_OK)
+		return BOOT_RESET;
+
+	if (application_valid && !install_requested
+			&& Validity_Check() == VALIDITY_TRIAL)
+	{
+		switch (CheckTrialBoot())
+		{
+		case TRIAL_RUN:
+			return BOOT_APP;
+		case TRIAL_CONFIRMED:
+			return BOOT_RESET;
+		default:
+			application_valid = 0;
+			break;
+		}
+	}
+
+	if (install_requested || !application_valid)
+	{
+		if (InstallStagedFirmware() == HAL_OK
+				|| (!application_valid && RestoreBackup() == HAL_OK))
+			return BOOT_RESET;
+		application_valid = Validity_ApplicationValid(Validity_Check());
+		if (install_requested && application_valid)
+			return BOOT_RESET;
+	}
+
+	// Bootloader mode: with a valid application, it starts after the timeout
+	return application_valid ? BOOT_APP : BOOT_USB;
+}
+
+// Boot, run the application if started, until it is or USB mode is reached
+static boot_t run(uint8_t install_requested)
+{
+	for (int i = 0; i < 16; i++)
+	{
+		boot_t result = boot(install_requested);
+
+		install_requested = 0;		// Cleared by the first boot
+		if (result == BOOT_APP)
+			run_application();
+		if (result != BOOT_RESET)
+			return result;
+	}
+	return BOOT_RESET;
+}
+
+// The application stages an .sfu: payload, then the record
+static void stage(const uint8_t *sfu, long size)
+{
+	static staging_record_t record;
+
+	memset(w25q + STAGING_OFFSET, 0xFF, STAGING_SIZE);
+	memcpy(w25q + STAGING_PAYLOAD_OFFSET, sfu + sizeof(SFU_Header_t),
+			size - sizeof(SFU_Header_t));
+	memset(&record, 0, sizeof(record));
+	memcpy(&record.header, sfu, sizeof(SFU_Header_t));
+	staging_write_record(&hospi2, &record);
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static int failures;
+
+static void expect(const char *what, int ok)
+{
+	printf("  %-48s %s\n", what, ok ? "OK" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+static int kept(void)
+{
+	rollback_record_t record;
+
+	return rollback_read_record(&hospi2, &record) == HAL_OK;
+}
+
+// Flash bank and W25Q, to start several scenarios from the same state
+static uint8_t saved_bank[BANK_SIZE];
+static uint8_t saved_w25q[W25Q_SIZE];
+
+static void save(void)
+{
+	memcpy(saved_bank, (void*) BANK_BASE, BANK_SIZE);
+	memcpy(saved_w25q, w25q, W25Q_SIZE);
+}
+
+static void restore(void)
+{
+	memcpy((void*) BANK_BASE, saved_bank, BANK_SIZE);
+	memcpy(w25q, saved_w25q, W25Q_SIZE);
+	old_runs = new_runs = 0;
+}
+
+static void stats_start(crypto_emu_stats_t *s, double *w)
+{
+	crypto_emu_get_stats(s);
+	w[0] = crypto_emu_now_ns();
+	w[1] = w25q_read_ns;
+	w[2] = w25q_program_ns;
+	w[3] = w25q_erase_ns;
+}
+
+static void stats_print(const char *what, const crypto_emu_stats_t *s0,
+		const double *w0)
+{
+	crypto_emu_stats_t s;
+
+	crypto_emu_get_stats(&s);
+	printf("  %s %.0f ms: flash erase %.0f ms, flash program %.0f ms, "
+			"W25Q read %.0f ms / program %.0f ms / erase %.0f ms, "
+			"CRYP %.0f ms, HASH %.0f ms\n", what,
+			(crypto_emu_now_ns() - w0[0]) / 1e6,
+			(s.erase_ns - s0->erase_ns) / 1e6,
+			(s.flash_ns - s0->flash_ns) / 1e6, (w25q_read_ns - w0[1]) / 1e6,
+			(w25q_program_ns - w0[2]) / 1e6, (w25q_erase_ns - w0[3]) / 1e6,
+			(s.cryp_ns - s0->cryp_ns) / 1e6, (s.hash_ns - s0->hash_ns) / 1e6);
+}
+
+static long load(const char *path, uint8_t *buf, long max)
+{
+	FILE *f = fopen(path, "rb");
+	long size;
+
+	if (!f)
+		return -1;
+	size = fread(buf, 1, max, f);
+	if (fgetc(f) != EOF)
+		size = -1;
+	fclose(f);
+	return size;
+}
+
+static int sfu_of(const uint8_t *sfu, long sfu_size, long image_size)
+{
+	SFU_Header_t header;
+
+	if (sfu_size < (long) sizeof(SFU_Header_t))
+		return 0;
+	memcpy(&header, sfu, sizeof(header));
+	return staging_header_valid(&header) && header.magic != SFU_MAGIC_DELTA
+			&& header.firmware_size == sfu_size - sizeof(SFU_Header_t)
+			&& header.original_size == image_size;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *old_path = NULL, *old_sfu_path = NULL;
+	const char *new_path = NULL, *new_sfu_path = NULL;
+	crypto_emu_stats_t s, s0;
+	double w0[4];
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--old") == 0 && i + 1 < argc)
+			old_path = argv[++i];
+		else if (strcmp(argv[i], "--old-sfu") == 0 && i + 1 < argc)
+			old_sfu_path = argv[++i];
+		else if (strcmp(argv[i], "--new") == 0 && i + 1 < argc)
+			new_path = argv[++i];
+		else if (strcmp(argv[i], "--new-sfu") == 0 && i + 1 < argc)
+			new_sfu_path = argv[++i];
+		else
+			old_path = NULL, i = argc;
+	}
+	if (!old_path || !old_sfu_path || !new_path || !new_sfu_path)
+	{
+		fprintf(stderr, "Usage: %s --old FILE --old-sfu FILE --new FILE "
+				"--new-sfu FILE\n", argv[0]);
+		return 2;
+	}
+
+	old_size = load(old_path, old_image, sizeof(old_image));
+	new_size = load(new_path, new_image, sizeof(new_image));
+	old_sfu_size = load(old_sfu_path, old_sfu, sizeof(old_sfu));
+	new_sfu_size = load(new_sfu_path, new_sfu, sizeof(new_sfu));
+	if (old_size <= 0 || new_size <= 0
+			|| !sfu_of(old_sfu, old_sfu_size, old_size)
+			|| !sfu_of(new_sfu, new_sfu_size, new_size))
+	{
+		fprintf(stderr, "%s and %s must be full .sfu files of %s and %s\n",
+				old_sfu_path, new_sfu_path, old_path, new_path);
+		return 2;
+	}
+	printf("old image %ld bytes, new image %ld bytes\n", old_size, new_size);
+
+	// Power-on: erased flash and W25Q, flash locked
+	crypto_emu_reset(&crypto_emu_typical);
+	map_registers((uintptr_t) FLASH);
+	map_registers((uintptr_t) IWDG1);
+	map_registers((uintptr_t) SCB);
+	memset(w25q, 0xFF, sizeof(w25q));
+
+	printf("first install\n");
+	stage(old_sfu, old_sfu_size);
+	expect("installed, started", run(1) == BOOT_APP);
+	expect("application is the old image", app_is(old_image, old_size));
+	expect("recorded without trial", Validity_Check() == VALIDITY_OK);
+	expect("no backup (nothing installed before)", !kept());
+
+	printf("install\n");
+	stage(new_sfu, new_sfu_size);
+	backup_ns = 0;
+	stats_start(&s0, w0);
+	expect("installed", boot(1) == BOOT_RESET);
+	stats_print("install", &s0, w0);
+	printf("  of which backup %.0f ms\n", backup_ns / 1e6);
+	expect("application is the new image", app_is(new_image, new_size));
+	expect("recorded on trial", Validity_Check() == VALIDITY_TRIAL);
+	expect("old image backed up", kept());
+	save();
+
+	printf("confirmed\n");
+	new_confirms = 1;
+	expect("new image started", run(0) == BOOT_APP && new_runs == 1);
+	expect("confirmation recorded, started",
+			run(0) == BOOT_APP && new_runs == 2);
+	expect("recorded without trial", Validity_Check() == VALIDITY_OK);
+	expect("application is the new image", app_is(new_image, new_size));
+
+	printf("not confirmed\n");
+	restore();
+	new_confirms = 0;
+	for (int i = 0; i < ROLLBACK_TRIAL_BOOTS; i++)
+		run(0);
+	expect("new image started for every trial boot",
+			new_runs == ROLLBACK_TRIAL_BOOTS && old_runs == 0);
+	save();
+	stats_start(&s0, w0);
+	expect("restored", boot(0) == BOOT_RESET);
+	long restore_writes = spent;
+	stats_print("restore", &s0, w0);
+	expect("application is the old image", app_is(old_image, old_size));
+	expect("recorded without trial", Validity_Check() == VALIDITY_OK);
+	expect("old image started", run(0) == BOOT_APP && old_runs == 1);
+	expect("backup kept", kept());
+
+	printf("restore cut\n");
+	int cuts_ok = 0, cuts = 0;
+	for (int k = 0; k <= 12; k++)
+	{
+		// From the restore mark to the validity record, both included
+		long budget = k * (restore_writes - 1) / 12;
+
+		restore();
+		next_budget = budget;
+		boot(0);
+		int cut = !powered;
+		boot_t result = run(0);
+
+		cuts++;
+		if (cut && result == BOOT_APP && old_runs == 1 && new_runs == 0
+				&& app_is(old_image, old_size)
+				&& Validity_Check() == VALIDITY_OK)
+			cuts_ok++;
+		else
+			printf("  cut after %ld of %ld writes: %s\n", budget,
+					restore_writes, cut ? "not restored" : "no power loss");
+	}
+	char line[64];
+	snprintf(line, sizeof(line), "old image back after %d of %d cuts", cuts_ok,
+			cuts);
+	expect(line, cuts_ok == cuts);
+
+	printf("tampered\n");
+	restore();
+	w25q[ROLLBACK_IMAGE_OFFSET + old_size / 2] ^= 0x01;
+	expect("refused, bootloader in USB mode", run(0) == BOOT_USB);
+	expect("old image not started", old_runs == 0);
+	expect("backup dropped", !kept());
+	expect("application invalid",
+			!Validity_ApplicationValid(Validity_Check()));
+	expect("still in USB mode at the next boot", run(0) == BOOT_USB);
+
+	crypto_emu_get_stats(&s);
+	expect("no emulator violations", s.violations == 0);
+	printf("%s\n", failures ? "FAILED" : "all scenarios OK");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+#!/bin/sh
+# Build validity_test on Linux (gcc, no other dependency)
+# Usage: Tools/validity_emulator/build.sh [output], from anywhere
+# The record tag is keyed with the key template's AES key, never
+# Bootloader_E's crypto_keys.h.
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+EMU=$ROOT/Tools/crypto_emulator
+OUT=${1:-$HERE/validity_test}
+KEYS=$(mktemp -d)
+trap 'rm -rf "$KEYS"' EXIT
+cp "$ROOT/Bootloader_E/Core/Inc/crypto_keys.h.template" "$KEYS/crypto_keys.h"
+
+cd "$ROOT"
+# -no-pie: HAL_FLASH_Program takes buffer addresses as 32-bit values
+# __ASM: the CMSIS core functions hold ARM instructions, never called here
+# -isystem: no warnings from the vendor headers (64-bit pointer casts)
+# -include: __set_FAULTMASK() for validity.c (cmsis_host.h)
+# --wrap: power loss on flash writes, tags counted (see validity_test.c)
+gcc -std=gnu11 -O2 -Wall -Wextra -no-pie \
+  -DSTM32H733xx -DUSE_HAL_DRIVER -DCRC_SOFTWARE '-D__ASM=if (1) {} else __asm__' \
+  -I"$KEYS" -I"$EMU" -include cmsis_host.h -IBootloader_E/Core/Inc -IChecksum -IuECC -IStaging \
+  -isystem Bootloader_E/Drivers/CMSIS/Device/ST/STM32H7xx/Include \
+  -isystem Bootloader_E/Drivers/CMSIS/Include \
+  -isystem Bootloader_E/Drivers/STM32H7xx_HAL_Driver/Inc \
+  -Wl,--wrap=HAL_FLASH_Program,--wrap=HAL_FLASHEx_Erase \
+  -Wl,--wrap=Crypto_RecordTag \
+  "$HERE/validity_test.c" "$EMU/crypto_emu.c" \
+  Bootloader_E/Core/Src/validity.c Bootloader_E/Core/Src/crypto.c \
+  Checksum/checksum.c Checksum/sha256.c uECC/uECC.c \
+  -o "$OUT"
+
+echo "$OUT"
@@ -0,0 +1,639 @@
+/*
+ * validity_test: Bootloader_E's application validity log on Linux, with
+ * power cuts, ECC errors, forged records and wrap-around
+ *
+ * Runs the unmodified Bootloader_E/Core/Src/validity.c and the record tag
+ * of crypto.c on the crypto_emulator flash model (bank 1 at 0x08000000,
+ * flash word programming, sector erase). A power cut while a flash word is
+ * programmed leaves it half-written and failing its ECC check: its page is
+ * protected, and a read of the word sets FLASH->SR1 DBECCERR when
+ * FAULTMASK and SCB->CCR.BFHFNMIGN are set, as the target ignores the bus
+ * error then, and is a HardFault otherwise (counted, the boot abandoned).
+ * Writes to FLASH->CCR1 clear SR1 flags. A power cut during the log erase
+ * leaves each flash word of the sector erased or damaged at random.
+ *
+ * The application is a small image written straight to flash: the log is
+ * under test, not the install (rollback_emulator and bl_emu run those).
+ * Power-on follows Bootloader_E main.c: the early jump on VALIDITY_OK, or
+ * on VALIDITY_NONE with a stack pointer in RAM, else the decision after
+ * init (Validity_ApplicationValid()).
+ *
+ * It reports the flash words and tags the power-on check costs, and an
+ * estimate of its time on the target from the cycle assumptions below.
+ *
+ * Usage: validity_test
+ */
+
+#define _GNU_SOURCE		// REG_ERR, REG_EFL
+#include <checksum.h>
+#include <crypto.h>
+#include <main.h>
+#include <validity.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#include "crypto_emu.h"
+
+#define APPLICATION_ADDRESS	0x08020000UL	// Bootloader_E main.c
+#define IMAGE_SIZE			(8 * 1024)
+#define PAGE_SIZE			0x1000UL
+#define UPDATES				1500			// Wrap-around: 3 records each
+
+// Target estimate: assumptions, not measurements. At reset the core runs
+// on HSI at 64 MHz, caches off, flash with its reset wait states.
+#define CPU_MHZ				64.0
+#define WORD_READ_CYCLES	10.0	// One 32-bit flash read, uncached
+#define SIPROUND_CYCLES		30.0	// 64-bit adds, rotates, XORs on 32-bit registers
+#define CHECK_CYCLES		400.0	// Search, compares and calls around them
+
+static int failures;
+
+static void expect(const char *what, int ok)
+{
+	printf("  %-50s %s\n", what, ok ? "OK" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+/* Registers ------------------------------------------------------------------*/
+
+// FLASH, IWDG1 and SCB are written directly: their pages are real memory
+static void map_registers(uintptr_t address)
+{
+	uintptr_t page = address & ~(PAGE_SIZE - 1);
+
+	if (mmap((void*) page, PAGE_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+			!= (void*) page)
+	{
+		perror("validity_test: registers");
+		exit(2);
+	}
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	FLASH->CR1 &= ~FLASH_CR_LOCK;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	FLASH->CR1 |= FLASH_CR_LOCK;
+	return HAL_OK;
+}
+
+// bootload.c's, for validity.c
+HAL_StatusTypeDef FlashUnlock(void)
+{
+	return HAL_FLASH_Unlock();
+}
+
+HAL_StatusTypeDef FlashLock(void)
+{
+	return HAL_FLASH_Lock();
+}
+
+/* ECC errors -----------------------------------------------------------------*/
+
+/* Pages holding a damaged word, the whole log while reads are counted, and
+ * the FLASH registers (writes, for CCR1) are protected. A fault is handled
+ * and the page opened for one instruction (trap flag), then closed again. */
+
+static uint8_t damaged[VALIDITY_SLOTS];	// Slot's flash word fails its ECC check
+static int count_reads;						// Whole log protected
+static long log_reads;						// 32-bit reads of the log counted
+static long hard_faults;
+static sigjmp_buf fault_exit;
+static uintptr_t open_page;
+
+static uintptr_t flash_page(void)
+{
+	return (uintptr_t) FLASH & ~(PAGE_SIZE - 1);
+}
+
+static void protect_pages(void)
+{
+	for (uintptr_t page = VALIDITY_LOG_ADDRESS;
+			page < VALIDITY_LOG_ADDRESS + VALIDITY_LOG_SIZE; page += PAGE_SIZE)
+	{
+		uint32_t first = (page - VALIDITY_LOG_ADDRESS) / VALIDITY_RECORD_SIZE;
+		int closed = count_reads;
+
+		for (uint32_t i = 0; i < PAGE_SIZE / VALIDITY_RECORD_SIZE; i++)
+			closed |= damaged[first + i];
+		mprotect((void*) page, PAGE_SIZE,
+				closed ? PROT_NONE : PROT_READ | PROT_WRITE);
+	}
+	mprotect((void*) flash_page(), PAGE_SIZE, PROT_READ);
+}
+
+static void on_fault(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = context;
+	uintptr_t address = (uintptr_t) info->si_addr;
+	int write = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+
+	(void) sig;
+	if (address >= VALIDITY_LOG_ADDRESS
+			&& address < VALIDITY_LOG_ADDRESS + VALIDITY_LOG_SIZE)
+	{
+		uint32_t slot = (address - VALIDITY_LOG_ADDRESS) / VALIDITY_RECORD_SIZE;
+
+		if (!write && count_reads)
+			log_reads++;
+		if (!write && damaged[slot])
+		{
+			// The bus error is ignored only at negative priority, BFHFNMIGN set
+			if (!crypto_emu_faultmask() || !(SCB->CCR & SCB_CCR_BFHFNMIGN_Msk))
+			{
+				hard_faults++;
+				siglongjmp(fault_exit, 1);
+			}
+			mprotect((void*) flash_page(), PAGE_SIZE, PROT_READ | PROT_WRITE);
+			FLASH->SR1 |= FLASH_SR_DBECCERR;
+		}
+	}
+	else if (address - flash_page() >= PAGE_SIZE)
+	{
+		signal(SIGSEGV, SIG_DFL);	// A real fault: crash on return
+		return;
+	}
+
+	open_page = address & ~(PAGE_SIZE - 1);
+	mprotect((void*) open_page, PAGE_SIZE, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= 0x100;
+}
+
+static void on_step(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = context;
+
+	(void) sig;
+	(void) info;
+	uc->uc_mcontext.gregs[REG_EFL] &= ~0x100;
+	if (open_page == flash_page())
+	{
+		FLASH->SR1 &= ~FLASH->CCR1;		// Clear bits, read as 0
+		FLASH->CCR1 = 0;
+	}
+	protect_pages();
+}
+
+static void ecc_init(void)
+{
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+	sa.sa_sigaction = on_fault;
+	sigaction(SIGSEGV, &sa, NULL);
+	sa.sa_sigaction = on_step;
+	sigaction(SIGTRAP, &sa, NULL);
+}
+
+static void damage_slot(uint32_t slot)
+{
+	damaged[slot] = 1;
+	protect_pages();
+}
+
+static void clear_damage(uint32_t first, uint32_t count)
+{
+	memset(damaged + first, 0, count);
+	protect_pages();
+}
+
+/* Power and flash (linked with --wrap) ---------------------------------------*/
+
+typedef enum
+{
+	CUT_NONE,
+	CUT_BEFORE,		// Power lost before the flash word starts
+	CUT_MID,		// Power lost while the flash word is programmed
+	CUT_ERASE,		// Power lost during the next sector erase
+	FAIL_PROGRAM	// The next program reports an error, power stays
+} cut_t;
+
+static cut_t cut;
+static int powered = 1;
+static long erases;
+static int erase_allowed;			// Only while an install starts
+
+HAL_StatusTypeDef __real_HAL_FLASH_Program(uint32_t TypeProgram,
+		uint32_t FlashAddress, uint32_t DataAddress);
+HAL_StatusTypeDef __real_HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+		uint32_t *SectorError);
+uint32_t __real_Crypto_RecordTag(const uint8_t *data, uint32_t length);
+
+HAL_StatusTypeDef __wrap_HAL_FLASH_Program(uint32_t TypeProgram,
+		uint32_t FlashAddress, uint32_t DataAddress)
+{
+	uint32_t slot = (FlashAddress - VALIDITY_LOG_ADDRESS) / VALIDITY_RECORD_SIZE;
+
+	if (!powered)
+		return HAL_ERROR;
+	if (cut == FAIL_PROGRAM)
+	{
+		cut = CUT_NONE;
+		return HAL_ERROR;
+	}
+	if (cut == CUT_BEFORE || cut == CUT_MID)
+	{
+		powered = 0;
+		if (cut == CUT_MID)
+		{
+			const uint8_t *data = (const uint8_t*) (uintptr_t) DataAddress;
+			uint8_t *word = (uint8_t*) (uintptr_t) FlashAddress;
+
+			// Some bits programmed, the ECC bits not matching
+			for (int i = 0; i < VALIDITY_RECORD_SIZE; i++)
+				word[i] = data[i] | (uint8_t) rand();
+			damage_slot(slot);
+		}
+		cut = CUT_NONE;
+		return HAL_ERROR;
+	}
+	return __real_HAL_FLASH_Program(TypeProgram, FlashAddress, DataAddress);
+}
+
+HAL_StatusTypeDef __wrap_HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+		uint32_t *SectorError)
+{
+	if (!powered)
+		return HAL_ERROR;
+	if (!erase_allowed)
+		failures++, printf("  log erased outside Validity_InstallStarted()\n");
+	erases++;
+	clear_damage(0, VALIDITY_SLOTS);
+	if (cut == CUT_ERASE)
+	{
+		uint8_t *log = (uint8_t*) VALIDITY_LOG_ADDRESS;
+
+		for (uint32_t i = 0; i < VALIDITY_SLOTS; i++)
+		{
+			if (rand() % 2)
+			{
+				memset(log + i * VALIDITY_RECORD_SIZE, rand(),
+						VALIDITY_RECORD_SIZE);
+				damaged[i] = 1;
+			}
+			else
+				memset(log + i * VALIDITY_RECORD_SIZE, 0xFF,
+						VALIDITY_RECORD_SIZE);
+		}
+		protect_pages();
+		cut = CUT_NONE;
+		powered = 0;
+		return HAL_ERROR;
+	}
+	return __real_HAL_FLASHEx_Erase(pEraseInit, SectorError);
+}
+
+static long tags;
+
+uint32_t __wrap_Crypto_RecordTag(const uint8_t *data, uint32_t length)
+{
+	tags++;
+	return __real_Crypto_RecordTag(data, length);
+}
+
+/* Application and boots ------------------------------------------------------*/
+
+typedef enum
+{
+	BOOT_EARLY,		// Early jump, before any init
+	BOOT_CHECKED,	// Application valid after init (CRC)
+	BOOT_REFUSED,	// Bootloader stays for an update
+	BOOT_FAULT		// HardFault on a damaged word
+} boot_t;
+
+static uint8_t image_a[IMAGE_SIZE], image_b[IMAGE_SIZE];
+
+static void make_image(uint8_t *image, unsigned seed)
+{
+	uint32_t vectors[2] = { 0x24050000, 0x08020299 + 4 * seed };
+
+	srand(seed);
+	for (int i = 0; i < IMAGE_SIZE; i++)
+		image[i] = rand();
+	memcpy(image, vectors, sizeof(vectors));
+}
+
+static void write_app(const uint8_t *image)
+{
+	memcpy(crypto_emu_flash(), image, IMAGE_SIZE);
+}
+
+static int app_is(const uint8_t *image)
+{
+	return memcmp(crypto_emu_flash(), image, IMAGE_SIZE) == 0;
+}
+
+static HAL_StatusTypeDef install(const uint8_t *image, uint8_t trial)
+{
+	erase_allowed = 1;
+	HAL_StatusTypeDef status = Validity_InstallStarted();
+	erase_allowed = 0;
+
+	if (status != HAL_OK)
+		return status;
+	write_app(image);
+	return Validity_InstallDone(IMAGE_SIZE,
+			crc32_ieee(CRC32_INIT, image, IMAGE_SIZE), trial);
+}
+
+// Bootloader_E main.c from a reset, up to the decision
+static boot_t boot(void)
+{
+	volatile boot_t result = BOOT_FAULT;
+
+	powered = 1;
+	FLASH->CR1 |= FLASH_CR_LOCK;
+	if (sigsetjmp(fault_exit, 1) == 0)
+	{
+		ValidityState_t validity = Validity_Check();
+		uint32_t early_app_stack = *((uint32_t*) APPLICATION_ADDRESS);
+
+		if (validity == VALIDITY_OK
+				|| (validity == VALIDITY_NONE
+						&& ((early_app_stack & 0xFFF00000) == 0x20000000
+								|| (early_app_stack & 0xFFF00000)
+										== 0x24000000)))
+			result = BOOT_EARLY;
+		else
+			result = Validity_ApplicationValid(validity) ?
+					BOOT_CHECKED : BOOT_REFUSED;
+	}
+	return result;
+}
+
+// Power-on from scratch: erased flash, application A installed
+static void fresh(void)
+{
+	clear_damage(0, VALIDITY_SLOTS);
+	crypto_emu_reset(&crypto_emu_typical);
+	powered = 1;
+	cut = CUT_NONE;
+	if (install(image_a, 0) != HAL_OK)
+		failures++, printf("  first install failed\n");
+}
+
+static uint32_t slots_written(void)
+{
+	const uint8_t *log = (const uint8_t*) VALIDITY_LOG_ADDRESS;
+	uint32_t n = VALIDITY_SLOTS;
+
+	while (n > 0 && !damaged[n - 1])
+	{
+		int erased = 1;
+
+		for (int i = 0; i < VALIDITY_RECORD_SIZE; i++)
+			erased &= log[(n - 1) * VALIDITY_RECORD_SIZE + i] == 0xFF;
+		if (!erased)
+			break;
+		n--;
+	}
+	return n;
+}
+
+static ValidityRecord_t* slot_at(uint32_t slot)
+{
+	return (ValidityRecord_t*) (VALIDITY_LOG_ADDRESS
+			+ slot * VALIDITY_RECORD_SIZE);
+}
+
+// Sum of SipRounds of a tag over length bytes
+static double tag_rounds(uint32_t length)
+{
+	return 2.0 * (length / 8 + 1) + 4;
+}
+
+int main(void)
+{
+	char line[96];
+
+	make_image(image_a, 1);
+	make_image(image_b, 2);
+	crypto_emu_reset(&crypto_emu_typical);
+	map_registers((uintptr_t) FLASH);
+	map_registers((uintptr_t) IWDG1);
+	map_registers((uintptr_t) SCB);
+	ecc_init();
+	protect_pages();
+
+	printf("empty log\n");
+	write_app(image_a);
+	expect("no record", Validity_Check() == VALIDITY_NONE);
+	expect("early jump on the stack pointer", boot() == BOOT_EARLY);
+
+	printf("install\n");
+	fresh();
+	erase_allowed = 1;
+	expect("started", Validity_InstallStarted() == HAL_OK);
+	erase_allowed = 0;
+	expect("application refused until done",
+			Validity_Check() == VALIDITY_INCOMPLETE && boot() == BOOT_REFUSED);
+	write_app(image_b);
+	expect("done", Validity_InstallDone(IMAGE_SIZE,
+			crc32_ieee(CRC32_INIT, image_b, IMAGE_SIZE), 0) == HAL_OK);
+	expect("early jump", boot() == BOOT_EARLY);
+
+	// Cost of the power-on check with a log that is in use
+	count_reads = 1;
+	log_reads = tags = 0;
+	protect_pages();
+	ValidityState_t state = Validity_Check();
+	count_reads = 0;
+	protect_pages();
+	double rounds = tags * tag_rounds(offsetof(ValidityRecord_t, tag))
+			+ 2 * tag_rounds(AES_KEY_SIZE / 2 + 4);
+	double cycles = log_reads * WORD_READ_CYCLES + rounds * SIPROUND_CYCLES
+			+ CHECK_CYCLES;
+	printf("  power-on check: %ld flash words, %ld tags + key derivation "
+			"(%.0f SipRounds), about %.0f cycles = %.0f us at %.0f MHz\n",
+			log_reads / (VALIDITY_RECORD_SIZE / 4), tags, rounds, cycles,
+			cycles / CPU_MHZ, CPU_MHZ);
+	expect("same decision with reads counted", state == VALIDITY_OK);
+
+	printf("trial\n");
+	fresh();
+	expect("done on trial", install(image_b, 1) == HAL_OK
+			&& Validity_Check() == VALIDITY_TRIAL);
+	expect("confirmed", Validity_Confirm() == HAL_OK
+			&& Validity_Check() == VALIDITY_OK);
+
+	printf("power cut while recording\n");
+	for (int mid = 0; mid <= 1; mid++)
+	{
+		const char *how = mid ? "mid-word" : "before the word";
+		long faults = hard_faults;
+
+		// Install started: application A still whole
+		fresh();
+		cut = mid ? CUT_MID : CUT_BEFORE;
+		install(image_b, 0);
+		snprintf(line, sizeof(line), "started, %s: A kept", how);
+		expect(line, boot() == (mid ? BOOT_CHECKED : BOOT_EARLY)
+				&& app_is(image_a));
+		snprintf(line, sizeof(line), "started, %s: early jump again", how);
+		expect(line, boot() == BOOT_EARLY);
+
+		// Install done: B programmed, record lost
+		fresh();
+		erase_allowed = 1;
+		Validity_InstallStarted();
+		erase_allowed = 0;
+		write_app(image_b);
+		cut = mid ? CUT_MID : CUT_BEFORE;
+		Validity_InstallDone(IMAGE_SIZE,
+				crc32_ieee(CRC32_INIT, image_b, IMAGE_SIZE), 0);
+		snprintf(line, sizeof(line), "done, %s: refused", how);
+		expect(line, boot() == BOOT_REFUSED);
+		snprintf(line, sizeof(line), "done, %s: installed again", how);
+		expect(line, install(image_b, 0) == HAL_OK && boot() == BOOT_EARLY);
+
+		// Confirmation: B stays on trial
+		fresh();
+		install(image_b, 1);
+		cut = mid ? CUT_MID : CUT_BEFORE;
+		Validity_Confirm();
+		snprintf(line, sizeof(line), "confirmation, %s: still on trial", how);
+		expect(line, boot() == BOOT_CHECKED
+				&& Validity_Check() == VALIDITY_TRIAL);
+		snprintf(line, sizeof(line), "confirmation, %s: confirmed again", how);
+		expect(line, Validity_Confirm() == HAL_OK && boot() == BOOT_EARLY);
+
+		snprintf(line, sizeof(line), "no HardFault, %s", how);
+		expect(line, hard_faults == faults);
+	}
+
+	printf("ECC error read outside the guarded path\n");
+	fresh();
+	damage_slot(slots_written());
+	{
+		long faults = hard_faults;
+
+		if (sigsetjmp(fault_exit, 1) == 0)
+			(void) *(volatile uint32_t*) slot_at(slots_written() - 1);
+		expect("HardFault (emulation check)", hard_faults == faults + 1);
+	}
+	clear_damage(0, VALIDITY_SLOTS);
+
+	printf("forged and copied records\n");
+	fresh();
+	install(image_b, 0);
+	{
+		uint32_t n = slots_written();
+		ValidityRecord_t forged = *slot_at(n - 1);
+
+		// Another CRC, the tag of the genuine record
+		forged.counter++;
+		forged.image_crc ^= 1;
+		memcpy(slot_at(n), &forged, sizeof(forged));
+		expect("forged record: no early jump, CRC decides",
+				Validity_Check() == VALIDITY_MISMATCH
+						&& boot() == BOOT_CHECKED);
+		expect("recorded again", boot() == BOOT_EARLY);
+
+		// A genuine record of A copied to the end, B installed
+		n = slots_written();
+		memcpy(slot_at(n), slot_at(1), sizeof(forged));
+		write_app(image_a);
+		expect("copied record: no early jump",
+				Validity_Check() == VALIDITY_MISMATCH);
+	}
+
+	printf("damaged image\n");
+	fresh();
+	((uint32_t*) crypto_emu_flash())[1] ^= 0x100;
+	expect("refused", boot() == BOOT_REFUSED);
+
+	printf("programming error\n");
+	fresh();
+	erase_allowed = 1;
+	Validity_InstallStarted();
+	erase_allowed = 0;
+	write_app(image_b);
+	cut = FAIL_PROGRAM;
+	expect("reported", Validity_InstallDone(IMAGE_SIZE,
+			crc32_ieee(CRC32_INIT, image_b, IMAGE_SIZE), 0) != HAL_OK);
+	expect("refused", boot() == BOOT_REFUSED);
+
+	printf("wrap-around\n");
+	fresh();
+	{
+		uint32_t counter = slot_at(slots_written() - 1)->counter;
+		int recorded = 0;
+		long faults = hard_faults;
+
+		erases = 0;
+		for (int i = 0; i < UPDATES; i++)
+		{
+			const uint8_t *image = i % 2 ? image_a : image_b;
+
+			if (install(image, 1) == HAL_OK && boot() == BOOT_CHECKED
+					&& Validity_Confirm() == HAL_OK && boot() == BOOT_EARLY
+					&& app_is(image))
+				recorded++;
+		}
+		snprintf(line, sizeof(line), "%d updates on trial, confirmed: %d early "
+				"jumps", UPDATES, recorded);
+		expect(line, recorded == UPDATES);
+		snprintf(line, sizeof(line), "log erased %ld times, when an install "
+				"started", erases);
+		expect(line, erases == (1 + 3 * UPDATES) / VALIDITY_SLOTS);
+		snprintf(line, sizeof(line), "counter %u after %u, across erases",
+				(unsigned) slot_at(slots_written() - 1)->counter,
+				(unsigned) counter);
+		expect(line, slot_at(slots_written() - 1)->counter
+				== counter + 3 * UPDATES);
+		expect("no HardFault", hard_faults == faults);
+	}
+
+	printf("power cut around the log erase\n");
+	for (int during = 0; during <= 1; during++)
+	{
+		long faults = hard_faults;
+
+		fresh();
+		while (slots_written() < VALIDITY_SLOTS - 2)
+			install(image_a, 0);
+		cut = during ? CUT_ERASE : CUT_BEFORE;
+		erase_allowed = 1;
+		Validity_InstallStarted();
+		erase_allowed = 0;
+		if (during)
+		{
+			boot_t result = boot();
+
+			expect("during: no HardFault", hard_faults == faults);
+			expect("during: refused or early jump (A whole)",
+					result == BOOT_REFUSED
+							|| (result == BOOT_EARLY && app_is(image_a)));
+			erases = 0;
+			expect("during: next install erases the log again",
+					install(image_b, 0) == HAL_OK && erases == 1
+							&& boot() == BOOT_EARLY);
+		}
+		else
+		{
+			expect("after: log empty, early jump on the stack pointer",
+					Validity_Check() == VALIDITY_NONE
+							&& boot() == BOOT_EARLY && app_is(image_a));
+			expect("after: next install recorded",
+					install(image_b, 0) == HAL_OK && boot() == BOOT_EARLY);
+		}
+	}
+
+	crypto_emu_stats_t s;
+	crypto_emu_get_stats(&s);
+	expect("no emulator violations", s.violations == 0);
+	printf("%s\n", failures ? "FAILED" : "all scenarios OK");
+	return failures ? 1 : 0;
+}
@@ -110,9 +110,15 @@ uint8_t UserTxBufferHS[APP_TX_DATA_SIZE];
 extern USBD_HandleTypeDef hUsbDeviceHS;
 
 /* USER CODE BEGIN EXPORTED_VARIABLES */
-volatile uint8_t packetReceived = 0;
-volatile uint8_t usbBufferCounts = 0;
-extern uint8_t usbBuffer[2048];
+/* Receive ring: the OUT endpoint writes each message straight into a slot,
+   the application reads it there and releases it, nothing is copied */
+static uint8_t usbRxSlot[USB_RX_SLOTS][USB_RX_SLOT_SIZE] __ALIGNED(32);
+static uint32_t usbRxLength[USB_RX_SLOTS];
+static volatile uint32_t usbRxHead = 0;	/* Messages received, free running */
+static volatile uint32_t usbRxTail = 0;	/* Messages released, free running */
+static uint32_t usbRxFill = 0;		/* Bytes of the message being received */
+static uint32_t usbRxArmed = 0;		/* Size of the OUT transfer in progress */
+static uint8_t usbRxStalled = 0;	/* OUT endpoint left NAKing, all slots full */
 
 /* USER CODE END EXPORTED_VARIABLES */
 
@@ -132,6 +138,7 @@ static int8_t CDC_Receive_HS(uint8_t* pbuf, uint32_t *Len);
 static int8_t CDC_TransmitCplt_HS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
+static void CDC_Arm_HS(void);
 
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
@@ -159,7 +166,12 @@ static int8_t CDC_Init_HS(void)
   /* USER CODE BEGIN 8 */
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceHS, UserTxBufferHS, 0);
-  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, UserRxBufferHS);
+  /* The class arms the first OUT transfer for one packet, in slot 0 */
+  usbRxHead = usbRxTail = usbRxFill = 0;
+  usbRxStalled = 0;
+  usbRxArmed = hUsbDeviceHS.dev_speed == USBD_SPEED_HIGH ?
+      CDC_DATA_HS_OUT_PACKET_SIZE : CDC_DATA_FS_OUT_PACKET_SIZE;
+  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, usbRxSlot[0]);
   return (USBD_OK);
   /* USER CODE END 8 */
 }
@@ -267,17 +279,30 @@ static int8_t CDC_Control_HS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_HS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 11 */
-  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, &Buf[0]);
-  USBD_CDC_ReceivePacket(&hUsbDeviceHS);
-/* CUSTOM */
-	memcpy(&usbBuffer[usbBufferCounts*64], Buf, *Len); /* Copy Data to the Buffer */
-	usbBufferCounts++;
-	if(usbBufferCounts == 32)
+  UNUSED(Buf);
+  usbRxFill += *Len;
+
+  /* A message ends with a short packet (ZLP included) or a full slot. A
+     transfer that ended on a full packet before the end of the slot was
+     armed by the class: the message continues in the same slot */
+  if (*Len == usbRxArmed && usbRxFill < USB_RX_SLOT_SIZE)
+  {
+    CDC_Arm_HS();
+    return (USBD_OK);
+  }
+  if (usbRxFill > 0)
   {
-		packetReceived = 1;
-		usbBufferCounts = 0;
-	}
-  /* END CUSTOM */
+    usbRxLength[usbRxHead % USB_RX_SLOTS] = usbRxFill;
+    usbRxFill = 0;
+    usbRxHead++;
+  }
+
+  /* Keep receiving while a slot is free, else the host is NAKed until
+     CDC_Release_Message_HS() frees one */
+  if (usbRxHead - usbRxTail < USB_RX_SLOTS)
+    CDC_Arm_HS();
+  else
+    usbRxStalled = 1;
   return (USBD_OK);
   /* USER CODE END 11 */
 }
@@ -328,6 +353,62 @@ static int8_t CDC_TransmitCplt_HS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
+/**
+  * @brief  Arm the OUT endpoint for the rest of the slot being filled
+  * @retval None
+  */
+static void CDC_Arm_HS(void)
+{
+  uint8_t *rx = &usbRxSlot[usbRxHead % USB_RX_SLOTS][usbRxFill];
+
+  usbRxArmed = USB_RX_SLOT_SIZE - usbRxFill;
+  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, rx);
+  USBD_LL_PrepareReceive(&hUsbDeviceHS, CDC_OUT_EP, rx, usbRxArmed);
+}
+
+/**
+  * @brief  Oldest message received, in reception order. A message is what
+  *         the host sent in one write: up to USB_RX_SLOT_SIZE bytes, ended
+  *         by a short packet. A message of a multiple of 64 bytes shorter
+  *         than a slot needs a zero-length packet after it, a longer one
+  *         comes as several slot-sized messages.
+  * @param  Len: Set to the message length
+  * @retval Pointer to the message in the receive ring, NULL if none; valid
+  *         until CDC_Release_Message_HS()
+  */
+uint8_t *CDC_Message_HS(uint32_t *Len)
+{
+  uint8_t *message = NULL;
+
+  __disable_irq();
+  if (usbRxHead != usbRxTail)
+  {
+    message = usbRxSlot[usbRxTail % USB_RX_SLOTS];
+    *Len = usbRxLength[usbRxTail % USB_RX_SLOTS];
+  }
+  __enable_irq();
+
+  return message;
+}
+
+/**
+  * @brief  Give the message returned by CDC_Message_HS() back to the
+  *         receiver, restart reception if it was waiting for a free slot
+  * @retval None
+  */
+void CDC_Release_Message_HS(void)
+{
+  __disable_irq();
+  if (usbRxHead != usbRxTail)
+    usbRxTail++;
+  if (usbRxStalled)
+  {
+    usbRxStalled = 0;
+    CDC_Arm_HS();
+  }
+  __enable_irq();
+}
+
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
 /**
@@ -52,6 +52,9 @@
 #define APP_RX_DATA_SIZE  2048
 #define APP_TX_DATA_SIZE  2048
 /* USER CODE BEGIN EXPORTED_DEFINES */
+#define USB_PACKET_SIZE   2048  /* Image utility packet, one receive slot */
+#define USB_RX_SLOT_SIZE  2048  /* Longest message, received in place by one OUT transfer */
+#define USB_RX_SLOTS      4     /* Receive ring, a power of 2 */
 
 /* USER CODE END EXPORTED_DEFINES */
 
@@ -109,6 +112,8 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_HS;
 uint8_t CDC_Transmit_HS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
+uint8_t *CDC_Message_HS(uint32_t *Len);
+void CDC_Release_Message_HS(void);
 
 /* USER CODE END EXPORTED_FUNCTIONS */
 
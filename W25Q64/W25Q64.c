@@ -3,9 +3,65 @@
 #include <octospi.h>
 #include <iwdg.h>
 
+/* Page program path: the commands are built once, only Address and NbData
+ * change between pages. The end of each program (tPP) is polled by the OSPI
+ * itself and signalled by the status match interrupt. */
+static OSPI_RegularCmdTypeDef sWriteEnableCmd = {
+	.OperationType      				= HAL_OSPI_OPTYPE_COMMON_CFG, 				/* Common configuration (indirect or auto-polling mode) */
+	.FlashId            				= HAL_OSPI_FLASH_ID_1, 						/* Set The OCTO SPI Flash ID */
+	.InstructionMode   					= HAL_OSPI_INSTRUCTION_1_LINE,				/* Instruction on a single line */
+	.InstructionSize    				= HAL_OSPI_INSTRUCTION_8_BITS,				/* 8-bit Instruction */
+	.Instruction 						= W25Q_WRITE_ENABLE_CMD,					/* Sets WEL as soon as CS goes high */
+	.AddressMode       					= HAL_OSPI_ADDRESS_NONE,					/* Define Address Lines: No Address */
+	.AddressSize 						= HAL_OSPI_ADDRESS_24_BITS,					/* 24-bit Address */
+	.AlternateBytesMode 				= HAL_OSPI_ALTERNATE_BYTES_NONE, 			/* Disable Alternate Bytes Mode */
+	.DataMode          					= HAL_OSPI_DATA_NONE,						/* Define Data Lines: No Data */
+	.SIOOMode          					= HAL_OSPI_SIOO_INST_EVERY_CMD, 			/* SIOO Mode: Send instruction on every transaction */
+};
+
+static OSPI_RegularCmdTypeDef sPageProgramCmd = {
+	.OperationType      				= HAL_OSPI_OPTYPE_COMMON_CFG, 				/* Common configuration (indirect or auto-polling mode) */
+	.FlashId            				= HAL_OSPI_FLASH_ID_1, 						/* Set The OCTO SPI Flash ID */
+	.InstructionMode   					= HAL_OSPI_INSTRUCTION_1_LINE,				/* Instruction on a single line */
+	.InstructionSize    				= HAL_OSPI_INSTRUCTION_8_BITS,				/* 8-bit Instruction */
+	.Instruction 						= W25Q_PAGE_PROGRAM_QUAD_INP_CMD,			/* What We Do? */
+	.AddressMode       					= HAL_OSPI_ADDRESS_1_LINE,					/* Define Address Lines: Address On a Single Line */
+	.AddressSize 						= HAL_OSPI_ADDRESS_24_BITS,					/* 24-bit Address */
+	.AlternateBytesMode 				= HAL_OSPI_ALTERNATE_BYTES_NONE, 			/* Disable Alternate Bytes Mode */
+	.DataMode          					= HAL_OSPI_DATA_4_LINES,					/* Define Data Lines: Data On Four Lines */
+	.SIOOMode          					= HAL_OSPI_SIOO_INST_EVERY_CMD, 			/* SIOO Mode: Send instruction on every transaction */
+};
+
+static OSPI_RegularCmdTypeDef sReadStatusCmd = {
+	.OperationType      				= HAL_OSPI_OPTYPE_COMMON_CFG, 				/* Common configuration (indirect or auto-polling mode) */
+	.FlashId            				= HAL_OSPI_FLASH_ID_1, 						/* Set The OCTO SPI Flash ID */
+	.InstructionMode   					= HAL_OSPI_INSTRUCTION_1_LINE,				/* Instruction on a single line */
+	.InstructionSize    				= HAL_OSPI_INSTRUCTION_8_BITS,				/* 8-bit Instruction */
+	.Instruction 						= W25Q_READ_SR1_CMD,						/* What We Do? */
+	.AddressMode       					= HAL_OSPI_ADDRESS_NONE,					/* Define Address Lines: No Address */
+	.AddressSize 						= HAL_OSPI_ADDRESS_24_BITS,					/* 24-bit Address */
+	.AlternateBytesMode 				= HAL_OSPI_ALTERNATE_BYTES_NONE, 			/* Disable Alternate Bytes Mode */
+	.DataMode          					= HAL_OSPI_DATA_1_LINE,						/* Define Data Lines: Data On a Single Line */
+	.NbData            					= 1,										/* Bytes Send With Data */
+	.SIOOMode          					= HAL_OSPI_SIOO_INST_EVERY_CMD, 			/* SIOO Mode: Send instruction on every transaction */
+};
+
+static OSPI_AutoPollingTypeDef sProgramDoneConfig = {
+	.Match           					= 0x00U,									/* BUSY = 0 */
+	.Mask            					= 0x01U,
+	.MatchMode       					= HAL_OSPI_MATCH_MODE_AND,
+	.Interval        					= W25Q_AUTOPOLLING_INTERVAL_TIME,
+	.AutomaticStop   					= HAL_OSPI_AUTOMATIC_STOP_ENABLE,
+};
+
+static volatile uint8_t ProgramPending = 0;		/* Cleared by the status match interrupt */
+static volatile uint8_t ProgramFailed = 0;
+
 /* OCTO SPI Initial Function */
 HAL_StatusTypeDef W25Q64_OCTO_SPI_Init(OSPI_HandleTypeDef* hospi)
 {
+	W25Q64_OSPI_WaitWrite(hospi);
+
 	if (HAL_OSPI_DeInit(hospi) != HAL_OK) {
 	    return HAL_ERROR;
 	}
@@ -33,6 +89,10 @@ HAL_StatusTypeDef W25Q64_OSPI_ResetChip(OSPI_HandleTypeDef* hospi)
 {
     OSPI_RegularCmdTypeDef sCommand={0};
 
+    if (W25Q64_OSPI_WaitWrite(hospi) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
     /* Enable Reset --------------------------- */
 	/* Common Commands*/
 	sCommand.OperationType      		= HAL_OSPI_OPTYPE_COMMON_CFG; 				/* Common configuration (indirect or auto-polling mode) */
@@ -224,6 +284,11 @@ HAL_StatusTypeDef W25Q64_OSPI_AutoPollingMemReady(OSPI_HandleTypeDef* hospi)
     OSPI_RegularCmdTypeDef sCommand;
     OSPI_AutoPollingTypeDef sConfig;
 
+    /* A page program may still be polled by interrupt */
+    if (W25Q64_OSPI_WaitWrite(hospi) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
     /* Configure automatic polling mode to wait for memory ready ------ */
 	/* Common Commands*/
 	sCommand.OperationType      		= HAL_OSPI_OPTYPE_COMMON_CFG; 				/* Common configuration (indirect or auto-polling mode) */
@@ -377,35 +442,25 @@ HAL_StatusTypeDef W25Q64_OSPI_EraseSector(OSPI_HandleTypeDef* hospi, uint32_t Er
     return HAL_OK;
 }
 
-/* Write Function */
-HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t WriteAddr, uint32_t Size)
+/* Largest erase unit (64KB block, 32KB block or 4KB sector) starting at Address
+ * that is aligned on its size and ends at or before EndAddress (exclusive) */
+uint32_t W25Q64_EraseBlockSize(uint32_t Address, uint32_t EndAddress)
 {
-  OSPI_RegularCmdTypeDef sCommand={0};
-  uint32_t end_addr=0, current_size=0, current_addr=0;
-  uint32_t data_addr=0;
-
-  current_addr = 0;
-
-  while (current_addr <= WriteAddr) {
-      current_addr += W25Q_PAGE_SIZE;
-  }
-  current_size = current_addr - WriteAddr;
-
-  /* Check if the size of the data is less than the remaining place in the page */
-  if (current_size > Size) {
-      current_size = Size;
-  }
-
-  /* Initialize the adress variables */
-  current_addr = WriteAddr;
-  end_addr = WriteAddr + Size;
+    if (Address % W25Q_BLOCK64_SIZE == 0 && EndAddress >= Address + W25Q_BLOCK64_SIZE) {
+        return W25Q_BLOCK64_SIZE;
+    }
+    if (Address % W25Q_BLOCK32_SIZE == 0 && EndAddress >= Address + W25Q_BLOCK32_SIZE) {
+        return W25Q_BLOCK32_SIZE;
+    }
+    return W25Q_SECTOR_SIZE;
+}
 
-  data_addr = (uint32_t)pData;
+/* Start Erase Block Function: waits for the previous erase/program, issues the
+ * erase of the block at Address (aligned on BlockSize) and returns while it runs */
+HAL_StatusTypeDef W25Q64_OSPI_EraseBlockStart(OSPI_HandleTypeDef* hospi, uint32_t Address, uint32_t BlockSize)
+{
+    OSPI_RegularCmdTypeDef sCommand={0};
 
-  /* Perform the write page by page */
-  do
-  {
-	/* Initialize the program command */
 	/* Common Commands*/
 	sCommand.OperationType      		= HAL_OSPI_OPTYPE_COMMON_CFG; 				/* Common configuration (indirect or auto-polling mode) */
 	sCommand.FlashId            		= HAL_OSPI_FLASH_ID_1; 						/* Set The OCTO SPI Flash ID */
@@ -415,57 +470,171 @@ HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef* hospi, uint8_t* pData, u
 	sCommand.DQSMode            		= HAL_OSPI_DQS_DISABLE; 					/* Disable Data Strobe */
 	sCommand.SIOOMode          			= HAL_OSPI_SIOO_INST_EVERY_CMD; 			/* SIOO Mode: Send instruction on every transaction */
 	sCommand.AlternateBytesMode 		= HAL_OSPI_ALTERNATE_BYTES_NONE; 			/* Disable Alternate Bytes Mode */
-	sCommand.AlternateBytes				= HAL_OSPI_ALTERNATE_BYTES_NONE; 			/* Alternate Bytes = 0 */
-	sCommand.AlternateBytesSize			= HAL_OSPI_ALTERNATE_BYTES_NONE; 			/* Alternate Bytes Size = 0 */
-	sCommand.AlternateBytesDtrMode		= HAL_OSPI_ALTERNATE_BYTES_DTR_DISABLE; 	/* Disable Alternate Bytes DDR/DTR Mode */
 	sCommand.InstructionMode   			= HAL_OSPI_INSTRUCTION_1_LINE;				/* Instruction on a single line */
 	sCommand.InstructionSize    		= HAL_OSPI_INSTRUCTION_8_BITS;				/* 8-bit Instruction */
 	sCommand.AddressSize 				= HAL_OSPI_ADDRESS_24_BITS;					/* 24-bit Address */
 	/* Instruction */
-	sCommand.Instruction 				= W25Q_PAGE_PROGRAM_QUAD_INP_CMD;			/* What We Do? */
+	sCommand.Instruction 				= BlockSize == W25Q_BLOCK64_SIZE ? W25Q_64KB_BLOCK_ERASE_CMD
+										: BlockSize == W25Q_BLOCK32_SIZE ? W25Q_32KB_BLOCK_ERASE_CMD
+										: W25Q_SECTOR_ERASE_CMD;
 	/* Address */
 	sCommand.AddressMode       			= HAL_OSPI_ADDRESS_1_LINE;					/* Define Address Lines: Address On a Single Line */
-	sCommand.Address					= current_addr;								/* Byte Address */
+	sCommand.Address					= (Address & 0xFFFFFF);						/* Byte Address */
 	/* Data */
-	sCommand.DataMode          			= HAL_OSPI_DATA_4_LINES;					/* Define Data Lines: Data On Four Lines */
-	sCommand.DummyCycles       			= 0;										/* Bytes Send With No Data */
-	sCommand.NbData            			= current_size;								/* Bytes Send With Data */
+	sCommand.DataMode          			= HAL_OSPI_DATA_NONE;						/* Define Data Lines: No Data */
 
-    if (current_size == 0) {
-        return HAL_OK;
+    if (Address % BlockSize != 0) {
+        return HAL_ERROR;
     }
 
-    /* Enable write operations */
-    if (W25Q64_OSPI_WriteEnable(hospi) != HAL_OK)
-    {
-      return HAL_ERROR;
+    if (W25Q64_OSPI_AutoPollingMemReady(hospi) != HAL_OK) {
+        return HAL_ERROR;
     }
 
-    /* Configure the command */
-    if (HAL_OSPI_Command(hospi, &sCommand, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+    if (W25Q64_OSPI_WriteEnable(hospi) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OSPI_Command(hospi, &sCommand, HAL_OSPI_TIMEOUT_DEFAULT_VALUE);
+}
+
+/* Erase Range Function: erases the sectors holding [StartAddress, EndAddress)
+ * with the largest blocks that fit, nothing outside them */
+HAL_StatusTypeDef W25Q64_OSPI_EraseRange(OSPI_HandleTypeDef* hospi, uint32_t StartAddress, uint32_t EndAddress)
+{
+    uint32_t Address = StartAddress - (StartAddress % W25Q_SECTOR_SIZE);
+    uint32_t BlockSize;
+
+    EndAddress = (EndAddress + W25Q_SECTOR_SIZE - 1) / W25Q_SECTOR_SIZE * W25Q_SECTOR_SIZE;
+
+    while (Address < EndAddress)
     {
-      return HAL_ERROR;
+        BlockSize = W25Q64_EraseBlockSize(Address, EndAddress);
+        if (W25Q64_OSPI_EraseBlockStart(hospi, Address, BlockSize) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        Address += BlockSize;
+
+        /* Refresh watchdog - 64KB block erase can take 150-2000ms each */
+        watchdog_refresh();
+    }
+
+    return W25Q64_OSPI_AutoPollingMemReady(hospi);
+}
+
+/* Program Page Function: Size bytes within one page, returns while the page
+ * is programmed (BUSY polled by the OSPI until the status match interrupt) */
+static HAL_StatusTypeDef W25Q64_OSPI_ProgramPage(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t Address, uint32_t Size)
+{
+    if (W25Q64_OSPI_WaitWrite(hospi) != HAL_OK) {
+        return HAL_ERROR;
     }
 
-    /* Transmission of the data */
-    if (HAL_OSPI_Transmit(hospi, (uint8_t*)data_addr, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+    if (HAL_OSPI_Command(hospi, &sWriteEnableCmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    sPageProgramCmd.Address = Address;
+    sPageProgramCmd.NbData = Size;
+    if (HAL_OSPI_Command(hospi, &sPageProgramCmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (HAL_OSPI_Transmit(hospi, pData, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (HAL_OSPI_Command(hospi, &sReadStatusCmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    ProgramFailed = 0;
+    ProgramPending = 1;
+    if (HAL_OSPI_AutoPolling_IT(hospi, &sProgramDoneConfig) != HAL_OK) {
+        ProgramPending = 0;
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/* Wait Write Function: waits for the last page started by W25Q64_OSPI_WriteStart */
+HAL_StatusTypeDef W25Q64_OSPI_WaitWrite(OSPI_HandleTypeDef* hospi)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    while (ProgramPending)
     {
-      return HAL_ERROR;
+        if ((HAL_GetTick() - tickstart) > HAL_OSPI_TIMEOUT_DEFAULT_VALUE) {
+            HAL_OSPI_Abort(hospi);
+            ProgramPending = 0;
+            return HAL_ERROR;
+        }
+    }
+
+    if (ProgramFailed) {
+        ProgramFailed = 0;
+        return HAL_ERROR;
     }
 
-    /* Configure automatic polling mode to wait for end of program */
-    if (W25Q64_OSPI_AutoPollingMemReady(hospi) != HAL_OK)
+    return HAL_OK;
+}
+
+/* Start Write Function: programs Size bytes page by page and returns while
+ * the last page is programmed. Any other W25Q64 call waits for it first,
+ * W25Q64_OSPI_WaitWrite gives the result. pData is no longer used on return. */
+HAL_StatusTypeDef W25Q64_OSPI_WriteStart(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t WriteAddr, uint32_t Size)
+{
+    /* First page up to the next page boundary */
+    uint32_t PageSize = W25Q_PAGE_SIZE - (WriteAddr % W25Q_PAGE_SIZE);
+
+    /* An erase may still be running */
+    if (W25Q64_OSPI_AutoPollingMemReady(hospi) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    while (Size > 0)
     {
-      return HAL_ERROR;
+        if (PageSize > Size) {
+            PageSize = Size;
+        }
+
+        if (W25Q64_OSPI_ProgramPage(hospi, pData, WriteAddr, PageSize) != HAL_OK) {
+            return HAL_ERROR;
+        }
+
+        pData += PageSize;
+        WriteAddr += PageSize;
+        Size -= PageSize;
+        PageSize = W25Q_PAGE_SIZE;
     }
 
-    /* Update the address and size variables for next page programming */
-    current_addr += current_size;
-    data_addr += current_size;
-    current_size = ((current_addr + W25Q_PAGE_SIZE) > end_addr) ? (end_addr - current_addr) : W25Q_PAGE_SIZE;
-  } while (current_addr <= end_addr);
+    return HAL_OK;
+}
 
-  return HAL_OK;
+/* Write Function */
+HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t WriteAddr, uint32_t Size)
+{
+    if (W25Q64_OSPI_WriteStart(hospi, pData, WriteAddr, Size) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return W25Q64_OSPI_WaitWrite(hospi);
+}
+
+/* OSPI Status Match Callback: end of page program */
+void HAL_OSPI_StatusMatchCallback(OSPI_HandleTypeDef* hospi)
+{
+    (void)hospi;
+    ProgramPending = 0;
+}
+
+/* OSPI Error Callback: auto-polling failed */
+void HAL_OSPI_ErrorCallback(OSPI_HandleTypeDef* hospi)
+{
+    (void)hospi;
+    ProgramFailed = 1;
+    ProgramPending = 0;
 }
 
 /* Read Function */
@@ -590,6 +759,18 @@ HAL_StatusTypeDef W25Q64_OSPI_EnableMemoryMappedMode(OSPI_HandleTypeDef* hospi)
     return HAL_OK;
 }
 
+/* Drop the D-cache lines of [Address, Address + Size) in the memory-mapped
+ * window: the window is cacheable (MPU_Config), so lines read before an
+ * erase or program would otherwise still hold the old bytes */
+void W25Q64_OSPI_InvalidateMapped(OSPI_HandleTypeDef* hospi, uint32_t Address, uint32_t Size)
+{
+    uint32_t base = hospi->Instance == OCTOSPI1 ? OCTOSPI1_BASE : OCTOSPI2_BASE;
+
+    if (SCB->CCR & SCB_CCR_DC_Msk) {
+        SCB_InvalidateDCache_by_Addr((void*) (uintptr_t) (base + Address), (int32_t) Size);
+    }
+}
+
 /* Check Chip is Busy Function */
 HAL_StatusTypeDef W25Q64_IsBusy(OSPI_HandleTypeDef* hospi)
 {
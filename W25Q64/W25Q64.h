@@ -13,6 +13,8 @@
 #define W25Q_PAGE_SIZE                   			    0x100 /* there are 131.072 (0x20000) pages of 256 Bytes each in total */
 #define W25Q_SECTOR_SIZE              			       0x1000 /* 1 sector = 16 (0x10) pages
 															   * there are 8.192 (0x2000) sectors of 4KB each in total */
+#define W25Q_BLOCK32_SIZE             			       0x8000 /* 32KB block = 8 sectors */
+#define W25Q_BLOCK64_SIZE             			      0x10000 /* 64KB block = 16 sectors */
 
 #define W25Q_DUMMY_CYCLES_READ_QUAD      			6
 
@@ -95,9 +97,15 @@ HAL_StatusTypeDef W25Q64_OSPI_WriteDisable(OSPI_HandleTypeDef* hospi);
 HAL_StatusTypeDef W25Q64_OSPI_AutoPollingMemReady(OSPI_HandleTypeDef* hospi);
 HAL_StatusTypeDef W25Q64_OSPI_Erase_Chip(OSPI_HandleTypeDef* hospi);
 HAL_StatusTypeDef W25Q64_OSPI_EraseSector(OSPI_HandleTypeDef* hospi, uint32_t EraseStartAddress, uint32_t EraseEndAddress);
+uint32_t W25Q64_EraseBlockSize(uint32_t Address, uint32_t EndAddress);
+HAL_StatusTypeDef W25Q64_OSPI_EraseBlockStart(OSPI_HandleTypeDef* hospi, uint32_t Address, uint32_t BlockSize);
+HAL_StatusTypeDef W25Q64_OSPI_EraseRange(OSPI_HandleTypeDef* hospi, uint32_t StartAddress, uint32_t EndAddress);
 HAL_StatusTypeDef W25Q64_OSPI_Write(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t WriteAddr, uint32_t Size);
+HAL_StatusTypeDef W25Q64_OSPI_WriteStart(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t WriteAddr, uint32_t Size);
+HAL_StatusTypeDef W25Q64_OSPI_WaitWrite(OSPI_HandleTypeDef* hospi);
 HAL_StatusTypeDef W25Q64_OSPI_Read(OSPI_HandleTypeDef* hospi, uint8_t* pData, uint32_t ReadAddr, uint32_t Size);
 HAL_StatusTypeDef W25Q64_OSPI_EnableMemoryMappedMode(OSPI_HandleTypeDef* hospi);
+void W25Q64_OSPI_InvalidateMapped(OSPI_HandleTypeDef* hospi, uint32_t Address, uint32_t Size);
 HAL_StatusTypeDef W25Q64_IsBusy(OSPI_HandleTypeDef* hospi);
 HAL_StatusTypeDef W25Q64_Read_Status_Registers(OSPI_HandleTypeDef* hospi, uint8_t* register_data, uint8_t register_num);
 HAL_StatusTypeDef W25Q64_Write_Status_Registers(OSPI_HandleTypeDef* hospi, uint8_t reg_data, uint8_t reg_num);
@@ -0,0 +1,233 @@
+#include <ecdsa_comb.h>
+
+#define NW	ECDSA_COMB_WORDS
+
+// Jacobian point: x = X/Z^2, y = Y/Z^3; Z = 0 is the point at infinity
+typedef struct
+{
+	uECC_word_t x[NW], y[NW], z[NW];
+} jacobian_t;
+
+static void mul(uECC_word_t *r, const uECC_word_t *a, const uECC_word_t *b)
+{
+	uECC_vli_modMult_fast(r, a, b, uECC_secp256r1());
+}
+
+static void sqr(uECC_word_t *r, const uECC_word_t *a)
+{
+	uECC_vli_modSquare_fast(r, a, uECC_secp256r1());
+}
+
+static void add(uECC_word_t *r, const uECC_word_t *a, const uECC_word_t *b)
+{
+	uECC_vli_modAdd(r, a, b, uECC_curve_p(uECC_secp256r1()), NW);
+}
+
+static void sub(uECC_word_t *r, const uECC_word_t *a, const uECC_word_t *b)
+{
+	uECC_vli_modSub(r, a, b, uECC_curve_p(uECC_secp256r1()), NW);
+}
+
+// 2P, a = -3 (dbl-2001-b): 3M + 5S
+static void point_double(jacobian_t *p)
+{
+	uECC_word_t delta[NW], gamma[NW], beta[NW], alpha[NW], t[NW];
+
+	if (uECC_vli_isZero(p->z, NW))
+		return;
+
+	sqr(delta, p->z);
+	sqr(gamma, p->y);
+	mul(beta, p->x, gamma);
+
+	// alpha = 3 (X - delta)(X + delta)
+	sub(t, p->x, delta);
+	add(alpha, p->x, delta);
+	mul(alpha, alpha, t);
+	add(t, alpha, alpha);
+	add(alpha, alpha, t);
+
+	// Z3 = (Y + Z)^2 - gamma - delta
+	add(t, p->y, p->z);
+	sqr(p->z, t);
+	sub(p->z, p->z, gamma);
+	sub(p->z, p->z, delta);
+
+	// X3 = alpha^2 - 8 beta
+	add(beta, beta, beta);
+	add(beta, beta, beta);
+	sqr(p->x, alpha);
+	sub(p->x, p->x, beta);
+	sub(p->x, p->x, beta);
+
+	// Y3 = alpha (4 beta - X3) - 8 gamma^2
+	sub(t, beta, p->x);
+	mul(p->y, alpha, t);
+	sqr(gamma, gamma);
+	add(gamma, gamma, gamma);
+	add(gamma, gamma, gamma);
+	add(gamma, gamma, gamma);
+	sub(p->y, p->y, gamma);
+}
+
+// P + Q with Q affine (madd-2007-bl): 7M + 4S
+static void point_add_affine(jacobian_t *p, const uECC_word_t *q)
+{
+	uECC_word_t zz[NW], u2[NW], s2[NW], h[NW], r[NW], i[NW], j[NW], v[NW];
+
+	if (uECC_vli_isZero(p->z, NW))
+	{
+		uECC_vli_set(p->x, q, NW);
+		uECC_vli_set(p->y, q + NW, NW);
+		uECC_vli_clear(p->z, NW);
+		p->z[0] = 1;
+		return;
+	}
+
+	sqr(zz, p->z);
+	mul(u2, q, zz);
+	mul(s2, q + NW, p->z);
+	mul(s2, s2, zz);
+	sub(h, u2, p->x);
+	sub(r, s2, p->y);
+
+	// Same x: P = Q doubles, P = -Q gives the point at infinity
+	if (uECC_vli_isZero(h, NW))
+	{
+		if (uECC_vli_isZero(r, NW))
+			point_double(p);
+		else
+			uECC_vli_clear(p->z, NW);
+		return;
+	}
+
+	add(r, r, r);
+	sqr(i, h);				// HH
+	add(j, p->z, h);		// Z3 = (Z + H)^2 - ZZ - HH
+	sqr(p->z, j);
+	sub(p->z, p->z, zz);
+	sub(p->z, p->z, i);
+	add(i, i, i);
+	add(i, i, i);
+	mul(j, h, i);
+	mul(v, p->x, i);
+
+	// X3 = r^2 - J - 2V
+	sqr(p->x, r);
+	sub(p->x, p->x, j);
+	sub(p->x, p->x, v);
+	sub(p->x, p->x, v);
+
+	// Y3 = r (V - X3) - 2 Y J
+	sub(v, v, p->x);
+	mul(j, p->y, j);
+	add(j, j, j);
+	mul(p->y, r, v);
+	sub(p->y, p->y, j);
+}
+
+static void to_affine(uECC_word_t *out, const jacobian_t *p)
+{
+	uECC_word_t zi[NW], zi2[NW];
+
+	uECC_vli_modInv(zi, p->z, uECC_curve_p(uECC_secp256r1()), NW);
+	sqr(zi2, zi);
+	mul(out, p->x, zi2);
+	mul(zi2, zi2, zi);
+	mul(out + NW, p->y, zi2);
+}
+
+// Column k of the comb: bit k + i * spacing of the scalar is tooth i
+static unsigned comb_index(const uECC_word_t *scalar, int k)
+{
+	unsigned index = 0;
+
+	for (int i = 0; i < ECDSA_COMB_TEETH; i++)
+	{
+		int bit = k + i * ECDSA_COMB_SPACING;
+
+		if (bit < 256 && uECC_vli_testBit(scalar, bit))
+			index |= 1U << i;
+	}
+	return index;
+}
+
+int ecdsa_comb_verify(const ecdsa_comb_point_t *q_table, const uint8_t hash[32],
+		const uint8_t signature[64])
+{
+	uECC_Curve curve = uECC_secp256r1();
+	const uECC_word_t *n = uECC_curve_n(curve);
+	uECC_word_t r[NW], s[NW], e[NW], u1[NW], u2[NW], x[2 * NW];
+	jacobian_t sum;
+
+	uECC_vli_bytesToNative(r, signature, 32);
+	uECC_vli_bytesToNative(s, signature + 32, 32);
+
+	// r, s in [1, n - 1]
+	if (uECC_vli_isZero(r, NW) || uECC_vli_isZero(s, NW)
+			|| uECC_vli_cmp(n, r, NW) != 1 || uECC_vli_cmp(n, s, NW) != 1)
+		return 0;
+
+	// u1 = e / s, u2 = r / s (mod n), e the hash reduced mod n
+	uECC_vli_bytesToNative(e, hash, 32);
+	if (uECC_vli_cmp(n, e, NW) != 1)
+		uECC_vli_sub(e, e, n, NW);
+	uECC_vli_modInv(s, s, n, NW);
+	uECC_vli_modMult(u1, e, s, n, NW);
+	uECC_vli_modMult(u2, r, s, n, NW);
+
+	// u1 G + u2 Q, both combs on one doubling chain (Shamir)
+	uECC_vli_clear(sum.z, NW);
+	for (int k = ECDSA_COMB_SPACING - 1; k >= 0; k--)
+	{
+		unsigned i1 = comb_index(u1, k), i2 = comb_index(u2, k);
+
+		point_double(&sum);
+		if (i1)
+			point_add_affine(&sum, ecdsa_comb_g[i1 - 1]);
+		if (i2)
+			point_add_affine(&sum, q_table[i2 - 1]);
+	}
+	if (uECC_vli_isZero(sum.z, NW))
+		return 0;
+
+	// Accept if x (mod n) == r
+	to_affine(x, &sum);
+	if (uECC_vli_cmp(n, x, NW) != 1)
+		uECC_vli_sub(x, x, n, NW);
+	return uECC_vli_equal(x, r, NW);
+}
+
+int ecdsa_comb_build(ecdsa_comb_point_t *table, const uint8_t public_key[64])
+{
+	uECC_word_t teeth[ECDSA_COMB_TEETH][2 * NW];
+	jacobian_t p;
+
+	uECC_vli_bytesToNative(teeth[0], public_key, 32);
+	uECC_vli_bytesToNative(teeth[0] + NW, public_key + 32, 32);
+	if (!uECC_valid_point(teeth[0], uECC_secp256r1()))
+		return 0;
+
+	// Tooth i = 2^(i * spacing) Q
+	for (int i = 1; i < ECDSA_COMB_TEETH; i++)
+	{
+		uECC_vli_clear(p.z, NW);
+		point_add_affine(&p, teeth[i - 1]);
+		for (int k = 0; k < ECDSA_COMB_SPACING; k++)
+			point_double(&p);
+		to_affine(teeth[i], &p);
+	}
+
+	// Entry j - 1 = sum of the teeth whose bits are set in j
+	for (unsigned j = 1; j <= ECDSA_COMB_POINTS; j++)
+	{
+		uECC_vli_clear(p.z, NW);
+		for (int i = 0; i < ECDSA_COMB_TEETH; i++)
+		{
+			if (j & (1U << i))
+				point_add_affine(&p, teeth[i]);
+		}
+		to_affine(table[j - 1], &p);
+	}
+	return 1;
+}
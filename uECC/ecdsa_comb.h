@@ -0,0 +1,39 @@
+/*
+ * P-256 ECDSA verification with precomputed comb tables
+ *
+ * uECC_verify() computes u1*G + u2*Q with 255 doublings and an addition
+ * for most bits. With both points fixed (G, and the bootloader's public
+ * key), each is replaced by a table of the 63 sums of its six "teeth"
+ * 2^(43*i) * P: one doubling and up to two table additions per column, 43
+ * columns in all. The G table is ecdsa_comb_g.c; tables are generated by
+ * Tools/ecdsa_comb_table.py and can be checked with ecdsa_comb_build().
+ *
+ * Uses the uECC VLI API (uECC_ENABLE_VLI_API in uECC_config.h).
+ */
+
+#ifndef ECDSA_COMB_H_
+#define ECDSA_COMB_H_
+
+#include <stdint.h>
+#include <uECC_vli.h>
+
+#define ECDSA_COMB_TEETH	6
+#define ECDSA_COMB_SPACING	43		// ceil(256 / ECDSA_COMB_TEETH)
+#define ECDSA_COMB_POINTS	((1 << ECDSA_COMB_TEETH) - 1)
+#define ECDSA_COMB_WORDS	(32 / uECC_WORD_SIZE)
+
+// Affine x then y, uECC native words (least significant first)
+typedef uECC_word_t ecdsa_comb_point_t[2 * ECDSA_COMB_WORDS];
+
+extern const ecdsa_comb_point_t ecdsa_comb_g[ECDSA_COMB_POINTS];
+
+// Same result as uECC_verify(public_key, hash, 32, signature, secp256r1)
+// for the key q_table was built from: 1 if the signature is valid
+int ecdsa_comb_verify(const ecdsa_comb_point_t *q_table, const uint8_t hash[32],
+		const uint8_t signature[64]);
+
+// Table of a public key (x || y, big-endian), as the generator makes it;
+// returns 0 if the key is not a valid point
+int ecdsa_comb_build(ecdsa_comb_point_t *table, const uint8_t public_key[64]);
+
+#endif /* ECDSA_COMB_H_ */
@@ -1,7 +1,8 @@
 /*
  * uECC_config.h
  * Configuration for micro-ecc library on STM32H7
- * Version D Encrypted Bootloader
+ * Shared by Bootloader_E (update signatures) and the application (staged
+ * firmware, see Staging/staging.h)
  */
 
 #ifndef UECC_CONFIG_H
@@ -35,8 +36,8 @@
 /* STM32 is little-endian but we handle byte order explicitly */
 #define uECC_VLI_NATIVE_LITTLE_ENDIAN 0
 
-/* Don't expose VLI API (only need signature verification) */
-#define uECC_ENABLE_VLI_API     0
+/* Expose the VLI API for the comb-table verification (ecdsa_comb.c) */
+#define uECC_ENABLE_VLI_API     1
 
 /* Max RNG tries before failure */
 #define uECC_RNG_MAX_TRIES      64